@@ -1,4 +1,5 @@
 #include "AcReference.hpp"
+#include "Database.hpp"
 #include "sqlite/sqlite3.h"
 
 #include <cmath>
@@ -58,6 +59,11 @@ Expected<AcReference*> AcReference::Lookup(unsigned int refID)
 	if (it != refs.end())
 		return it->second;
 
+	AcReference* reference = Database<AcReference>::Load(refID);
+
+	if (reference)
+		return reference;
+
 	return VaultException("No actor / creature reference with refID %08X found", refID);
 }
 
@@ -32,6 +32,9 @@ namespace DB
 			AcReference& operator=(const AcReference&) = delete;
 
 		public:
+			/**
+			 * \brief Returns the references read so far, references are read from the database on their first lookup
+			 */
 			static const std::unordered_map<unsigned int, AcReference*>& Get() { return refs; }
 			static Expected<AcReference*> Lookup(unsigned int refID);
 
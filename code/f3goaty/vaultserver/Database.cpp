@@ -13,6 +13,9 @@
 #include "AcReference.hpp"
 #include "sqlite/sqlite3.h"
 
+#include <algorithm>
+#include <chrono>
+
 #ifdef __WIN32__
 	#include <winsock2.h>
 	#include <io.h>
@@ -29,17 +32,13 @@ DebugInput<Database<T>> Database<T>::debug;
 #endif
 
 template <typename T>
-unsigned int Database<T>::initialize(const string& file, const vector<string>& tables)
-{
-	data.clear();
-
-	if (tables.empty())
-		return 0;
+Database<T>* Database<T>::prepared = nullptr;
 
+static sqlite3* OpenDatabase(const string& file, char (&_file)[MAX_PATH])
+{
 	char base[MAX_PATH];
 	_getcwd(base, sizeof(base));
 
-	char _file[MAX_PATH];
 	snprintf(_file, sizeof(_file), "%s/%s/%s", base, DATA_PATH, file.c_str());
 
 	sqlite3* db;
@@ -50,16 +49,70 @@ unsigned int Database<T>::initialize(const string& file, const vector<string>& t
 		throw VaultException("Could not open SQLite3 database: %s", sqlite3_errmsg(db)).stacktrace();
 	}
 
+	return db;
+}
+
+static sqlite3_stmt* PrepareQuery(sqlite3* db, const string& query)
+{
+	sqlite3_stmt* stmt;
+
+	if (sqlite3_prepare_v2(db, query.c_str(), query.length() + 1, &stmt, nullptr) != SQLITE_OK)
+		throw VaultException("Could not prepare query: %s", sqlite3_errmsg(db)).stacktrace();
+
+	return stmt;
+}
+
+template <typename T>
+Database<T>::~Database()
+{
+	close();
+}
+
+template <typename T>
+void Database<T>::close()
+{
+	for (sqlite3_stmt* stmt : statements)
+		sqlite3_finalize(stmt);
+
+	statements.clear();
+	rows.clear();
+	tables.clear();
+
+	if (db)
+	{
+		sqlite3_close(db);
+		db = nullptr;
+	}
+
+	if (prepared == this)
+		prepared = nullptr;
+}
+
+template <typename T>
+unsigned int Database<T>::initialize(const string& file, const vector<string>& tables)
+{
+	close();
+	data.clear();
+
+	if (tables.empty())
+		return 0;
+
+	char _file[MAX_PATH];
+	sqlite3* db = OpenDatabase(file, _file);
 	sqlite3_stmt* stmt;
 	string query = "SELECT (0) ";
 
 	for (const string& table : tables)
 		query += "+ (SELECT COUNT(*) FROM " + table + ")";
 
-	if (sqlite3_prepare_v2(db, query.c_str(), query.length() + 1, &stmt, nullptr) != SQLITE_OK)
+	try
+	{
+		stmt = PrepareQuery(db, query);
+	}
+	catch (...)
 	{
 		sqlite3_close(db);
-		throw VaultException("Could not prepare query: %s", sqlite3_errmsg(db)).stacktrace();
+		throw;
 	}
 
 	int ret = sqlite3_step(stmt);
@@ -80,20 +133,23 @@ unsigned int Database<T>::initialize(const string& file, const vector<string>& t
 		return 0;
 	}
 
-	data.reserve(count);
-
 	double end = 0.0;
 	double delta = 100.0 / count;
+	auto start = chrono::steady_clock::now();
 	printf("Reading database %s (%s, ...)\n", file.c_str(), tables.front().c_str());
 
 	for (const string& table : tables)
 	{
 		query = "SELECT * FROM " + table;
 
-		if (sqlite3_prepare_v2(db, query.c_str(), query.length() + 1, &stmt, nullptr) != SQLITE_OK)
+		try
+		{
+			stmt = PrepareQuery(db, query);
+		}
+		catch (...)
 		{
 			sqlite3_close(db);
-			throw VaultException("Could not prepare query: %s", sqlite3_errmsg(db)).stacktrace();
+			throw;
 		}
 
 		int ret = sqlite3_step(stmt);
@@ -135,6 +191,9 @@ unsigned int Database<T>::initialize(const string& file, const vector<string>& t
 
 	sqlite3_close(db);
 
+	Utils::timestamp();
+	printf("Read %u records in %u ms\n", (unsigned int) data.size(), (unsigned int) chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count());
+
 #ifdef VAULTMP_DEBUG
 	debug.print("Successfully read ", dec, data.size(), " records (", typeid(T).name(), ") from ", _file);
 #endif
@@ -142,6 +201,118 @@ unsigned int Database<T>::initialize(const string& file, const vector<string>& t
 	return data.size();
 }
 
+template <typename T>
+unsigned int Database<T>::prepare(const string& file, const vector<string>& tables, unsigned int key, unsigned int dlc)
+{
+	close();
+	data.clear();
+
+	if (tables.empty())
+		return 0;
+
+	char _file[MAX_PATH];
+	db = OpenDatabase(file, _file);
+
+	auto start = chrono::steady_clock::now();
+	printf("Indexing database %s (%s, ...)\n", file.c_str(), tables.front().c_str());
+
+	try
+	{
+		for (const string& table : tables)
+		{
+			unsigned int index = this->tables.size();
+			this->tables.emplace_back(table);
+
+			// the row is read by rowid, so a lookup never scans the table
+			sqlite3_stmt* stmt = PrepareQuery(db, "SELECT * FROM " + table + " WHERE rowid = ?1");
+			statements.emplace_back(stmt);
+
+			if (static_cast<unsigned int>(sqlite3_column_count(stmt)) <= max(key, dlc))
+				throw VaultException("Malformed input database: %s", table.c_str()).stacktrace();
+
+			string columns = string("SELECT rowid, ") + sqlite3_column_name(stmt, key) + ", " + sqlite3_column_name(stmt, dlc) + " FROM " + table;
+			sqlite3_stmt* scan = PrepareQuery(db, columns);
+			int ret;
+
+			while ((ret = sqlite3_step(scan)) == SQLITE_ROW)
+			{
+				Row row{index, sqlite3_column_int64(scan, 0)};
+				unsigned int id = static_cast<unsigned int>(sqlite3_column_int(scan, 1));
+
+				// the same overriding as in the record constructors: a DLC record never replaces
+				// one that was read before, a record of the base game replaces it
+				if (id & 0xFF000000)
+				{
+					id &= 0x00FFFFFF;
+					id |= static_cast<unsigned int>(sqlite3_column_int(scan, 2)) << 24;
+					rows.emplace(id, row);
+				}
+				else
+					rows[id] = row;
+			}
+
+			sqlite3_finalize(scan);
+
+			if (ret != SQLITE_DONE)
+				throw VaultException("Failed processing query: %s", sqlite3_errmsg(db)).stacktrace();
+		}
+	}
+	catch (...)
+	{
+		close();
+		throw;
+	}
+
+	prepared = this;
+
+	Utils::timestamp();
+	printf("Indexed %u records in %u ms\n", (unsigned int) rows.size(), (unsigned int) chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count());
+
+#ifdef VAULTMP_DEBUG
+	debug.print("Successfully indexed ", dec, rows.size(), " records (", typeid(T).name(), ") from ", _file);
+#endif
+
+	return rows.size();
+}
+
+template <typename T>
+T* Database<T>::Load(unsigned int id)
+{
+	if (!prepared)
+		return nullptr;
+
+	auto it = prepared->rows.find(id);
+
+	if (it == prepared->rows.end())
+		return nullptr;
+
+	Row row = it->second;
+	prepared->rows.erase(it);
+
+	sqlite3_stmt* stmt = prepared->statements[row.table];
+	sqlite3_bind_int64(stmt, 1, row.rowid);
+
+	T* record = nullptr;
+
+	try
+	{
+		if (sqlite3_step(stmt) != SQLITE_ROW)
+			throw VaultException("Failed processing query: %s", sqlite3_errmsg(prepared->db)).stacktrace();
+
+		prepared->data.emplace_back(prepared->tables[row.table], stmt);
+		record = &prepared->data.back();
+	}
+	catch (...)
+	{
+		sqlite3_reset(stmt);
+		throw;
+	}
+
+	sqlite3_reset(stmt);
+
+	return record;
+}
+
 template class Database<DB::Record>;
 template class Database<DB::Reference>;
 template class Database<DB::Exterior>;
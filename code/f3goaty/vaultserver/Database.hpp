@@ -9,9 +9,17 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <unordered_map>
+
+class sqlite3;
+class sqlite3_stmt;
 
 /**
  * \brief Used to access vaultmp SQLite3 databases
+ *
+ * A database is either read completely on initialize, or only indexed by its key column on
+ * prepare. A prepared database reads a row when the record is first looked up.
  */
 
 template<typename T>
@@ -24,12 +32,42 @@ class Database
 		static DebugInput<Database<T>> debug;
 #endif
 
-		std::vector<T> data;
+		struct Row
+		{
+			unsigned int table;
+			long long rowid;
+		};
+
+		static Database<T>* prepared;
+
+		std::deque<T> data;
+
+		sqlite3* db = nullptr;
+		std::vector<std::string> tables;
+		std::vector<sqlite3_stmt*> statements;
+		std::unordered_map<unsigned int, Row> rows;
 
 		Database() = default;
-		~Database() = default;
+		~Database();
+
+		void close();
 
 		unsigned int initialize(const std::string& file, const std::vector<std::string>& tables);
+		/**
+		 * \brief Indexes the tables by the key column, the rows are read by Load
+		 *
+		 * key - the column of the baseID / refID
+		 * dlc - the column of the DLC index
+		 */
+		unsigned int prepare(const std::string& file, const std::vector<std::string>& tables, unsigned int key, unsigned int dlc);
+
+	public:
+		/**
+		 * \brief Reads the record with the given ID from the prepared database
+		 *
+		 * Returns nullptr if the ID is unknown or was read before. T's constructor registers the record in T's lookup table
+		 */
+		static T* Load(unsigned int id);
 };
 
 #endif
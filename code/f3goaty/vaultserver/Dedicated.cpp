@@ -10,6 +10,10 @@
 #include "Timer.hpp"
 #include "Script.hpp"
 
+#include <deque>
+#include <functional>
+#include <algorithm>
+
 using namespace std;
 using namespace RakNet;
 using namespace Values;
@@ -27,6 +31,14 @@ TimeMS Dedicated::announcetime;
 ServerEntry* Dedicated::self = nullptr;
 unsigned int Dedicated::cell;
 ModList Dedicated::modfiles;
+unsigned int Dedicated::workers = DEDICATED_STANDARD_WORKERS;
+bool Dedicated::latencystats = false;
+unsigned int Dedicated::loadclients = 0;
+shared_ptr<const Dedicated::ServerInfo> Dedicated::serverinfo;
+mutex Dedicated::wakemutex;
+condition_variable Dedicated::wakeup;
+bool Dedicated::wakepending = false;
+chrono::steady_clock::time_point Dedicated::waketime;
 
 #ifdef VAULTMP_DEBUG
 DebugInput<Dedicated> Dedicated::debug;
@@ -34,8 +46,217 @@ DebugInput<Dedicated> Dedicated::debug;
 
 bool Dedicated::thread;
 
+/**
+ * \brief Copy of the ServerEntry data sent in announces and query replies
+ */
+struct Dedicated::ServerInfo
+{
+	RakString name;
+	RakString map;
+	unsigned int players;
+	unsigned int playersMax;
+	vector<pair<RakString, RakString>> rules;
+	vector<RakString> mods;
+};
+
+/**
+ * \brief Collects latency samples in microseconds and prints percentiles every LATENCY_REPORT_RATE ms
+ *
+ * Samples may be added from any thread
+ */
+class LatencyStats
+{
+	private:
+		const char* name;
+		mutex lock;
+		vector<unsigned int> samples;
+		TimeMS reporttime;
+
+	public:
+		LatencyStats(const char* name) : name(name), reporttime(GetTimeMS()) {}
+
+		void Add(chrono::steady_clock::time_point since)
+		{
+			unsigned int usecs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - since).count();
+
+			lock_guard<mutex> guard(lock);
+			samples.emplace_back(usecs);
+		}
+
+		void Report()
+		{
+			vector<unsigned int> sorted;
+
+			{
+				lock_guard<mutex> guard(lock);
+
+				if ((GetTimeMS() - reporttime) <= LATENCY_REPORT_RATE)
+					return;
+
+				reporttime = GetTimeMS();
+				sorted.swap(samples);
+			}
+
+			if (sorted.empty())
+				return;
+
+			sort(sorted.begin(), sorted.end());
+
+			auto percentile = [&sorted](unsigned int p) { return sorted[(sorted.size() - 1) * p / 100] / 1000.0; };
+
+			Utils::timestamp();
+			printf("%s latency: %u packets, p50 %.3f ms, p99 %.3f ms, max %.3f ms\n", name, (unsigned int) sorted.size(), percentile(50), percentile(99), sorted.back() / 1000.0);
+		}
+};
+
+static LatencyStats serverlatency("Packet to response");
+
+/**
+ * \brief Runs handlers that don't touch world state off the network thread
+ *
+ * Jobs submitted with the same key run on the same worker in submission order
+ */
+class PacketWorkers
+{
+	private:
+		struct Worker
+		{
+			std::thread handle;
+			mutex lock;
+			condition_variable signal;
+			deque<function<void()>> jobs;
+			bool running = true;
+		};
+
+		vector<unique_ptr<Worker>> workers;
+
+		static void Run(Worker* worker)
+		{
+			unique_lock<mutex> guard(worker->lock);
+
+			while (true)
+			{
+				worker->signal.wait(guard, [worker] { return !worker->jobs.empty() || !worker->running; });
+
+				if (worker->jobs.empty())
+					return;
+
+				function<void()> job = move(worker->jobs.front());
+				worker->jobs.pop_front();
+				guard.unlock();
+
+				try
+				{
+					job();
+				}
+				catch (exception& e)
+				{
+					VaultException vaulterror(e.what());
+					vaulterror.Console();
+				}
+
+				guard.lock();
+			}
+		}
+
+	public:
+		void Start(unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				workers.emplace_back(new Worker());
+				workers.back()->handle = std::thread(Run, workers.back().get());
+			}
+		}
+
+		/**
+		 * \brief Finishes the queued jobs and joins the workers
+		 */
+		void Stop()
+		{
+			for (auto& worker : workers)
+			{
+				{
+					lock_guard<mutex> guard(worker->lock);
+					worker->running = false;
+				}
+
+				worker->signal.notify_one();
+				worker->handle.join();
+			}
+
+			workers.clear();
+		}
+
+		/**
+		 * \brief Runs the job on the calling thread if there are no workers
+		 */
+		void Submit(size_t key, function<void()> job)
+		{
+			if (workers.empty())
+			{
+				job();
+				return;
+			}
+
+			Worker* worker = workers[key % workers.size()].get();
+
+			{
+				lock_guard<mutex> guard(worker->lock);
+				worker->jobs.emplace_back(move(job));
+			}
+
+			worker->signal.notify_one();
+		}
+} packetWorkers;
+
+/**
+ * \brief Wakes the network thread as soon as RakNet read a datagram from the socket
+ */
+class ReceiveSignal : public PluginInterface2
+{
+		virtual void OnDirectSocketReceive(const char*, const BitSize_t, SystemAddress)
+		{
+			Dedicated::Wake();
+		}
+
+} receiveSignal;
+
+void Dedicated::Wake()
+{
+	{
+		lock_guard<mutex> guard(wakemutex);
+
+		if (!wakepending)
+		{
+			wakepending = true;
+			waketime = chrono::steady_clock::now();
+		}
+	}
+
+	wakeup.notify_one();
+}
+
+bool Dedicated::WaitForPackets(unsigned int ms, chrono::steady_clock::time_point& arrival)
+{
+	unique_lock<mutex> guard(wakemutex);
+
+	if (!wakepending && ms)
+		wakeup.wait_for(guard, chrono::milliseconds(ms), [] { return wakepending; });
+
+	bool signaled = wakepending;
+
+	if (signaled)
+		arrival = waketime;
+
+	wakepending = false;
+
+	return signaled;
+}
+
 void Dedicated::TerminateThread()
 {
+	// also called from the signal handler, the network thread notices within RAKNET_MAX_WAIT ms
 	thread = false;
 }
 
@@ -64,6 +285,50 @@ unsigned int Dedicated::GetMaximumPlayers()
 	return self->GetServerPlayers().second;
 }
 
+shared_ptr<const Dedicated::ServerInfo> Dedicated::GetServerInfo()
+{
+	// taken at most once per network thread iteration, workers keep their copy alive
+	if (!serverinfo)
+	{
+		shared_ptr<ServerInfo> info = make_shared<ServerInfo>();
+
+		info->name = self->GetServerName().c_str();
+		info->map = self->GetServerMap().c_str();
+		info->players = self->GetServerPlayers().first;
+		info->playersMax = self->GetServerPlayers().second;
+
+		for (const auto& i : self->GetServerRules())
+			info->rules.emplace_back(i.first.c_str(), i.second.c_str());
+
+		for (const auto& j : modfiles)
+			info->mods.emplace_back(j.first.c_str());
+
+		serverinfo = info;
+	}
+
+	return serverinfo;
+}
+
+void Dedicated::WriteServerInfo(BitStream& query, const ServerInfo& info)
+{
+	query.Write(info.name);
+	query.Write(info.map);
+	query.Write(info.players);
+	query.Write(info.playersMax);
+	query.Write(info.rules.size());
+
+	for (const auto& i : info.rules)
+	{
+		query.Write(i.first);
+		query.Write(i.second);
+	}
+
+	query.Write(info.mods.size());
+
+	for (const auto& j : info.mods)
+		query.Write(j);
+}
+
 void Dedicated::Announce(bool announce)
 {
 	if (peer->GetConnectionState(master) == IS_CONNECTED)
@@ -74,34 +339,7 @@ void Dedicated::Announce(bool announce)
 		{
 			query.Write((MessageID) ID_MASTER_ANNOUNCE);
 			query.Write(true);
-
-			RakString name(self->GetServerName().c_str());
-			RakString _map(self->GetServerMap().c_str());
-			unsigned int players = self->GetServerPlayers().first;
-			unsigned int playersMax = self->GetServerPlayers().second;
-			const map<string, string>& rules = self->GetServerRules();
-
-			query.Write(name);
-			query.Write(_map);
-			query.Write(players);
-			query.Write(playersMax);
-			query.Write(rules.size());
-
-			for (const auto& i : rules)
-			{
-				RakString key(i.first.c_str());
-				RakString value(i.second.c_str());
-				query.Write(key);
-				query.Write(value);
-			}
-
-			query.Write(modfiles.size());
-
-			for (const auto& j : modfiles)
-			{
-			    RakString name(j.first.c_str());
-			    query.Write(name);
-			}
+			WriteServerInfo(query, *GetServerInfo());
 		}
 		else
 		{
@@ -121,7 +359,7 @@ void Dedicated::Announce(bool announce)
 	announcetime = GetTimeMS();
 }
 
-void Dedicated::Query(Packet* packet)
+void Dedicated::Query(Packet* packet, chrono::steady_clock::time_point arrival)
 {
 	if (Dedicated::query)
 	{
@@ -131,43 +369,30 @@ void Dedicated::Query(Packet* packet)
 		SystemAddress addr;
 		queryy.Read(addr);
 
-		BitStream query;
-
-		query.Write((MessageID) ID_MASTER_UPDATE);
-		query.Write(addr);
-
-		RakString name(self->GetServerName().c_str());
-		RakString _map(self->GetServerMap().c_str());
-		unsigned int players = self->GetServerPlayers().first;
-		unsigned int playersMax = self->GetServerPlayers().second;
-		const map<string, string>& rules = self->GetServerRules();
+		SystemAddress target = packet->systemAddress;
+		shared_ptr<const ServerInfo> info = GetServerInfo();
 
-		query.Write(name);
-		query.Write(_map);
-		query.Write(players);
-		query.Write(playersMax);
-		query.Write(rules.size());
-
-		for (const auto& i : rules)
+		// the reply only reads the snapshot, replies to one system stay in order because they share a worker
+		packetWorkers.Submit(SystemAddress::ToInteger(target), [addr, target, info, arrival]()
 		{
-			RakString key(i.first.c_str());
-			RakString value(i.second.c_str());
-			query.Write(key);
-			query.Write(value);
-		}
+			BitStream query;
 
-		query.Write(modfiles.size());
+			query.Write((MessageID) ID_MASTER_UPDATE);
+			query.Write(addr);
+			WriteServerInfo(query, *info);
 
-		for (const auto& k : modfiles)
-        {
-            RakString mod_name(k.first.c_str());
-            query.Write(mod_name);
-        }
+			peer->Send(&query, LOW_PRIORITY, RELIABLE_ORDERED, CHANNEL_SYSTEM, target, false, 0);
 
-		peer->Send(&query, LOW_PRIORITY, RELIABLE_ORDERED, CHANNEL_SYSTEM, packet->systemAddress, false, 0);
+			if (latencystats)
+				serverlatency.Add(arrival);
 
-		Utils::timestamp();
-		printf("Query processed (%s)\n", packet->systemAddress.ToString());
+			// the load generator would flood the console
+			if (!loadclients)
+			{
+				Utils::timestamp();
+				printf("Query processed (%s)\n", target.ToString());
+			}
+		});
 	}
 	else
 	{
@@ -243,6 +468,97 @@ void Dedicated::FileThread()
 		this_thread::sleep_for(chrono::milliseconds(5));
 	}
 }
+void Dedicated::LoadThread()
+{
+	struct LoadClient
+	{
+		RakPeerInterface* peer;
+		SystemAddress server;
+		bool connected;
+		bool waiting;
+		chrono::steady_clock::time_point sent;
+	};
+
+	// leave one slot to real players
+	unsigned int count = min(loadclients, connections > 1 ? connections - 1 : 1u);
+	vector<LoadClient> clients(count);
+	LatencyStats looplatency("Load generator round trip");
+	const char* target = host ? host : "127.0.0.1";
+
+	Utils::timestamp();
+	printf("Load generator connecting %u clients to %s:%u\n", count, target, port);
+
+	for (LoadClient& client : clients)
+	{
+		SocketDescriptor sockdescr;
+		client.peer = RakPeerInterface::GetInstance();
+		client.peer->Startup(1, &sockdescr, 1, THREAD_PRIORITY_NORMAL);
+		client.peer->Connect(target, port, DEDICATED_VERSION, sizeof(DEDICATED_VERSION), 0, 0, 3, 500, 0);
+		client.connected = false;
+		client.waiting = false;
+	}
+
+	while (thread)
+	{
+		for (LoadClient& client : clients)
+		{
+			for (Packet* packet = client.peer->Receive(); packet; client.peer->DeallocatePacket(packet), packet = client.peer->Receive())
+			{
+				switch (packet->data[0])
+				{
+					case ID_CONNECTION_REQUEST_ACCEPTED:
+						client.server = packet->systemAddress;
+						client.connected = true;
+						break;
+
+					case ID_MASTER_UPDATE:
+						looplatency.Add(client.sent);
+						client.waiting = false;
+						break;
+
+					case ID_CONNECTION_ATTEMPT_FAILED:
+						// the server may still be loading its scripts
+						client.peer->Connect(target, port, DEDICATED_VERSION, sizeof(DEDICATED_VERSION), 0, 0, 3, 500, 0);
+						break;
+
+					case ID_NO_FREE_INCOMING_CONNECTIONS:
+					case ID_DISCONNECTION_NOTIFICATION:
+					case ID_CONNECTION_LOST:
+						client.connected = false;
+						client.waiting = false;
+						break;
+
+					default:
+						break;
+				}
+			}
+
+			// closed loop, every client has one query in flight
+			if (client.connected && !client.waiting)
+			{
+				BitStream query;
+				query.Write((MessageID) ID_MASTER_UPDATE);
+				query.Write(client.peer->GetMyBoundAddress());
+
+				client.sent = chrono::steady_clock::now();
+				client.waiting = true;
+				client.peer->Send(&query, LOW_PRIORITY, RELIABLE_ORDERED, CHANNEL_SYSTEM, client.server, false, 0);
+			}
+		}
+
+		looplatency.Report();
+
+		// don't sleep, it would add up to the sleep granularity to every round trip
+		this_thread::yield();
+	}
+
+	for (LoadClient& client : clients)
+	{
+		client.peer->Shutdown(100);
+		RakPeerInterface::DestroyInstance(client.peer);
+	}
+}
+
 #include <iomanip>
 void Dedicated::DedicatedThread()
 {
@@ -291,16 +607,36 @@ void Dedicated::DedicatedThread()
 
 		Script::Call<Script::CBI("OnServerInit")>();
 
+		peer->AttachPlugin(&receiveSignal);
+		packetWorkers.Start(workers);
+
 		try
 		{
+			// time of the last socket signal, kept through the grace polls until the packets it announced are handled
+			chrono::steady_clock::time_point arrival = chrono::steady_clock::now();
+			bool signaled = false;
+			unsigned int grace = 0;
+
 			while (thread)
 			{
 				while (Network::Dispatch(peer));
 
+				bool handled = false;
+
 				for (Packet* packet = peer->Receive(); packet; peer->DeallocatePacket(packet), packet = peer->Receive())
 				{
+					grace = RAKNET_SIGNAL_GRACE;
+					handled = true;
+
+					// packets RakNet makes up itself (connection events) come without a signal
+					if (!signaled)
+					{
+						arrival = chrono::steady_clock::now();
+						signaled = true;
+					}
+
 					if (packet->data[0] == ID_MASTER_UPDATE)
-						Query(packet);
+						Query(packet, arrival);
 					else
 					{
 						try
@@ -319,6 +655,9 @@ void Dedicated::DedicatedThread()
 
 							for (RakNetGUID& guid : closures)
 								peer->CloseConnection(guid, true, CHANNEL_SYSTEM, HIGH_PRIORITY);
+
+							if (latencystats)
+								serverlatency.Add(arrival);
 						}
 						catch (...)
 						{
@@ -329,15 +668,45 @@ void Dedicated::DedicatedThread()
 					}
 				}
 
-				Timer::GlobalTick();
+				// whatever the last signal announced has been handled, time the next packets from the next signal
+				if (handled)
+					signaled = false;
+
+				serverinfo.reset();
 
-				this_thread::sleep_for(chrono::milliseconds(1));
+				Timer::GlobalTick();
 
 				if (announce)
 				{
 					if ((GetTimeMS() - announcetime) > RAKNET_MASTER_RATE)
 						Announce(true);
 				}
+
+				if (latencystats)
+					serverlatency.Report();
+
+				// sleep until the next datagram, timer or announce. A datagram is signaled before RakNet has
+				// turned it into a packet, so keep polling for a few milliseconds after socket activity
+				unsigned int wait = 1;
+
+				if (!grace)
+				{
+					wait = min(Timer::NextTick(), (unsigned int) RAKNET_MAX_WAIT);
+
+					if (announce)
+					{
+						unsigned int elapsed = GetTimeMS() - announcetime;
+						wait = min(wait, elapsed < RAKNET_MASTER_RATE ? RAKNET_MASTER_RATE - elapsed + 1 : 0u);
+					}
+				}
+				else
+					--grace;
+
+				if (WaitForPackets(wait, arrival))
+				{
+					grace = RAKNET_SIGNAL_GRACE;
+					signaled = true;
+				}
 			}
 		}
 		catch (...)
@@ -362,6 +731,8 @@ void Dedicated::DedicatedThread()
 		}
 	}
 
+	packetWorkers.Stop();
+
 	Script::UnloadScripts();
 
 	thread = false;
@@ -397,6 +768,9 @@ std::thread Dedicated::InitializeServer(unsigned int port, const char* host, uns
 	if (fileserve)
 		std::thread(FileThread).detach();
 
+	if (loadclients)
+		std::thread(LoadThread).detach();
+
 	return hDedicatedThread;
 }
 
@@ -415,6 +789,17 @@ void Dedicated::SetModfiles(ModList modfiles)
 	Dedicated::modfiles = modfiles;
 }
 
+void Dedicated::SetWorkers(unsigned int workers)
+{
+	Dedicated::workers = workers;
+}
+
+void Dedicated::SetLatencyStats(bool enabled, unsigned int loadclients)
+{
+	Dedicated::latencystats = enabled;
+	Dedicated::loadclients = loadclients;
+}
+
 /* void Dedicated::SetServerConnections(int connections)
 {
 
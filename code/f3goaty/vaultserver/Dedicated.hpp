@@ -10,11 +10,19 @@
 
 #include <vector>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
 
 #define RAKNET_STANDARD_PORT            1770
 #define RAKNET_STANDARD_CONNECTIONS     4
 #define RAKNET_MASTER_RATE              2000
 #define RAKNET_MASTER_STANDARD_PORT     1660
+#define RAKNET_MAX_WAIT                 50
+#define RAKNET_SIGNAL_GRACE             5
+#define DEDICATED_STANDARD_WORKERS      2
+#define LATENCY_REPORT_RATE             10000
 
 typedef std::vector<std::pair<std::string, unsigned int>> ModList;
 
@@ -29,6 +37,7 @@ class Dedicated
 		friend class NetworkServer;
 		friend class Server;
 		friend class FileProgress;
+		friend class ReceiveSignal;
 
 	private:
 		static RakNet::RakPeerInterface* peer;
@@ -41,8 +50,17 @@ class Dedicated
 		static bool query;
 		static bool fileserve;
 
+		static unsigned int workers;
+		static bool latencystats;
+		static unsigned int loadclients;
+
+		struct ServerInfo;
+		static std::shared_ptr<const ServerInfo> serverinfo;
+		static std::shared_ptr<const ServerInfo> GetServerInfo();
+		static void WriteServerInfo(RakNet::BitStream& query, const ServerInfo& info);
+
 		static void Announce(bool announce);
-		static void Query(RakNet::Packet* packet);
+		static void Query(RakNet::Packet* packet, std::chrono::steady_clock::time_point arrival);
 		static RakNet::TimeMS announcetime;
 		static RakNet::SystemAddress master;
 		static ServerEntry* self;
@@ -51,9 +69,27 @@ class Dedicated
 
 		static void DedicatedThread();
 		static void FileThread();
+		static void LoadThread();
 
 		static bool thread;
 
+		static std::mutex wakemutex;
+		static std::condition_variable wakeup;
+		static bool wakepending;
+		static std::chrono::steady_clock::time_point waketime;
+
+		/**
+		 * \brief Called from RakNet's receive thread whenever a datagram arrived on the socket
+		 */
+		static void Wake();
+		/**
+		 * \brief Waits up to ms milliseconds for a datagram
+		 *
+		 * Returns true if one arrived, arrival is then set to the time the first datagram since the last wait was read
+		 * from the socket. It is left alone otherwise
+		 */
+		static bool WaitForPackets(unsigned int ms, std::chrono::steady_clock::time_point& arrival);
+
 #ifdef VAULTMP_DEBUG
 		static DebugInput<Dedicated> debug;
 #endif
@@ -85,6 +121,16 @@ class Dedicated
 		 * unsigned int is the CRC32 of the modfile
 		 */
 		static void SetModfiles(ModList modfiles);
+		/**
+		 * \brief Sets the number of worker threads answering queries off the network thread
+		 */
+		static void SetWorkers(unsigned int workers);
+		/**
+		 * \brief Enables periodic output of the packet to response latency
+		 *
+		 * loadclients - the number of local clients sending queries to the server in a closed loop, 0 disables the load generator
+		 */
+		static void SetLatencyStats(bool enabled, unsigned int loadclients);
 		/**
 		 * \brief Terminates the dedicated server thread
 		 */
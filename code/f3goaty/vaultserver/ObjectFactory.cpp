@@ -1,5 +1,7 @@
 #include "ObjectFactory.hpp"
 
+using namespace std;
+
 Database<DB::Record> ObjectFactory::dbRecords;
 Database<DB::Reference> ObjectFactory::dbReferences;
 Database<DB::Exterior> ObjectFactory::dbExteriors;
@@ -11,10 +13,30 @@ Database<DB::Item> ObjectFactory::dbItems;
 Database<DB::Terminal> ObjectFactory::dbTerminals;
 Database<DB::Interior> ObjectFactory::dbInteriors;
 Database<DB::AcReference> ObjectFactory::dbAcReferences;
+bool ObjectFactory::lazy = true;
+
+void ObjectFactory::SetLazy(bool lazy)
+{
+	ObjectFactory::lazy = lazy;
+}
 
 void ObjectFactory::Initialize()
 {
-	dbRecords.initialize(DB_FALLOUT3, {"CONT", "NPC_", "CREA", "LVLI", "ALCH", "AMMO", "ARMA", "ARMO", "BOOK", "ENCH", "KEYM", "MISC", "NOTE", "WEAP", "CELL", "IDLE", "WTHR", "STAT", "MSTT", "RACE", "LIGH", "DOOR", "TERM", "EXPL", "PROJ", "STAT", "SOUN"});
+	const vector<string> records = {"CONT", "NPC_", "CREA", "LVLI", "ALCH", "AMMO", "ARMA", "ARMO", "BOOK", "ENCH", "KEYM", "MISC", "NOTE", "WEAP", "CELL", "IDLE", "WTHR", "STAT", "MSTT", "RACE", "LIGH", "DOOR", "TERM", "EXPL", "PROJ", "STAT", "SOUN"};
+	const vector<string> acreferences = {"arefs", "crefs"};
+
+	// the other tables are walked as a whole (cells of references, items of containers...)
+	if (lazy)
+	{
+		dbRecords.prepare(DB_FALLOUT3, records, 0, 3); // baseID, dlc
+		dbAcReferences.prepare(DB_FALLOUT3, acreferences, 1, 11); // refID, dlc
+	}
+	else
+	{
+		dbRecords.initialize(DB_FALLOUT3, records);
+		dbAcReferences.initialize(DB_FALLOUT3, acreferences);
+	}
+
 	dbExteriors.initialize(DB_FALLOUT3, {"exteriors"});
 	dbWeapons.initialize(DB_FALLOUT3, {"weapons"});
 	dbRaces.initialize(DB_FALLOUT3, {"races"});
@@ -23,6 +45,5 @@ void ObjectFactory::Initialize()
 	dbItems.initialize(DB_FALLOUT3, {"items"});
 	dbTerminals.initialize(DB_FALLOUT3, {"terminals"});
 	dbInteriors.initialize(DB_FALLOUT3, {"interiors"});
-	dbAcReferences.initialize(DB_FALLOUT3, {"arefs", "crefs"});
 	dbReferences.initialize(DB_FALLOUT3, {"refs_CONT", "refs_DOOR", "refs_TERM", "refs_STAT"});
 }
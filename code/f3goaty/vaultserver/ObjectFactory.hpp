@@ -18,7 +18,13 @@ class ObjectFactory
 {
     public:
         static void Initialize();
+        /**
+         * \brief Whether records and actor references are read on their first lookup instead of at startup
+         */
+        static void SetLazy(bool lazy);
     private:
+        static bool lazy;
+
         static Database<DB::Record> dbRecords;
 	static Database<DB::Reference> dbReferences;
 	static Database<DB::Exterior> dbExteriors;
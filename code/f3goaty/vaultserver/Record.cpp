@@ -1,6 +1,7 @@
 #include "Record.hpp"
 #include "Exterior.hpp"
 #include "Interior.hpp"
+#include "Database.hpp"
 #include "sqlite/sqlite3.h"
 
 #include <algorithm>
@@ -36,36 +37,46 @@ Record::Record(const string& table, sqlite3_stmt* stmt)
 	data.emplace(baseID, this);
 }
 
-Expected<Record*> Record::Lookup(unsigned int baseID)
+Record* Record::Find(unsigned int baseID)
 {
 	auto it = data.find(baseID);
 
 	if (it != data.end())
 		return it->second;
 
+	return Database<Record>::Load(baseID);
+}
+
+Expected<Record*> Record::Lookup(unsigned int baseID)
+{
+	Record* record = Find(baseID);
+
+	if (record)
+		return record;
+
 	return VaultException("No record with baseID %08X found", baseID);
 }
 
 Expected<Record*> Record::Lookup(unsigned int baseID, const string& type)
 {
-	auto it = data.find(baseID);
+	Record* record = Find(baseID);
 
-	if (it != data.end() && !it->second->GetType().compare(type))
-		return it->second;
+	if (record && !record->GetType().compare(type))
+		return record;
 
 	return VaultException("No record with baseID %08X and type %s found", baseID, type.c_str());
 }
 
 Expected<Record*> Record::Lookup(unsigned int baseID, const vector<string>& types)
 {
-	auto it = data.find(baseID);
+	Record* record = Find(baseID);
 
-	if (it != data.end())
+	if (record)
 	{
-		const string& type = it->second->GetType();
+		const string& type = record->GetType();
 
 		if (find(types.begin(), types.end(), type) != types.end())
-			return it->second;
+			return record;
 	}
 
 	return VaultException("No record with baseID %08X found", baseID);
@@ -31,7 +31,12 @@ namespace DB
 			Record(const Record&) = delete;
 			Record& operator=(const Record&) = delete;
 
+			static Record* Find(unsigned int baseID);
+
 		public:
+			/**
+			 * \brief Returns the records read so far, records are read from the database on their first lookup
+			 */
 			static const std::unordered_map<unsigned int, Record*>& Get() { return data; }
 			static Expected<Record*> Lookup(unsigned int baseID);
 			static Expected<Record*> Lookup(unsigned int baseID, const std::string& type);
@@ -1,6 +1,9 @@
 #include "Timer.hpp"
 #include "Network.hpp"
 
+#include <climits>
+#include <algorithm>
+
 using namespace std;
 using namespace RakNet;
 
@@ -55,6 +58,30 @@ void Timer::GlobalTick()
 	}
 }
 
+unsigned int Timer::NextTick()
+{
+	unsigned int now = msecs();
+	unsigned int next = UINT_MAX;
+
+	for (const auto& it : timers)
+	{
+		const Timer* timer = it.second;
+
+		if (timer->markdelete)
+			continue;
+
+		unsigned int elapsed = now - timer->ms;
+
+		// GlobalTick calls the timer once elapsed exceeds the interval
+		if (elapsed > timer->interval)
+			return 0;
+
+		next = min(next, timer->interval - elapsed + 1);
+	}
+
+	return next;
+}
+
 NetworkID Timer::LastTimer()
 {
 	return last_timer;
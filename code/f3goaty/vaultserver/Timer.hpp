@@ -38,6 +38,10 @@ class Timer : public ScriptFunction, public RakNet::NetworkIDObject
 		 * Calls timer functions
 		 */
 		static void GlobalTick();
+		/**
+		 * \brief Returns the milliseconds until GlobalTick calls the next timer, UINT_MAX if there are no timers
+		 */
+		static unsigned int NextTick();
 		/**
 		 * \brief Returns the NetworkID of the latest timer
 		 */
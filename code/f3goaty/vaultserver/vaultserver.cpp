@@ -4,6 +4,7 @@
 #include "Utils.hpp"
 #include "Client.hpp"
 #include "ServerEntry.hpp"
+#include "ObjectFactory.hpp"
 #include "iniparser/src/dictionary.h"
 #include "iniparser/src/iniparser.h"
 
@@ -137,6 +138,10 @@ int main(int, char* argv[])
 	const char* mods;
 	unsigned int cell;
 	bool keep;
+	unsigned int workers;
+	bool latency;
+	unsigned int loadtest;
+	bool lazydb;
 
 	dictionary* config = iniparser_load(args.count("ini") ? args["ini"] : "vaultserver.ini");
 
@@ -153,6 +158,10 @@ int main(int, char* argv[])
 	announce = iniparser_getstring_ex("general:master", "vaultmp.com");
 	cell = iniparser_getint_ex("general:spawn", 0x000010C1); // Vault101Exterior
 	keep = iniparser_getboolean_ex("general:keepalive", false);
+	workers = iniparser_getint_ex("general:workers", DEDICATED_STANDARD_WORKERS);
+	latency = iniparser_getboolean_ex("general:latency", false);
+	loadtest = iniparser_getint_ex("general:loadtest", 0);
+	lazydb = iniparser_getboolean_ex("general:lazydb", true);
 	scripts = iniparser_getstring_ex("scripts:scripts", "");
 	mods = iniparser_getstring_ex("mods:mods", "");
 
@@ -214,6 +223,9 @@ int main(int, char* argv[])
 			}
 
 			Dedicated::SetModfiles(modfiles);
+			Dedicated::SetWorkers(workers);
+			Dedicated::SetLatencyStats(latency || loadtest, loadtest);
+			ObjectFactory::SetLazy(lazydb);
 
 			thread hDedicatedThread = Dedicated::InitializeServer(port, host, players, announce, query, files, fileslots);
 			hDedicatedThread.join();
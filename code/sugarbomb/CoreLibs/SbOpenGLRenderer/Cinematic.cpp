@@ -82,6 +82,24 @@ extern "C" {
 #include <BinkDecoder.h>
 #endif // USE_BINKDEC
 
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+idCVar r_cinematicDecodeAhead("r_cinematicDecodeAhead", "4", CVAR_RENDERER | CVAR_INTEGER, "number of ffmpeg/BinkDec video frames decoded ahead on a worker thread, 0 = decode when the frame is drawn", 0, 8);
+
+// updated by the decode threads and the back end, printed by cinematicStats
+struct cinematicStats_t
+{
+	int decodedFrames;
+	int droppedFrames;  // decoded but never shown because a later frame was already due
+	int lateFrames;     // draws that had to repeat the previous frame because the decoder was behind
+	uint64 decodeMicroSec;
+};
+
+static cinematicStats_t cinematicStats;
+static idSysMutex cinematicStatsMutex;
+
+class idCinematicDecodeThread;
+#endif
+
 class idCinematicLocal : public idCinematic
 {
 public:
@@ -125,6 +143,55 @@ private:
 	idImage *imgY;
 	idImage *imgCr;
 	idImage *imgCb;
+#endif
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+	// Decode-ahead: a worker thread keeps a ring of converted frames filled while
+	// the back end only uploads the frame that is due, see r_cinematicDecodeAhead.
+	// The ring is single producer / single consumer, decodeWrite is only advanced
+	// by the worker and decodeRead only by ImageForTime.
+	friend class idCinematicDecodeThread;
+
+	static const int MAX_DECODED_FRAMES = 8;
+
+	struct decodedFrame_t
+	{
+		int sequence;  // incremented every time the decoder restarts the video
+		int frameNum;
+		bool endOfStream;
+		byte *data;  // BGRA for ffmpeg, the Y, Cb and Cr planes for BinkDec
+		int dataSize;
+		int planeWidth[3];
+		int planeHeight[3];
+	};
+
+	idCinematicDecodeThread *decodeThread;
+	decodedFrame_t decodedFrames[MAX_DECODED_FRAMES];
+	int numDecodedFrames;
+	idSysInterlockedInteger decodeRead;
+	idSysInterlockedInteger decodeWrite;
+	idSysInterlockedInteger decodeSkipSequence;  // the worker only converts frames from
+	idSysInterlockedInteger decodeSkipFrame;     // this point on, set when playback is late
+
+	// only touched by the worker, or while it is idle
+	int decodeSequence;
+	int decodeFramePos;
+	bool decodeEndOfStream;
+
+	// only touched by ImageForTime
+	int playSequence;
+	int playFramePos;
+
+	void StartDecodeAhead();
+	void StopDecodeAhead();
+	void RestartDecodeAhead();
+	void DecodeAhead();
+	bool DecodeNextFrame(decodedFrame_t &frame, bool convert);
+	bool RewindDecoder();
+	void UploadDecodedFrame(const decodedFrame_t &frame);
+	cinData_t ImageForTimeDecodeAhead(int thisTime);
+#endif
+#ifdef USE_BINKDEC
+	void UploadBinkDecPlane(idImage *image, const byte *data, int w, int h);
 #endif
 	idImage *img;
 	bool isRoQ;
@@ -198,6 +265,23 @@ private:
 	idFileSystem *fileSystem{ nullptr };
 };
 
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+class idCinematicDecodeThread : public idSysThread
+{
+public:
+	idCinematicDecodeThread(idCinematicLocal *cinematic) : cinematic(cinematic) {}
+
+	virtual int Run()
+	{
+		cinematic->DecodeAhead();
+		return 0;
+	}
+
+private:
+	idCinematicLocal *cinematic;
+};
+#endif
+
 // Carl: ROQ files from original Doom 3
 const int DEFAULT_CIN_WIDTH = 512;
 const int DEFAULT_CIN_HEIGHT = 512;
@@ -230,6 +314,27 @@ static unsigned short *vq8 = nullptr;
 
 //===========================================
 
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+/*
+==============
+R_CinematicStats_f
+==============
+*/
+static void R_CinematicStats_f(const idCmdArgs &args)
+{
+	idScopedCriticalSection lock(cinematicStatsMutex);
+
+	const int decoded = cinematicStats.decodedFrames;
+	mpSystem->Printf("%i frames decoded, %.2f ms average decode time\n", decoded, decoded > 0 ? cinematicStats.decodeMicroSec / (decoded * 1000.0) : 0.0);
+	mpSystem->Printf("%i late frames, %i dropped frames\n", cinematicStats.lateFrames, cinematicStats.droppedFrames);
+
+	if(idStr::Icmp(args.Argv(1), "reset") == 0)
+	{
+		memset(&cinematicStats, 0, sizeof(cinematicStats));
+	}
+}
+#endif
+
 /*
 ==============
 idCinematicLocal::InitCinematic
@@ -269,6 +374,10 @@ void idCinematic::InitCinematic()
 	vq2 = (word *)Mem_Alloc(256 * 16 * 4 * sizeof(word), TAG_CINEMATIC);
 	vq4 = (word *)Mem_Alloc(256 * 64 * 4 * sizeof(word), TAG_CINEMATIC);
 	vq8 = (word *)Mem_Alloc(256 * 256 * 4 * sizeof(word), TAG_CINEMATIC);
+
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+	cmdSystem->AddCommand("cinematicStats", R_CinematicStats_f, CMD_FL_RENDERER, "prints video decode time and late frames, 'cinematicStats reset' clears them");
+#endif
 }
 
 /*
@@ -460,6 +569,12 @@ idCinematicLocal::idCinematicLocal(idCommon *apCommon, idFileSystem *apFileSyste
 
 #endif
 
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+	decodeThread = nullptr;
+	numDecodedFrames = 0;
+	memset(decodedFrames, 0, sizeof(decodedFrames));
+#endif
+
 	// Carl: Original Doom 3 RoQ files:
 	image = nullptr;
 	status = FMV_EOF;
@@ -638,6 +753,8 @@ bool idCinematicLocal::InitFromFFMPEGFile(const char *qpath, bool amilooping)
 	img_convert_ctx = sws_getContext(dec_ctx->width, dec_ctx->height, dec_ctx->pix_fmt, CIN_WIDTH, CIN_HEIGHT, AV_PIX_FMT_BGR32, SWS_BICUBIC, nullptr, nullptr, nullptr);
 	status = FMV_PLAY;
 
+	StartDecodeAhead();
+
 	startTime = 0;
 	ImageForTime(0);
 	status = (looping) ? FMV_PLAY : FMV_IDLE;
@@ -736,6 +853,8 @@ bool idCinematicLocal::InitFromBinkDecFile(const char *qpath, bool amilooping)
 	memset(yuvBuffer, 0, sizeof(yuvBuffer));
 	framePos = -1;
 
+	StartDecodeAhead();
+
 	return true;
 }
 
@@ -847,6 +966,11 @@ idCinematicLocal::Close
 */
 void idCinematicLocal::Close()
 {
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+	// the worker has to be gone before the decoder is closed
+	StopDecodeAhead();
+#endif
+
 	if(image)
 	{
 		Mem_Free((void *)image);
@@ -1075,6 +1199,11 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG(int thisTime)
 		return cinData;
 	}
 
+	if(decodeThread != nullptr)
+	{
+		return ImageForTimeDecodeAhead(thisTime);
+	}
+
 	if((!hasFrame) || startTime == -1)
 	{
 		if(startTime == -1)
@@ -1104,6 +1233,9 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG(int thisTime)
 		return cinData;
 	}
 
+	const uint64 decodeStart = Sys_Microseconds();
+	const long firstFrame = framePos;
+
 	AVPacket packet;
 	while(framePos < desiredFrame)
 	{
@@ -1152,6 +1284,15 @@ cinData_t idCinematicLocal::ImageForTimeFFMPEG(int thisTime)
 	// We have reached the desired frame
 	// Convert the image from its native format to RGB
 	sws_scale(img_convert_ctx, frame->data, frame->linesize, 0, dec_ctx->height, frame2->data, frame2->linesize);
+
+	if(framePos > firstFrame)
+	{
+		idScopedCriticalSection lock(cinematicStatsMutex);
+		cinematicStats.decodedFrames += framePos - firstFrame;
+		cinematicStats.droppedFrames += framePos - firstFrame - 1;
+		cinematicStats.decodeMicroSec += Sys_Microseconds() - decodeStart;
+	}
+
 	cinData.imageWidth = CIN_WIDTH;
 	cinData.imageHeight = CIN_HEIGHT;
 	cinData.status = status;
@@ -1184,6 +1325,11 @@ cinData_t idCinematicLocal::ImageForTimeBinkDec(int thisTime)
 		return cinData;
 	}
 
+	if(decodeThread != nullptr)
+	{
+		return ImageForTimeDecodeAhead(thisTime);
+	}
+
 	if(startTime == -1)
 	{
 		BinkDecReset();
@@ -1229,6 +1375,8 @@ cinData_t idCinematicLocal::ImageForTimeBinkDec(int thisTime)
 	// Bink_GotoFrame(binkHandle, desiredFrame);
 	// apparently Bink_GotoFrame() doesn't work super well, so skip frames
 	// (if necessary) by calling Bink_GetNextFrame()
+	const uint64 decodeStart = Sys_Microseconds();
+	const int firstFrame = framePos;
 	while(framePos < desiredFrame)
 	{
 		framePos = Bink_GetNextFrame(binkHandle, yuvBuffer);
@@ -1238,47 +1386,438 @@ cinData_t idCinematicLocal::ImageForTimeBinkDec(int thisTime)
 	cinData.imageHeight = CIN_HEIGHT;
 	cinData.status = status;
 
-	double invAspRat = double(CIN_HEIGHT) / double(CIN_WIDTH);
+	idImage *imgs[3] = { imgY, imgCb, imgCr }; // that's the order of the channels in yuvBuffer[]
+	for(int i = 0; i < 3; ++i)
+	{
+		UploadBinkDecPlane(imgs[i], yuvBuffer[i].data, yuvBuffer[i].width, yuvBuffer[i].height);
+	}
 
+	if(framePos > firstFrame)
+	{
+		idScopedCriticalSection lock(cinematicStatsMutex);
+		cinematicStats.decodedFrames += framePos - firstFrame;
+		cinematicStats.droppedFrames += framePos - firstFrame - 1;
+		cinematicStats.decodeMicroSec += Sys_Microseconds() - decodeStart;
+	}
+
+	cinData.imageY = imgY;
+	cinData.imageCr = imgCr;
+	cinData.imageCb = imgCb;
+
+	return cinData;
+}
+
+/*
+==============
+idCinematicLocal::UploadBinkDecPlane
+==============
+*/
+void idCinematicLocal::UploadBinkDecPlane(idImage *image, const byte *data, int w, int h)
+{
+	// Note: img->UploadScratch() seems to assume 32bit per pixel data, but this is 8bit/pixel
+	//       so uploading is a bit more manual here (compared to ffmpeg or RoQ)
+
+	// some videos, including the logo video and the main menu background,
+	// seem to have superfluous rows in at least some of the channels,
+	// leading to a black or glitchy bar at the bottom of the video.
+	// cut that off by reducing the height to the expected height
+	if(h > CIN_HEIGHT)
+	{
+		h = CIN_HEIGHT;
+	}
+	else if(h < CIN_HEIGHT)
+	{
+		// the U and V channels have a lower resolution than the Y channel
+		// (or the logical video resolution), so use the aspect ratio to
+		// calculate the real height
+		double invAspRat = double(CIN_HEIGHT) / double(CIN_WIDTH);
+		int hExp = invAspRat * w + 0.5;
+		if(h > hExp)
+			h = hExp;
+	}
+
+	if(image->GetUploadWidth() != w || image->GetUploadHeight() != h)
+	{
+		idImageOpts opts = image->GetOpts();
+		opts.width = w;
+		opts.height = h;
+		image->AllocImage(opts, TF_LINEAR, TR_REPEAT);
+	}
+	image->SubImageUpload(0, 0, 0, 0, w, h, data);
+}
+#endif
+
+#if defined(USE_FFMPEG) || defined(USE_BINKDEC)
+/*
+==============
+idCinematicLocal::StartDecodeAhead
+==============
+*/
+void idCinematicLocal::StartDecodeAhead()
+{
+	numDecodedFrames = idMath::ClampInt(0, MAX_DECODED_FRAMES, r_cinematicDecodeAhead.GetInteger());
+	if(numDecodedFrames == 0)
+	{
+		return;
+	}
+
+	decodeRead.SetValue(0);
+	decodeWrite.SetValue(0);
+	decodeSkipSequence.SetValue(-1);
+	decodeSkipFrame.SetValue(0);
+	decodeSequence = 0;
+	decodeFramePos = -1;
+	decodeEndOfStream = false;
+	playSequence = 0;
+	playFramePos = -1;
+
+	decodeThread = new idCinematicDecodeThread(this);
+	decodeThread->StartWorkerThread("Cinematic", CORE_ANY, THREAD_BELOW_NORMAL);
+	decodeThread->SignalWork();
+}
+
+/*
+==============
+idCinematicLocal::StopDecodeAhead
+==============
+*/
+void idCinematicLocal::StopDecodeAhead()
+{
+	if(decodeThread != nullptr)
+	{
+		decodeThread->StopThread();
+		delete decodeThread;
+		decodeThread = nullptr;
+	}
+
+	for(int i = 0; i < MAX_DECODED_FRAMES; i++)
+	{
+		Mem_Free(decodedFrames[i].data);
+		decodedFrames[i].data = nullptr;
+		decodedFrames[i].dataSize = 0;
+	}
+	numDecodedFrames = 0;
+}
+
+/*
+==============
+idCinematicLocal::RestartDecodeAhead
+
+Flushes the ring and starts decoding from the first frame again
+==============
+*/
+void idCinematicLocal::RestartDecodeAhead()
+{
+	decodeThread->WaitForThread();
+
+	RewindDecoder();
+	decodeSequence++;
+	decodeFramePos = -1;
+	decodeEndOfStream = false;
+	decodeRead.SetValue(decodeWrite.GetValue());
+
+	playSequence = decodeSequence;
+	playFramePos = -1;
+	status = FMV_PLAY;
+
+	decodeThread->SignalWork();
+}
+
+/*
+==============
+idCinematicLocal::RewindDecoder
+==============
+*/
+bool idCinematicLocal::RewindDecoder()
+{
+#if defined(USE_FFMPEG)
+	if(av_seek_frame(fmt_ctx, video_stream_index, 0, 0) < 0)
+	{
+		return false;
+	}
+	avcodec_flush_buffers(dec_ctx);
+	return true;
+#else
+	Bink_GotoFrame(binkHandle, 0);
+	return true;
+#endif
+}
+
+/*
+==============
+idCinematicLocal::DecodeNextFrame
+
+Runs on the decode thread. Frames that won't be shown are decoded, because
+later frames depend on them, but not converted.
+==============
+*/
+bool idCinematicLocal::DecodeNextFrame(decodedFrame_t &slot, bool convert)
+{
+#if defined(USE_FFMPEG)
+	AVPacket packet;
+	int frameFinished = 0;
+	while(!frameFinished)
+	{
+		if(av_read_frame(fmt_ctx, &packet) < 0)
+		{
+			return false;
+		}
+		if(packet.stream_index == video_stream_index)
+		{
+			avcodec_decode_video2(dec_ctx, frame, &frameFinished, &packet);
+		}
+		av_free_packet(&packet);
+	}
+
+	if(convert)
+	{
+		const int size = CIN_WIDTH * CIN_HEIGHT * 4;
+		if(slot.dataSize != size)
+		{
+			Mem_Free(slot.data);
+			slot.data = (byte *)Mem_Alloc(size, TAG_CINEMATIC);
+			slot.dataSize = size;
+		}
+
+		uint8_t *dstData[4] = { slot.data, nullptr, nullptr, nullptr };
+		int dstLinesize[4] = { CIN_WIDTH * 4, 0, 0, 0 };
+		sws_scale(img_convert_ctx, frame->data, frame->linesize, 0, dec_ctx->height, dstData, dstLinesize);
+	}
+	return true;
+#else
+	if(decodeFramePos + 1 >= numFrames)
+	{
+		return false;
+	}
+
+	// Bink_GetNextFrame() returns pointers into the decoder, which get
+	// overwritten by the next frame, so the planes are copied into the ring
+	Bink_GetNextFrame(binkHandle, yuvBuffer);
+
+	if(convert)
+	{
+		int size = 0;
+		for(int i = 0; i < 3; i++)
+		{
+			size += yuvBuffer[i].width * yuvBuffer[i].height;
+		}
+		if(slot.dataSize < size)
+		{
+			Mem_Free(slot.data);
+			slot.data = (byte *)Mem_Alloc(size, TAG_CINEMATIC);
+			slot.dataSize = size;
+		}
+
+		byte *dst = slot.data;
+		for(int i = 0; i < 3; i++)
+		{
+			slot.planeWidth[i] = yuvBuffer[i].width;
+			slot.planeHeight[i] = yuvBuffer[i].height;
+			memcpy(dst, yuvBuffer[i].data, slot.planeWidth[i] * slot.planeHeight[i]);
+			dst += slot.planeWidth[i] * slot.planeHeight[i];
+		}
+	}
+	return true;
+#endif
+}
+
+/*
+==============
+idCinematicLocal::DecodeAhead
+
+Runs on the decode thread until the ring is full
+==============
+*/
+void idCinematicLocal::DecodeAhead()
+{
+	while(!decodeEndOfStream && !decodeThread->IsTerminating())
+	{
+		const int write = decodeWrite.GetValue();
+		if(write - decodeRead.GetValue() >= numDecodedFrames)
+		{
+			return;
+		}
+
+		decodedFrame_t &slot = decodedFrames[write % numDecodedFrames];
+
+		// playback is already past this frame
+		const bool late = decodeSkipSequence.GetValue() == decodeSequence && decodeFramePos + 1 < decodeSkipFrame.GetValue();
+
+		const uint64 decodeStart = Sys_Microseconds();
+		if(!DecodeNextFrame(slot, !late))
+		{
+			// don't spin on videos that have no frames at all
+			if(looping && decodeFramePos >= 0 && RewindDecoder())
+			{
+				decodeSequence++;
+				decodeFramePos = -1;
+				continue;
+			}
+
+			slot.sequence = decodeSequence;
+			slot.frameNum = decodeFramePos + 1;
+			slot.endOfStream = true;
+			decodeEndOfStream = true;
+			decodeWrite.Increment();
+			return;
+		}
+		decodeFramePos++;
+
+		{
+			idScopedCriticalSection lock(cinematicStatsMutex);
+			cinematicStats.decodedFrames++;
+			cinematicStats.droppedFrames += late ? 1 : 0;
+			cinematicStats.decodeMicroSec += Sys_Microseconds() - decodeStart;
+		}
+
+		if(late)
+		{
+			continue;
+		}
+
+		slot.sequence = decodeSequence;
+		slot.frameNum = decodeFramePos;
+		slot.endOfStream = false;
+		decodeWrite.Increment();
+	}
+}
+
+/*
+==============
+idCinematicLocal::UploadDecodedFrame
+==============
+*/
+void idCinematicLocal::UploadDecodedFrame(const decodedFrame_t &slot)
+{
+#if defined(USE_FFMPEG)
+	img->UploadScratch(slot.data, CIN_WIDTH, CIN_HEIGHT);
+#else
 	idImage *imgs[3] = { imgY, imgCb, imgCr }; // that's the order of the channels in yuvBuffer[]
+	const byte *data = slot.data;
 	for(int i = 0; i < 3; ++i)
 	{
-		// Note: img->UploadScratch() seems to assume 32bit per pixel data, but this is 8bit/pixel
-		//       so uploading is a bit more manual here (compared to ffmpeg or RoQ)
-		idImage *img = imgs[i];
-		int w = yuvBuffer[i].width;
-		int h = yuvBuffer[i].height;
-		// some videos, including the logo video and the main menu background,
-		// seem to have superfluous rows in at least some of the channels,
-		// leading to a black or glitchy bar at the bottom of the video.
-		// cut that off by reducing the height to the expected height
-		if(h > CIN_HEIGHT)
+		UploadBinkDecPlane(imgs[i], data, slot.planeWidth[i], slot.planeHeight[i]);
+		data += slot.planeWidth[i] * slot.planeHeight[i];
+	}
+#endif
+}
+
+/*
+==============
+idCinematicLocal::ImageForTimeDecodeAhead
+
+Uploads the newest decoded frame that is due, never waits for the decoder
+except for the very first frame
+==============
+*/
+cinData_t idCinematicLocal::ImageForTimeDecodeAhead(int thisTime)
+{
+	cinData_t cinData;
+	memset(&cinData, 0, sizeof(cinData));
+
+	if(startTime == -1)
+	{
+		RestartDecodeAhead();
+	}
+
+	if(playFramePos < 0)
+	{
+		// nothing shown yet, wait for the first frame and start the clock with it
+		if(decodeWrite.GetValue() == decodeRead.GetValue())
 		{
-			h = CIN_HEIGHT;
+			decodeThread->WaitForThread();
 		}
-		else if(h < CIN_HEIGHT)
+		startTime = thisTime;
+	}
+
+	int desiredFrame = ((thisTime - startTime) * frameRate) / 1000.0f;
+	if(desiredFrame < 0)
+	{
+		desiredFrame = 0;
+	}
+
+	if(desiredFrame < playFramePos)
+	{
+		RestartDecodeAhead();
+		decodeThread->WaitForThread();
+		startTime = thisTime;
+		desiredFrame = 0;
+	}
+
+	// find the newest frame that is due, the ones before it are skipped
+	const int write = decodeWrite.GetValue();
+	int due = -1;
+	for(int i = decodeRead.GetValue(); i < write; i++)
+	{
+		const decodedFrame_t &slot = decodedFrames[i % numDecodedFrames];
+		if(slot.sequence != playSequence)
 		{
-			// the U and V channels have a lower resolution than the Y channel
-			// (or the logical video resolution), so use the aspect ratio to
-			// calculate the real height
-			int hExp = invAspRat * w + 0.5;
-			if(h > hExp)
-				h = hExp;
+			// the decoder looped, restart the clock with the first frame of the new pass
+			if(due != -1)
+			{
+				break;
+			}
+			playSequence = slot.sequence;
+			playFramePos = -1;
+			startTime = thisTime;
+			desiredFrame = 0;
 		}
 
-		if(img->GetUploadWidth() != w || img->GetUploadHeight() != h)
+		if(slot.frameNum > desiredFrame)
 		{
-			idImageOpts opts = img->GetOpts();
-			opts.width = w;
-			opts.height = h;
-			img->AllocImage(opts, TF_LINEAR, TR_REPEAT);
+			break;
+		}
+
+		if(slot.endOfStream)
+		{
+			if(due == -1)
+			{
+				decodeRead.SetValue(i + 1);
+				status = FMV_IDLE;
+				return cinData;
+			}
+			break;
 		}
-		img->SubImageUpload(0, 0, 0, 0, w, h, yuvBuffer[i].data);
+
+		if(due != -1)
+		{
+			idScopedCriticalSection lock(cinematicStatsMutex);
+			cinematicStats.droppedFrames++;
+		}
+		due = i;
+	}
+
+	if(due != -1)
+	{
+		const decodedFrame_t &slot = decodedFrames[due % numDecodedFrames];
+		UploadDecodedFrame(slot);
+		playFramePos = slot.frameNum;
+
+		// hand the slots back to the decoder
+		decodeRead.SetValue(due + 1);
+		decodeThread->SignalWork();
+	}
+	else if(playFramePos < desiredFrame)
+	{
+		// the decoder is behind, keep showing the previous frame and
+		// let the decoder skip the conversion of frames that are already late
+		decodeSkipSequence.SetValue(playSequence);
+		decodeSkipFrame.SetValue(desiredFrame);
+
+		idScopedCriticalSection lock(cinematicStatsMutex);
+		cinematicStats.lateFrames++;
 	}
 
+	cinData.imageWidth = CIN_WIDTH;
+	cinData.imageHeight = CIN_HEIGHT;
+	cinData.status = status;
+#if defined(USE_FFMPEG)
+	cinData.image = img;
+#else
 	cinData.imageY = imgY;
 	cinData.imageCr = imgCr;
 	cinData.imageCb = imgCb;
+#endif
 
 	return cinData;
 }
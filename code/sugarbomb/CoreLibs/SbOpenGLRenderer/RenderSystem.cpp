@@ -114,6 +114,14 @@ void idRenderSystemLocal::PrintPerformanceCounters()
 		               pc.c_guiSurfs);
 	}
 
+	if(r_showLods.GetBool())
+	{
+		mpSystem->Printf("lodSurfs:%i tris:%i (full detail:%i)\n",
+		               pc.c_lodSurfs,
+		               pc.c_lodIndexes / 3,
+		               pc.c_lodFullIndexes / 3);
+	}
+
 	if(r_showCull.GetBool())
 	{
 		mpSystem->Printf("%i box in %i box out\n",
@@ -127,6 +135,12 @@ void idRenderSystemLocal::PrintPerformanceCounters()
 		mpSystem->Printf("viewEntities:%i  shadowEntities:%i  viewLights:%i\n", pc.c_visibleViewEntities,
 		               pc.c_shadowViewEntities, pc.c_viewLights);
 	}
+	if(r_showLightGrid.GetBool())
+	{
+		mpSystem->Printf("lightGrid:%s culledPairs:%i binning:%iusec addLights+addModels:%iusec\n",
+		               r_useLightGrid.GetBool() ? "on" : "off",
+		               pc.c_lightGridCulledPairs, pc.lightGridMicroSec, pc.addInteractionsMicroSec);
+	}
 	if(r_showUpdates.GetBool())
 	{
 		mpSystem->Printf("entityUpdates:%i  entityRefs:%i  lightUpdates:%i  lightRefs:%i\n",
@@ -171,8 +185,8 @@ void idRenderSystemLocal::RenderCommandBuffers(const emptyCommand_t *const cmdHe
 	// usefull data can be received.
 
 	// r_skipRender is usually more usefull, because it will still
-	// draw 2D graphics
-	if(!r_skipBackEnd.GetBool())
+	// draw 2D graphics, the null renderer has no context to run them on
+	if(!r_skipBackEnd.GetBool() && !r_nullRenderer.GetBool())
 	{
 #if !defined(USE_GLES2) && !defined(USE_GLES3)
 		if(glConfig.timerQueryAvailable)
@@ -681,8 +695,10 @@ uint64 *gpuMicroSec)
 		return;
 	}
 
+	const bool nullRenderer = r_nullRenderer.GetBool();
+
 	// After coming back from an autoswap, we won't have anything to render
-	if(frameData->cmdHead->next != nullptr)
+	if(frameData->cmdHead->next != nullptr && !nullRenderer)
 	{
 		// wait for our fence to hit, which means the swap has actually happened
 		// We must do this before clearing any resources the GPU may be using
@@ -690,7 +706,7 @@ uint64 *gpuMicroSec)
 	}
 
 	// read back the start and end timer queries from the previous frame
-	if(glConfig.timerQueryAvailable)
+	if(glConfig.timerQueryAvailable && !nullRenderer)
 	{
 		// RB: 64 bit fixes, changed int64 to GLuint64EXT
 		GLuint64EXT drawingTimeNanoseconds = 0;
@@ -725,6 +741,11 @@ uint64 *gpuMicroSec)
 	// print any other statistics and clear all of them
 	PrintPerformanceCounters();
 
+	if(nullRenderer)
+	{
+		return;
+	}
+
 	// check for dynamic changes that require some initialization
 	backend.CheckCVars();
 
@@ -1014,7 +1035,7 @@ idRenderSystemLocal::CaptureRenderToFile
 */
 void idRenderSystemLocal::CaptureRenderToFile(const char *fileName, bool fixAlpha)
 {
-	if(!R_IsInitialized())
+	if(!R_IsInitialized() || r_nullRenderer.GetBool())
 	{
 		return;
 	}
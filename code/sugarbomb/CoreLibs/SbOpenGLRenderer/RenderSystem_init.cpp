@@ -83,10 +83,17 @@ idCVar r_windowHeight("r_windowHeight", "720", CVAR_RENDERER | CVAR_ARCHIVE | CV
 
 idCVar r_useViewBypass("r_useViewBypass", "1", CVAR_RENDERER | CVAR_INTEGER, "bypass a frame of latency to the view");
 idCVar r_useLightPortalFlow("r_useLightPortalFlow", "1", CVAR_RENDERER | CVAR_BOOL, "use a more precise area reference determination");
+idCVar r_sparseInteractionTable("r_sparseInteractionTable", "0", CVAR_RENDERER | CVAR_BOOL, "store light / entity interactions in a hash instead of a dense lights x entities table, takes effect on the next map load");
+idCVar r_useLightGrid("r_useLightGrid", "0", CVAR_RENDERER | CVAR_BOOL, "bin lights into screen tiles and depth slices and skip light / entity pairs that don't share a cluster");
+idCVar r_lightGridRefineLimit("r_lightGridRefineLimit", "512", CVAR_RENDERER | CVAR_INTEGER, "lights covering more clusters are binned by their screen box instead of testing each cluster against the light volume");
 idCVar r_singleTriangle("r_singleTriangle", "0", CVAR_RENDERER | CVAR_BOOL, "only draw a single triangle per primitive");
 idCVar r_checkBounds("r_checkBounds", "0", CVAR_RENDERER | CVAR_BOOL, "compare all surface bounds with precalculated ones");
 idCVar r_useConstantMaterials("r_useConstantMaterials", "1", CVAR_RENDERER | CVAR_BOOL, "use pre-calculated material registers if possible");
 idCVar r_useSilRemap("r_useSilRemap", "1", CVAR_RENDERER | CVAR_BOOL, "consider verts with the same XYZ, but different ST the same for shadows");
+idCVar r_optimizeMeshes("r_optimizeMeshes", "1", CVAR_RENDERER | CVAR_INTEGER, "0 = off, 1 = reorder the triangles and vertexes of opaque static model surfaces for vertex cache, overdraw and fetch locality, 2 = also print the ACMR of each model", 0, 2);
+idCVar r_generateLods("r_generateLods", "1", CVAR_RENDERER | CVAR_BOOL, "create simplified LOD index lists for static model surfaces at load time, they are stored in the binary models");
+idCVar r_useLods("r_useLods", "1", CVAR_RENDERER | CVAR_BOOL, "draw static model surfaces with the simplified LOD that matches their projected size");
+idCVar r_lodMaxPixelError("r_lodMaxPixelError", "1.0", CVAR_RENDERER | CVAR_FLOAT, "largest projected simplification error in pixels a LOD may have", 0.0f, 16.0f);
 idCVar r_useNodeCommonChildren("r_useNodeCommonChildren", "1", CVAR_RENDERER | CVAR_BOOL, "stop pushing reference bounds early when possible");
 idCVar r_useShadowSurfaceScissor("r_useShadowSurfaceScissor", "1", CVAR_RENDERER | CVAR_BOOL, "scissor shadows by the scissor rect of the interaction surfaces");
 idCVar r_useCachedDynamicModels("r_useCachedDynamicModels", "1", CVAR_RENDERER | CVAR_BOOL, "cache snapshots of dynamic models");
@@ -118,6 +125,7 @@ idCVar r_skipInteractions("r_skipInteractions", "0", CVAR_RENDERER | CVAR_BOOL,
 idCVar r_skipDynamicTextures("r_skipDynamicTextures", "0", CVAR_RENDERER | CVAR_BOOL, "don't dynamically create textures");
 idCVar r_skipCopyTexture("r_skipCopyTexture", "0", CVAR_RENDERER | CVAR_BOOL, "do all rendering, but don't actually copyTexSubImage2D");
 idCVar r_skipBackEnd("r_skipBackEnd", "0", CVAR_RENDERER | CVAR_BOOL, "don't draw anything");
+idCVar r_nullRenderer("r_nullRenderer", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_INIT, "don't open a window or create an OpenGL context, the front end still runs but nothing is sent to the GPU");
 idCVar r_skipRender("r_skipRender", "0", CVAR_RENDERER | CVAR_BOOL, "skip 3D rendering, but pass 2D");
 // RB begin
 idCVar r_skipRenderContext("r_skipRenderContext", "0", CVAR_RENDERER | CVAR_BOOL, "DISABLED: nullptr the rendering context during backend 3D rendering");
@@ -202,9 +210,11 @@ idCVar r_showNormals("r_showNormals", "0", CVAR_RENDERER | CVAR_FLOAT, "draws wi
 idCVar r_showMemory("r_showMemory", "0", CVAR_RENDERER | CVAR_BOOL, "print frame memory utilization");
 idCVar r_showCull("r_showCull", "0", CVAR_RENDERER | CVAR_BOOL, "report sphere and box culling stats");
 idCVar r_showAddModel("r_showAddModel", "0", CVAR_RENDERER | CVAR_BOOL, "report stats from tr_addModel");
+idCVar r_showLightGrid("r_showLightGrid", "0", CVAR_RENDERER | CVAR_BOOL, "report light / entity pairs skipped by the light grid and the front end time spent on interactions");
 idCVar r_showDepth("r_showDepth", "0", CVAR_RENDERER | CVAR_BOOL, "display the contents of the depth buffer and the depth range");
 idCVar r_showSurfaces("r_showSurfaces", "0", CVAR_RENDERER | CVAR_BOOL, "report surface/light/shadow counts");
 idCVar r_showPrimitives("r_showPrimitives", "0", CVAR_RENDERER | CVAR_INTEGER, "report drawsurf/index/vertex counts");
+idCVar r_showLods("r_showLods", "0", CVAR_RENDERER | CVAR_BOOL, "report triangles of LOD capable surfaces drawn with and without LOD selection");
 idCVar r_showEdges("r_showEdges", "0", CVAR_RENDERER | CVAR_BOOL, "draw the sil edges");
 idCVar r_showTexturePolarity("r_showTexturePolarity", "0", CVAR_RENDERER | CVAR_BOOL, "shade triangles by texture area polarity");
 idCVar r_showTangentSpace("r_showTangentSpace", "0", CVAR_RENDERER | CVAR_INTEGER, "shade triangles by tangent space, 1 = use 1st tangent vector, 2 = use 2nd tangent vector, 3 = use normal vector", 0, 3, idCmdSystem::ArgCompletion_Integer<0, 3>);
@@ -821,6 +831,52 @@ void R_SetNewMode(const bool fullInit)
 
 idStr extensions_string;
 
+/*
+==================
+R_InitNullRenderer
+
+Sets up everything the front end needs without a window or an OpenGL context.
+Buffer objects live in system memory, images are never uploaded and the back
+end commands are dropped, so timings only contain CPU work.
+==================
+*/
+static void R_InitNullRenderer()
+{
+	gpSys->Printf("Using the null renderer, nothing will be drawn\n");
+
+	glConfig.vendor_string = "none";
+	glConfig.renderer_string = "null";
+	glConfig.version_string = "0.0";
+	glConfig.shading_language_string = "0.0";
+	glConfig.extensions_string = "";
+	glConfig.wgl_extensions_string = "";
+
+	glConfig.maxTextureSize = 16384;
+	glConfig.nativeScreenWidth = r_customWidth.GetInteger();
+	glConfig.nativeScreenHeight = r_customHeight.GetInteger();
+	glConfig.displayFrequency = 60;
+	glConfig.isFullscreen = 0;
+	glConfig.multisamples = 0;
+	glConfig.pixelAspect = 1.0f;
+	glConfig.physicalScreenWidthInCentimeters = 100.0f;
+	glConfig.uniformBufferOffsetAlignment = 256;
+
+	// input doesn't need a window, the events are still polled every frame
+	Sys_InitInput();
+
+	r_initialized = true;
+
+	// fill the builtin shader tables, materials look their programs up in them
+	// (no GLSL is compiled without a context)
+	renderProgManager.Init();
+
+	// allocate the vertex cache in system memory
+	vertexCache.Init();
+
+	// allocate the frame data, which may be more if smp is enabled
+	R_InitFrameData();
+}
+
 /*
 ==================
 R_InitOpenGL
@@ -846,6 +902,12 @@ void R_InitOpenGL()
 		gpSys->FatalError("R_InitOpenGL called while active");
 	}
 
+	if(r_nullRenderer.GetBool())
+	{
+		R_InitNullRenderer();
+		return;
+	}
+
 	// DG: make sure SDL has setup video so getting supported modes in R_SetNewMode() works
 	GLimp_PreInit();
 	// DG end
@@ -2214,6 +2276,11 @@ void R_SetColorMappings()
 		tr.gammaTable[i] = idMath::ClampInt(0, 0xFFFF, inf);
 	}
 
+	if(r_nullRenderer.GetBool())
+	{
+		return;
+	}
+
 	GLimp_SetGamma(tr.gammaTable, tr.gammaTable, tr.gammaTable);
 }
 
@@ -2349,7 +2416,7 @@ R_VidRestart_f
 void R_VidRestart_f(const idCmdArgs &args)
 {
 	// if OpenGL isn't started, do nothing
-	if(!R_IsInitialized())
+	if(!R_IsInitialized() || r_nullRenderer.GetBool())
 	{
 		return;
 	}
@@ -2552,6 +2619,7 @@ void R_InitCommands()
 	cmdSystem->AddCommand("testVideo", R_TestVideo_f, CMD_FL_RENDERER | CMD_FL_CHEAT, "displays the given cinematic", idCmdSystem::ArgCompletion_VideoName);
 	cmdSystem->AddCommand("reportSurfaceAreas", R_ReportSurfaceAreas_f, CMD_FL_RENDERER, "lists all used materials sorted by surface area");
 	cmdSystem->AddCommand("showInteractionMemory", R_ShowInteractionMemory_f, CMD_FL_RENDERER, "shows memory used by interactions");
+	cmdSystem->AddCommand("benchmarkInteractionTable", R_BenchmarkInteractionTable_f, CMD_FL_RENDERER, "compares memory and lookup time of the dense and sparse interaction tables");
 	cmdSystem->AddCommand("vid_restart", R_VidRestart_f, CMD_FL_RENDERER, "restarts renderSystem");
 	cmdSystem->AddCommand("listRenderEntityDefs", R_ListRenderEntityDefs_f, CMD_FL_RENDERER, "lists the entity defs");
 	cmdSystem->AddCommand("listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs");
@@ -2609,6 +2677,7 @@ void idRenderSystemLocal::Clear()
 	}
 
 	frontEndJobList = nullptr;
+	skinningJobList = nullptr;
 }
 
 /*
@@ -2883,6 +2952,7 @@ void idRenderSystemLocal::Init()
 	}
 
 	frontEndJobList = parallelJobManager->AllocJobList(JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, nullptr);
+	skinningJobList = parallelJobManager->AllocJobList(JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_HIGH, 64, 0, nullptr);
 
 	// make sure the command buffers are ready to accept the first screen update
 	SwapCommandBuffers(nullptr, nullptr, nullptr, nullptr);
@@ -2920,7 +2990,10 @@ void idRenderSystemLocal::Shutdown()
 	// free frame memory
 	R_ShutdownFrameData();
 
-	UnbindBufferObjects();
+	if(!r_nullRenderer.GetBool())
+	{
+		UnbindBufferObjects();
+	}
 
 	// free the vertex cache, which should have nothing allocated now
 	vertexCache.Shutdown();
@@ -2930,6 +3003,7 @@ void idRenderSystemLocal::Shutdown()
 	delete guiModel;
 
 	parallelJobManager->FreeJobList(frontEndJobList);
+	parallelJobManager->FreeJobList(skinningJobList);
 
 	Clear();
 
@@ -3071,6 +3145,11 @@ void idRenderSystemLocal::InitOpenGL()
 		// Reloading images here causes the rendertargets to get deleted. Figure out how to handle this properly on 360
 		globalImages->ReloadImages(true);
 
+		if(r_nullRenderer.GetBool())
+		{
+			return;
+		}
+
 		int err = glGetError();
 		if(err != GL_NO_ERROR)
 		{
@@ -3088,7 +3167,10 @@ void idRenderSystemLocal::ShutdownOpenGL()
 {
 	// free the context and close the window
 	R_ShutdownFrameData();
-	GLimp_Shutdown();
+	if(!r_nullRenderer.GetBool())
+	{
+		GLimp_Shutdown();
+	}
 	r_initialized = false;
 }
 
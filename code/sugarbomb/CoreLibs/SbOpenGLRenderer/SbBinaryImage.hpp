@@ -95,6 +95,15 @@ public:
 	}
 	static void GetGeneratedFileName(idStr &gfn, const char *imageName);
 
+	// totals over all Load2DFromMemory calls, for reporting bake throughput
+	struct binarizeStats_t
+	{
+		int numImages;
+		int64 numTexels;
+		uint64 microseconds;
+	};
+	static binarizeStats_t binarizeStats;
+
 private:
 	idStr imgName; // game path, including extension (except for cube maps), may be an image program
 	bimageFile_t fileData;
@@ -39,6 +39,8 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar r_showBuffers("r_showBuffers", "0", CVAR_INTEGER, "");
 
+extern idCVar r_nullRenderer;
+
 //static const GLenum bufferUsage = GL_STATIC_DRAW;
 static const GLenum bufferUsage = GL_DYNAMIC_DRAW;
 
@@ -190,6 +192,17 @@ bool idVertexBuffer::AllocBufferObject(const void *data, int allocSize)
 
 	int numBytes = GetAllocedSize();
 
+	if(r_nullRenderer.GetBool())
+	{
+		// there is no context, keep the data in system memory
+		apiObject = Mem_ClearedAlloc(numBytes, TAG_RENDER);
+		if(data != nullptr)
+		{
+			Update(data, allocSize);
+		}
+		return true;
+	}
+
 	// clear out any previous error
 	glGetError();
 
@@ -255,6 +268,13 @@ void idVertexBuffer::FreeBufferObject()
 		idLib::Printf("vertex buffer free %p, api %p (%i bytes)\n", this, GetAPIObject(), GetSize());
 	}
 
+	if(r_nullRenderer.GetBool())
+	{
+		Mem_Free(apiObject);
+		ClearWithoutFreeing();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	glDeleteBuffers(1, (const unsigned int *)&bufferObject);
@@ -322,6 +342,12 @@ void idVertexBuffer::Update(const void *data, int updateSize) const
 
 	int numBytes = (updateSize + 15) & ~15;
 
+	if(r_nullRenderer.GetBool())
+	{
+		memcpy((byte *)apiObject + GetOffset(), data, updateSize);
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	// RB end
@@ -345,6 +371,12 @@ void *idVertexBuffer::MapBuffer(bufferMapType_t mapType) const
 	assert(apiObject != nullptr);
 	assert(IsMapped() == false);
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetMapped();
+		return (byte *)apiObject + GetOffset();
+	}
+
 	void *buffer = nullptr;
 
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
@@ -403,6 +435,12 @@ void idVertexBuffer::UnmapBuffer() const
 	assert(apiObject != nullptr);
 	assert(IsMapped());
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetUnmapped();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	// RB end
@@ -480,6 +518,17 @@ bool idIndexBuffer::AllocBufferObject(const void *data, int allocSize)
 
 	int numBytes = GetAllocedSize();
 
+	if(r_nullRenderer.GetBool())
+	{
+		// there is no context, keep the data in system memory
+		apiObject = Mem_ClearedAlloc(numBytes, TAG_RENDER);
+		if(data != nullptr)
+		{
+			Update(data, allocSize);
+		}
+		return true;
+	}
+
 	// clear out any previous error
 	glGetError();
 
@@ -546,6 +595,13 @@ void idIndexBuffer::FreeBufferObject()
 		idLib::Printf("index buffer free %p, api %p (%i bytes)\n", this, GetAPIObject(), GetSize());
 	}
 
+	if(r_nullRenderer.GetBool())
+	{
+		Mem_Free(apiObject);
+		ClearWithoutFreeing();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	glDeleteBuffers(1, (const unsigned int *)&bufferObject);
@@ -613,6 +669,12 @@ void idIndexBuffer::Update(const void *data, int updateSize) const
 
 	int numBytes = (updateSize + 15) & ~15;
 
+	if(r_nullRenderer.GetBool())
+	{
+		memcpy((byte *)apiObject + GetOffset(), data, updateSize);
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	// RB end
@@ -636,6 +698,12 @@ void *idIndexBuffer::MapBuffer(bufferMapType_t mapType) const
 	assert(apiObject != nullptr);
 	assert(IsMapped() == false);
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetMapped();
+		return (byte *)apiObject + GetOffset();
+	}
+
 	void *buffer = nullptr;
 
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
@@ -689,6 +757,12 @@ void idIndexBuffer::UnmapBuffer() const
 	assert(apiObject != nullptr);
 	assert(IsMapped());
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetUnmapped();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr bufferObject = reinterpret_cast<GLintptr>(apiObject);
 	// RB end
@@ -766,6 +840,17 @@ bool idJointBuffer::AllocBufferObject(const float *joints, int numAllocJoints)
 
 	const int numBytes = GetAllocedSize();
 
+	if(r_nullRenderer.GetBool())
+	{
+		// there is no context, keep the joints in system memory
+		apiObject = Mem_ClearedAlloc(numBytes, TAG_JOINTBUFFER);
+		if(joints != nullptr)
+		{
+			Update(joints, numAllocJoints);
+		}
+		return true;
+	}
+
 	GLuint buffer = 0;
 	glGenBuffers(1, &buffer);
 	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
@@ -816,6 +901,13 @@ void idJointBuffer::FreeBufferObject()
 		idLib::Printf("joint buffer free %p, api %p (%i joints)\n", this, GetAPIObject(), GetNumJoints());
 	}
 
+	if(r_nullRenderer.GetBool())
+	{
+		Mem_Free(apiObject);
+		ClearWithoutFreeing();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	GLintptr buffer = reinterpret_cast<GLintptr>(apiObject);
 
@@ -886,6 +978,12 @@ void idJointBuffer::Update(const float *joints, int numUpdateJoints) const
 
 	const int numBytes = numUpdateJoints * 3 * 4 * sizeof(float);
 
+	if(r_nullRenderer.GetBool())
+	{
+		memcpy((byte *)apiObject + GetOffset(), joints, numBytes);
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	glBindBuffer(GL_UNIFORM_BUFFER, reinterpret_cast<GLintptr>(apiObject));
 	// RB end
@@ -904,6 +1002,12 @@ float *idJointBuffer::MapBuffer(bufferMapType_t mapType) const
 	assert(mapType == BM_WRITE);
 	assert(apiObject != nullptr);
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetMapped();
+		return (float *)((byte *)apiObject + GetOffset());
+	}
+
 	int numBytes = GetAllocedSize();
 
 	void *buffer = nullptr;
@@ -942,6 +1046,12 @@ void idJointBuffer::UnmapBuffer() const
 	assert(apiObject != nullptr);
 	assert(IsMapped());
 
+	if(r_nullRenderer.GetBool())
+	{
+		SetUnmapped();
+		return;
+	}
+
 	// RB: 64 bit fixes, changed GLuint to GLintptrARB
 	glBindBuffer(GL_UNIFORM_BUFFER, reinterpret_cast<GLintptr>(apiObject));
 	// RB end
@@ -96,6 +96,12 @@ void Framebuffer::Init(idCommon *apCommon, idCmdSystem *cmdSystem)
 
 	tr.backend.currentFramebuffer = nullptr;
 
+	// nothing to render to without a context
+	if(r_nullRenderer.GetBool())
+	{
+		return;
+	}
+
 	// SHADOWMAPS
 
 	int width, height;
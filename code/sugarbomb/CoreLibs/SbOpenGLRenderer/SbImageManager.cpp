@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "precompiled.h"
 
 #include "RenderCommon.h"
+#include "SbBinaryImage.hpp"
 
 #include "framework/IDeclManager.hpp"
 #include "framework/PreloadManifest.hpp"
@@ -604,6 +605,50 @@ void idImageManager::ReloadImages(bool all)
 	}
 }
 
+/*
+===============
+R_BakeImages_f
+
+Parses every material so all images they reference get binarized into
+generated/images, then reports how fast the binarizing went.
+===============
+*/
+void R_BakeImages_f(const idCmdArgs &args)
+{
+	const idBinaryImage::binarizeStats_t statsBefore = idBinaryImage::binarizeStats;
+	const int start = Sys_Milliseconds();
+
+	// images referenced outside a level load are loaded, and binarized if needed, by the material parse
+	const int numMaterials = declManager->GetNumDecls(DECL_MATERIAL);
+	for(int i = 0; i < numMaterials; i++)
+	{
+		declManager->DeclByIndex(DECL_MATERIAL, i, true);
+	}
+
+	// anything referenced during a level load is still waiting for EndLevelLoad, generated images are always loaded
+	const int numImages = globalImages->images.Num();
+	for(int i = 0; i < numImages; i++)
+	{
+		idImage *image = globalImages->images[i];
+		if(!image->IsLoaded())
+		{
+			image->ActuallyLoadImage(false);
+		}
+	}
+
+	const int end = Sys_Milliseconds();
+	const int numBinarized = idBinaryImage::binarizeStats.numImages - statsBefore.numImages;
+	const int64 numTexels = idBinaryImage::binarizeStats.numTexels - statsBefore.numTexels;
+	const uint64 binarizeMicroseconds = idBinaryImage::binarizeStats.microseconds - statsBefore.microseconds;
+
+	idLib::Printf("%i materials, %i images, %i binarized in %5.1f seconds\n", numMaterials, numImages, numBinarized, (end - start) * 0.001f);
+	if(binarizeMicroseconds > 0)
+	{
+		idLib::Printf("binarize: %.1f Mtexels in %5.1f seconds, %.2f Mtexels/s, %.1f images/s\n", numTexels / 1000000.0f, binarizeMicroseconds / 1000000.0f,
+		              (float)numTexels / binarizeMicroseconds, numBinarized * 1000000.0f / binarizeMicroseconds);
+	}
+}
+
 /*
 ===============
 R_CombineCubeImages_f
@@ -710,6 +755,7 @@ void idImageManager::Init()
 	cmdSystem->AddCommand("reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images");
 	cmdSystem->AddCommand("listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images");
 	cmdSystem->AddCommand("combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression");
+	cmdSystem->AddCommand("bakeImages", R_BakeImages_f, CMD_FL_RENDERER, "binarizes every image referenced by the materials and reports the throughput");
 
 	// should forceLoadImages be here?
 }
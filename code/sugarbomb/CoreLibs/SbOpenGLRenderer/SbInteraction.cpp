@@ -583,14 +583,13 @@ idInteraction *idInteraction::AllocAndLink(idRenderEntityLocal *edef, idRenderLi
 	}
 
 	// update the interaction table
-	if(renderWorld->interactionTable != nullptr)
+	if(renderWorld->HasInteractionTable())
 	{
-		int index = ldef->index * renderWorld->interactionTableWidth + edef->index;
-		if(renderWorld->interactionTable[index] != nullptr)
+		if(renderWorld->GetInteraction(ldef->index, edef->index) != nullptr)
 		{
 			mpSystem->Error("idInteraction::AllocAndLink: non nullptr table entry");
 		}
-		renderWorld->interactionTable[index] = interaction;
+		renderWorld->SetInteraction(ldef->index, edef->index, interaction);
 	}
 
 	return interaction;
@@ -681,14 +680,14 @@ void idInteraction::UnlinkAndFree()
 	// clear the table pointer
 	idRenderWorldLocal *renderWorld = this->lightDef->world;
 	// RB: added check for nullptr
-	if(renderWorld->interactionTable != nullptr)
+	if(renderWorld->HasInteractionTable())
 	{
-		int index = this->lightDef->index * renderWorld->interactionTableWidth + this->entityDef->index;
-		if(renderWorld->interactionTable[index] != this && renderWorld->interactionTable[index] != INTERACTION_EMPTY)
+		const idInteraction *inter = renderWorld->GetInteraction(this->lightDef->index, this->entityDef->index);
+		if(inter != this && inter != INTERACTION_EMPTY)
 		{
 			mpSystem->Error("idInteraction::UnlinkAndFree: interactionTable wasn't set");
 		}
-		renderWorld->interactionTable[index] = nullptr;
+		renderWorld->SetInteraction(this->lightDef->index, this->entityDef->index, nullptr);
 	}
 	// RB end
 
@@ -745,9 +744,8 @@ void idInteraction::MakeEmpty()
 	}
 
 	// store the special marker in the interaction table
-	const int interactionIndex = lightDef->index * entityDef->world->interactionTableWidth + entityDef->index;
-	assert(entityDef->world->interactionTable[interactionIndex] == this);
-	entityDef->world->interactionTable[interactionIndex] = INTERACTION_EMPTY;
+	assert(entityDef->world->GetInteraction(lightDef->index, entityDef->index) == this);
+	entityDef->world->SetInteraction(lightDef->index, entityDef->index, INTERACTION_EMPTY);
 }
 
 /*
@@ -982,6 +980,104 @@ void R_ShowInteractionMemory_f(const idCmdArgs &args)
 	gpSys->Printf("%5i indexes in %5i shadow tris\n", shadowTriIndexes, shadowTris);
 	gpSys->Printf("%i maxInteractionsForEntity\n", maxInteractionsForEntity);
 	gpSys->Printf("%i maxInteractionsForLight\n", maxInteractionsForLight);
+
+	const idRenderWorldLocal *world = tr.primaryWorld;
+	if(world->interactionTable != nullptr)
+	{
+		gpSys->Printf("%i bytes in dense interactionTable (%i x %i)\n", world->interactionTableWidth * world->interactionTableHeight * (int)sizeof(idInteraction *), world->interactionTableHeight, world->interactionTableWidth);
+	}
+	else if(world->sparseInteractionTable.IsAllocated())
+	{
+		gpSys->Printf("%i bytes in sparse interactionTable (%i pairs)\n", world->sparseInteractionTable.Allocated(), world->sparseInteractionTable.Num());
+	}
+}
+
+/*
+==============
+R_BenchmarkInteractionTable_f
+
+Builds a dense and a sparse table from the current interactions of the primary world
+and times the lookups CreateLightDefInteractions() would do for every light.
+==============
+*/
+void R_BenchmarkInteractionTable_f(const idCmdArgs &args)
+{
+	const idRenderWorldLocal *world = tr.primaryWorld;
+	if(world == nullptr)
+	{
+		gpSys->Printf("no primary world\n");
+		return;
+	}
+	const int passes = (args.Argc() > 1) ? idMath::ClampInt(1, 1000, atoi(args.Argv(1))) : 10;
+
+	const int width = world->entityDefs.Num();
+	const int height = world->lightDefs.Num();
+	idInteraction **dense = (idInteraction **)R_ClearedStaticAlloc(width * height * sizeof(idInteraction *));
+	idSparseInteractionTable sparse;
+	sparse.Init(0);
+
+	// the light / entity pairs that are looked up when the lights are added to a view
+	idList<int> lightIndexes;
+	idList<int> entityIndexes;
+
+	for(int i = 0; i < height; i++)
+	{
+		const idRenderLightLocal *light = world->lightDefs[i];
+		if(light == nullptr)
+		{
+			continue;
+		}
+		for(idInteraction *inter = light->firstInteraction; inter != nullptr; inter = inter->lightNext)
+		{
+			idInteraction *marker = inter->IsEmpty() ? INTERACTION_EMPTY : inter;
+			dense[i * width + inter->entityDef->index] = marker;
+			sparse.Set(i, inter->entityDef->index, marker);
+		}
+		for(areaReference_t *lref = light->references; lref != nullptr; lref = lref->ownerNext)
+		{
+			const portalArea_t *area = lref->area;
+			for(areaReference_t *eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext)
+			{
+				lightIndexes.Append(i);
+				entityIndexes.Append(eref->entity->index);
+			}
+		}
+	}
+
+	const int numLookups = lightIndexes.Num();
+	int denseFound = 0;
+	int sparseFound = 0;
+
+	const uint64 denseStart = Sys_Microseconds();
+	for(int pass = 0; pass < passes; pass++)
+	{
+		for(int i = 0; i < numLookups; i++)
+		{
+			denseFound += (dense[lightIndexes[i] * width + entityIndexes[i]] != nullptr);
+		}
+	}
+	const uint64 denseTime = Sys_Microseconds() - denseStart;
+
+	const uint64 sparseStart = Sys_Microseconds();
+	for(int pass = 0; pass < passes; pass++)
+	{
+		for(int i = 0; i < numLookups; i++)
+		{
+			sparseFound += (sparse.Find(lightIndexes[i], entityIndexes[i]) != nullptr);
+		}
+	}
+	const uint64 sparseTime = Sys_Microseconds() - sparseStart;
+
+	if(denseFound != sparseFound)
+	{
+		mpSystem->Warning("R_BenchmarkInteractionTable_f: dense and sparse tables disagree (%i / %i)", denseFound, sparseFound);
+	}
+
+	gpSys->Printf("%i lights, %i entities, %i interactions, %i lookups x %i passes\n", height, width, sparse.Num(), numLookups, passes);
+	gpSys->Printf("dense:  %10i bytes, %6i usec\n", width * height * (int)sizeof(idInteraction *), (int)denseTime);
+	gpSys->Printf("sparse: %10i bytes, %6i usec\n", sparse.Allocated(), (int)sparseTime);
+
+	R_StaticFree(dense);
 }
 
 //} // namespace sbe
\ No newline at end of file
@@ -158,6 +158,7 @@ private:
 };
 
 void R_ShowInteractionMemory_f(const idCmdArgs &args);
+void R_BenchmarkInteractionTable_f(const idCmdArgs &args);
 
 //} // namespace sbe
 
@@ -52,7 +52,7 @@ idCVar idRenderModelStatic::r_slopVertex("r_slopVertex", "0.01", CVAR_RENDERER,
 idCVar idRenderModelStatic::r_slopTexCoord("r_slopTexCoord", "0.001", CVAR_RENDERER, "merge texture coordinates this far apart");
 idCVar idRenderModelStatic::r_slopNormal("r_slopNormal", "0.02", CVAR_RENDERER, "merge normals that dot less than this");
 
-static const byte BRM_VERSION = 108;
+static const byte BRM_VERSION = 111;
 static const unsigned int BRM_MAGIC = ('B' << 24) | ('R' << 16) | ('M' << 8) | BRM_VERSION;
 
 /*
@@ -538,6 +538,48 @@ bool idRenderModelStatic::LoadBinaryModel(idFile *file, const ID_TIME_T sourceTi
 			file->ReadBig(tri.numShadowIndexesNoCaps);
 			file->ReadBig(tri.shadowCapPlaneBits);
 
+			int numLods = 0;
+			file->ReadBig(numLods);
+			tri.numLods = 0;
+			tri.lods = nullptr;
+			bool lodsValid = (numLods >= 0 && numLods <= MAX_TRI_LODS);
+			if(lodsValid && numLods > 0)
+			{
+				R_AllocStaticTriSurfLods(&tri, numLods);
+				for(int j = 0; j < tri.numLods && lodsValid; j++)
+				{
+					triLod_t &lod = tri.lods[j];
+					file->ReadBig(lod.numIndexes);
+					file->ReadFloat(lod.error);
+					lod.indexCache = 0;
+					if(lod.numIndexes < 0 || lod.numIndexes > tri.numIndexes || lod.numIndexes % 3 != 0)
+					{
+						lod.numIndexes = 0;
+						lodsValid = false;
+						break;
+					}
+					lod.indexes = (triIndex_t *)Mem_Alloc16(lod.numIndexes * sizeof(triIndex_t), TAG_TRI_LODS);
+					file->ReadBigArray(lod.indexes, lod.numIndexes);
+					for(int k = 0; k < lod.numIndexes; k++)
+					{
+						if(lod.indexes[k] >= tri.numVerts)
+						{
+							lodsValid = false;
+							break;
+						}
+					}
+				}
+			}
+
+			// a damaged cache, make the caller rebuild the model from its source
+			if(!lodsValid)
+			{
+				mpSys->Printf("LoadBinaryModel: bad LODs in surface %i of %s\n", i, name.c_str());
+				surfaces.SetNum(i + 1);
+				PurgeModel();
+				return false;
+			}
+
 			tri.ambientSurface = nullptr;
 			tri.nextDeferredFree = nullptr;
 			tri.indexCache = 0;
@@ -716,6 +758,14 @@ void idRenderModelStatic::WriteBinaryModel(idFile *file, ID_TIME_T *_timeStamp)
 			file->WriteBig(tri.numShadowIndexesNoFrontCaps);
 			file->WriteBig(tri.numShadowIndexesNoCaps);
 			file->WriteBig(tri.shadowCapPlaneBits);
+
+			file->WriteBig(tri.numLods);
+			for(int j = 0; j < tri.numLods; j++)
+			{
+				file->WriteBig(tri.lods[j].numIndexes);
+				file->WriteFloat(tri.lods[j].error);
+				file->WriteBigArray(tri.lods[j].indexes, tri.lods[j].numIndexes);
+			}
 		}
 	}
 
@@ -1222,11 +1272,13 @@ void idRenderModelStatic::FinishSurfaces()
 	}
 
 	// clean the surfaces
+	triOptimizeStats_t optimizeStats;
+	memset(&optimizeStats, 0, sizeof(optimizeStats));
 	for(i = 0; i < surfaces.Num(); i++)
 	{
 		const modelSurface_t *surf = &surfaces[i];
 
-		R_CleanupTriangles(surf->geometry, surf->geometry->generateNormals, true, surf->shader->UseUnsmoothedTangents());
+		R_CleanupTriangles(surf->geometry, surf->geometry->generateNormals, true, surf->shader->UseUnsmoothedTangents(), surf->shader, &optimizeStats);
 		if(surf->shader->SurfaceCastsShadow())
 		{
 			totalVerts += surf->geometry->numVerts;
@@ -1234,6 +1286,27 @@ void idRenderModelStatic::FinishSurfaces()
 		}
 	}
 
+	// build the LOD chains, world areas are too large to be simplified as a whole
+	if(r_generateLods.GetBool() && !isStaticWorldModel)
+	{
+		for(i = 0; i < surfaces.Num(); i++)
+		{
+			const modelSurface_t *surf = &surfaces[i];
+
+			if(surf->shader->IsDrawn() && surf->shader->Deform() == DFRM_NONE)
+			{
+				R_CreateTriSurfLods(surf->geometry);
+			}
+		}
+	}
+
+	if(r_optimizeMeshes.GetInteger() > 1 && optimizeStats.numTris > 0)
+	{
+		mpSys->Printf("%s: %i tris, %i verts, ACMR %.3f -> %.3f\n", name.c_str(), optimizeStats.numTris, optimizeStats.numVerts,
+		              (float)optimizeStats.cacheMissesBefore / optimizeStats.numTris,
+		              (float)optimizeStats.cacheMissesAfter / optimizeStats.numTris);
+	}
+
 	// add up the total surface area for development information
 	for(i = 0; i < surfaces.Num(); i++)
 	{
@@ -87,6 +87,7 @@ static const byte MD5B_VERSION = 106;
 static const unsigned int MD5B_MAGIC = ('5' << 24) | ('D' << 16) | ('M' << 8) | MD5B_VERSION;
 
 idCVar r_useGPUSkinning("r_useGPUSkinning", "1", CVAR_INTEGER, "animate normals and tangents instead of deriving");
+idCVar r_skinningJobVerts("r_skinningJobVerts", "8192", CVAR_RENDERER | CVAR_INTEGER, "CPU skinning of meshes with more verts than this is split into jobs, 0 = never split");
 
 /***********************************************************************
 
@@ -486,38 +487,100 @@ void idMD5Mesh::ParseMesh(idLexer &parser, int numJoints, const idJointMat *join
 	Mem_Free(basePose);
 }
 
+/*
+============
+TransformVertsAndTangentsJob
+============
+*/
+struct skinningJobParms_t
+{
+	idDrawVert *targetVerts;
+	const idDrawVert *baseVerts;
+	const idJointMat *joints;
+	int numVerts;
+	int vertsPerJob;
+	int numJobs;
+	idSysInterlockedInteger nextJob;
+};
+
+static const int MAX_SKINNING_JOBS = 64;
+
+static idSysInterlockedInteger skinningJobListInUse;
+
+static void TransformVertsAndTangentsJob(skinningJobParms_t *parms)
+{
+	// every job, and the thread that submitted them, keeps taking slices until none are left
+	for(int jobNum = parms->nextJob.Increment() - 1; jobNum < parms->numJobs; jobNum = parms->nextJob.Increment() - 1)
+	{
+		const int firstVert = jobNum * parms->vertsPerJob;
+		SIMDProcessor->TransformVertsAndTangents(parms->targetVerts + firstVert, Min(parms->vertsPerJob, parms->numVerts - firstVert),
+		                                         parms->baseVerts + firstVert, parms->joints);
+	}
+}
+
+REGISTER_PARALLEL_JOB(TransformVertsAndTangentsJob, "TransformVertsAndTangentsJob");
+
 /*
 ============
 TransformVertsAndTangents
+
+Large meshes are split into slices of r_skinningJobVerts verts. The calling thread skins
+slices as well instead of idling in Wait(), so this also works from inside an
+r_useParallelAddModels job: the slices it didn't get to are picked up by the other job
+threads as soon as they finish their current entity, because the skinning list has a
+higher priority than the front end list.
 ============
 */
-void TransformVertsAndTangents(idDrawVert *targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints)
+static void TransformVertsAndTangents(idDrawVert *targetVerts, const int numVerts, const idDrawVert *baseVerts, const idJointMat *joints)
 {
-	for(int i = 0; i < numVerts; i++)
+	const int jobVerts = r_skinningJobVerts.GetInteger();
+	if(jobVerts <= 0 || numVerts <= jobVerts || tr.skinningJobList == nullptr)
 	{
-		const idDrawVert &base = baseVerts[i];
+		SIMDProcessor->TransformVertsAndTangents(targetVerts, numVerts, baseVerts, joints);
+		return;
+	}
 
-		const idJointMat &j0 = joints[base.color[0]];
-		const idJointMat &j1 = joints[base.color[1]];
-		const idJointMat &j2 = joints[base.color[2]];
-		const idJointMat &j3 = joints[base.color[3]];
+	// with a single job thread that thread may be the one calling us, and nobody else would run the jobs
+	const int numHelpers = parallelJobManager->GetNumProcessingUnits();
+	if(numHelpers == 1 && r_useParallelAddModels.GetBool())
+	{
+		SIMDProcessor->TransformVertsAndTangents(targetVerts, numVerts, baseVerts, joints);
+		return;
+	}
 
-		const float w0 = base.color2[0] * (1.0f / 255.0f);
-		const float w1 = base.color2[1] * (1.0f / 255.0f);
-		const float w2 = base.color2[2] * (1.0f / 255.0f);
-		const float w3 = base.color2[3] * (1.0f / 255.0f);
+	// several entities can be skinned at once with r_useParallelAddModels, and the game can
+	// instantiate dynamic models while the front end is running
+	if(skinningJobListInUse.Increment() != 1)
+	{
+		skinningJobListInUse.Decrement();
+		SIMDProcessor->TransformVertsAndTangents(targetVerts, numVerts, baseVerts, joints);
+		return;
+	}
 
-		idJointMat accum;
-		idJointMat::Mul(accum, j0, w0);
-		idJointMat::Mad(accum, j1, w1);
-		idJointMat::Mad(accum, j2, w2);
-		idJointMat::Mad(accum, j3, w3);
+	// keep the slice size a multiple of four so only the last slice has verts left over for the scalar path
+	skinningJobParms_t parms;
+	parms.targetVerts = targetVerts;
+	parms.baseVerts = baseVerts;
+	parms.joints = joints;
+	parms.numVerts = numVerts;
+	parms.numJobs = Min(MAX_SKINNING_JOBS, (numVerts + jobVerts - 1) / jobVerts);
+	parms.vertsPerJob = (((numVerts + parms.numJobs - 1) / parms.numJobs) + 3) & ~3;
+	parms.numJobs = (numVerts + parms.vertsPerJob - 1) / parms.vertsPerJob;
 
-		targetVerts[i].xyz = accum * idVec4(base.xyz.x, base.xyz.y, base.xyz.z, 1.0f);
-		targetVerts[i].SetNormal(accum * base.GetNormal());
-		targetVerts[i].SetTangent(accum * base.GetTangent());
-		targetVerts[i].tangent[3] = base.tangent[3];
+	// the calling thread takes one slice itself
+	const int numJobs = Min(parms.numJobs - 1, Max(numHelpers, 1));
+	for(int i = 0; i < numJobs; i++)
+	{
+		tr.skinningJobList->AddJob((jobRun_t)TransformVertsAndTangentsJob, &parms);
 	}
+	tr.skinningJobList->Submit();
+
+	TransformVertsAndTangentsJob(&parms);
+
+	// jobs that start after all slices are taken return right away
+	tr.skinningJobList->Wait();
+
+	skinningJobListInUse.Decrement();
 }
 
 /*
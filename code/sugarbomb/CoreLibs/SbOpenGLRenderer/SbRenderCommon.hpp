@@ -297,6 +297,22 @@ public:
 	bool needsPortalSky;
 };
 
+// the view frustum is split into screen tiles and exponential depth slices, lights are
+// binned into the clusters their volume touches so entities outside of them can be
+// skipped without creating interactions
+const int LIGHT_GRID_TILES_X = 16; // must fit in the bits of a uint32 row
+const int LIGHT_GRID_TILES_Y = 9;
+const int LIGHT_GRID_SLICES = 16;
+const int LIGHT_GRID_ROWS = LIGHT_GRID_SLICES * LIGHT_GRID_TILES_Y;
+
+// inclusive cluster range covered by the screen projection of some bounds
+// x1 > x2 if the bounds aren't on screen
+struct lightGridBox_t
+{
+	byte x1, y1, z1;
+	byte x2, y2, z2;
+};
+
 struct shadowOnlyEntity_t
 {
 	shadowOnlyEntity_t *next;
@@ -359,6 +375,11 @@ struct viewLight_t
 
 	// R_AddSingleLight will build a chain of parameters here to setup shadow volumes
 	preLightShadowVolumeParms_t *preLightShadowVolumes;
+
+	// [LIGHT_GRID_SLICES][LIGHT_GRID_TILES_Y] rows of tile bits the light volume touches,
+	// nullptr if the light grid isn't used for this view
+	const uint32 *lightGridMask;
+	int lightGridCulledPairs; // entities R_AddSingleLight skipped because they are outside the clusters
 };
 
 // a viewEntity is created whenever a idRenderEntityLocal is considered for inclusion
@@ -400,6 +421,9 @@ struct viewEntity_t
 	// R_AddSingleModel will build a chain of parameters here to setup shadow volumes
 	staticShadowVolumeParms_t *staticShadowVolumes;
 	dynamicShadowVolumeParms_t *dynamicShadowVolumes;
+
+	// clusters covered by the reference bounds, set by R_BinViewEntities for directly visible entities
+	lightGridBox_t lightGridBox;
 };
 
 const int MAX_CLIP_PLANES = 1; // we may expand this to six for some subview issues
@@ -431,6 +455,17 @@ enum
 typedef idPlane frustum_t[FRUSTUM_PLANES];
 // RB end
 
+// cluster layout of a view, set up by R_SetupLightGrid
+// grid space is x forward, y right and z up from the view origin
+struct lightGrid_t
+{
+	bool enabled;
+	idRenderMatrix gridToWorld;
+	float sliceDepth[LIGHT_GRID_SLICES + 1]; // the last slice reaches to infinity
+	float tileTanX[LIGHT_GRID_TILES_X + 1];  // y / x at the tile edges
+	float tileTanY[LIGHT_GRID_TILES_Y + 1];  // z / x at the tile edges
+};
+
 // viewDefs are allocated on the frame temporary stack memory
 struct viewDef_t
 {
@@ -507,6 +542,8 @@ struct viewDef_t
 	// crossing a closed door.  This is used to avoid drawing interactions
 	// when the light is behind a closed door.
 	bool *connectedAreas;
+
+	lightGrid_t lightGrid;
 };
 
 // complex light / surface interactions are broken up into multiple passes of a
@@ -610,6 +647,7 @@ enum frameAllocType_t
 	FRAME_ALLOC_SHADER_REGISTER,
 	FRAME_ALLOC_DRAW_SURFACE_POINTER,
 	FRAME_ALLOC_DRAW_COMMAND,
+	FRAME_ALLOC_LIGHT_GRID,
 	FRAME_ALLOC_UNKNOWN,
 	FRAME_ALLOC_MAX
 };
@@ -680,7 +718,13 @@ struct performanceCounters_t
 	int c_entityReferences;
 	int c_lightReferences;
 	int c_guiSurfs;
+	int c_lodSurfs;         // surfaces drawn with a simplified LOD
+	int c_lodIndexes;       // indexes drawn for all the LOD capable surfaces
+	int c_lodFullIndexes;   // indexes those surfaces would have drawn at full detail
 	int frontEndMicroSec; // sum of time in all RE_RenderScene's in a frame
+	int c_lightGridCulledPairs;   // light / entity pairs skipped by the light grid
+	int lightGridMicroSec;        // binning the view entities, the lights are binned in R_AddSingleLight
+	int addInteractionsMicroSec;  // R_AddLights and R_AddModels, to compare with the light grid on and off
 };
 
 enum vertexLayoutType_t
@@ -878,6 +922,7 @@ public:
 	drawSurf_t testImageSurface_;
 
 	idParallelJobList *frontEndJobList;
+	idParallelJobList *skinningJobList; // splits CPU skinning of large meshes
 
 	idRenderBackend backend;
 
@@ -919,10 +964,18 @@ extern idCVar r_useTrilinearFiltering;   // Extra quality filtering
 extern idCVar r_lodBias;                 // lod bias
 
 extern idCVar r_useLightPortalFlow;      // 1 = do a more precise area reference determination
+extern idCVar r_sparseInteractionTable;  // 1 = hash light / entity interactions instead of a dense lights x entities table
+extern idCVar r_useLightGrid;            // 1 = bin lights into screen tiles and depth slices to skip entities outside them
+extern idCVar r_lightGridRefineLimit;    // lights covering more clusters only use their screen box
+extern idCVar r_showLightGrid;           // report light grid binning stats
 extern idCVar r_useShadowSurfaceScissor; // 1 = scissor shadows by the scissor rect of the interaction surfaces
 extern idCVar r_useConstantMaterials;    // 1 = use pre-calculated material registers if possible
 extern idCVar r_useNodeCommonChildren;   // stop pushing reference bounds early when possible
 extern idCVar r_useSilRemap;             // 1 = consider verts with the same XYZ, but different ST the same for shadows
+extern idCVar r_optimizeMeshes;          // 1 = reorder static model triangles and vertexes for the vertex cache, 2 = also report ACMR
+extern idCVar r_generateLods;            // 1 = create simplified index lists for static model surfaces
+extern idCVar r_useLods;                 // 1 = draw static model surfaces with the LOD that matches their screen size
+extern idCVar r_lodMaxPixelError;        // how many pixels a LOD may deviate from the full detail surface
 extern idCVar r_useLightPortalCulling;   // 0 = none, 1 = box, 2 = exact clip of polyhedron faces, 3 MVP to plane culling
 extern idCVar r_useLightAreaCulling;     // 0 = off, 1 = on
 extern idCVar r_useLightScissors;        // 1 = use custom scissor rectangle for each light
@@ -950,6 +1003,7 @@ extern idCVar r_skipSuppress;            // ignore the per-view suppressions
 extern idCVar r_skipInteractions;        // skip all light/surface interaction drawing
 extern idCVar r_skipFrontEnd;            // bypasses all front end work, but 2D gui rendering still draws
 extern idCVar r_skipBackEnd;             // don't draw anything
+extern idCVar r_nullRenderer;            // no window or OpenGL context, the back end is never run
 extern idCVar r_skipCopyTexture;         // do all rendering, but don't actually copyTexSubImage2D
 extern idCVar r_skipRender;              // skip 3D rendering, but pass 2D
 extern idCVar r_skipRenderContext;       // NULL the rendering context during backend 3D rendering
@@ -1001,6 +1055,7 @@ extern idCVar r_showCull;               // report sphere and box culling stats
 extern idCVar r_showAddModel;           // report stats from tr_addModel
 extern idCVar r_showSurfaces;           // report surface/light/shadow counts
 extern idCVar r_showPrimitives;         // report vertex/index/draw counts
+extern idCVar r_showLods;               // report triangles drawn with and without LOD selection
 extern idCVar r_showPortals;            // draw portal outlines in color based on passed / not passed
 extern idCVar r_showSkel;               // draw the skeleton when model animates
 extern idCVar r_showOverDraw;           // show overdraw
@@ -1036,6 +1091,7 @@ extern idCVar r_debugRenderToTexture;
 extern idCVar stereoRender_deGhost; // subtract from opposite eye to reduce ghosting
 
 extern idCVar r_useGPUSkinning;
+extern idCVar r_useParallelAddModels;
 
 // RB begin
 extern idCVar r_shadowMapFrustumFOV;
@@ -1260,6 +1316,41 @@ void R_OptimizeViewLightsList();
 /*
 ============================================================
 
+TR_FRONTEND_LIGHTGRID
+
+============================================================
+*/
+
+void R_SetupLightGrid(viewDef_t *viewDef);
+void R_BinViewEntities();
+const uint32 *R_BinViewLight(const viewDef_t *viewDef, const idRenderLightLocal *light);
+bool R_LightGridBoxForBounds(const viewDef_t *viewDef, const idBounds &bounds, lightGridBox_t &box);
+
+// true if any cluster of the box is touched by the light
+ID_INLINE bool R_LightGridTouchesBox(const uint32 *lightGridMask, const lightGridBox_t &box)
+{
+	if(box.x1 > box.x2)
+	{
+		return false;
+	}
+	const uint32 rowBits = (uint32)(((2ull << box.x2) - 1) & ~((1ull << box.x1) - 1));
+	for(int z = box.z1; z <= box.z2; z++)
+	{
+		const uint32 *row = lightGridMask + z * LIGHT_GRID_TILES_Y;
+		for(int y = box.y1; y <= box.y2; y++)
+		{
+			if(row[y] & rowBits)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/*
+============================================================
+
 TR_FRONTEND_ADDMODELS
 
 ============================================================
@@ -1324,6 +1415,7 @@ void R_AllocStaticTriSurfDominantTris(srfTriangles_t *tri, int numVerts);
 void R_AllocStaticTriSurfSilEdges(srfTriangles_t *tri, int numSilEdges);
 void R_AllocStaticTriSurfMirroredVerts(srfTriangles_t *tri, int numMirroredVerts);
 void R_AllocStaticTriSurfDupVerts(srfTriangles_t *tri, int numDupVerts);
+void R_AllocStaticTriSurfLods(srfTriangles_t *tri, int numLods);
 
 srfTriangles_t *R_CopyStaticTriSurf(const srfTriangles_t *tri);
 
@@ -1333,6 +1425,7 @@ void R_ReferenceStaticTriSurfVerts(srfTriangles_t *tri, const srfTriangles_t *re
 void R_ReferenceStaticTriSurfIndexes(srfTriangles_t *tri, const srfTriangles_t *reference);
 
 void R_FreeStaticTriSurfSilIndexes(srfTriangles_t *tri);
+void R_FreeStaticTriSurfLods(srfTriangles_t *tri);
 void R_FreeStaticTriSurf(srfTriangles_t *tri);
 void R_FreeStaticTriSurfVerts(srfTriangles_t *tri);
 void R_FreeStaticTriSurfVertexCaches(srfTriangles_t *tri);
@@ -1345,7 +1438,26 @@ void R_RemoveDegenerateTriangles(srfTriangles_t *tri);
 void R_RemoveUnusedVerts(srfTriangles_t *tri);
 void R_RangeCheckIndexes(const srfTriangles_t *tri);
 void R_CreateVertexNormals(srfTriangles_t *tri); // also called by dmap
-void R_CleanupTriangles(srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents);
+
+// vertex cache / overdraw / vertex fetch reordering stats, accumulated over
+// all the surfaces of a model
+struct triOptimizeStats_t
+{
+	int numTris;
+	int numVerts;
+	int cacheMissesBefore; // ACMR = cacheMisses / numTris
+	int cacheMissesAfter;
+};
+
+int R_CalcVertexCacheMisses(const triIndex_t *indexes, const int numIndexes, const int numVerts, const int cacheSize);
+void R_OptimizeTriangles(srfTriangles_t *tri, const idMaterial *material, triOptimizeStats_t *stats); // stats may be NULL
+void R_CleanupTriangles(srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents,
+                        const idMaterial *material = NULL, triOptimizeStats_t *optimizeStats = NULL);
+
+// quadric error simplified index lists sharing the verts, silIndexes must have been created
+void R_CreateTriSurfLods(srfTriangles_t *tri);
+// returns -1 for full detail
+int R_SelectTriSurfLod(const srfTriangles_t *tri, const float distance, const float pixelScale, const float maxPixelError);
 void R_ReverseTriangles(srfTriangles_t *tri);
 
 // Only deals with vertexes and indexes, not silhouettes, planes, etc.
@@ -317,6 +317,12 @@ idRenderProgManager::KillAllShaders()
 */
 void idRenderProgManager::KillAllShaders()
 {
+	// the null renderer never created any GL objects
+	if(r_nullRenderer.GetBool())
+	{
+		return;
+	}
+
 	Unbind();
 	for(int i = 0; i < vertexShaders.Num(); i++)
 	{
@@ -420,9 +426,9 @@ idRenderProgManager::LoadVertexShader
 */
 void idRenderProgManager::LoadVertexShader(int index)
 {
-	if(vertexShaders[index].progId != INVALID_PROGID)
+	if(vertexShaders[index].progId != INVALID_PROGID || r_nullRenderer.GetBool())
 	{
-		return; // Already loaded
+		return; // Already loaded, or nothing to compile against
 	}
 
 	vertexShader_t &vs = vertexShaders[index];
@@ -436,9 +442,9 @@ idRenderProgManager::LoadFragmentShader
 */
 void idRenderProgManager::LoadFragmentShader(int index)
 {
-	if(fragmentShaders[index].progId != INVALID_PROGID)
+	if(fragmentShaders[index].progId != INVALID_PROGID || r_nullRenderer.GetBool())
 	{
-		return; // Already loaded
+		return; // Already loaded, or nothing to compile against
 	}
 
 	fragmentShader_t &fs = fragmentShaders[index];
@@ -2144,9 +2144,9 @@ void idRenderProgManager::LoadGLSLProgram( const int programIndex, const int ver
 {
 	glslProgram_t& prog = glslPrograms[programIndex];
 	
-	if( prog.progId != INVALID_PROGID )
+	if( prog.progId != INVALID_PROGID || r_nullRenderer.GetBool() )
 	{
-		return; // Already loaded
+		return; // Already loaded, or nothing to link against
 	}
 	
 	GLuint vertexProgID = ( vertexShaderIndex != -1 ) ? vertexShaders[ vertexShaderIndex ].progId : INVALID_PROGID;
@@ -234,6 +234,131 @@ void idRenderWorldLocal::ResizeInteractionTable()
 	R_StaticFree(oldInteractionTable);
 }
 
+/*
+===================
+idSparseInteractionTable
+===================
+*/
+idSparseInteractionTable::idSparseInteractionTable()
+{
+	entries = nullptr;
+	capacity = 0;
+	num = 0;
+}
+
+idSparseInteractionTable::~idSparseInteractionTable()
+{
+	Free();
+}
+
+void idSparseInteractionTable::Init(const int expectedInteractions)
+{
+	Free();
+
+	int newCapacity = 1024;
+	while(newCapacity < expectedInteractions * 2)
+	{
+		newCapacity <<= 1;
+	}
+	Resize(newCapacity);
+}
+
+void idSparseInteractionTable::Free()
+{
+	if(entries != nullptr)
+	{
+		R_StaticFree(entries);
+		entries = nullptr;
+	}
+	capacity = 0;
+	num = 0;
+}
+
+void idSparseInteractionTable::Resize(const int newCapacity)
+{
+	entry_t *oldEntries = entries;
+	const int oldCapacity = capacity;
+
+	entries = (entry_t *)R_ClearedStaticAlloc(newCapacity * sizeof(entry_t));
+	capacity = newCapacity;
+
+	const unsigned int mask = capacity - 1;
+	for(int i = 0; i < oldCapacity; i++)
+	{
+		const entry_t &entry = oldEntries[i];
+		if(entry.interaction == nullptr)
+		{
+			continue;
+		}
+		unsigned int slot = Hash(entry.lightIndex, entry.entityIndex) & mask;
+		while(entries[slot].interaction != nullptr)
+		{
+			slot = (slot + 1) & mask;
+		}
+		entries[slot] = entry;
+	}
+
+	if(oldEntries != nullptr)
+	{
+		R_StaticFree(oldEntries);
+	}
+}
+
+void idSparseInteractionTable::Set(const int lightIndex, const int entityIndex, idInteraction *interaction)
+{
+	if(interaction != nullptr && (num + 1) * 2 > capacity)
+	{
+		Resize(capacity > 0 ? capacity * 2 : 1024);
+	}
+
+	const unsigned int mask = capacity - 1;
+	unsigned int slot = Hash(lightIndex, entityIndex) & mask;
+	while(entries[slot].interaction != nullptr)
+	{
+		if(entries[slot].lightIndex == lightIndex && entries[slot].entityIndex == entityIndex)
+		{
+			break;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	if(interaction != nullptr)
+	{
+		if(entries[slot].interaction == nullptr)
+		{
+			entries[slot].lightIndex = lightIndex;
+			entries[slot].entityIndex = entityIndex;
+			num++;
+		}
+		entries[slot].interaction = interaction;
+		return;
+	}
+
+	if(entries[slot].interaction == nullptr)
+	{
+		// not in the table
+		return;
+	}
+
+	// backward shift deletion, so lookups never need tombstones
+	unsigned int hole = slot;
+	for(unsigned int next = (hole + 1) & mask; entries[next].interaction != nullptr; next = (next + 1) & mask)
+	{
+		const unsigned int home = Hash(entries[next].lightIndex, entries[next].entityIndex) & mask;
+
+		// the entry can stay if its home slot lies cyclically in (hole, next]
+		const bool stays = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+		if(stays)
+		{
+			continue;
+		}
+		entries[hole] = entries[next];
+		hole = next;
+	}
+	entries[hole].interaction = nullptr;
+	num--;
+}
+
 /*
 ===================
 AddEntityDef
@@ -1757,11 +1882,19 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	tr.viewDef = nullptr;
 
 	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 100;
-	interactionTableHeight = lightDefs.Num() + 100;
-	int size = interactionTableWidth * interactionTableHeight * sizeof(*interactionTable);
-	interactionTable = (idInteraction **)R_ClearedStaticAlloc(size);
+	if(r_sparseInteractionTable.GetBool())
+	{
+		// only holds the pairs that get evaluated, grows as needed
+		sparseInteractionTable.Init(lightDefs.Num() * 16);
+	}
+	else
+	{
+		// this will be dynamically resized if the entity / light counts grow too much
+		interactionTableWidth = entityDefs.Num() + 100;
+		interactionTableHeight = lightDefs.Num() + 100;
+		int size = interactionTableWidth * interactionTableHeight * sizeof(*interactionTable);
+		interactionTable = (idInteraction **)R_ClearedStaticAlloc(size);
+	}
 
 	// itterate through all lights
 	int count = 0;
@@ -1820,7 +1953,14 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	int msec = end - start;
 
 	mpSys->Printf("idRenderWorld::GenerateAllInteractions, msec = %i\n", msec);
-	mpSys->Printf("interactionTable size: %i bytes\n", size);
+	if(interactionTable != nullptr)
+	{
+		mpSys->Printf("interactionTable size: %i bytes\n", interactionTableWidth * interactionTableHeight * (int)sizeof(*interactionTable));
+	}
+	else
+	{
+		mpSys->Printf("sparse interactionTable size: %i bytes for %i pairs\n", sparseInteractionTable.Allocated(), sparseInteractionTable.Num());
+	}
 	mpSys->Printf("%i interactions take %i bytes\n", count, count * sizeof(idInteraction));
 
 	// entities flagged as noDynamicInteractions will no longer make any
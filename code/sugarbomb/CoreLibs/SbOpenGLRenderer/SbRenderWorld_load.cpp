@@ -788,6 +788,7 @@ void idRenderWorldLocal::FreeDefs()
 		R_StaticFree(interactionTable);
 		interactionTable = nullptr;
 	}
+	sparseInteractionTable.Free();
 
 	// free all lightDefs
 	for(int i = 0; i < lightDefs.Num(); i++)
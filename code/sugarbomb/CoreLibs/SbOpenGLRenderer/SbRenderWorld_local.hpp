@@ -118,6 +118,87 @@ struct reusableOverlay_t
 	idRenderModelOverlay *overlays;
 };
 
+/*
+===============================================================================
+
+idSparseInteractionTable
+
+Open addressed hash of light / entity pairs, an alternative to the dense
+lightDefs * entityDefs interaction table for worlds with many thousands of
+entities where almost every light / entity slot would be nullptr.
+Only pairs that have an interaction or the INTERACTION_EMPTY marker take memory,
+walking the interactions of a single light is done with its interaction chain.
+
+===============================================================================
+*/
+class idSparseInteractionTable
+{
+public:
+	idSparseInteractionTable();
+	~idSparseInteractionTable();
+
+	void Init(const int expectedInteractions);
+	void Free();
+
+	bool IsAllocated() const
+	{
+		return entries != nullptr;
+	}
+
+	idInteraction *Find(const int lightIndex, const int entityIndex) const
+	{
+		if(entries == nullptr)
+		{
+			return nullptr;
+		}
+		const unsigned int mask = capacity - 1;
+		for(unsigned int i = Hash(lightIndex, entityIndex) & mask;; i = (i + 1) & mask)
+		{
+			const entry_t &entry = entries[i];
+			if(entry.interaction == nullptr)
+			{
+				return nullptr;
+			}
+			if(entry.lightIndex == lightIndex && entry.entityIndex == entityIndex)
+			{
+				return entry.interaction;
+			}
+		}
+	}
+
+	// a nullptr interaction removes the pair
+	void Set(const int lightIndex, const int entityIndex, idInteraction *interaction);
+
+	int Num() const
+	{
+		return num;
+	}
+	int Allocated() const
+	{
+		return capacity * (int)sizeof(entry_t);
+	}
+
+private:
+	struct entry_t
+	{
+		int lightIndex;
+		int entityIndex;
+		idInteraction *interaction; // nullptr for an unused slot
+	};
+
+	static unsigned int Hash(const int lightIndex, const int entityIndex)
+	{
+		unsigned int h = (unsigned int)entityIndex * 0x9E3779B1u + (unsigned int)lightIndex * 0x85EBCA77u;
+		return h ^ (h >> 15);
+	}
+
+	void Resize(const int newCapacity);
+
+	entry_t *entries; // [capacity], capacity is a power of two kept at most half full
+	int capacity;
+	int num;
+};
+
 class idRenderWorldLocal : public idRenderWorld
 {
 public:
@@ -220,6 +301,33 @@ public:
 	int interactionTableWidth;  // entityDefs
 	int interactionTableHeight; // lightDefs
 
+	// used instead of interactionTable when r_sparseInteractionTable was set at GenerateAllInteractions()
+	idSparseInteractionTable sparseInteractionTable;
+
+	bool HasInteractionTable() const
+	{
+		return interactionTable != nullptr || sparseInteractionTable.IsAllocated();
+	}
+	idInteraction *GetInteraction(const int lightIndex, const int entityIndex) const
+	{
+		if(interactionTable != nullptr)
+		{
+			return interactionTable[lightIndex * interactionTableWidth + entityIndex];
+		}
+		return sparseInteractionTable.Find(lightIndex, entityIndex);
+	}
+	void SetInteraction(const int lightIndex, const int entityIndex, idInteraction *interaction)
+	{
+		if(interactionTable != nullptr)
+		{
+			interactionTable[lightIndex * interactionTableWidth + entityIndex] = interaction;
+		}
+		else if(sparseInteractionTable.IsAllocated())
+		{
+			sparseInteractionTable.Set(lightIndex, entityIndex, interaction);
+		}
+	}
+
 	bool generateAllInteractionsCalled;
 
 	//-----------------------
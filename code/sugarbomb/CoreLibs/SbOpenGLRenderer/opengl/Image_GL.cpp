@@ -284,6 +284,12 @@ void idImage::SubImageUpload( int mipLevel, int x, int y, int z, int width, int
 {
 	assert( x >= 0 && y >= 0 && mipLevel >= 0 && width >= 0 && height >= 0 && mipLevel < opts.numLevels );
 	
+	// the null renderer never creates the texture
+	if( r_nullRenderer.GetBool() )
+	{
+		return;
+	}
+	
 	int compressedSize = 0;
 	
 	if( IsCompressed() )
@@ -736,7 +742,7 @@ void idImage::AllocImage()
 	// have filled in the parms.  We must have the values set, or
 	// an image match from a shader before OpenGL starts would miss
 	// the generated texture
-	if( !R_IsInitialized() )
+	if( !R_IsInitialized() || r_nullRenderer.GetBool() )
 	{
 		return;
 	}
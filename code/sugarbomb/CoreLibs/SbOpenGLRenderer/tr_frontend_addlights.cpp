@@ -139,6 +139,8 @@ static void R_AddSingleLight(viewLight_t *vLight)
 	vLight->removeFromList = true;
 	vLight->shadowOnlyViewEntities = nullptr;
 	vLight->preLightShadowVolumes = nullptr;
+	vLight->lightGridMask = nullptr;
+	vLight->lightGridCulledPairs = 0;
 
 	// globals we really should pass in...
 	const viewDef_t *viewDef = tr.viewDef;
@@ -387,7 +389,17 @@ static void R_AddSingleLight(viewLight_t *vLight)
 	// this bool array will be set true whenever the entity will visibly interact with the light
 	vLight->entityInteractionState = (byte *)R_ClearedFrameAlloc(light->world->entityDefs.Num() * sizeof(vLight->entityInteractionState[0]), FRAME_ALLOC_INTERACTION_STATE);
 
-	idInteraction **const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
+	// the dense interaction table is walked by row, the sparse one is probed per entity
+	idInteraction **const interactionTableRow = (light->world->interactionTable != nullptr) ? light->world->interactionTable + light->index * light->world->interactionTableWidth : nullptr;
+	const idSparseInteractionTable &sparseInteractionTable = light->world->sparseInteractionTable;
+
+	// the clusters of the view the light volume touches, see tr_frontend_lightgrid.cpp
+	const uint32 *lightGridMask = nullptr;
+	if(viewDef->lightGrid.enabled)
+	{
+		lightGridMask = R_BinViewLight(viewDef, light);
+		vLight->lightGridMask = lightGridMask;
+	}
 
 	for(areaReference_t *lref = light->references; lref != nullptr; lref = lref->ownerNext)
 	{
@@ -417,7 +429,7 @@ static void R_AddSingleLight(viewLight_t *vLight)
 			vLight->entityInteractionState[edef->index] = viewLight_t::INTERACTION_NO;
 
 			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-			const idInteraction *inter = interactionTableRow[edef->index];
+			const idInteraction *inter = (interactionTableRow != nullptr) ? interactionTableRow[edef->index] : sparseInteractionTable.Find(light->index, edef->index);
 
 			const renderEntity_t &eParms = edef->parms;
 			const idRenderModel *eModel = eParms.hModel;
@@ -477,11 +489,21 @@ static void R_AddSingleLight(viewLight_t *vLight)
 
 			// we now know that the entity and light do overlap
 
+			bool outsideLightGrid = false;
 			if(edef->IsDirectlyVisible())
 			{
-				// entity is directly visible, so the interaction is definitely needed
-				vLight->entityInteractionState[edef->index] = viewLight_t::INTERACTION_YES;
-				continue;
+				// entity is directly visible, so the interaction is definitely needed,
+				// unless it shares no cluster with the light and none of its pixels can be lit
+				// (weapons are drawn with their own projection)
+				if(lightGridMask == nullptr || eParms.weaponDepthHack || R_LightGridTouchesBox(lightGridMask, edef->viewEntity->lightGridBox))
+				{
+					vLight->entityInteractionState[edef->index] = viewLight_t::INTERACTION_YES;
+					continue;
+				}
+
+				// it may still shadow lit surfaces
+				outsideLightGrid = true;
+				vLight->lightGridCulledPairs++;
 			}
 
 			// the entity is not directly visible, but if we can tell that it may cast
@@ -519,6 +541,21 @@ static void R_AddSingleLight(viewLight_t *vLight)
 				continue;
 			}
 
+			// the shadow only matters where the light reaches on screen
+			if(lightGridMask != nullptr)
+			{
+				lightGridBox_t shadowBox;
+				R_LightGridBoxForBounds(viewDef, shadowBounds, shadowBox);
+				if(!R_LightGridTouchesBox(lightGridMask, shadowBox))
+				{
+					if(!outsideLightGrid)
+					{
+						vLight->lightGridCulledPairs++;
+					}
+					continue;
+				}
+			}
+
 			// debug tool to allow viewing of only one entity at a time
 			if(r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index)
 			{
@@ -528,6 +565,13 @@ static void R_AddSingleLight(viewLight_t *vLight)
 			// we do need it for shadows
 			vLight->entityInteractionState[edef->index] = viewLight_t::INTERACTION_YES;
 
+			if(outsideLightGrid)
+			{
+				// visible after all, so it already has a viewEntity
+				vLight->lightGridCulledPairs--;
+				continue;
+			}
+
 			// we will need to create a viewEntity_t for it in the serial code section
 			shadowOnlyEntity_t *shadEnt = (shadowOnlyEntity_t *)R_FrameAlloc(sizeof(shadowOnlyEntity_t), FRAME_ALLOC_SHADOW_ONLY_ENTITY);
 			shadEnt->next = vLight->shadowOnlyViewEntities;
@@ -664,6 +708,7 @@ void R_AddLights()
 
 		// serial work
 		tr.pc.c_viewLights++;
+		tr.pc.c_lightGridCulledPairs += vLight->lightGridCulledPairs;
 
 		for(shadowOnlyEntity_t *shadEnt = vLight->shadowOnlyViewEntities; shadEnt != nullptr; shadEnt = shadEnt->next)
 		{
@@ -86,6 +86,21 @@ idCVar r_lodMaterialDistance("r_lodMaterialDistance", "500", CVAR_RENDERER | CVA
 
 static const float CHECK_BOUNDS_EPSILON = 1.0f;
 
+/*
+==================
+R_DistanceToLocalBounds
+==================
+*/
+static float R_DistanceToLocalBounds(const idVec3 &localPoint, const idBounds &bounds)
+{
+	idVec3 nearestPointOnBounds;
+	for(int i = 0; i < 3; i++)
+	{
+		nearestPointOnBounds[i] = Min(Max(localPoint[i], bounds[0][i]), bounds[1][i]);
+	}
+	return (nearestPointOnBounds - localPoint).LengthFast();
+}
+
 /*
 ==================
 R_SortViewEntities
@@ -465,7 +480,7 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 				if(vLight->entityInteractionState[entityIndex] == viewLight_t::INTERACTION_YES)
 				{
 					contactedLights[numContactedLights] = vLight;
-					staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+					staticInteractions[numContactedLights] = world->GetInteraction(vLight->lightDef->index, entityIndex);
 					if(++numContactedLights == MAX_CONTACTED_LIGHTS)
 					{
 						break;
@@ -521,7 +536,7 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 				}
 			}
 			contactedLights[numContactedLights] = vLight;
-			staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+			staticInteractions[numContactedLights] = world->GetInteraction(vLight->lightDef->index, entityIndex);
 			if(++numContactedLights == MAX_CONTACTED_LIGHTS)
 			{
 				break;
@@ -613,6 +628,10 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 	idVec3 localViewOrigin;
 	R_GlobalPointToLocal(vEntity->modelMatrix, viewDef->renderView.vieworg, localViewOrigin);
 
+	// pixels covered by one unit at a distance of one unit, for LOD selection
+	const float lodPixelScale = viewDef->viewport.GetHeight() * 0.5f * viewDef->projectionMatrix[1 * 4 + 1];
+	const bool useLods = r_useLods.GetBool() && !renderEntity->weaponDepthHack && renderEntity->modelDepthHack == 0.0f;
+
 	//---------------------------
 	// add all the model surfaces
 	//---------------------------
@@ -743,6 +762,33 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 		const bool gpuSkinned = (tri->staticModelWithJoints != nullptr && r_useGPUSkinning.GetBool() && glConfig.gpuSkinningAvailable);
 		// RB end
 
+		//--------------------------
+		// select a simplified LOD from the projected size of the surface
+		//
+		// The LOD replaces the index list for the base drawing surface and the
+		// light interactions, so the depth equal interaction passes match.
+		// Shadows keep using the full detail silhouette edges.
+		//--------------------------
+		triIndex_t *drawIndexes = tri->indexes;
+		int numDrawIndexes = tri->numIndexes;
+		vertCacheHandle_t *drawIndexCache = &tri->indexCache;
+		bool drawingLod = false;
+		if(tri->numLods > 0 && surfaceDirectlyVisible)
+		{
+			const int lodNum = useLods ? R_SelectTriSurfLod(tri, R_DistanceToLocalBounds(localViewOrigin, tri->bounds), lodPixelScale, r_lodMaxPixelError.GetFloat()) : -1;
+			if(lodNum >= 0)
+			{
+				triLod_t &lod = tri->lods[lodNum];
+				drawIndexes = lod.indexes;
+				numDrawIndexes = lod.numIndexes;
+				drawIndexCache = &lod.indexCache;
+				drawingLod = true;
+				tr.pc.c_lodSurfs++;
+			}
+			tr.pc.c_lodIndexes += numDrawIndexes;
+			tr.pc.c_lodFullIndexes += tri->numIndexes;
+		}
+
 		//--------------------------
 		// base drawing surface
 		//--------------------------
@@ -753,9 +799,9 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 			if(surfaceDirectlyVisible)
 			{
 				// make sure we have an ambient cache and all necessary normals / tangents
-				if(!vertexCache.CacheIsCurrent(tri->indexCache))
+				if(!vertexCache.CacheIsCurrent(*drawIndexCache))
 				{
-					tri->indexCache = vertexCache.AllocIndex(tri->indexes, ALIGN(tri->numIndexes * sizeof(triIndex_t), INDEX_CACHE_ALIGN));
+					*drawIndexCache = vertexCache.AllocIndex(drawIndexes, ALIGN(numDrawIndexes * sizeof(triIndex_t), INDEX_CACHE_ALIGN));
 				}
 
 				if(!vertexCache.CacheIsCurrent(tri->ambientCache))
@@ -814,16 +860,16 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 					{
 						tri->ambientCache = vertexCache.AllocVertex(tri->verts, ALIGN(tri->numVerts * sizeof(tri->verts[0]), VERTEX_CACHE_ALIGN));
 					}
-					if(!vertexCache.CacheIsCurrent(tri->indexCache))
+					if(!vertexCache.CacheIsCurrent(*drawIndexCache))
 					{
-						tri->indexCache = vertexCache.AllocIndex(tri->indexes, ALIGN(tri->numIndexes * sizeof(tri->indexes[0]), INDEX_CACHE_ALIGN));
+						*drawIndexCache = vertexCache.AllocIndex(drawIndexes, ALIGN(numDrawIndexes * sizeof(drawIndexes[0]), INDEX_CACHE_ALIGN));
 					}
 
 					R_SetupDrawSurfJoints(baseDrawSurf, tri, shader);
 
-					baseDrawSurf->numIndexes = tri->numIndexes;
+					baseDrawSurf->numIndexes = numDrawIndexes;
 					baseDrawSurf->ambientCache = tri->ambientCache;
-					baseDrawSurf->indexCache = tri->indexCache;
+					baseDrawSurf->indexCache = *drawIndexCache;
 					baseDrawSurf->shadowCache = 0;
 
 					baseDrawSurf->linkChain = nullptr; // link to the view
@@ -895,7 +941,18 @@ void R_AddSingleModel(viewEntity_t *vEntity)
 						// create a drawSurf for this interaction
 						drawSurf_t *lightDrawSurf = (drawSurf_t *)R_FrameAlloc(sizeof(*lightDrawSurf), FRAME_ALLOC_DRAW_SURFACE);
 
-						if(surfInter != nullptr)
+						if(drawingLod)
+						{
+							// the light triangles were culled from the full detail surface,
+							// so throw the whole LOD at the light instead
+							if(!vertexCache.CacheIsCurrent(*drawIndexCache))
+							{
+								*drawIndexCache = vertexCache.AllocIndex(drawIndexes, ALIGN(numDrawIndexes * sizeof(drawIndexes[0]), INDEX_CACHE_ALIGN));
+							}
+							lightDrawSurf->numIndexes = numDrawIndexes;
+							lightDrawSurf->indexCache = *drawIndexCache;
+						}
+						else if(surfInter != nullptr)
 						{
 							// optimized static interaction
 							lightDrawSurf->numIndexes = surfInter->numLightTrisIndexes;
@@ -0,0 +1,297 @@
+/*
+*******************************************************************************
+
+Copyright (C) 2019 SugarBombEngine Developers
+
+This file is part of SugarBombEngine
+
+SugarBombEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SugarBombEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SugarBombEngine. If not, see <http://www.gnu.org/licenses/>.
+
+*******************************************************************************
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "framework/ICVarSystem.hpp"
+
+#include "idlib/bv/Bounds.h"
+#include "idlib/geometry/RenderMatrix.h"
+#include "idlib/math/Math.h"
+#include "idlib/math/Matrix.h"
+#include "idlib/math/Vector.h"
+#include "idlib/sys/sys_types.h"
+
+#include "RenderCommon.h"
+#include "RenderWorld_local.h"
+
+//namespace sbe
+//{
+
+/*
+==========================================================================================
+
+LIGHT GRID
+
+The view is split into screen tiles and exponentially spaced depth slices. Each view light
+gets a mask of the clusters its volume touches and each directly visible view entity the
+box of clusters its reference bounds cover. R_AddSingleLight doesn't create interactions
+for entities that share no cluster with the light, because none of their pixels on screen
+can be lit, unless their shadow may still fall into the light's clusters.
+
+This is a conservative screen space test, there is no occlusion culling on the CPU.
+
+==========================================================================================
+*/
+
+idCVar r_lightGridFar("r_lightGridFar", "8192", CVAR_RENDERER | CVAR_FLOAT, "depth of the last light grid slice, everything further away shares it");
+
+/*
+====================
+R_GridDepthRange
+
+Distance range of the bounds along the view direction.
+====================
+*/
+static void R_GridDepthRange(const viewDef_t *viewDef, const idBounds &bounds, float &minDepth, float &maxDepth)
+{
+	const idVec3 &forward = viewDef->renderView.viewaxis[0];
+	const idVec3 center = bounds.GetCenter();
+	const idVec3 extents = bounds[1] - center;
+
+	const float centerDepth = (center - viewDef->renderView.vieworg) * forward;
+	const float depthExtent = idMath::Fabs(forward[0]) * extents[0] + idMath::Fabs(forward[1]) * extents[1] + idMath::Fabs(forward[2]) * extents[2];
+
+	minDepth = centerDepth - depthExtent;
+	maxDepth = centerDepth + depthExtent;
+}
+
+/*
+====================
+R_LightGridSlice
+====================
+*/
+static int R_LightGridSlice(const lightGrid_t &grid, float depth)
+{
+	// walk the slice depths instead of taking a log, so the result matches the cluster bounds exactly
+	int slice = 0;
+	while(slice < LIGHT_GRID_SLICES - 1 && depth >= grid.sliceDepth[slice + 1])
+	{
+		slice++;
+	}
+	return slice;
+}
+
+/*
+====================
+R_LightGridTile
+====================
+*/
+static int R_LightGridTile(float windowCoord, int numTiles)
+{
+	return idMath::ClampInt(0, numTiles - 1, idMath::Ftoi(idMath::Floor(windowCoord * numTiles)));
+}
+
+/*
+====================
+R_SetupLightGrid
+
+Called after the projection matrix is set up.
+====================
+*/
+void R_SetupLightGrid(viewDef_t *viewDef)
+{
+	lightGrid_t &grid = viewDef->lightGrid;
+
+	grid.enabled = r_useLightGrid.GetBool() && !viewDef->is2Dgui;
+	if(!grid.enabled)
+	{
+		return;
+	}
+
+	const renderView_t &renderView = viewDef->renderView;
+
+	// grid space is x forward, y right and z up like the tiles
+	const idMat3 gridAxis(renderView.viewaxis[0], -renderView.viewaxis[1], renderView.viewaxis[2]);
+	idRenderMatrix::CreateFromOriginAxis(renderView.vieworg, gridAxis, grid.gridToWorld);
+
+	// the same near plane R_SetupProjectionMatrix uses
+	const float zNear = (renderView.cramZNear) ? (r_znear.GetFloat() * 0.25f) : r_znear.GetFloat();
+	const float zFar = Max(r_lightGridFar.GetFloat(), zNear * 2.0f);
+
+	for(int i = 0; i < LIGHT_GRID_SLICES; i++)
+	{
+		grid.sliceDepth[i] = zNear * idMath::Pow(zFar / zNear, (float)i / (LIGHT_GRID_SLICES - 1));
+	}
+	grid.sliceDepth[LIGHT_GRID_SLICES] = idMath::INFINITY;
+
+	// the tile edges come from the projection matrix so jittered and off center views line up
+	const float *projection = viewDef->projectionMatrix;
+	for(int i = 0; i <= LIGHT_GRID_TILES_X; i++)
+	{
+		const float ndc = 2.0f * i / LIGHT_GRID_TILES_X - 1.0f;
+		grid.tileTanX[i] = (ndc + projection[2 * 4 + 0]) / projection[0 * 4 + 0];
+	}
+	for(int i = 0; i <= LIGHT_GRID_TILES_Y; i++)
+	{
+		const float ndc = 2.0f * i / LIGHT_GRID_TILES_Y - 1.0f;
+		grid.tileTanY[i] = (ndc + projection[2 * 4 + 1]) / projection[1 * 4 + 1];
+	}
+}
+
+/*
+====================
+R_LightGridBoxForBounds
+
+Returns false and an empty box if the bounds are off screen.
+====================
+*/
+bool R_LightGridBoxForBounds(const viewDef_t *viewDef, const idBounds &bounds, lightGridBox_t &box)
+{
+	idBounds projected;
+	idRenderMatrix::ProjectedNearClippedBounds(projected, viewDef->worldSpace.mvp, bounds);
+
+	if(projected[0][2] >= projected[1][2] ||
+	   projected[0][0] >= 1.0f || projected[1][0] <= 0.0f ||
+	   projected[0][1] >= 1.0f || projected[1][1] <= 0.0f)
+	{
+		box.x1 = box.y1 = box.z1 = 1;
+		box.x2 = box.y2 = box.z2 = 0;
+		return false;
+	}
+
+	float minDepth, maxDepth;
+	R_GridDepthRange(viewDef, bounds, minDepth, maxDepth);
+
+	box.x1 = (byte)R_LightGridTile(projected[0][0], LIGHT_GRID_TILES_X);
+	box.x2 = (byte)R_LightGridTile(projected[1][0], LIGHT_GRID_TILES_X);
+	box.y1 = (byte)R_LightGridTile(projected[0][1], LIGHT_GRID_TILES_Y);
+	box.y2 = (byte)R_LightGridTile(projected[1][1], LIGHT_GRID_TILES_Y);
+	box.z1 = (byte)R_LightGridSlice(viewDef->lightGrid, minDepth);
+	box.z2 = (byte)R_LightGridSlice(viewDef->lightGrid, maxDepth);
+	return true;
+}
+
+/*
+====================
+R_BinViewEntities
+
+Called after FindViewLightsAndEntities, before the light jobs read the boxes.
+====================
+*/
+void R_BinViewEntities()
+{
+	const viewDef_t *viewDef = tr.viewDef;
+	if(!viewDef->lightGrid.enabled)
+	{
+		return;
+	}
+
+	const uint64 start = Sys_Microseconds();
+
+	for(viewEntity_t *vEntity = viewDef->viewEntitys; vEntity != nullptr; vEntity = vEntity->next)
+	{
+		R_LightGridBoxForBounds(viewDef, vEntity->entityDef->globalReferenceBounds, vEntity->lightGridBox);
+	}
+
+	tr.pc.lightGridMicroSec += (int)(Sys_Microseconds() - start);
+}
+
+/*
+====================
+R_BinViewLight
+
+May be run in parallel.
+
+Starts from the screen box of the light bounds and, unless that covers too many clusters,
+drops the clusters that are outside the light volume.
+====================
+*/
+const uint32 *R_BinViewLight(const viewDef_t *viewDef, const idRenderLightLocal *light)
+{
+	const lightGrid_t &grid = viewDef->lightGrid;
+
+	uint32 *mask = (uint32 *)R_ClearedFrameAlloc(LIGHT_GRID_ROWS * sizeof(mask[0]), FRAME_ALLOC_LIGHT_GRID);
+
+	lightGridBox_t box;
+	if(!R_LightGridBoxForBounds(viewDef, light->globalLightBounds, box))
+	{
+		// nothing on screen can be lit
+		return mask;
+	}
+
+	const int numClusters = (box.x2 - box.x1 + 1) * (box.y2 - box.y1 + 1) * (box.z2 - box.z1 + 1);
+	if(numClusters > r_lightGridRefineLimit.GetInteger())
+	{
+		const uint32 rowBits = (uint32)(((2ull << box.x2) - 1) & ~((1ull << box.x1) - 1));
+		for(int z = box.z1; z <= box.z2; z++)
+		{
+			for(int y = box.y1; y <= box.y2; y++)
+			{
+				mask[z * LIGHT_GRID_TILES_Y + y] = rowBits;
+			}
+		}
+		return mask;
+	}
+
+	float minDepth, maxDepth;
+	R_GridDepthRange(viewDef, light->globalLightBounds, minDepth, maxDepth);
+
+	// grid space to light projected space
+	idRenderMatrix gridLightProject;
+	idRenderMatrix::Multiply(light->baseLightProject, grid.gridToWorld, gridLightProject);
+
+	for(int z = box.z1; z <= box.z2; z++)
+	{
+		// only the part of the slice inside the light bounds
+		const float d0 = Max(grid.sliceDepth[z], minDepth);
+		const float d1 = Min(grid.sliceDepth[z + 1], maxDepth);
+		if(d0 > d1)
+		{
+			continue;
+		}
+
+		for(int y = box.y1; y <= box.y2; y++)
+		{
+			const float tanY0 = grid.tileTanY[y];
+			const float tanY1 = grid.tileTanY[y + 1];
+
+			uint32 bits = 0;
+			for(int x = box.x1; x <= box.x2; x++)
+			{
+				const float tanX0 = grid.tileTanX[x];
+				const float tanX1 = grid.tileTanX[x + 1];
+
+				// axial bounds of the cluster frustum piece in grid space
+				idBounds cluster;
+				cluster[0][0] = d0;
+				cluster[1][0] = d1;
+				cluster[0][1] = Min(tanX0 * d0, tanX0 * d1);
+				cluster[1][1] = Max(tanX1 * d0, tanX1 * d1);
+				cluster[0][2] = Min(tanY0 * d0, tanY0 * d1);
+				cluster[1][2] = Max(tanY1 * d0, tanY1 * d1);
+
+				if(!idRenderMatrix::CullBoundsToMVP(gridLightProject, cluster, true))
+				{
+					bits |= 1u << x;
+				}
+			}
+			mask[z * LIGHT_GRID_TILES_Y + y] = bits;
+		}
+	}
+
+	return mask;
+}
+
+//} // namespace sbe
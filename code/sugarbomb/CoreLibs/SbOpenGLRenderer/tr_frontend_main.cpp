@@ -529,6 +529,9 @@ void R_RenderView(viewDef_t *parms)
 	R_SetupSplitFrustums(tr.viewDef);
 	// RB end
 
+	// tiles and depth slices the view lights and entities are binned into
+	R_SetupLightGrid(tr.viewDef);
+
 	// identify all the visible portal areas, and create view lights and view entities
 	// for all the the entityDefs and lightDefs that are in the visible portal areas
 	static_cast<idRenderWorldLocal *>(parms->renderWorld)->FindViewLightsAndEntities();
@@ -536,6 +539,11 @@ void R_RenderView(viewDef_t *parms)
 	// wait for any shadow volume jobs from the previous frame to finish
 	tr.frontEndJobList->Wait();
 
+	// screen clusters of the directly visible entities, the lights are binned in R_AddLights
+	R_BinViewEntities();
+
+	const uint64 addInteractionsStart = Sys_Microseconds();
+
 	// make sure that interactions exist for all light / entity combinations that are visible
 	// add any pre-generated light shadows, and calculate the light shader values
 	R_AddLights();
@@ -543,6 +551,8 @@ void R_RenderView(viewDef_t *parms)
 	// adds ambient surfaces and create any necessary interaction surfaces to add to the light lists
 	R_AddModels();
 
+	tr.pc.addInteractionsMicroSec += (int)(Sys_Microseconds() - addInteractionsStart);
+
 	// build up the GUIs on world surfaces
 	R_AddInGameGuis(tr.viewDef->drawSurfs, tr.viewDef->numDrawSurfs);
 
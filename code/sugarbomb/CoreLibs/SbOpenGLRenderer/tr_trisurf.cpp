@@ -204,6 +204,10 @@ int R_TriSurfMemory(const srfTriangles_t *tri)
 	{
 		total += tri->numDupVerts * sizeof(tri->dupVerts[0]);
 	}
+	for(int i = 0; i < tri->numLods; i++)
+	{
+		total += tri->lods[i].numIndexes * sizeof(tri->lods[i].indexes[0]) + sizeof(tri->lods[i]);
+	}
 
 	total += sizeof(*tri);
 
@@ -222,6 +226,10 @@ void R_FreeStaticTriSurfVertexCaches(srfTriangles_t *tri)
 	tri->ambientCache = 0;
 	tri->indexCache = 0;
 	tri->shadowCache = 0;
+	for(int i = 0; i < tri->numLods; i++)
+	{
+		tri->lods[i].indexCache = 0;
+	}
 }
 
 /*
@@ -280,6 +288,7 @@ void R_FreeStaticTriSurf(srfTriangles_t *tri)
 		{
 			Mem_Free(tri->dupVerts);
 		}
+		R_FreeStaticTriSurfLods(tri);
 	}
 
 	if(tri->preLightShadowVertexes != nullptr)
@@ -428,6 +437,41 @@ void R_AllocStaticTriSurfSilEdges(srfTriangles_t *tri, int numSilEdges)
 	tri->silEdges = (silEdge_t *)Mem_Alloc16(numSilEdges * sizeof(silEdge_t), TAG_TRI_SIL_EDGE);
 }
 
+/*
+=================
+R_AllocStaticTriSurfLods
+=================
+*/
+void R_AllocStaticTriSurfLods(srfTriangles_t *tri, int numLods)
+{
+	assert(tri->lods == nullptr);
+	tri->lods = (triLod_t *)Mem_ClearedAlloc(numLods * sizeof(triLod_t), TAG_TRI_LODS);
+	tri->numLods = numLods;
+}
+
+/*
+=================
+R_FreeStaticTriSurfLods
+=================
+*/
+void R_FreeStaticTriSurfLods(srfTriangles_t *tri)
+{
+	if(tri->lods == nullptr)
+	{
+		return;
+	}
+	for(int i = 0; i < tri->numLods; i++)
+	{
+		if(tri->lods[i].indexes != nullptr)
+		{
+			Mem_Free(tri->lods[i].indexes);
+		}
+	}
+	Mem_Free(tri->lods);
+	tri->lods = nullptr;
+	tri->numLods = 0;
+}
+
 /*
 =================
 R_AllocStaticTriSurfPreLightShadowVerts
@@ -1936,6 +1980,1064 @@ void R_ReverseTriangles(srfTriangles_t *tri)
 	}
 }
 
+/*
+===================================================================================
+
+VERTEX CACHE OPTIMIZATION
+
+Static surfaces are reordered once at load / binarize time, so the optimized
+order is baked into the cached binary models:
+
+  1. triangles are reordered for the post-transform vertex cache using
+     Tom Forsyth's linear-speed scoring heuristic
+  2. the cache optimized triangle list is split into clusters at the points
+     where the simulated cache gets flushed, and the clusters are sorted so
+     that the outward facing ones are drawn first to reduce overdraw
+  3. vertexes are reordered in first-use order for vertex fetch locality
+
+This must run before the sil edges, mirrored vertexes and dup verts are created,
+because those reference vertex numbers.
+===================================================================================
+*/
+
+static const int	FORSYTH_CACHE_SIZE = 32;
+static const float	FORSYTH_CACHE_DECAY_POWER = 1.5f;
+static const float	FORSYTH_LAST_TRI_SCORE = 0.75f;
+static const float	FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+static const float	FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+// size of the FIFO cache used for measuring, roughly matches current hardware
+static const int	ACMR_CACHE_SIZE = 24;
+
+// FIFO cache size used to find the cluster boundaries for overdraw sorting
+static const int	OVERDRAW_CACHE_SIZE = 16;
+
+/*
+=================
+R_VertexCacheScore
+=================
+*/
+static float R_VertexCacheScore(const int cachePosition, const int numActiveTris)
+{
+	if(numActiveTris == 0)
+	{
+		// no triangles left that use this vertex
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if(cachePosition >= 0)
+	{
+		if(cachePosition < 3)
+		{
+			// the vertexes of the last triangle get a fixed score, so it
+			// doesn't matter which of them is used next
+			score = FORSYTH_LAST_TRI_SCORE;
+		}
+		else
+		{
+			assert(cachePosition < FORSYTH_CACHE_SIZE);
+			const float scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+			score = idMath::Pow(1.0f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+
+	// bonus points for having a low number of triangles left, so lone
+	// vertexes get taken out of the way
+	score += FORSYTH_VALENCE_BOOST_SCALE * idMath::Pow((float)numActiveTris, -FORSYTH_VALENCE_BOOST_POWER);
+
+	return score;
+}
+
+/*
+=================
+R_CalcVertexCacheMisses
+
+Simulates a FIFO post-transform cache and returns the number of vertexes
+that had to be transformed. ACMR is misses / triangles.
+=================
+*/
+int R_CalcVertexCacheMisses(const triIndex_t *indexes, const int numIndexes, const int numVerts, const int cacheSize)
+{
+	// timestamp of the miss that put each vertex in the cache
+	int *cacheTime = (int *)R_StaticAlloc(numVerts * sizeof(cacheTime[0]));
+	for(int i = 0; i < numVerts; i++)
+	{
+		cacheTime[i] = -cacheSize - 1;
+	}
+
+	int misses = 0;
+	for(int i = 0; i < numIndexes; i++)
+	{
+		const int v = indexes[i];
+		if(misses - cacheTime[v] > cacheSize)
+		{
+			cacheTime[v] = misses;
+			misses++;
+		}
+	}
+
+	R_StaticFree(cacheTime);
+
+	return misses;
+}
+
+/*
+=================
+R_OptimizeTriangleOrder
+
+Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+silIndexes may be nullptr, otherwise they are permuted together with the indexes.
+=================
+*/
+static void R_OptimizeTriangleOrder(triIndex_t *indexes, triIndex_t *silIndexes, const int numIndexes, const int numVerts)
+{
+	const int numTris = numIndexes / 3;
+
+	// build the vertex to triangle adjacency
+	int *numActiveTris = (int *)R_ClearedStaticAlloc(numVerts * sizeof(numActiveTris[0]));
+	int *firstAdjTri = (int *)R_StaticAlloc((numVerts + 1) * sizeof(firstAdjTri[0]));
+	int *adjTris = (int *)R_StaticAlloc(numIndexes * sizeof(adjTris[0]));
+
+	for(int i = 0; i < numIndexes; i++)
+	{
+		numActiveTris[indexes[i]]++;
+	}
+	firstAdjTri[0] = 0;
+	for(int i = 0; i < numVerts; i++)
+	{
+		firstAdjTri[i + 1] = firstAdjTri[i] + numActiveTris[i];
+		numActiveTris[i] = 0;
+	}
+	for(int i = 0; i < numIndexes; i++)
+	{
+		const int v = indexes[i];
+		adjTris[firstAdjTri[v] + numActiveTris[v]] = i / 3;
+		numActiveTris[v]++;
+	}
+
+	int *cachePosition = (int *)R_StaticAlloc(numVerts * sizeof(cachePosition[0]));
+	float *vertScore = (float *)R_StaticAlloc(numVerts * sizeof(vertScore[0]));
+	for(int i = 0; i < numVerts; i++)
+	{
+		cachePosition[i] = -1;
+		vertScore[i] = R_VertexCacheScore(-1, numActiveTris[i]);
+	}
+
+	float *triScore = (float *)R_StaticAlloc(numTris * sizeof(triScore[0]));
+	bool *triEmitted = (bool *)R_ClearedStaticAlloc(numTris * sizeof(triEmitted[0]));
+	for(int i = 0; i < numTris; i++)
+	{
+		triScore[i] = vertScore[indexes[i * 3 + 0]] + vertScore[indexes[i * 3 + 1]] + vertScore[indexes[i * 3 + 2]];
+	}
+
+	int cache[FORSYTH_CACHE_SIZE + 3];
+	int newCache[FORSYTH_CACHE_SIZE + 3];
+	int cacheCount = 0;
+
+	int *triOrder = (int *)R_StaticAlloc(numTris * sizeof(triOrder[0]));
+
+	int bestTri = -1;
+	int inputCursor = 0;
+	for(int outTri = 0; outTri < numTris; outTri++)
+	{
+		if(bestTri < 0)
+		{
+			// nothing in the cache has any triangles left, so continue with
+			// the next triangle in input order
+			while(triEmitted[inputCursor])
+			{
+				inputCursor++;
+			}
+			bestTri = inputCursor;
+		}
+
+		triOrder[outTri] = bestTri;
+		triEmitted[bestTri] = true;
+
+		// the triangle vertexes go to the front of the cache, followed by
+		// the previous contents without them
+		int newCacheCount = 0;
+		for(int j = 0; j < 3; j++)
+		{
+			const int v = indexes[bestTri * 3 + j];
+			newCache[newCacheCount++] = v;
+
+			// remove the triangle from the adjacency of the vertex
+			int *adj = adjTris + firstAdjTri[v];
+			for(int k = 0; k < numActiveTris[v]; k++)
+			{
+				if(adj[k] == bestTri)
+				{
+					adj[k] = adj[numActiveTris[v] - 1];
+					break;
+				}
+			}
+			numActiveTris[v]--;
+		}
+		for(int j = 0; j < cacheCount; j++)
+		{
+			const int v = cache[j];
+			if(v != newCache[0] && v != newCache[1] && v != newCache[2])
+			{
+				newCache[newCacheCount++] = v;
+			}
+		}
+
+		// update the scores of everything that was touched, the vertexes
+		// that fell out of the cache get their out-of-cache scores
+		for(int j = 0; j < newCacheCount; j++)
+		{
+			const int v = newCache[j];
+			cachePosition[v] = (j < FORSYTH_CACHE_SIZE) ? j : -1;
+			vertScore[v] = R_VertexCacheScore(cachePosition[v], numActiveTris[v]);
+		}
+
+		bestTri = -1;
+		float bestScore = -1.0f;
+		for(int j = 0; j < newCacheCount; j++)
+		{
+			const int v = newCache[j];
+			const int *adj = adjTris + firstAdjTri[v];
+			for(int k = 0; k < numActiveTris[v]; k++)
+			{
+				const int t = adj[k];
+				const float score = vertScore[indexes[t * 3 + 0]] + vertScore[indexes[t * 3 + 1]] + vertScore[indexes[t * 3 + 2]];
+				triScore[t] = score;
+				if(score > bestScore)
+				{
+					bestScore = score;
+					bestTri = t;
+				}
+			}
+		}
+
+		cacheCount = Min(newCacheCount, FORSYTH_CACHE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(cache[0]));
+	}
+
+	// apply the new triangle order
+	triIndex_t *newIndexes = (triIndex_t *)R_StaticAlloc(numIndexes * sizeof(newIndexes[0]));
+	for(int i = 0; i < numTris; i++)
+	{
+		for(int j = 0; j < 3; j++)
+		{
+			newIndexes[i * 3 + j] = indexes[triOrder[i] * 3 + j];
+		}
+	}
+	memcpy(indexes, newIndexes, numIndexes * sizeof(indexes[0]));
+
+	if(silIndexes != nullptr)
+	{
+		for(int i = 0; i < numTris; i++)
+		{
+			for(int j = 0; j < 3; j++)
+			{
+				newIndexes[i * 3 + j] = silIndexes[triOrder[i] * 3 + j];
+			}
+		}
+		memcpy(silIndexes, newIndexes, numIndexes * sizeof(silIndexes[0]));
+	}
+
+	R_StaticFree(newIndexes);
+	R_StaticFree(triOrder);
+	R_StaticFree(triEmitted);
+	R_StaticFree(triScore);
+	R_StaticFree(vertScore);
+	R_StaticFree(cachePosition);
+	R_StaticFree(adjTris);
+	R_StaticFree(firstAdjTri);
+	R_StaticFree(numActiveTris);
+}
+
+struct triCluster_t
+{
+	int		firstTri;
+	int		numTris;
+	float	sortKey;
+};
+
+/*
+=================
+ClusterSort
+=================
+*/
+static int ClusterSort(const void *a, const void *b)
+{
+	const float keyA = ((const triCluster_t *)a)->sortKey;
+	const float keyB = ((const triCluster_t *)b)->sortKey;
+
+	// outward facing clusters first
+	if(keyA > keyB)
+	{
+		return -1;
+	}
+	if(keyA < keyB)
+	{
+		return 1;
+	}
+	// keep the sort stable
+	return ((const triCluster_t *)a)->firstTri - ((const triCluster_t *)b)->firstTri;
+}
+
+/*
+=================
+R_OptimizeOverdraw
+
+Splits the vertex cache optimized triangle list where the cache gets flushed
+anyway, so the cluster order can be changed without a noticeable ACMR loss,
+then sorts the clusters by how much they face away from the mesh center.
+Clusters on the outside of a convex-ish mesh will then occlude the ones
+behind them.
+=================
+*/
+static void R_OptimizeOverdraw(srfTriangles_t *tri)
+{
+	const int numTris = tri->numIndexes / 3;
+	if(numTris < 2)
+	{
+		return;
+	}
+
+	// find the hard cluster boundaries, a triangle that misses with all
+	// of its vertexes starts a new cluster
+	idList<triCluster_t> clusters;
+	int *cacheTime = (int *)R_StaticAlloc(tri->numVerts * sizeof(cacheTime[0]));
+	for(int i = 0; i < tri->numVerts; i++)
+	{
+		cacheTime[i] = -OVERDRAW_CACHE_SIZE - 1;
+	}
+	int misses = 0;
+	for(int i = 0; i < numTris; i++)
+	{
+		int triMisses = 0;
+		for(int j = 0; j < 3; j++)
+		{
+			const int v = tri->indexes[i * 3 + j];
+			if(misses - cacheTime[v] > OVERDRAW_CACHE_SIZE)
+			{
+				cacheTime[v] = misses;
+				misses++;
+				triMisses++;
+			}
+		}
+		if(triMisses == 3 || clusters.Num() == 0)
+		{
+			triCluster_t &cluster = clusters.Alloc();
+			cluster.firstTri = i;
+			cluster.numTris = 0;
+			cluster.sortKey = 0.0f;
+		}
+		clusters[clusters.Num() - 1].numTris++;
+	}
+	R_StaticFree(cacheTime);
+
+	if(clusters.Num() < 2)
+	{
+		return;
+	}
+
+	// area weighted mesh center
+	idVec3 meshCenter = vec3_origin;
+	float meshArea = 0.0f;
+	for(int i = 0; i < tri->numIndexes; i += 3)
+	{
+		const idVec3 &a = tri->verts[tri->indexes[i + 0]].xyz;
+		const idVec3 &b = tri->verts[tri->indexes[i + 1]].xyz;
+		const idVec3 &c = tri->verts[tri->indexes[i + 2]].xyz;
+		const float area = ((b - a).Cross(c - a)).Length();
+		meshCenter += (a + b + c) * (area / 3.0f);
+		meshArea += area;
+	}
+	if(meshArea <= 0.0f)
+	{
+		return;
+	}
+	meshCenter /= meshArea;
+
+	for(int i = 0; i < clusters.Num(); i++)
+	{
+		triCluster_t &cluster = clusters[i];
+
+		idVec3 center = vec3_origin;
+		idVec3 normal = vec3_origin;
+		float area = 0.0f;
+		for(int t = cluster.firstTri; t < cluster.firstTri + cluster.numTris; t++)
+		{
+			const idVec3 &a = tri->verts[tri->indexes[t * 3 + 0]].xyz;
+			const idVec3 &b = tri->verts[tri->indexes[t * 3 + 1]].xyz;
+			const idVec3 &c = tri->verts[tri->indexes[t * 3 + 2]].xyz;
+			// same winding as the face normals in R_DeriveNormalsAndTangents,
+			// the length is twice the area, which cancels out in the center
+			const idVec3 cross = (c - a).Cross(b - a);
+			const float triArea = cross.Length();
+			center += (a + b + c) * (triArea / 3.0f);
+			normal += cross;
+			area += triArea;
+		}
+		if(area > 0.0f)
+		{
+			center /= area;
+		}
+		normal.Normalize();
+
+		cluster.sortKey = (center - meshCenter) * normal;
+	}
+
+	qsort(clusters.Ptr(), clusters.Num(), sizeof(triCluster_t), ClusterSort);
+
+	triIndex_t *newIndexes = (triIndex_t *)R_StaticAlloc(tri->numIndexes * sizeof(newIndexes[0]));
+	triIndex_t *newSilIndexes = (triIndex_t *)R_StaticAlloc(tri->numIndexes * sizeof(newSilIndexes[0]));
+	int numIndexes = 0;
+	for(int i = 0; i < clusters.Num(); i++)
+	{
+		const int first = clusters[i].firstTri * 3;
+		const int count = clusters[i].numTris * 3;
+		memcpy(newIndexes + numIndexes, tri->indexes + first, count * sizeof(newIndexes[0]));
+		memcpy(newSilIndexes + numIndexes, tri->silIndexes + first, count * sizeof(newSilIndexes[0]));
+		numIndexes += count;
+	}
+	assert(numIndexes == tri->numIndexes);
+	memcpy(tri->indexes, newIndexes, tri->numIndexes * sizeof(tri->indexes[0]));
+	memcpy(tri->silIndexes, newSilIndexes, tri->numIndexes * sizeof(tri->silIndexes[0]));
+
+	R_StaticFree(newSilIndexes);
+	R_StaticFree(newIndexes);
+}
+
+/*
+=================
+R_OptimizeVertexFetch
+
+Reorders the vertexes in the order they are first referenced by the indexes.
+Vertexes that are not referenced by any triangle are moved to the end.
+=================
+*/
+static void R_OptimizeVertexFetch(srfTriangles_t *tri)
+{
+	int *remap = (int *)R_StaticAlloc(tri->numVerts * sizeof(remap[0]));
+	for(int i = 0; i < tri->numVerts; i++)
+	{
+		remap[i] = -1;
+	}
+
+	int numRemapped = 0;
+	for(int i = 0; i < tri->numIndexes; i++)
+	{
+		const int v = tri->indexes[i];
+		if(remap[v] == -1)
+		{
+			remap[v] = numRemapped++;
+		}
+	}
+	for(int i = 0; i < tri->numVerts; i++)
+	{
+		if(remap[i] == -1)
+		{
+			remap[i] = numRemapped++;
+		}
+	}
+	assert(numRemapped == tri->numVerts);
+
+	idDrawVert *newVerts = (idDrawVert *)R_StaticAlloc(tri->numVerts * sizeof(newVerts[0]));
+	for(int i = 0; i < tri->numVerts; i++)
+	{
+		newVerts[remap[i]] = tri->verts[i];
+	}
+	memcpy(tri->verts, newVerts, tri->numVerts * sizeof(tri->verts[0]));
+
+	// silIndexes still reference a vertex with the same xyz after the remap
+	for(int i = 0; i < tri->numIndexes; i++)
+	{
+		tri->indexes[i] = remap[tri->indexes[i]];
+		tri->silIndexes[i] = remap[tri->silIndexes[i]];
+	}
+
+	R_StaticFree(newVerts);
+	R_StaticFree(remap);
+}
+
+/*
+=================
+R_TriangleOrderIsVisible
+
+Translucent and blended surfaces are drawn in index order, so changing the
+triangle order would change how they look. Deformed surfaces are left alone
+too, since autosprite and tube deforms expect every quad as 4 consecutive
+verts and 6 consecutive indexes.
+=================
+*/
+static bool R_TriangleOrderIsVisible(const idMaterial *material)
+{
+	if(material == nullptr || material->Coverage() != MC_OPAQUE)
+	{
+		return true;
+	}
+
+	if(material->Deform() != DFRM_NONE)
+	{
+		return true;
+	}
+
+	for(int i = 0; i < material->GetNumStages(); i++)
+	{
+		const uint64 blendBits = material->GetStage(i)->drawStateBits & (GLS_SRCBLEND_BITS | GLS_DSTBLEND_BITS);
+		if(blendBits != (GLS_SRCBLEND_ONE | GLS_DSTBLEND_ZERO))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+=================
+R_OptimizeTriangles
+
+silIndexes must have already been calculated, and the sil edges, mirrored
+and dup verts must not have been created yet.
+
+Surfaces without a material or with a translucent, blended or deformed one are left alone.
+=================
+*/
+void R_OptimizeTriangles(srfTriangles_t *tri, const idMaterial *material, triOptimizeStats_t *stats)
+{
+	if(tri->referencedVerts || tri->referencedIndexes || tri->numIndexes < 3)
+	{
+		return;
+	}
+
+	if(R_TriangleOrderIsVisible(material))
+	{
+		return;
+	}
+
+	assert(tri->silIndexes != nullptr);
+	assert(tri->silEdges == nullptr && tri->mirroredVerts == nullptr && tri->dupVerts == nullptr);
+
+	if(stats != nullptr)
+	{
+		stats->numTris += tri->numIndexes / 3;
+		stats->numVerts += tri->numVerts;
+		stats->cacheMissesBefore += R_CalcVertexCacheMisses(tri->indexes, tri->numIndexes, tri->numVerts, ACMR_CACHE_SIZE);
+	}
+
+	R_OptimizeTriangleOrder(tri->indexes, tri->silIndexes, tri->numIndexes, tri->numVerts);
+
+	R_OptimizeOverdraw(tri);
+
+	R_OptimizeVertexFetch(tri);
+
+	if(stats != nullptr)
+	{
+		stats->cacheMissesAfter += R_CalcVertexCacheMisses(tri->indexes, tri->numIndexes, tri->numVerts, ACMR_CACHE_SIZE);
+	}
+}
+
+/*
+===================================================================================
+
+LEVEL OF DETAIL
+
+Static surfaces get a chain of simplified index lists that share the vertexes
+of the full detail surface, so selecting a LOD in the front end only swaps
+the index buffer.
+
+The simplifier collapses edges by quadric error (Garland / Heckbert), always
+onto an existing vertex.  Vertexes on borders and on texture / normal seams
+(several vertexes with the same xyz, see R_CreateSilIndexes) are locked, so
+the silhouette and the texture mapping of the surface are preserved.
+===================================================================================
+*/
+
+// each LOD targets this fraction of the triangles of the previous one
+static const float	LOD_TRIANGLE_RATIO = 0.5f;
+
+// surfaces with less triangles than this don't get LODs
+static const int	LOD_MIN_TRIANGLES = 64;
+
+// give up on the chain when a level can't get below this fraction of the previous one
+static const float	LOD_MIN_REDUCTION = 0.8f;
+
+// reject collapses that turn a triangle by more than ~75 degrees
+static const float	LOD_MAX_NORMAL_CHANGE = 0.25f;
+
+// plane equation error quadric, area weighted
+struct errorQuadric_t
+{
+	float	a2, ab, ac, ad;
+	float	b2, bc, bd;
+	float	c2, cd;
+	float	d2;
+	float	weight;
+
+	void	Clear()
+	{
+		memset(this, 0, sizeof(*this));
+	}
+
+	void	AddPlane(const idVec3 &n, const float d, const float w)
+	{
+		a2 += n.x * n.x * w;
+		ab += n.x * n.y * w;
+		ac += n.x * n.z * w;
+		ad += n.x * d * w;
+		b2 += n.y * n.y * w;
+		bc += n.y * n.z * w;
+		bd += n.y * d * w;
+		c2 += n.z * n.z * w;
+		cd += n.z * d * w;
+		d2 += d * d * w;
+		weight += w;
+	}
+
+	void	Add(const errorQuadric_t &q)
+	{
+		a2 += q.a2;
+		ab += q.ab;
+		ac += q.ac;
+		ad += q.ad;
+		b2 += q.b2;
+		bc += q.bc;
+		bd += q.bd;
+		c2 += q.c2;
+		cd += q.cd;
+		d2 += q.d2;
+		weight += q.weight;
+	}
+
+	// sum of the squared distances of p to all the planes
+	float	Eval(const idVec3 &p) const
+	{
+		const float rx = a2 * p.x + ab * p.y + ac * p.z + ad;
+		const float ry = ab * p.x + b2 * p.y + bc * p.z + bd;
+		const float rz = ac * p.x + bc * p.y + c2 * p.z + cd;
+		const float r = rx * p.x + ry * p.y + rz * p.z + (ad * p.x + bd * p.y + cd * p.z + d2);
+		return Max(r, 0.0f);
+	}
+};
+
+struct lodCollapse_t
+{
+	int		vertex;		// collapses away
+	int		target;		// onto this vertex
+	float	cost;		// squared distance
+};
+
+/*
+=================
+CollapseSort
+=================
+*/
+static int CollapseSort(const void *a, const void *b)
+{
+	const float costA = ((const lodCollapse_t *)a)->cost;
+	const float costB = ((const lodCollapse_t *)b)->cost;
+
+	if(costA < costB)
+	{
+		return -1;
+	}
+	if(costA > costB)
+	{
+		return 1;
+	}
+	return ((const lodCollapse_t *)a)->vertex - ((const lodCollapse_t *)b)->vertex;
+}
+
+/*
+=================
+R_LodTriangleNormal
+
+Same winding as the face normals in R_DeriveNormalsAndTangents, not normalized.
+=================
+*/
+static ID_INLINE idVec3 R_LodTriangleNormal(const idVec3 &a, const idVec3 &b, const idVec3 &c)
+{
+	return (c - a).Cross(b - a);
+}
+
+/*
+=================
+R_SimplifyIndexes
+
+Simplifies srcIndexes down to about targetIndexes and returns the number of
+dstIndexes, which must be able to hold numSrcIndexes.  The quadrics are
+accumulated over collapses and error is the largest collapse distance.
+
+vertGroup maps every vertex to the first vertex with the same xyz.
+=================
+*/
+static int R_SimplifyIndexes(const srfTriangles_t *tri, const int *vertGroup, const bool *lockedVerts, errorQuadric_t *quadrics,
+                             const triIndex_t *srcIndexes, const int numSrcIndexes, const int targetIndexes,
+                             triIndex_t *dstIndexes, float &error)
+{
+	const int numVerts = tri->numVerts;
+
+	memcpy(dstIndexes, srcIndexes, numSrcIndexes * sizeof(dstIndexes[0]));
+	int numIndexes = numSrcIndexes;
+
+	int *numVertTris = (int *)R_StaticAlloc(numVerts * sizeof(numVertTris[0]));
+	int *firstVertTri = (int *)R_StaticAlloc((numVerts + 1) * sizeof(firstVertTri[0]));
+	int *vertTris = (int *)R_StaticAlloc(numSrcIndexes * sizeof(vertTris[0]));
+	bool *borderVerts = (bool *)R_StaticAlloc(numVerts * sizeof(borderVerts[0]));
+	bool *touched = (bool *)R_StaticAlloc(numVerts * sizeof(touched[0]));
+	int *remap = (int *)R_StaticAlloc(numVerts * sizeof(remap[0]));
+	lodCollapse_t *collapses = (lodCollapse_t *)R_StaticAlloc(numVerts * sizeof(collapses[0]));
+
+	idHashIndex edgeHash(1024, numSrcIndexes);
+	idList<int> edges;	// welded vertex pairs
+	idList<int> edgeCounts;
+
+	while(numIndexes > targetIndexes)
+	{
+		const int numTris = numIndexes / 3;
+
+		// welded vertex to triangle adjacency
+		memset(numVertTris, 0, numVerts * sizeof(numVertTris[0]));
+		for(int i = 0; i < numIndexes; i++)
+		{
+			numVertTris[vertGroup[dstIndexes[i]]]++;
+		}
+		firstVertTri[0] = 0;
+		for(int i = 0; i < numVerts; i++)
+		{
+			firstVertTri[i + 1] = firstVertTri[i] + numVertTris[i];
+			numVertTris[i] = 0;
+		}
+		for(int i = 0; i < numIndexes; i++)
+		{
+			const int v = vertGroup[dstIndexes[i]];
+			vertTris[firstVertTri[v] + numVertTris[v]++] = i / 3;
+		}
+
+		// every edge that isn't shared by exactly two triangles locks its vertexes
+		edgeHash.Clear();
+		edges.SetNum(0);
+		edgeCounts.SetNum(0);
+		for(int i = 0; i < numIndexes; i++)
+		{
+			int v1 = vertGroup[dstIndexes[i]];
+			int v2 = vertGroup[dstIndexes[(i % 3 == 2) ? i - 2 : i + 1]];
+			if(v1 > v2)
+			{
+				const int temp = v1;
+				v1 = v2;
+				v2 = temp;
+			}
+			const int hashKey = edgeHash.GenerateKey(v1, v2);
+			int e;
+			for(e = edgeHash.First(hashKey); e >= 0; e = edgeHash.Next(e))
+			{
+				if(edges[e * 2 + 0] == v1 && edges[e * 2 + 1] == v2)
+				{
+					edgeCounts[e]++;
+					break;
+				}
+			}
+			if(e < 0)
+			{
+				edgeHash.Add(hashKey, edgeCounts.Num());
+				edges.Append(v1);
+				edges.Append(v2);
+				edgeCounts.Append(1);
+			}
+		}
+		memset(borderVerts, 0, numVerts * sizeof(borderVerts[0]));
+		for(int e = 0; e < edgeCounts.Num(); e++)
+		{
+			if(edgeCounts[e] != 2)
+			{
+				borderVerts[edges[e * 2 + 0]] = true;
+				borderVerts[edges[e * 2 + 1]] = true;
+			}
+		}
+
+		// find the cheapest collapse for every free vertex
+		int numCollapses = 0;
+		for(int v = 0; v < numVerts; v++)
+		{
+			if(lockedVerts[v] || borderVerts[v] || numVertTris[v] == 0)
+			{
+				continue;
+			}
+			lodCollapse_t best;
+			best.vertex = v;
+			best.target = -1;
+			best.cost = idMath::INFINITY;
+
+			errorQuadric_t q = quadrics[v];
+			const int *adj = vertTris + firstVertTri[v];
+			for(int k = 0; k < numVertTris[v]; k++)
+			{
+				const triIndex_t *t = dstIndexes + adj[k] * 3;
+				for(int j = 0; j < 3; j++)
+				{
+					const int target = t[j];
+					if(target == v)
+					{
+						continue;
+					}
+					errorQuadric_t sum = q;
+					sum.Add(quadrics[vertGroup[target]]);
+					const float cost = sum.Eval(tri->verts[target].xyz) / Max(sum.weight, idMath::FLT_SMALLEST_NON_DENORMAL);
+					if(cost < best.cost)
+					{
+						best.cost = cost;
+						best.target = target;
+					}
+				}
+			}
+			if(best.target >= 0)
+			{
+				collapses[numCollapses++] = best;
+			}
+		}
+		if(numCollapses == 0)
+		{
+			break;
+		}
+
+		qsort(collapses, numCollapses, sizeof(collapses[0]), CollapseSort);
+
+		for(int i = 0; i < numVerts; i++)
+		{
+			remap[i] = i;
+		}
+		memset(touched, 0, numVerts * sizeof(touched[0]));
+
+		// apply the collapses that don't overlap, two triangles go away with each one
+		int numRemovedTris = 0;
+		const int numTrisToRemove = numTris - targetIndexes / 3;
+		for(int c = 0; c < numCollapses && numRemovedTris < numTrisToRemove; c++)
+		{
+			const int v = collapses[c].vertex;
+			const int target = collapses[c].target;
+			const int targetGroup = vertGroup[target];
+			if(touched[v] || touched[targetGroup])
+			{
+				continue;
+			}
+
+			// don't fold any of the remaining triangles over
+			const idVec3 &newPos = tri->verts[target].xyz;
+			const int *adj = vertTris + firstVertTri[v];
+			bool flipped = false;
+			for(int k = 0; k < numVertTris[v] && !flipped; k++)
+			{
+				const triIndex_t *t = dstIndexes + adj[k] * 3;
+				const int g0 = vertGroup[t[0]];
+				const int g1 = vertGroup[t[1]];
+				const int g2 = vertGroup[t[2]];
+				if(g0 == targetGroup || g1 == targetGroup || g2 == targetGroup)
+				{
+					continue;	// goes away
+				}
+				const idVec3 &p0 = tri->verts[t[0]].xyz;
+				const idVec3 &p1 = tri->verts[t[1]].xyz;
+				const idVec3 &p2 = tri->verts[t[2]].xyz;
+				const idVec3 oldNormal = R_LodTriangleNormal(p0, p1, p2);
+				const idVec3 newNormal = R_LodTriangleNormal(g0 == v ? newPos : p0, g1 == v ? newPos : p1, g2 == v ? newPos : p2);
+				if(oldNormal * newNormal <= LOD_MAX_NORMAL_CHANGE * oldNormal.Length() * newNormal.Length())
+				{
+					flipped = true;
+				}
+			}
+			if(flipped)
+			{
+				continue;
+			}
+
+			// the whole neighborhood has to stay fixed for the rest of the pass
+			for(int k = 0; k < numVertTris[v]; k++)
+			{
+				const triIndex_t *t = dstIndexes + adj[k] * 3;
+				for(int j = 0; j < 3; j++)
+				{
+					touched[vertGroup[t[j]]] = true;
+				}
+				if(vertGroup[t[0]] == targetGroup || vertGroup[t[1]] == targetGroup || vertGroup[t[2]] == targetGroup)
+				{
+					numRemovedTris++;
+				}
+			}
+
+			remap[v] = target;
+			quadrics[targetGroup].Add(quadrics[v]);
+			error = Max(error, idMath::Sqrt(collapses[c].cost));
+		}
+		if(numRemovedTris == 0)
+		{
+			break;
+		}
+
+		// rewrite the triangles and drop the ones that became degenerate
+		int newNumIndexes = 0;
+		for(int i = 0; i < numIndexes; i += 3)
+		{
+			const int a = remap[dstIndexes[i + 0]];
+			const int b = remap[dstIndexes[i + 1]];
+			const int c = remap[dstIndexes[i + 2]];
+			if(vertGroup[a] == vertGroup[b] || vertGroup[a] == vertGroup[c] || vertGroup[b] == vertGroup[c])
+			{
+				continue;
+			}
+			dstIndexes[newNumIndexes + 0] = a;
+			dstIndexes[newNumIndexes + 1] = b;
+			dstIndexes[newNumIndexes + 2] = c;
+			newNumIndexes += 3;
+		}
+		numIndexes = newNumIndexes;
+	}
+
+	R_StaticFree(collapses);
+	R_StaticFree(remap);
+	R_StaticFree(touched);
+	R_StaticFree(borderVerts);
+	R_StaticFree(vertTris);
+	R_StaticFree(firstVertTri);
+	R_StaticFree(numVertTris);
+
+	return numIndexes;
+}
+
+/*
+=================
+R_CreateTriSurfLods
+
+Builds up to MAX_TRI_LODS simplified index lists, each one with about half
+the triangles of the previous one.  silIndexes must have been calculated.
+=================
+*/
+void R_CreateTriSurfLods(srfTriangles_t *tri)
+{
+	R_FreeStaticTriSurfLods(tri);
+
+	if(tri->referencedIndexes || tri->verts == nullptr || tri->silIndexes == nullptr || tri->numIndexes / 3 < LOD_MIN_TRIANGLES)
+	{
+		return;
+	}
+
+	const int numVerts = tri->numVerts;
+
+	// weld on xyz, and lock every vertex that shares its xyz with another one
+	// so texture seams and normal creases stay intact
+	int *vertGroup = (int *)R_StaticAlloc(numVerts * sizeof(vertGroup[0]));
+	int *groupSize = (int *)R_ClearedStaticAlloc(numVerts * sizeof(groupSize[0]));
+	bool *lockedVerts = (bool *)R_ClearedStaticAlloc(numVerts * sizeof(lockedVerts[0]));
+	for(int i = 0; i < numVerts; i++)
+	{
+		vertGroup[i] = i;
+	}
+	for(int i = 0; i < tri->numIndexes; i++)
+	{
+		vertGroup[tri->indexes[i]] = tri->silIndexes[i];
+	}
+	for(int i = 0; i < numVerts; i++)
+	{
+		groupSize[vertGroup[i]]++;
+	}
+	for(int i = 0; i < numVerts; i++)
+	{
+		lockedVerts[i] = (groupSize[vertGroup[i]] > 1);
+	}
+
+	// one quadric per welded vertex from the full detail triangles
+	errorQuadric_t *quadrics = (errorQuadric_t *)R_StaticAlloc(numVerts * sizeof(quadrics[0]));
+	for(int i = 0; i < numVerts; i++)
+	{
+		quadrics[i].Clear();
+	}
+	for(int i = 0; i < tri->numIndexes; i += 3)
+	{
+		const idVec3 &a = tri->verts[tri->indexes[i + 0]].xyz;
+		const idVec3 &b = tri->verts[tri->indexes[i + 1]].xyz;
+		const idVec3 &c = tri->verts[tri->indexes[i + 2]].xyz;
+		idVec3 normal = R_LodTriangleNormal(a, b, c);
+		const float area = normal.Normalize() * 0.5f;
+		if(area <= 0.0f)
+		{
+			continue;
+		}
+		const float d = -(normal * a);
+		for(int j = 0; j < 3; j++)
+		{
+			quadrics[vertGroup[tri->indexes[i + j]]].AddPlane(normal, d, area);
+		}
+	}
+
+	triLod_t lods[MAX_TRI_LODS];
+	int numLods = 0;
+	triIndex_t *scratch = (triIndex_t *)R_StaticAlloc(tri->numIndexes * sizeof(scratch[0]));
+	const triIndex_t *srcIndexes = tri->indexes;
+	int numSrcIndexes = tri->numIndexes;
+	float error = 0.0f;
+
+	while(numLods < MAX_TRI_LODS && numSrcIndexes / 3 >= LOD_MIN_TRIANGLES)
+	{
+		const int targetIndexes = idMath::Ftoi(numSrcIndexes / 3 * LOD_TRIANGLE_RATIO) * 3;
+		const int numIndexes = R_SimplifyIndexes(tri, vertGroup, lockedVerts, quadrics, srcIndexes, numSrcIndexes, targetIndexes, scratch, error);
+		if(numIndexes == 0 || numIndexes > numSrcIndexes * LOD_MIN_REDUCTION)
+		{
+			break;
+		}
+
+		triLod_t &lod = lods[numLods++];
+		lod.numIndexes = numIndexes;
+		lod.indexes = (triIndex_t *)Mem_Alloc16(numIndexes * sizeof(triIndex_t), TAG_TRI_LODS);
+		lod.error = error;
+		lod.indexCache = 0;
+		memcpy(lod.indexes, scratch, numIndexes * sizeof(lod.indexes[0]));
+
+		R_OptimizeTriangleOrder(lod.indexes, nullptr, lod.numIndexes, numVerts);
+
+		srcIndexes = lod.indexes;
+		numSrcIndexes = lod.numIndexes;
+	}
+
+	if(numLods > 0)
+	{
+		R_AllocStaticTriSurfLods(tri, numLods);
+		memcpy(tri->lods, lods, numLods * sizeof(tri->lods[0]));
+	}
+
+	R_StaticFree(scratch);
+	R_StaticFree(quadrics);
+	R_StaticFree(lockedVerts);
+	R_StaticFree(groupSize);
+	R_StaticFree(vertGroup);
+}
+
+/*
+=================
+R_SelectTriSurfLod
+
+Returns the coarsest LOD whose simplification error projects to less than
+maxPixelError pixels at distance, or -1 for the full detail surface.
+pixelScale is the projection scale in pixels at a distance of one unit.
+=================
+*/
+int R_SelectTriSurfLod(const srfTriangles_t *tri, const float distance, const float pixelScale, const float maxPixelError)
+{
+	if(tri->numLods == 0 || distance <= 0.0f)
+	{
+		return -1;
+	}
+
+	const float maxError = maxPixelError * distance / pixelScale;
+
+	int lod = -1;
+	for(int i = 0; i < tri->numLods; i++)
+	{
+		if(tri->lods[i].error > maxError)
+		{
+			break;
+		}
+		lod = i;
+	}
+	return lod;
+}
+
 /*
 =================
 R_CleanupTriangles
@@ -1943,7 +3045,7 @@ R_CleanupTriangles
 FIXME: allow createFlat and createSmooth normals, as well as explicit
 =================
 */
-void R_CleanupTriangles(srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents)
+void R_CleanupTriangles(srfTriangles_t *tri, bool createNormals, bool identifySilEdges, bool useUnsmoothedTangents, const idMaterial *material, triOptimizeStats_t *optimizeStats)
 {
 	R_RangeCheckIndexes(tri);
 
@@ -1953,6 +3055,11 @@ void R_CleanupTriangles(srfTriangles_t *tri, bool createNormals, bool identifySi
 
 	R_RemoveDegenerateTriangles(tri);
 
+	if(r_optimizeMeshes.GetInteger() > 0)
+	{
+		R_OptimizeTriangles(tri, material, optimizeStats);
+	}
+
 	R_TestDegenerateTextureSpace(tri);
 
 	//	R_RemoveUnusedVerts( tri );
@@ -2203,6 +3310,11 @@ void R_CreateStaticBuffersForTri(srfTriangles_t &tri)
 		tri.indexCache = vertexCache.AllocStaticIndex(tri.indexes, ALIGN(tri.numIndexes * sizeof(tri.indexes[0]), INDEX_CACHE_ALIGN));
 	}
 
+	for(int i = 0; i < tri.numLods; i++)
+	{
+		tri.lods[i].indexCache = vertexCache.AllocStaticIndex(tri.lods[i].indexes, ALIGN(tri.lods[i].numIndexes * sizeof(tri.lods[i].indexes[0]), INDEX_CACHE_ALIGN));
+	}
+
 	// vertex cache
 	if(tri.verts != nullptr)
 	{
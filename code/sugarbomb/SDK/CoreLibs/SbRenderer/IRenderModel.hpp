@@ -83,6 +83,17 @@ struct dominantTri_t
 	float						normalizationScale[3];
 };
 
+// simplified index list that uses the verts of the full detail surface
+struct triLod_t
+{
+	int							numIndexes;
+	triIndex_t* 				indexes;				// allocated with special allocator
+	float						error;					// largest simplification error in model units
+	vertCacheHandle_t			indexCache;				// GL_INDEX_TYPE
+};
+
+const int MAX_TRI_LODS = 4;
+
 // our only drawing geometry type
 struct srfTriangles_t
 {
@@ -116,6 +127,9 @@ struct srfTriangles_t
 	
 	dominantTri_t* 				dominantTris;			// [numVerts] for deformed surface fast tangent calculation
 	
+	int							numLods;				// number of simplified index lists, coarser ones last
+	triLod_t* 					lods;					// only created for static surfaces
+	
 	int							numShadowIndexesNoFrontCaps;	// shadow volumes with front caps omitted
 	int							numShadowIndexesNoCaps;			// shadow volumes with the front and rear caps omitted
 	
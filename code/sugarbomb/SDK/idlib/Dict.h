@@ -55,6 +55,11 @@ Keys are compared case-insensitive.
 
 Does not allocate memory until the first key/value pair is added.
 
+Keys are interned in a permanent pool shared by all dictionaries. InternKey
+returns a handle to a key that can be kept and used for lookups without
+hashing or comparing strings. The key and value pools can be used from any
+thread, a single dictionary can only be used from one thread at a time.
+
 ===============================================================================
 */
 
@@ -105,6 +110,9 @@ public:
 	}
 };
 
+// handle to an interned key, valid until idDict::Shutdown
+typedef const idPoolStr* idDictKey;
+
 class idDict
 {
 public:
@@ -146,6 +154,7 @@ public:
 	void				SetVec4( const char* key, const idVec4& val );
 	void				SetAngles( const char* key, const idAngles& val );
 	void				SetMatrix( const char* key, const idMat3& val );
+	void				Set( idDictKey key, const char* value );
 	
 	// these return default values of 0.0, 0 and false
 	const char* 		GetString( const char* key, const char* defaultString = "" ) const;
@@ -175,6 +184,13 @@ public:
 	bool				GetAngles( const char* key, const char* defaultString, idAngles& out ) const;
 	bool				GetMatrix( const char* key, const char* defaultString, idMat3& out ) const;
 	
+	// lookups by key handle
+	const char* 		GetString( idDictKey key, const char* defaultString = "" ) const;
+	float				GetFloat( idDictKey key, const float defaultFloat = 0.0f ) const;
+	int					GetInt( idDictKey key, const int defaultInt = 0 ) const;
+	bool				GetBool( idDictKey key, const bool defaultBool = false ) const;
+	idVec3				GetVector( idDictKey key, const char* defaultString = NULL ) const;
+	
 	int					GetNumKeyVals() const;
 	const idKeyValue* 	GetKeyVal( int index ) const;
 	// returns the key/value pair with the given key
@@ -183,6 +199,8 @@ public:
 	// returns the index to the key/value pair with the given key
 	// returns -1 if the key/value pair does not exist
 	int					FindKeyIndex( const char* key ) const;
+	const idKeyValue* 	FindKey( idDictKey key ) const;
+	int					FindKeyIndex( idDictKey key ) const;
 	// delete the key/value pair with the given key
 	void				Delete( const char* key );
 	// finds the next key/value pair with the given key prefix.
@@ -209,6 +227,9 @@ public:
 	static void			Init();
 	static void			Shutdown();
 	
+	// returns the handle of the key, adding it to the key pool if needed
+	static idDictKey	InternKey( const char* key );
+	
 	static void			ShowMemoryUsage_f( const idCmdArgs& args );
 	static void			ListKeys_f( const idCmdArgs& args );
 	static void			ListValues_f( const idCmdArgs& args );
@@ -407,6 +428,70 @@ ID_INLINE idMat3 idDict::GetMatrix( const char* key, const char* defaultString )
 	return out;
 }
 
+ID_INLINE const char* idDict::GetString( idDictKey key, const char* defaultString ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return kv->GetValue();
+	}
+	return defaultString;
+}
+
+ID_INLINE float idDict::GetFloat( idDictKey key, const float defaultFloat ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atof( kv->GetValue() );
+	}
+	return defaultFloat;
+}
+
+ID_INLINE int idDict::GetInt( idDictKey key, const int defaultInt ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atoi( kv->GetValue() );
+	}
+	return defaultInt;
+}
+
+ID_INLINE bool idDict::GetBool( idDictKey key, const bool defaultBool ) const
+{
+	const idKeyValue* kv = FindKey( key );
+	if( kv )
+	{
+		return atoi( kv->GetValue() ) != 0;
+	}
+	return defaultBool;
+}
+
+ID_INLINE const idKeyValue* idDict::FindKey( idDictKey key ) const
+{
+	const int i = FindKeyIndex( key );
+	if( i != -1 )
+	{
+		return &args[i];
+	}
+	return NULL;
+}
+
+ID_INLINE int idDict::FindKeyIndex( idDictKey key ) const
+{
+	// keys are interned, so the same key is always the same string
+	assert( key->GetPool() == &globalKeys );
+	for( int i = argHash.First( key->GetHash() ); i != -1; i = argHash.Next( i ) )
+	{
+		if( args[i].key == key )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
 ID_INLINE int idDict::GetNumKeyVals() const
 {
 	return args.Num();
@@ -67,6 +67,7 @@ ID_INLINE void		Mem_Free( void* ptr )
 
 void* 		Mem_ClearedAlloc( const size_t size, const memTag_t tag );
 char* 		Mem_CopyString( const char* in );
+int			Mem_GetNumAllocs();		// total number of allocations so far, for benchmarks
 // RB end
 
 ID_INLINE void* operator new( size_t s )
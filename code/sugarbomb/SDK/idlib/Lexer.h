@@ -139,6 +139,17 @@ typedef struct punctuation_s
 	int n;							// punctuation id
 } punctuation_t;
 
+// token read with idLexer::ReadTokenView
+typedef struct tokenView_s
+{
+	const char* text;					// not zero terminated, points into the script or the lexer's own token
+	int length;							// length of the text
+	int type;							// token type
+	int subtype;						// token sub type
+	int line;							// line in script the token was on
+	int linesCrossed;					// number of lines crossed in white space before token
+} tokenView_t;
+
 
 class idLexer
 {
@@ -168,6 +179,11 @@ public:
 	};
 	// read a token
 	int				ReadToken( idToken* token );
+	// read a token without copying it, names and plain strings point into the script, anything
+	// else into the lexer's own token. The view is valid until the next token is read
+	int				ReadTokenView( tokenView_t* view );
+	// copy the last token read with ReadTokenView into an idToken
+	void			MaterializeToken( const tokenView_t* view, idToken* token ) const;
 	// expect a certain token, reads the token when available
 	int				ExpectTokenString( const char* string );
 	// expect a certain token type
@@ -254,9 +270,13 @@ public:
 	void			Warning( VERIFY_FORMAT_STRING const char* str, ... );
 	// returns true if Error() was called with LEXFL_NOFATALERRORS or LEXFL_NOERRORS set
 	bool			HadError() const;
+	// append warnings to the list instead of printing them, nullptr prints them again
+	void			SetWarningList( idList<idStr>* list );
 	
 	// set the base folder to load files from
 	static void		SetBaseFolder( const char* path );
+	// scan white space, comments, names and strings 16 bytes at a time when SSE2 is available
+	static void		SetVectorScan( bool enable );
 	
 private:
 	int				loaded;					// set when a script file is loaded from file or memory
@@ -280,6 +300,7 @@ private:
 	idToken			token;					// available token
 	idLexer* 		next;					// next script in a chain
 	bool			hadError;				// set by idLexer::Error, even if the error is supressed
+	idList<idStr>* 	warningList;			// warnings are appended here instead of printed when set
 	
 	static char		baseFolder[ 256 ];		// base folder to load files from
 	
@@ -292,6 +313,7 @@ private:
 	int				ReadNumber( idToken* token );
 	int				ReadPunctuation( idToken* token );
 	int				ReadPrimitive( idToken* token );
+	int				ReadTokenText( idToken* token );
 	int				CheckString( const char* str ) const;
 	int				NumLinesCrossed();
 };
@@ -306,6 +306,9 @@ public:
 #include "Base64.h"
 #include "CmdArgs.h"
 
+// threading, used by the string pool
+#include "Thread.h"
+
 // containers
 #include "containers/Array.h"
 #include "containers/BTree.h"
@@ -334,7 +337,6 @@ public:
 #include "BitMsg.h"
 #include "MapFile.h"
 #include "Timer.h"
-#include "Thread.h"
 #include "Swap.h"
 #include "Callback.h"
 #include "ParallelJobList.h"
@@ -65,6 +65,29 @@ const float DEFAULT_CURVE_MAX_LENGTH_CD		= -1.0f;
 
 struct idDeclManager;
 
+/*
+===============================================================================
+
+	Strings of a binary map file. Every distinct material name, key and
+	value is written once and referenced by index.
+
+===============================================================================
+*/
+
+class idMapStringTable
+{
+public:
+	int						Intern( const char* string );
+	const idStrList&		GetStrings() const
+	{
+		return strings;
+	}
+	
+private:
+	idStrList				strings;
+	idHashIndex				hash;
+};
+
 class idMapPrimitive
 {
 public:
@@ -155,6 +178,8 @@ public:
 	static idMapBrush* 		Parse( idLexer& src, const idVec3& origin, bool newFormat = true, float version = CURRENT_MAP_VERSION );
 	static idMapBrush* 		ParseQ3( idLexer& src, const idVec3& origin );
 	bool					Write( idFile* fp, int primitiveNum, const idVec3& origin ) const;
+	static idMapBrush* 		ReadBinary( idFile* file, const idStrList& strings );
+	void					WriteBinary( idFile* file, idMapStringTable& strings ) const;
 	int						GetNumSides() const
 	{
 		return sides.Num();
@@ -183,6 +208,8 @@ public:
 	~idMapPatch() { }
 	static idMapPatch* 		Parse( idLexer& src, const idVec3& origin, bool patchDef3 = true, float version = CURRENT_MAP_VERSION );
 	bool					Write( idFile* fp, int primitiveNum, const idVec3& origin ) const;
+	static idMapPatch* 		ReadBinary( idFile* file, const idStrList& strings );
+	void					WriteBinary( idFile* file, idMapStringTable& strings ) const;
 	const char* 			GetMaterial() const
 	{
 		return material;
@@ -322,6 +349,9 @@ public:
 	static MapPolygonMesh*	ParseJSON( idDeclManager *apDeclManager, idLexer& src );
 	bool					WriteJSON( idFile* fp, int primitiveNum, const idVec3& origin ) const;
 	
+	static MapPolygonMesh*	ReadBinary( idDeclManager *apDeclManager, idFile* file, const idStrList& strings );
+	void					WriteBinary( idFile* file, idMapStringTable& strings ) const;
+	
 	
 	
 	int						GetNumVertices() const
@@ -411,6 +441,8 @@ public:
 	static idMapEntity* 	ParseJSON( idDeclManager *apDeclManager, idLexer& src );
 	bool					WriteJSON( idFile* fp, int entityNum, int numEntities ) const;
 	// RB end
+	static idMapEntity* 	ReadBinary( idDeclManager *apDeclManager, idFile* file, const idStrList& strings );
+	void					WriteBinary( idFile* file, idMapStringTable& strings ) const;
 	int						GetNumPrimitives() const
 	{
 		return primitives.Num();
@@ -444,6 +476,8 @@ public:
 	// normally this will use a .reg file instead of a .map file if it exists,
 	// which is what the game and dmap want, but the editor will want to always
 	// load a .map file
+	// unless osPath is set the map is loaded from generated/maps/*.bmap when that
+	// was written from the same source file, otherwise the .bmap is written after parsing
 	bool					Parse( idDeclManager *apDeclManager, const char* filename, bool ignoreRegion = false, bool osPath = false );
 	bool					Write( const char* fileName, const char* ext, bool fromBasePath = true );
 	
@@ -480,6 +514,11 @@ public:
 	}
 	// returns true if the file on disk changed
 	bool					NeedsReload();
+	// returns true if the last Parse read the binary version of the map
+	bool					LoadedFromBinary() const
+	{
+		return loadedFromBinary;
+	}
 	
 	int						AddEntity( idMapEntity* mapentity );
 	idMapEntity* 			FindEntity( const char* name );
@@ -499,9 +538,13 @@ protected:
 	idList<idMapEntity*, TAG_IDLIB_LIST_MAP>	entities;
 	idStr					name;
 	bool					hasPrimitiveData;
+	bool					loadedFromBinary;
 	
 private:
 	void					SetGeometryCRC();
+	bool					ParseText( idDeclManager *apDeclManager, bool ignoreRegion, bool osPath, idStr& sourceName );
+	bool					LoadBinary( idDeclManager *apDeclManager, const char* fileName, const char* sourceName, ID_TIME_T sourceTime );
+	bool					WriteBinary( const char* fileName, const char* sourceName ) const;
 };
 
 ID_INLINE idMapFile::idMapFile()
@@ -511,6 +554,7 @@ ID_INLINE idMapFile::idMapFile()
 	geometryCRC = 0;
 	entities.Resize( 1024, 256 );
 	hasPrimitiveData = false;
+	loadedFromBinary = false;
 }
 
 //} // namespace BFG
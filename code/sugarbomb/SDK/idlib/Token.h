@@ -113,6 +113,7 @@ private:
 	idToken* 		next;								// next token in chain, only used by idParser
 	
 	void			AppendDirty( const char a );		// append character without adding trailing zero
+	void			AppendDirty( const char* text, int length );	// append characters without adding trailing zero
 };
 
 ID_INLINE idToken::idToken() : type(), subtype(), line(), linesCrossed(), flags()
@@ -185,6 +186,13 @@ ID_INLINE void idToken::AppendDirty( const char a )
 	data[len++] = a;
 }
 
+ID_INLINE void idToken::AppendDirty( const char* text, int length )
+{
+	EnsureAlloced( len + length + 1, true );
+	memcpy( data + len, text, length );
+	len += length;
+}
+
 //} // namespace BFG
 
 #endif /* !__TOKEN_H__ */
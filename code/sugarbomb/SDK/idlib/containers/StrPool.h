@@ -40,6 +40,11 @@ If you have questions concerning this license or the applicable additional terms
 
 	idStrPool
 
+	All functions can be called from any thread. Reference counted strings are
+	spread over shards by hash, each with its own lock. A permanent pool never
+	frees a string before Clear, so lookups and inserts don't need a lock and
+	the returned strings are stable handles with a precomputed hash.
+
 ===============================================================================
 */
 
@@ -53,6 +58,8 @@ public:
 	idPoolStr()
 	{
 		numUsers = 0;
+		hash = 0;
+		next = nullptr;
 	}
 	~idPoolStr()
 	{
@@ -74,231 +81,74 @@ public:
 	{
 		return pool;
 	}
+	// returns the hash of the string, case insensitive if the pool is
+	int					GetHash() const
+	{
+		return hash;
+	}
 	
 private:
 	idStrPool* 			pool;
-	mutable int			numUsers;
+	mutable int			numUsers;		// not counted for permanent pools
+	int					hash;
+	idPoolStr* 			next;			// next string in the same bucket of a permanent pool
 };
 
 class idStrPool
 {
 public:
-	idStrPool()
-	{
-		caseSensitive = true;
-	}
+	idStrPool( bool caseSensitive = true, bool permanent = false );
 	
 	void				SetCaseSensitive( bool caseSensitive );
-	
-	int					Num() const
+	bool				IsPermanent() const
 	{
-		return pool.Num();
+		return permanent;
 	}
+	
+	int					Num() const;
 	size_t				Allocated() const;
 	size_t				Size() const;
 	
-	const idPoolStr* 	operator[]( int index ) const
-	{
-		return pool[index];
-	}
-	
 	const idPoolStr* 	AllocString( const char* string );
 	void				FreeString( const idPoolStr* poolStr );
 	const idPoolStr* 	CopyString( const idPoolStr* poolStr );
+	// not thread safe, all strings are deleted even if they are still used
 	void				Clear();
 	
 private:
-	bool				caseSensitive;
-	idList<idPoolStr*>	pool;
-	idHashIndex			poolHash;
-};
-
-/*
-================
-idStrPool::SetCaseSensitive
-================
-*/
-ID_INLINE void idStrPool::SetCaseSensitive( bool caseSensitive )
-{
-	this->caseSensitive = caseSensitive;
-}
-
-/*
-================
-idStrPool::AllocString
-================
-*/
-ID_INLINE const idPoolStr* idStrPool::AllocString( const char* string )
-{
-	int i, hash;
-	idPoolStr* poolStr;
+	static const int	SHARD_BITS = 4;
+	static const int	NUM_SHARDS = 1 << SHARD_BITS;
+	static const int	PERMANENT_HASH_BITS = 12;
 	
-	hash = poolHash.GenerateKey( string, caseSensitive );
-	if( caseSensitive )
+	struct poolShard_t
 	{
-		for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-		{
-			if( pool[i]->Cmp( string ) == 0 )
-			{
-				pool[i]->numUsers++;
-				return pool[i];
-			}
-		}
-	}
-	else
-	{
-		for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-		{
-			if( pool[i]->Icmp( string ) == 0 )
-			{
-				pool[i]->numUsers++;
-				return pool[i];
-			}
-		}
-	}
-	
-	poolStr = new( TAG_IDLIB_STRING ) idPoolStr;
-	*static_cast<idStr*>( poolStr ) = string;
-	poolStr->pool = this;
-	poolStr->numUsers = 1;
-	poolHash.Add( hash, pool.Append( poolStr ) );
-	return poolStr;
-}
-
-/*
-================
-idStrPool::FreeString
-================
-*/
-ID_INLINE void idStrPool::FreeString( const idPoolStr* poolStr )
-{
-	int i, hash;
-	
-	/*
-	 * DG: numUsers can actually be 0 when shutting down the game, because then
-	 * first idCommonLocal::Quit() -> idCommonLocal::Shutdown() -> idLib::Shutdown()
-	 * -> idDict::Shutdown() -> idDict::globalKeys.Clear() and idDict::globalVars.Clear()
-	 * is called and then, from destructors,
-	 * ~idSessionLocal() => destroy idDict titleStorageVars -> ~idDict() -> idDict::Clear()
-	 * -> idDict::globalVars.FreeString() and idDict::globalKeys.FreeString() (this function)
-	 * is called, leading here.
-	 * So just return if poolStr->numUsers < 1, instead of segfaulting/asserting below
-	 * when i == -1 because nothing was found here. As there is no nice way to find out if
-	 * we're shutting down (at this point) just get rid of the following assertion:
-	 * assert( poolStr->numUsers >= 1 );
-	 */
-	if( poolStr->numUsers < 1 )
-		return;
-	// DG end
-	
-	assert( poolStr->pool == this );
+		idSysMutex			mutex;
+		idList<idPoolStr*>	pool;
+		idHashIndex			poolHash;
+	};
 	
-	poolStr->numUsers--;
-	if( poolStr->numUsers <= 0 )
-	{
-		hash = poolHash.GenerateKey( poolStr->c_str(), caseSensitive );
-		if( caseSensitive )
-		{
-			for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-			{
-				if( pool[i]->Cmp( poolStr->c_str() ) == 0 )
-				{
-					break;
-				}
-			}
-		}
-		else
-		{
-			for( i = poolHash.First( hash ); i != -1; i = poolHash.Next( i ) )
-			{
-				if( pool[i]->Icmp( poolStr->c_str() ) == 0 )
-				{
-					break;
-				}
-			}
-		}
-		assert( i != -1 );
-		assert( pool[i] == poolStr );
-		delete pool[i];
-		pool.RemoveIndex( i );
-		poolHash.RemoveIndex( hash, i );
-	}
-}
-
-/*
-================
-idStrPool::CopyString
-================
-*/
-ID_INLINE const idPoolStr* idStrPool::CopyString( const idPoolStr* poolStr )
-{
-
-	assert( poolStr->numUsers >= 1 );
+	bool				caseSensitive;
+	const bool			permanent;
 	
-	if( poolStr->pool == this )
-	{
-		// the string is from this pool so just increase the user count
-		poolStr->numUsers++;
-		return poolStr;
-	}
-	else
-	{
-		// the string is from another pool so it needs to be re-allocated from this pool.
-		return AllocString( poolStr->c_str() );
-	}
-}
-
-/*
-================
-idStrPool::Clear
-================
-*/
-ID_INLINE void idStrPool::Clear()
-{
-	int i;
+	poolShard_t			shards[NUM_SHARDS];
 	
-	for( i = 0; i < pool.Num(); i++ )
-	{
-		pool[i]->numUsers = 0;
-	}
-	pool.DeleteContents( true );
-	poolHash.Free();
-}
-
-/*
-================
-idStrPool::Allocated
-================
-*/
-ID_INLINE size_t idStrPool::Allocated() const
-{
-	int i;
-	size_t size;
+	idPoolStr* 			buckets[1 << PERMANENT_HASH_BITS];
+	interlockedInt_t	numPermanent;
 	
-	size = pool.Allocated() + poolHash.Allocated();
-	for( i = 0; i < pool.Num(); i++ )
-	{
-		size += pool[i]->Allocated();
-	}
-	return size;
-}
+	int					Hash( const char* string ) const;
+	int					Compare( const idPoolStr* poolStr, const char* string ) const;
+	const idPoolStr* 	FindPermanent( const idPoolStr* first, const idPoolStr* last, int hash, const char* string ) const;
+	const idPoolStr* 	AllocPermanentString( const char* string );
+};
 
 /*
 ================
-idStrPool::Size
+idStrPool::SetCaseSensitive
 ================
 */
-ID_INLINE size_t idStrPool::Size() const
+ID_INLINE void idStrPool::SetCaseSensitive( bool caseSensitive )
 {
-	int i;
-	size_t size;
-	
-	size = pool.Size() + poolHash.Size();
-	for( i = 0; i < pool.Num(); i++ )
-	{
-		size += pool[i]->Size();
-	}
-	return size;
+	this->caseSensitive = caseSensitive;
 }
 
 //} // namespace BFG
@@ -124,7 +124,8 @@ class idDrawVert
 	friend class idShadowVertSkinned;
 	friend class idRenderModelStatic;
 	
-	friend void TransformVertsAndTangents( idDrawVert* targetVerts, const int numVerts, const idDrawVert* baseVerts, const idJointMat* joints );
+	friend class idSIMD_Generic;
+	friend class idSIMD_SSE;
 	
 public:
 	idVec3				xyz;			// 12 bytes
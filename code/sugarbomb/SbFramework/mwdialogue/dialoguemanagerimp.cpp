@@ -47,6 +47,7 @@
 
 #include "filter.hpp"
 #include "hypertextparser.hpp"
+#include "infoindex.hpp"
 
 namespace MWDialogue
 {
@@ -63,6 +64,14 @@ namespace MWDialogue
         mIsInChoice = false;
         mGoodbye = false;
         mCompilerContext.setExtensions (&extensions);
+
+        const MWWorld::ESMStore& store = MWBase::Environment::get().getWorld()->getStore();
+
+        // OPENMW_DIALOGUE_BENCHMARK compares scanning all infos with the info index (and builds the index)
+        if (getenv("OPENMW_DIALOGUE_BENCHMARK"))
+            InfoIndex::benchmark (store);
+        else
+            InfoIndex::get().build (store);
     }
 
     void DialogueManager::clear()
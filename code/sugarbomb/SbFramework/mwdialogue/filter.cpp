@@ -614,7 +614,28 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
 
 MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
 : mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
-{}
+{
+    const InfoIndex& index = InfoIndex::get();
+
+    if (mActor.getTypeName() != typeid (ESM::NPC).name())
+    {
+        mIndexActor = index.makeActor (mActor.getCellRef().getRefId(), "", "", "", true);
+    }
+    else
+    {
+        MWWorld::LiveCellRef<ESM::NPC> *cellRef = mActor.get<ESM::NPC>();
+
+        mIndexActor = index.makeActor (mActor.getCellRef().getRefId(), cellRef->mBase->mRace,
+            cellRef->mBase->mClass, mActor.getClass().getPrimaryFaction (mActor), false);
+    }
+}
+
+std::vector<const ESM::DialInfo *> MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    std::vector<const ESM::DialInfo *> candidates;
+    InfoIndex::get().getCandidates (dialogue, mIndexActor, candidates);
+    return candidates;
+}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
 {
@@ -629,10 +650,11 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    const std::vector<const ESM::DialInfo *> candidates = getCandidates (dialogue);
+    for (std::vector<const ESM::DialInfo *>::const_iterator iter = candidates.begin(); iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (**iter))
+            infos.push_back(*iter);
     }
     return infos;
 }
@@ -644,14 +666,16 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
     bool infoRefusal = false;
 
-    // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    // Iterate over topic responses to find a matching one, the index already skipped
+    // the ones that can't match the static actor conditions
+    const std::vector<const ESM::DialInfo *> candidates = getCandidates (dialogue);
+    for (std::vector<const ESM::DialInfo *>::const_iterator iter = candidates.begin();
+        iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        if (testActor (**iter) && testPlayer (**iter) && testSelectStructs (**iter))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (**iter, invertDisposition)) {
+                infos.push_back(*iter);
                 if (!searchAll)
                     break;
             }
@@ -670,10 +694,11 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        const std::vector<const ESM::DialInfo *> refusals = getCandidates (infoRefusalDialogue);
+        for (std::vector<const ESM::DialInfo *>::const_iterator iter = refusals.begin();
+            iter!=refusals.end(); ++iter)
+            if (testActor (**iter) && testPlayer (**iter) && testSelectStructs (**iter) && testDisposition(**iter, invertDisposition)) {
+                infos.push_back(*iter);
                 if (!searchAll)
                     break;
             }
@@ -684,10 +709,11 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
 bool MWDialogue::Filter::responseAvailable (const ESM::Dialogue& dialogue) const
 {
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    const std::vector<const ESM::DialInfo *> candidates = getCandidates (dialogue);
+    for (std::vector<const ESM::DialInfo *>::const_iterator iter = candidates.begin();
+        iter!=candidates.end(); ++iter)
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        if (testActor (**iter) && testPlayer (**iter) && testSelectStructs (**iter))
             return true;
     }
 
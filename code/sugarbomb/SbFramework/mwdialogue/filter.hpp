@@ -5,6 +5,8 @@
 
 #include "../mwworld/ptr.hpp"
 
+#include "infoindex.hpp"
+
 namespace ESM
 {
     struct DialInfo;
@@ -20,6 +22,10 @@ namespace MWDialogue
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            InfoIndex::Actor mIndexActor;
+
+            std::vector<const ESM::DialInfo *> getCandidates (const ESM::Dialogue& dialogue) const;
+            ///< Infos of \a dialogue that can match the static conditions of the actor, in info order
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
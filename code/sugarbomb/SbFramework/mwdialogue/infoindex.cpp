@@ -0,0 +1,218 @@
+#include "infoindex.hpp"
+
+#include <chrono>
+
+#include <components/debug/debuglog.hpp>
+
+#include <components/esm/loaddial.hpp>
+#include <components/esm/loadinfo.hpp>
+#include <components/esm/loadnpc.hpp>
+
+#include <components/misc/stringops.hpp>
+
+#include "../mwworld/esmstore.hpp"
+
+namespace
+{
+    bool matches (int atom, int actorAtom)
+    {
+        return atom == 0 || atom == actorAtom;
+    }
+
+    /// The static part of Filter::testActor, done with string comparisons
+    bool testStatic (const ESM::DialInfo& info, const ESM::NPC& npc)
+    {
+        if (!info.mActor.empty() && !Misc::StringUtils::ciEqual (info.mActor, npc.mId))
+            return false;
+
+        if (!info.mRace.empty() && !Misc::StringUtils::ciEqual (info.mRace, npc.mRace))
+            return false;
+
+        if (!info.mClass.empty() && !Misc::StringUtils::ciEqual (info.mClass, npc.mClass))
+            return false;
+
+        if (info.mFactionLess)
+            return npc.mFaction.empty();
+
+        return info.mFaction.empty() || Misc::StringUtils::ciEqual (info.mFaction, npc.mFaction);
+    }
+}
+
+namespace MWDialogue
+{
+    InfoIndex& InfoIndex::get()
+    {
+        static InfoIndex index;
+        return index;
+    }
+
+    int InfoIndex::intern (const std::string& id)
+    {
+        if (id.empty())
+            return 0;
+
+        return mAtoms.insert (std::make_pair (Misc::StringUtils::lowerCase (id), static_cast<int> (mAtoms.size()) + 1)).first->second;
+    }
+
+    int InfoIndex::find (const std::string& id) const
+    {
+        if (id.empty())
+            return 0;
+
+        std::unordered_map<std::string, int>::const_iterator iter = mAtoms.find (Misc::StringUtils::lowerCase (id));
+        return iter != mAtoms.end() ? iter->second : -1;
+    }
+
+    void InfoIndex::indexDialogue (const ESM::Dialogue& dialogue)
+    {
+        DialogueIndex& index = mDialogues[&dialogue];
+        index.mByActor.clear();
+        index.mGeneric.clear();
+
+        int order = 0;
+        for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter != dialogue.mInfo.end(); ++iter)
+        {
+            Entry entry;
+            entry.mInfo = &*iter;
+            entry.mOrder = order++;
+            entry.mRace = intern (iter->mRace);
+            entry.mClass = intern (iter->mClass);
+            entry.mFaction = intern (iter->mFaction);
+            entry.mFactionLess = iter->mFactionLess;
+
+            if (iter->mActor.empty())
+                index.mGeneric.push_back (entry);
+            else
+                index.mByActor[intern (iter->mActor)].push_back (entry);
+        }
+    }
+
+    void InfoIndex::build (const MWWorld::ESMStore& store)
+    {
+        mDialogues.clear();
+
+        const MWWorld::Store<ESM::Dialogue>& dialogues = store.get<ESM::Dialogue>();
+        for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogues.begin(); iter != dialogues.end(); ++iter)
+            indexDialogue (*iter);
+    }
+
+    const InfoIndex::DialogueIndex& InfoIndex::getDialogueIndex (const ESM::Dialogue& dialogue)
+    {
+        std::map<const ESM::Dialogue *, DialogueIndex>::const_iterator iter = mDialogues.find (&dialogue);
+        if (iter != mDialogues.end())
+            return iter->second;
+
+        // not known at build time
+        indexDialogue (dialogue);
+        return mDialogues[&dialogue];
+    }
+
+    InfoIndex::Actor InfoIndex::makeActor (const std::string& id, const std::string& race, const std::string& cls,
+        const std::string& faction, bool creature) const
+    {
+        Actor actor;
+        actor.mId = find (id);
+        actor.mRace = find (race);
+        actor.mClass = find (cls);
+        actor.mFaction = find (faction);
+        actor.mCreature = creature;
+        return actor;
+    }
+
+    void InfoIndex::getCandidates (const ESM::Dialogue& dialogue, const Actor& actor,
+        std::vector<const ESM::DialInfo *>& candidates)
+    {
+        candidates.clear();
+
+        const DialogueIndex& index = getDialogueIndex (dialogue);
+
+        static const std::vector<Entry> sEmpty;
+        std::unordered_map<int, std::vector<Entry> >::const_iterator bucket = index.mByActor.find (actor.mId);
+        const std::vector<Entry>& byActor = bucket != index.mByActor.end() ? bucket->second : sEmpty;
+
+        // creatures must not have topics aside of those specific to their id
+        const std::vector<Entry>& generic = actor.mCreature ? sEmpty : index.mGeneric;
+
+        // merge both lists back into info order
+        std::vector<Entry>::const_iterator a = byActor.begin();
+        std::vector<Entry>::const_iterator b = generic.begin();
+        while (a != byActor.end() || b != generic.end())
+        {
+            const Entry& entry = (b == generic.end() || (a != byActor.end() && a->mOrder < b->mOrder)) ? *a++ : *b++;
+
+            if (!actor.mCreature)
+            {
+                if (!matches (entry.mRace, actor.mRace) || !matches (entry.mClass, actor.mClass))
+                    continue;
+
+                if (entry.mFactionLess ? actor.mFaction != 0 : !matches (entry.mFaction, actor.mFaction))
+                    continue;
+            }
+
+            candidates.push_back (entry.mInfo);
+        }
+    }
+
+    void InfoIndex::benchmark (const MWWorld::ESMStore& store)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        InfoIndex& index = get();
+
+        Clock::time_point start = Clock::now();
+        index.build (store);
+        const double buildTime = std::chrono::duration<double, std::milli> (Clock::now() - start).count();
+
+        const MWWorld::Store<ESM::Dialogue>& dialogues = store.get<ESM::Dialogue>();
+        const MWWorld::Store<ESM::NPC>& npcs = store.get<ESM::NPC>();
+
+        std::size_t numNpcs = 0;
+        std::size_t scanned = 0;
+        std::size_t candidates = 0;
+        std::size_t mismatches = 0;
+        double scanTime = 0;
+        double indexTime = 0;
+
+        std::vector<const ESM::DialInfo *> list;
+
+        for (MWWorld::Store<ESM::NPC>::iterator npc = npcs.begin(); npc != npcs.end(); ++npc)
+        {
+            ++numNpcs;
+
+            start = Clock::now();
+            std::size_t passed = 0;
+            for (MWWorld::Store<ESM::Dialogue>::iterator dialogue = dialogues.begin(); dialogue != dialogues.end(); ++dialogue)
+            {
+                for (ESM::Dialogue::InfoContainer::const_iterator info = dialogue->mInfo.begin(); info != dialogue->mInfo.end(); ++info)
+                {
+                    ++scanned;
+                    if (testStatic (*info, *npc))
+                        ++passed;
+                }
+            }
+            scanTime += std::chrono::duration<double, std::milli> (Clock::now() - start).count();
+
+            start = Clock::now();
+            const Actor actor = index.makeActor (npc->mId, npc->mRace, npc->mClass, npc->mFaction, false);
+            std::size_t found = 0;
+            for (MWWorld::Store<ESM::Dialogue>::iterator dialogue = dialogues.begin(); dialogue != dialogues.end(); ++dialogue)
+            {
+                index.getCandidates (*dialogue, actor, list);
+                found += list.size();
+            }
+            indexTime += std::chrono::duration<double, std::milli> (Clock::now() - start).count();
+
+            candidates += found;
+            if (found != passed)
+                ++mismatches;
+        }
+
+        Log(Debug::Info) << "Dialogue info index benchmark: " << dialogues.getSize() << " dialogues, "
+            << numNpcs << " NPCs, index built in " << buildTime << " ms";
+        Log(Debug::Info) << "  scan: " << scanned << " infos tested in " << scanTime << " ms";
+        Log(Debug::Info) << "  index: " << candidates << " candidates in " << indexTime << " ms";
+
+        if (mismatches != 0)
+            Log(Debug::Error) << "  " << mismatches << " NPCs got different infos from the index and the scan";
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+    struct NPC;
+}
+
+namespace MWWorld
+{
+    class ESMStore;
+}
+
+namespace MWDialogue
+{
+    /// \brief Lookup of the infos of a dialogue by their static actor conditions
+    ///
+    /// Infos with a speaker id are bucketed by that id, all others are kept in one list with
+    /// their race, class and faction conditions interned to integers. Filter then only runs
+    /// the runtime tests on infos that can still match the actor, in the original info order.
+    class InfoIndex
+    {
+        public:
+
+            /// Interned static attributes of the actor that is talking
+            struct Actor
+            {
+                int mId;
+                int mRace;
+                int mClass;
+                int mFaction; ///< 0 if the actor has no faction
+                bool mCreature;
+            };
+
+            static InfoIndex& get();
+
+            void build (const MWWorld::ESMStore& store);
+            ///< Index all dialogues of \a store, replaces the previous index
+
+            Actor makeActor (const std::string& id, const std::string& race, const std::string& cls,
+                const std::string& faction, bool creature) const;
+
+            void getCandidates (const ESM::Dialogue& dialogue, const Actor& actor,
+                std::vector<const ESM::DialInfo *>& candidates);
+            ///< Infos of \a dialogue that pass the static actor conditions (rank and gender are not checked)
+
+            static void benchmark (const MWWorld::ESMStore& store);
+            ///< Logs the cost of the static actor checks over all topics, by scanning and through the index
+
+        private:
+
+            struct Entry
+            {
+                const ESM::DialInfo *mInfo;
+                int mOrder;
+                int mRace;
+                int mClass;
+                int mFaction;
+                bool mFactionLess;
+            };
+
+            struct DialogueIndex
+            {
+                std::unordered_map<int, std::vector<Entry> > mByActor;
+                std::vector<Entry> mGeneric;
+            };
+
+            std::unordered_map<std::string, int> mAtoms;
+            std::map<const ESM::Dialogue *, DialogueIndex> mDialogues;
+
+            int intern (const std::string& id);
+            ///< 0 for an empty id
+
+            int find (const std::string& id) const;
+            ///< 0 for an empty id, -1 if the id is not used by any info
+
+            const DialogueIndex& getDialogueIndex (const ESM::Dialogue& dialogue);
+
+            void indexDialogue (const ESM::Dialogue& dialogue);
+    };
+}
+
+#endif
@@ -72,8 +72,8 @@ Suite 120, Rockville, Maryland 20850 USA.
 
 //class idCmdArgs;
 
-idStrPool		idDict::globalKeys;
-idStrPool		idDict::globalValues;
+idStrPool		idDict::globalKeys( false, true );
+idStrPool		idDict::globalValues( true, false );
 
 /*
 ================
@@ -131,7 +131,7 @@ void idDict::Copy( const idDict& other )
 		found = ( int* ) _alloca16( other.args.Num() * sizeof( int ) );
 		for( i = 0; i < n; i++ )
 		{
-			found[i] = FindKeyIndex( other.args[i].GetKey() );
+			found[i] = FindKeyIndex( other.args[i].key );
 		}
 	}
 	else
@@ -152,7 +152,7 @@ void idDict::Copy( const idDict& other )
 		{
 			kv.key = globalKeys.CopyString( other.args[i].key );
 			kv.value = globalValues.CopyString( other.args[i].value );
-			argHash.Add( argHash.GenerateKey( kv.GetKey(), false ), args.Append( kv ) );
+			argHash.Add( kv.key->GetHash(), args.Append( kv ) );
 		}
 	}
 }
@@ -252,12 +252,12 @@ void idDict::SetDefaults( const idDict* dict )
 	for( i = 0; i < n; i++ )
 	{
 		def = &dict->args[i];
-		kv = FindKey( def->GetKey() );
+		kv = FindKey( def->key );
 		if( !kv )
 		{
 			newkv.key = globalKeys.CopyString( def->key );
 			newkv.value = globalValues.CopyString( def->value );
-			argHash.Add( argHash.GenerateKey( newkv.GetKey(), false ), args.Append( newkv ) );
+			argHash.Add( newkv.key->GetHash(), args.Append( newkv ) );
 		}
 	}
 }
@@ -374,7 +374,38 @@ void idDict::Set( const char* key, const char* value )
 	{
 		kv.key = globalKeys.AllocString( key );
 		kv.value = globalValues.AllocString( value );
-		argHash.Add( argHash.GenerateKey( kv.GetKey(), false ), args.Append( kv ) );
+		argHash.Add( kv.key->GetHash(), args.Append( kv ) );
+	}
+}
+
+/*
+================
+idDict::Set
+================
+*/
+void idDict::Set( idDictKey key, const char* value )
+{
+	int i;
+	idKeyValue kv;
+	
+	if( key == nullptr || key->Length() == 0 )
+	{
+		return;
+	}
+	
+	i = FindKeyIndex( key );
+	if( i != -1 )
+	{
+		// first set the new value and then free the old value to allow proper self copying
+		const idPoolStr* oldValue = args[i].value;
+		args[i].value = globalValues.AllocString( value );
+		globalValues.FreeString( oldValue );
+	}
+	else
+	{
+		kv.key = globalKeys.CopyString( key );
+		kv.value = globalValues.AllocString( value );
+		argHash.Add( key->GetHash(), args.Append( kv ) );
 	}
 }
 
@@ -525,6 +556,22 @@ bool idDict::GetVector( const char* key, const char* defaultString, idVec3& out
 	return found;
 }
 
+/*
+================
+idDict::GetVector
+================
+*/
+idVec3 idDict::GetVector( idDictKey key, const char* defaultString ) const
+{
+	idVec3 out;
+	const idKeyValue* kv = FindKey( key );
+	const char* s = kv ? kv->GetValue().c_str() : ( defaultString ? defaultString : "0 0 0" );
+	
+	out.Zero();
+	sscanf( s, "%f %f %f", &out.x, &out.y, &out.z );
+	return out;
+}
+
 /*
 ================
 idDict::GetVec2
@@ -1087,6 +1134,16 @@ void idDict::Shutdown()
 	globalValues.Clear();
 }
 
+/*
+================
+idDict::InternKey
+================
+*/
+idDictKey idDict::InternKey( const char* key )
+{
+	return globalKeys.AllocString( key );
+}
+
 /*
 ================
 idDict::ShowMemoryUsage_f
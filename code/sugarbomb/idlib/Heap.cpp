@@ -39,6 +39,8 @@ If you have questions concerning this license or the applicable additional terms
 #include <cstdlib>
 #undef new
 
+static interlockedInt_t mem_numAllocs = 0;
+
 /*
 ==================
 Mem_Alloc16
@@ -52,6 +54,7 @@ void* Mem_Alloc16( const size_t size, const memTag_t tag )
 	{
 		return nullptr;
 	}
+	Sys_InterlockedIncrement( mem_numAllocs );
 	const size_t paddedSize = ( size + 15 ) & ~15;
 #ifdef _WIN32
 	// this should work with MSVC and mingw, as long as __MSVCRT_VERSION__ >= 0x0700
@@ -98,6 +101,16 @@ void* Mem_ClearedAlloc( const size_t size, const memTag_t tag )
 	return mem;
 }
 
+/*
+==================
+Mem_GetNumAllocs
+==================
+*/
+int Mem_GetNumAllocs()
+{
+	return mem_numAllocs;
+}
+
 /*
 ==================
 Mem_CopyString
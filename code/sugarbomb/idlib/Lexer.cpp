@@ -138,6 +138,292 @@ int default_setup;
 
 char idLexer::baseFolder[ 256 ];
 
+#if ( defined( __GNUC__ ) && defined( __SSE2__ ) ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define LEXER_SSE2
+#include <emmintrin.h>
+#endif
+
+static bool lexerVectorScan = true;
+
+/*
+==========================================================================================
+
+	Scanners
+
+	Find the end of a run of white space, name characters or plain string characters. The SSE2
+	versions load aligned 16 byte blocks, these never cross a page boundary, so reading past the
+	terminating zero of the script is safe because the zero ends every run. Bytes before the
+	start of the run in the first block are masked out.
+
+	Like the byte by byte loops, white space is every non zero char <= ' ' with chars being
+	signed, so bytes >= 0x80 are white space as well.
+
+==========================================================================================
+*/
+
+#ifdef LEXER_SSE2
+
+ID_INLINE static int Lexer_FirstBit( unsigned int mask )
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward( &index, mask );
+	return ( int )index;
+#else
+	return __builtin_ctz( mask );
+#endif
+}
+
+ID_INLINE static int Lexer_CountBits( unsigned int mask )
+{
+	mask = mask - ( ( mask >> 1 ) & 0x55555555 );
+	mask = ( mask & 0x33333333 ) + ( ( mask >> 2 ) & 0x33333333 );
+	return ( ( ( mask + ( mask >> 4 ) ) & 0x0F0F0F0F ) * 0x01010101 ) >> 24;
+}
+
+ID_INLINE static __m128i Lexer_InRange( const __m128i v, char low, char high )
+{
+	return _mm_and_si128( _mm_cmpgt_epi8( v, _mm_set1_epi8( low - 1 ) ), _mm_cmplt_epi8( v, _mm_set1_epi8( high + 1 ) ) );
+}
+
+/*
+================
+Lexer_SkipSpacesSSE2
+
+Returns the first char that isn't white space, adds the newlines on the way to lines.
+================
+*/
+static const char* Lexer_SkipSpacesSSE2( const char* p, int& lines )
+{
+	const __m128i space = _mm_set1_epi8( ' ' );
+	const __m128i newline = _mm_set1_epi8( '\n' );
+	const __m128i zero = _mm_setzero_si128();
+	
+	const int misalign = ( int )( ( uintptr_t )p & 15 );
+	const char* block = p - misalign;
+	unsigned int valid = ( 0xFFFFu << misalign ) & 0xFFFF;
+	while( 1 )
+	{
+		const __m128i v = _mm_load_si128( ( const __m128i* )block );
+		const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( _mm_cmpgt_epi8( v, space ), _mm_cmpeq_epi8( v, zero ) ) ) & valid;
+		const unsigned int newlines = _mm_movemask_epi8( _mm_cmpeq_epi8( v, newline ) ) & valid;
+		if( stop )
+		{
+			const int i = Lexer_FirstBit( stop );
+			lines += Lexer_CountBits( newlines & ( ( 1u << i ) - 1 ) );
+			return block + i;
+		}
+		lines += Lexer_CountBits( newlines );
+		block += 16;
+		valid = 0xFFFF;
+	}
+}
+
+/*
+================
+Lexer_FindCharSSE2
+
+Returns the first occurrence of c or zero, adds the newlines on the way to lines.
+================
+*/
+static const char* Lexer_FindCharSSE2( const char* p, char c, int& lines )
+{
+	const __m128i find = _mm_set1_epi8( c );
+	const __m128i newline = _mm_set1_epi8( '\n' );
+	const __m128i zero = _mm_setzero_si128();
+	
+	const int misalign = ( int )( ( uintptr_t )p & 15 );
+	const char* block = p - misalign;
+	unsigned int valid = ( 0xFFFFu << misalign ) & 0xFFFF;
+	while( 1 )
+	{
+		const __m128i v = _mm_load_si128( ( const __m128i* )block );
+		const unsigned int stop = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, find ), _mm_cmpeq_epi8( v, zero ) ) ) & valid;
+		const unsigned int newlines = _mm_movemask_epi8( _mm_cmpeq_epi8( v, newline ) ) & valid;
+		if( stop )
+		{
+			const int i = Lexer_FirstBit( stop );
+			lines += Lexer_CountBits( newlines & ( ( 1u << i ) - 1 ) );
+			return block + i;
+		}
+		lines += Lexer_CountBits( newlines );
+		block += 16;
+		valid = 0xFFFF;
+	}
+}
+
+/*
+================
+Lexer_SkipNameSSE2
+================
+*/
+static const char* Lexer_SkipNameSSE2( const char* p, int flags )
+{
+	// optional name chars, disabled ones repeat '_'
+	const bool paths = ( flags & LEXFL_ALLOWPATHNAMES ) != 0;
+	const __m128i dash = _mm_set1_epi8( ( flags & LEXFL_ONLYSTRINGS ) ? '-' : '_' );
+	const __m128i slash = _mm_set1_epi8( paths ? '/' : '_' );
+	const __m128i backslash = _mm_set1_epi8( paths ? '\\' : '_' );
+	const __m128i colon = _mm_set1_epi8( paths ? ':' : '_' );
+	const __m128i dot = _mm_set1_epi8( paths ? '.' : '_' );
+	const __m128i underscore = _mm_set1_epi8( '_' );
+	
+	const int misalign = ( int )( ( uintptr_t )p & 15 );
+	const char* block = p - misalign;
+	unsigned int valid = ( 0xFFFFu << misalign ) & 0xFFFF;
+	while( 1 )
+	{
+		const __m128i v = _mm_load_si128( ( const __m128i* )block );
+		__m128i name = _mm_or_si128( Lexer_InRange( v, 'a', 'z' ), Lexer_InRange( v, 'A', 'Z' ) );
+		name = _mm_or_si128( name, Lexer_InRange( v, '0', '9' ) );
+		name = _mm_or_si128( name, _mm_cmpeq_epi8( v, underscore ) );
+		name = _mm_or_si128( name, _mm_cmpeq_epi8( v, dash ) );
+		name = _mm_or_si128( name, _mm_or_si128( _mm_cmpeq_epi8( v, slash ), _mm_cmpeq_epi8( v, backslash ) ) );
+		name = _mm_or_si128( name, _mm_or_si128( _mm_cmpeq_epi8( v, colon ), _mm_cmpeq_epi8( v, dot ) ) );
+		const unsigned int stop = ~_mm_movemask_epi8( name ) & valid;
+		if( stop )
+		{
+			return block + Lexer_FirstBit( stop );
+		}
+		block += 16;
+		valid = 0xFFFF;
+	}
+}
+
+/*
+================
+Lexer_FindStringEndSSE2
+
+Returns the first quote, zero, newline or backslash if escapes are allowed.
+================
+*/
+static const char* Lexer_FindStringEndSSE2( const char* p, char quote, bool escapes )
+{
+	const __m128i q = _mm_set1_epi8( quote );
+	const __m128i newline = _mm_set1_epi8( '\n' );
+	const __m128i backslash = _mm_set1_epi8( escapes ? '\\' : '\n' );
+	const __m128i zero = _mm_setzero_si128();
+	
+	const int misalign = ( int )( ( uintptr_t )p & 15 );
+	const char* block = p - misalign;
+	unsigned int valid = ( 0xFFFFu << misalign ) & 0xFFFF;
+	while( 1 )
+	{
+		const __m128i v = _mm_load_si128( ( const __m128i* )block );
+		const __m128i end = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, q ), _mm_cmpeq_epi8( v, zero ) ),
+										  _mm_or_si128( _mm_cmpeq_epi8( v, newline ), _mm_cmpeq_epi8( v, backslash ) ) );
+		const unsigned int stop = _mm_movemask_epi8( end ) & valid;
+		if( stop )
+		{
+			return block + Lexer_FirstBit( stop );
+		}
+		block += 16;
+		valid = 0xFFFF;
+	}
+}
+
+#endif // LEXER_SSE2
+
+/*
+================
+Lexer_SkipSpaces
+================
+*/
+ID_INLINE static const char* Lexer_SkipSpaces( const char* p, int& lines )
+{
+#ifdef LEXER_SSE2
+	if( lexerVectorScan )
+	{
+		return Lexer_SkipSpacesSSE2( p, lines );
+	}
+#endif
+	while( *p <= ' ' )
+	{
+		if( !*p )
+		{
+			break;
+		}
+		if( *p == '\n' )
+		{
+			lines++;
+		}
+		p++;
+	}
+	return p;
+}
+
+/*
+================
+Lexer_FindChar
+================
+*/
+ID_INLINE static const char* Lexer_FindChar( const char* p, char c, int& lines )
+{
+#ifdef LEXER_SSE2
+	if( lexerVectorScan )
+	{
+		return Lexer_FindCharSSE2( p, c, lines );
+	}
+#endif
+	while( *p && *p != c )
+	{
+		if( *p == '\n' )
+		{
+			lines++;
+		}
+		p++;
+	}
+	return p;
+}
+
+/*
+================
+Lexer_SkipName
+================
+*/
+ID_INLINE static const char* Lexer_SkipName( const char* p, int flags )
+{
+#ifdef LEXER_SSE2
+	if( lexerVectorScan )
+	{
+		return Lexer_SkipNameSSE2( p, flags );
+	}
+#endif
+	char c = *p;
+	while( ( c >= 'a' && c <= 'z' ) ||
+			( c >= 'A' && c <= 'Z' ) ||
+			( c >= '0' && c <= '9' ) ||
+			c == '_' ||
+			// if treating all tokens as strings, don't parse '-' as a separate token
+			( ( flags & LEXFL_ONLYSTRINGS ) && ( c == '-' ) ) ||
+			// if special path name characters are allowed
+			( ( flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == ':' || c == '.' ) ) )
+	{
+		c = *++p;
+	}
+	return p;
+}
+
+/*
+================
+Lexer_FindStringEnd
+================
+*/
+ID_INLINE static const char* Lexer_FindStringEnd( const char* p, char quote, bool escapes )
+{
+#ifdef LEXER_SSE2
+	if( lexerVectorScan )
+	{
+		return Lexer_FindStringEndSSE2( p, quote, escapes );
+	}
+#endif
+	while( *p && *p != quote && *p != '\n' && !( escapes && *p == '\\' ) )
+	{
+		p++;
+	}
+	return p;
+}
+
 /*
 ================
 idLexer::CreatePunctuationTable
@@ -303,9 +589,28 @@ void idLexer::Warning( const char* str, ... )
 	va_start( ap, str );
 	std::vsprintf( text, str, ap );
 	va_end( ap );
+	
+	if( idLexer::warningList != nullptr )
+	{
+		char message[MAX_STRING_CHARS];
+		idStr::snPrintf( message, sizeof( message ), "file %s, line %d: %s", idLexer::filename.c_str(), idLexer::line, text );
+		idLexer::warningList->Append( message );
+		return;
+	}
+	
 	idLib::sys->Warning( "file %s, line %d: %s", idLexer::filename.c_str(), idLexer::line, text );
 }
 
+/*
+================
+idLexer::SetWarningList
+================
+*/
+void idLexer::SetWarningList( idList<idStr>* list )
+{
+	idLexer::warningList = list;
+}
+
 /*
 ================
 idLexer::SetPunctuations
@@ -346,17 +651,10 @@ int idLexer::ReadWhiteSpace()
 	while( 1 )
 	{
 		// skip white space
-		while( *idLexer::script_p <= ' ' )
+		idLexer::script_p = Lexer_SkipSpaces( idLexer::script_p, idLexer::line );
+		if( !*idLexer::script_p )
 		{
-			if( !*idLexer::script_p )
-			{
-				return 0;
-			}
-			if( *idLexer::script_p == '\n' )
-			{
-				idLexer::line++;
-			}
-			idLexer::script_p++;
+			return 0;
 		}
 		// skip comments
 		if( *idLexer::script_p == '/' )
@@ -364,16 +662,12 @@ int idLexer::ReadWhiteSpace()
 			// comments //
 			if( *( idLexer::script_p + 1 ) == '/' )
 			{
-				idLexer::script_p++;
-				do
+				int lines = 0;
+				idLexer::script_p = Lexer_FindChar( idLexer::script_p + 2, '\n', lines );
+				if( !*idLexer::script_p )
 				{
-					idLexer::script_p++;
-					if( !*idLexer::script_p )
-					{
-						return 0;
-					}
+					return 0;
 				}
-				while( *idLexer::script_p != '\n' );
 				idLexer::line++;
 				idLexer::script_p++;
 				if( !*idLexer::script_p )
@@ -388,25 +682,19 @@ int idLexer::ReadWhiteSpace()
 				idLexer::script_p++;
 				while( 1 )
 				{
-					idLexer::script_p++;
+					// jump to the next slash
+					idLexer::script_p = Lexer_FindChar( idLexer::script_p + 1, '/', idLexer::line );
 					if( !*idLexer::script_p )
 					{
 						return 0;
 					}
-					if( *idLexer::script_p == '\n' )
+					if( *( idLexer::script_p - 1 ) == '*' )
 					{
-						idLexer::line++;
+						break;
 					}
-					else if( *idLexer::script_p == '/' )
+					if( *( idLexer::script_p + 1 ) == '*' )
 					{
-						if( *( idLexer::script_p - 1 ) == '*' )
-						{
-							break;
-						}
-						if( *( idLexer::script_p + 1 ) == '*' )
-						{
-							idLexer::Warning( "nested comment" );
-						}
+						idLexer::Warning( "nested comment" );
 					}
 				}
 				idLexer::script_p++;
@@ -737,7 +1025,10 @@ int idLexer::ReadString( idToken* token, int quote )
 				idLexer::Error( "newline inside string" );
 				return 0;
 			}
-			token->AppendDirty( *idLexer::script_p++ );
+			// copy everything up to the next quote, escape character or line end at once
+			const char* end_p = Lexer_FindStringEnd( idLexer::script_p + 1, quote, !( idLexer::flags & LEXFL_NOSTRINGESCAPECHARS ) );
+			token->AppendDirty( idLexer::script_p, end_p - idLexer::script_p );
+			idLexer::script_p = end_p;
 		}
 	}
 	token->data[token->len] = '\0';
@@ -768,22 +1059,12 @@ idLexer::ReadName
 */
 int idLexer::ReadName( idToken* token )
 {
-	char c;
+	// the first char is always part of the name
+	const char* start_p = idLexer::script_p;
+	idLexer::script_p = Lexer_SkipName( start_p + 1, idLexer::flags );
 	
 	token->type = TT_NAME;
-	do
-	{
-		token->AppendDirty( *idLexer::script_p++ );
-		c = *idLexer::script_p;
-	}
-	while( ( c >= 'a' && c <= 'z' ) ||
-			( c >= 'A' && c <= 'Z' ) ||
-			( c >= '0' && c <= '9' ) ||
-			c == '_' ||
-			// if treating all tokens as strings, don't parse '-' as a separate token
-			( ( idLexer::flags & LEXFL_ONLYSTRINGS ) && ( c == '-' ) ) ||
-			// if special path name characters are allowed
-			( ( idLexer::flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == ':' || c == '.' ) ) );
+	token->AppendDirty( start_p, idLexer::script_p - start_p );
 	token->data[token->len] = '\0';
 	//the sub type is the length of the name
 	token->subtype = token->Length();
@@ -1113,8 +1394,6 @@ idLexer::ReadToken
 */
 int idLexer::ReadToken( idToken* token )
 {
-	int c;
-	
 	if( !loaded )
 	{
 		idLib::sys->Error( "idLexer::ReadToken: no file loaded" );
@@ -1158,6 +1437,20 @@ int idLexer::ReadToken( idToken* token )
 	// clear token flags
 	token->flags = 0;
 	
+	return ReadTokenText( token );
+}
+
+/*
+================
+idLexer::ReadTokenText
+
+Reads the token starting at the script pointer, after the white space.
+================
+*/
+int idLexer::ReadTokenText( idToken* token )
+{
+	int c;
+	
 	c = *idLexer::script_p;
 	
 	// if we're keeping everything as whitespace deliminated strings
@@ -1231,6 +1524,147 @@ int idLexer::ReadToken( idToken* token )
 	return 1;
 }
 
+/*
+================
+idLexer::ReadTokenView
+
+Same tokens as ReadToken. Names and strings without escape characters or concatenation
+aren't copied, everything else is read into idLexer::token.
+================
+*/
+int idLexer::ReadTokenView( tokenView_t* view )
+{
+	if( !loaded )
+	{
+		idLib::sys->Error( "idLexer::ReadTokenView: no file loaded" );
+		return 0;
+	}
+	
+	if( script_p == nullptr )
+	{
+		return 0;
+	}
+	
+	// if there is a token available (from unreadToken)
+	if( tokenavailable )
+	{
+		tokenavailable = 0;
+		view->text = idLexer::token.c_str();
+		view->length = idLexer::token.Length();
+		view->type = idLexer::token.type;
+		view->subtype = idLexer::token.subtype;
+		view->line = idLexer::token.line;
+		view->linesCrossed = idLexer::token.linesCrossed;
+		return 1;
+	}
+	// save script pointer
+	lastScript_p = script_p;
+	// save line counter
+	lastline = line;
+	// start of the white space
+	whiteSpaceStart_p = script_p;
+	// read white space before token
+	if( !ReadWhiteSpace() )
+	{
+		return 0;
+	}
+	// end of the white space
+	whiteSpaceEnd_p = script_p;
+	
+	view->line = line;
+	view->linesCrossed = line - lastline;
+	
+	const char* start_p = script_p;
+	const int c = *script_p;
+	
+	// names, the first char is always part of the name
+	if( ( flags & LEXFL_ONLYSTRINGS ) ?
+			( c != '\"' && c != '\'' ) :
+			( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_' ||
+			  ( ( flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || ( c == '.' && !( script_p[1] >= '0' && script_p[1] <= '9' ) ) ) ) ) )
+	{
+		script_p = Lexer_SkipName( start_p + 1, flags );
+		view->text = start_p;
+		view->length = script_p - start_p;
+		view->type = TT_NAME;
+		view->subtype = view->length;
+		return 1;
+	}
+	
+	// strings that are copied verbatim
+	if( c == '\"' )
+	{
+		const char* end_p = Lexer_FindStringEnd( start_p + 1, '\"', !( flags & LEXFL_NOSTRINGESCAPECHARS ) );
+		if( *end_p == '\"' )
+		{
+			bool concat = false;
+			if( !( flags & LEXFL_NOSTRINGCONCAT ) || ( flags & LEXFL_ALLOWBACKSLASHSTRINGCONCAT ) )
+			{
+				// ReadString would append a following string
+				script_p = end_p + 1;
+				if( ReadWhiteSpace() )
+				{
+					concat = ( flags & LEXFL_NOSTRINGCONCAT ) ? ( *script_p == '\\' ) : ( *script_p == '\"' );
+				}
+				line = view->line;
+			}
+			if( !concat )
+			{
+				script_p = end_p + 1;
+				view->text = start_p + 1;
+				view->length = end_p - start_p - 1;
+				view->type = TT_STRING;
+				view->subtype = view->length;
+				return 1;
+			}
+		}
+		script_p = start_p;
+	}
+	
+	// everything else
+	idToken& token = idLexer::token;
+	token.data[0] = '\0';
+	token.len = 0;
+	token.whiteSpaceStart_p = whiteSpaceStart_p;
+	token.whiteSpaceEnd_p = whiteSpaceEnd_p;
+	token.line = view->line;
+	token.linesCrossed = view->linesCrossed;
+	token.flags = 0;
+	if( !ReadTokenText( &token ) )
+	{
+		return 0;
+	}
+	view->text = token.c_str();
+	view->length = token.Length();
+	view->type = token.type;
+	view->subtype = token.subtype;
+	return 1;
+}
+
+/*
+================
+idLexer::MaterializeToken
+================
+*/
+void idLexer::MaterializeToken( const tokenView_t* view, idToken* token ) const
+{
+	if( view->text == idLexer::token.c_str() )
+	{
+		*token = idLexer::token;
+		return;
+	}
+	token->len = 0;
+	token->AppendDirty( view->text, view->length );
+	token->data[token->len] = '\0';
+	token->type = view->type;
+	token->subtype = view->subtype;
+	token->line = view->line;
+	token->linesCrossed = view->linesCrossed;
+	token->flags = 0;
+	token->whiteSpaceStart_p = whiteSpaceStart_p;
+	token->whiteSpaceEnd_p = whiteSpaceEnd_p;
+}
+
 /*
 ================
 idLexer::ExpectTokenString
@@ -1498,23 +1932,24 @@ Internal brace depths are properly skipped.
 */
 int idLexer::SkipBracedSection( bool parseFirstBrace )
 {
-	idToken token;
+	tokenView_t token;
 	int depth;
 	
 	depth = parseFirstBrace ? 0 : 1;
 	do
 	{
-		if( !ReadToken( &token ) )
+		// the tokens are only looked at, don't copy them
+		if( !ReadTokenView( &token ) )
 		{
 			return false;
 		}
 		if( token.type == TT_PUNCTUATION )
 		{
-			if( token == "{" )
+			if( token.length == 1 && token.text[0] == '{' )
 			{
 				depth++;
 			}
-			else if( token == "}" )
+			else if( token.length == 1 && token.text[0] == '}' )
 			{
 				depth--;
 			}
@@ -2244,6 +2679,7 @@ idLexer::idLexer()
 	idLexer::token = "";
 	idLexer::next = nullptr;
 	idLexer::hadError = false;
+	idLexer::warningList = nullptr;
 }
 
 /*
@@ -2266,6 +2702,7 @@ idLexer::idLexer( int flags )
 	idLexer::token = "";
 	idLexer::next = nullptr;
 	idLexer::hadError = false;
+	idLexer::warningList = nullptr;
 }
 
 /*
@@ -2282,6 +2719,7 @@ idLexer::idLexer( const char* filename, int flags, bool OSPath )
 	idLexer::token = "";
 	idLexer::next = nullptr;
 	idLexer::hadError = false;
+	idLexer::warningList = nullptr;
 	idLexer::LoadFile( filename, OSPath );
 }
 
@@ -2299,6 +2737,7 @@ idLexer::idLexer( const char* ptr, int length, const char* name, int flags )
 	idLexer::token = "";
 	idLexer::next = nullptr;
 	idLexer::hadError = false;
+	idLexer::warningList = nullptr;
 	idLexer::LoadMemory( ptr, length, name );
 }
 
@@ -2322,6 +2761,16 @@ void idLexer::SetBaseFolder( const char* path )
 	idStr::Copynz( baseFolder, path, sizeof( baseFolder ) );
 }
 
+/*
+================
+idLexer::SetVectorScan
+================
+*/
+void idLexer::SetVectorScan( bool enable )
+{
+	lexerVectorScan = enable;
+}
+
 /*
 ================
 idLexer::HadError
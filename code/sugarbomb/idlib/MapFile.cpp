@@ -38,10 +38,13 @@ Suite 120, Rockville, Maryland 20850 USA.
 #include "precompiled.h"
 #pragma hdrstop
 
+#include "framework/CVar.hpp"
 #include "framework/IDeclManager.hpp"
 
 #include "renderer/Material.h"
 
+static idCVar map_useBinary( "map_useBinary", "1", CVAR_BOOL, "load maps from generated/maps/*.bmap if they are up to date and write them after parsing the text file" );
+
 /*
 ===============
 FloatCRC
@@ -1138,18 +1141,151 @@ idMapFile::Parse
 ===============
 */
 bool idMapFile::Parse( idDeclManager *apDeclManager, const char* filename, bool ignoreRegion, bool osPath )
+{
+	idStr sourceName;
+	idMapEntity* mapEnt;
+	int i, j, k;
+	
+	name = filename;
+	name.StripFileExtension();
+	hasPrimitiveData = false;
+	loadedFromBinary = false;
+	
+	const bool useBinary = !osPath && map_useBinary.GetBool();
+	
+	idStrStatic< MAX_OSPATH > generatedFileName = "generated/";
+	generatedFileName.AppendPath( name );
+	generatedFileName.SetFileExtension( "bmap" );
+	
+	if( useBinary )
+	{
+		// the same source file ParseText would load
+		ID_TIME_T sourceTime = FILE_NOT_FOUND_TIMESTAMP;
+		if( !ignoreRegion )
+		{
+			sourceName = name;
+			sourceName.SetFileExtension( "json" );
+			sourceTime = idLib::fileSystem->GetTimestamp( sourceName );
+		}
+		if( sourceTime == FILE_NOT_FOUND_TIMESTAMP )
+		{
+			sourceName = name;
+			sourceName.SetFileExtension( "map" );
+			sourceTime = idLib::fileSystem->GetTimestamp( sourceName );
+		}
+		
+		if( sourceTime != FILE_NOT_FOUND_TIMESTAMP )
+		{
+			loadedFromBinary = LoadBinary( apDeclManager, generatedFileName, sourceName, sourceTime );
+		}
+	}
+	
+	if( !loadedFromBinary )
+	{
+		if( !ParseText( apDeclManager, ignoreRegion, osPath, sourceName ) )
+		{
+			return false;
+		}
+		
+		SetGeometryCRC();
+		
+		if( useBinary )
+		{
+			WriteBinary( generatedFileName, sourceName );
+		}
+	}
+	
+	// if the map has a worldspawn
+	if( entities.Num() )
+	{
+	
+		// "removeEntities" "classname" can be set in the worldspawn to remove all entities with the given classname
+		const idKeyValue* removeEntities = entities[0]->epairs.MatchPrefix( "removeEntities", nullptr );
+		while( removeEntities )
+		{
+			RemoveEntities( removeEntities->GetValue() );
+			removeEntities = entities[0]->epairs.MatchPrefix( "removeEntities", removeEntities );
+		}
+		
+		// "overrideMaterial" "material" can be set in the worldspawn to reset all materials
+		idStr material;
+		if( entities[0]->epairs.GetString( "overrideMaterial", "", material ) )
+		{
+			for( i = 0; i < entities.Num(); i++ )
+			{
+				mapEnt = entities[i];
+				for( j = 0; j < mapEnt->GetNumPrimitives(); j++ )
+				{
+					idMapPrimitive* mapPrimitive = mapEnt->GetPrimitive( j );
+					switch( mapPrimitive->GetType() )
+					{
+						case idMapPrimitive::TYPE_BRUSH:
+						{
+							idMapBrush* mapBrush = static_cast<idMapBrush*>( mapPrimitive );
+							for( k = 0; k < mapBrush->GetNumSides(); k++ )
+							{
+								mapBrush->GetSide( k )->SetMaterial( material );
+							}
+							break;
+						}
+						case idMapPrimitive::TYPE_PATCH:
+						{
+							static_cast<idMapPatch*>( mapPrimitive )->SetMaterial( material );
+							break;
+						}
+					}
+				}
+			}
+		}
+		
+		// force all entities to have a name key/value pair
+		if( entities[0]->epairs.GetBool( "forceEntityNames" ) )
+		{
+			for( i = 1; i < entities.Num(); i++ )
+			{
+				mapEnt = entities[i];
+				if( !mapEnt->epairs.FindKey( "name" ) )
+				{
+					mapEnt->epairs.Set( "name", va( "%s%d", mapEnt->epairs.GetString( "classname", "forcedName" ), i ) );
+				}
+			}
+		}
+		
+		// move the primitives of any func_group entities to the worldspawn
+		if( entities[0]->epairs.GetBool( "moveFuncGroups" ) )
+		{
+			for( i = 1; i < entities.Num(); i++ )
+			{
+				mapEnt = entities[i];
+				if( idStr::Icmp( mapEnt->epairs.GetString( "classname" ), "func_group" ) == 0 )
+				{
+					entities[0]->primitives.Append( mapEnt->primitives );
+					mapEnt->primitives.Clear();
+				}
+			}
+		}
+	}
+	
+	hasPrimitiveData = true;
+	return true;
+}
+
+/*
+===============
+idMapFile::ParseText
+
+Reads the .json or .map file, sourceName is set to the file that was loaded.
+===============
+*/
+bool idMapFile::ParseText( idDeclManager *apDeclManager, bool ignoreRegion, bool osPath, idStr& sourceName )
 {
 	// no string concatenation for epairs and allow path names for materials
 	idLexer src( LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES );
 	idToken token;
 	idStr fullName;
 	idMapEntity* mapEnt;
-	int i, j, k;
 	
-	name = filename;
-	name.StripFileExtension();
 	fullName = name;
-	hasPrimitiveData = false;
 	
 	bool isJSON = false;
 	if( !ignoreRegion )
@@ -1271,80 +1407,7 @@ bool idMapFile::Parse( idDeclManager *apDeclManager, const char* filename, bool
 		}
 	}
 	
-	SetGeometryCRC();
-	
-	// if the map has a worldspawn
-	if( entities.Num() )
-	{
-	
-		// "removeEntities" "classname" can be set in the worldspawn to remove all entities with the given classname
-		const idKeyValue* removeEntities = entities[0]->epairs.MatchPrefix( "removeEntities", nullptr );
-		while( removeEntities )
-		{
-			RemoveEntities( removeEntities->GetValue() );
-			removeEntities = entities[0]->epairs.MatchPrefix( "removeEntities", removeEntities );
-		}
-		
-		// "overrideMaterial" "material" can be set in the worldspawn to reset all materials
-		idStr material;
-		if( entities[0]->epairs.GetString( "overrideMaterial", "", material ) )
-		{
-			for( i = 0; i < entities.Num(); i++ )
-			{
-				mapEnt = entities[i];
-				for( j = 0; j < mapEnt->GetNumPrimitives(); j++ )
-				{
-					idMapPrimitive* mapPrimitive = mapEnt->GetPrimitive( j );
-					switch( mapPrimitive->GetType() )
-					{
-						case idMapPrimitive::TYPE_BRUSH:
-						{
-							idMapBrush* mapBrush = static_cast<idMapBrush*>( mapPrimitive );
-							for( k = 0; k < mapBrush->GetNumSides(); k++ )
-							{
-								mapBrush->GetSide( k )->SetMaterial( material );
-							}
-							break;
-						}
-						case idMapPrimitive::TYPE_PATCH:
-						{
-							static_cast<idMapPatch*>( mapPrimitive )->SetMaterial( material );
-							break;
-						}
-					}
-				}
-			}
-		}
-		
-		// force all entities to have a name key/value pair
-		if( entities[0]->epairs.GetBool( "forceEntityNames" ) )
-		{
-			for( i = 1; i < entities.Num(); i++ )
-			{
-				mapEnt = entities[i];
-				if( !mapEnt->epairs.FindKey( "name" ) )
-				{
-					mapEnt->epairs.Set( "name", va( "%s%d", mapEnt->epairs.GetString( "classname", "forcedName" ), i ) );
-				}
-			}
-		}
-		
-		// move the primitives of any func_group entities to the worldspawn
-		if( entities[0]->epairs.GetBool( "moveFuncGroups" ) )
-		{
-			for( i = 1; i < entities.Num(); i++ )
-			{
-				mapEnt = entities[i];
-				if( idStr::Icmp( mapEnt->epairs.GetString( "classname" ), "func_group" ) == 0 )
-				{
-					entities[0]->primitives.Append( mapEnt->primitives );
-					mapEnt->primitives.Clear();
-				}
-			}
-		}
-	}
-	
-	hasPrimitiveData = true;
+	sourceName = fullName;
 	return true;
 }
 
@@ -2333,3 +2396,636 @@ bool idMapFile::ConvertToPolygonMeshFormat(idDeclManager *apDeclManager)
 }
 
 // RB end
+
+/*
+===============================================================================
+
+	Binary map files
+
+	Written to generated/maps/*.bmap after a map was parsed and loaded instead
+	of the text file as long as the source file keeps its timestamp. All strings
+	are stored once in a table at the end of the file and referenced by index.
+
+===============================================================================
+*/
+
+static const byte BMAP_VERSION = 1;
+static const unsigned int BMAP_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'P' << 8 ) | BMAP_VERSION;
+
+/*
+===============
+idMapStringTable::Intern
+===============
+*/
+int idMapStringTable::Intern( const char* string )
+{
+	const int key = idStr::Hash( string );
+	for( int i = hash.First( key ); i != -1; i = hash.Next( i ) )
+	{
+		if( strings[i].Cmp( string ) == 0 )
+		{
+			return i;
+		}
+	}
+	
+	const int index = strings.Append( string );
+	hash.Add( key, index );
+	return index;
+}
+
+/*
+===============
+ReadBinaryCount
+
+Reads an element count and fails if it is negative or if the rest of the file
+is too short to hold that many elements of at least elementSize bytes each. The
+count is 0 when it fails.
+===============
+*/
+static bool ReadBinaryCount( idFile* file, int& count, int elementSize )
+{
+	count = -1;
+	file->ReadBig( count );
+	if( count < 0 || count > ( file->Length() - file->Tell() ) / elementSize )
+	{
+		count = 0;
+		return false;
+	}
+	return true;
+}
+
+/*
+===============
+ReadBinaryString
+
+Returns nullptr for an index outside of the string table.
+===============
+*/
+static const char* ReadBinaryString( idFile* file, const idStrList& strings )
+{
+	int index = -1;
+	file->ReadBig( index );
+	if( index < 0 || index >= strings.Num() )
+	{
+		return nullptr;
+	}
+	return strings[index].c_str();
+}
+
+/*
+===============
+ReadBinaryDict
+===============
+*/
+static bool ReadBinaryDict( idFile* file, const idStrList& strings, idDict& dict )
+{
+	// key and value index
+	int numPairs = 0;
+	if( !ReadBinaryCount( file, numPairs, 8 ) )
+	{
+		return false;
+	}
+	for( int i = 0; i < numPairs; i++ )
+	{
+		const char* key = ReadBinaryString( file, strings );
+		const char* value = ReadBinaryString( file, strings );
+		if( key == nullptr || value == nullptr )
+		{
+			return false;
+		}
+		dict.Set( key, value );
+	}
+	return true;
+}
+
+/*
+===============
+WriteBinaryDict
+===============
+*/
+static void WriteBinaryDict( idFile* file, const idDict& dict, idMapStringTable& strings )
+{
+	file->WriteBig( dict.GetNumKeyVals() );
+	for( int i = 0; i < dict.GetNumKeyVals(); i++ )
+	{
+		const idKeyValue* kv = dict.GetKeyVal( i );
+		file->WriteBig( strings.Intern( kv->GetKey() ) );
+		file->WriteBig( strings.Intern( kv->GetValue() ) );
+	}
+}
+
+/*
+===============
+idMapBrush::ReadBinary
+===============
+*/
+idMapBrush* idMapBrush::ReadBinary( idFile* file, const idStrList& strings )
+{
+	idMapBrush* brush = new( TAG_IDLIB ) idMapBrush();
+	if( !ReadBinaryDict( file, strings, brush->epairs ) )
+	{
+		delete brush;
+		return nullptr;
+	}
+	
+	// material index, plane, texture matrix and origin
+	int numSides = 0;
+	if( !ReadBinaryCount( file, numSides, 4 + 13 * 4 ) )
+	{
+		delete brush;
+		return nullptr;
+	}
+	brush->sides.Resize( Max( numSides, 1 ) );
+	
+	for( int i = 0; i < numSides; i++ )
+	{
+		const char* material = ReadBinaryString( file, strings );
+		if( material == nullptr )
+		{
+			delete brush;
+			return nullptr;
+		}
+		
+		// plane, texture matrix and origin
+		float v[13];
+		file->ReadBigArray( v, 13 );
+		
+		idMapBrushSide* side = new( TAG_IDLIB ) idMapBrushSide();
+		side->material = material;
+		side->plane = idPlane( v[0], v[1], v[2], v[3] );
+		side->texMat[0].Set( v[4], v[5], v[6] );
+		side->texMat[1].Set( v[7], v[8], v[9] );
+		side->origin.Set( v[10], v[11], v[12] );
+		brush->sides.Append( side );
+	}
+	
+	return brush;
+}
+
+/*
+===============
+idMapBrush::WriteBinary
+===============
+*/
+void idMapBrush::WriteBinary( idFile* file, idMapStringTable& strings ) const
+{
+	WriteBinaryDict( file, epairs, strings );
+	
+	file->WriteBig( sides.Num() );
+	for( int i = 0; i < sides.Num(); i++ )
+	{
+		const idMapBrushSide* side = sides[i];
+		file->WriteBig( strings.Intern( side->material ) );
+		file->WriteBigArray( side->plane.ToFloatPtr(), 4 );
+		file->WriteBigArray( side->texMat[0].ToFloatPtr(), 3 );
+		file->WriteBigArray( side->texMat[1].ToFloatPtr(), 3 );
+		file->WriteBigArray( side->origin.ToFloatPtr(), 3 );
+	}
+}
+
+/*
+===============
+idMapPatch::ReadBinary
+===============
+*/
+idMapPatch* idMapPatch::ReadBinary( idFile* file, const idStrList& strings )
+{
+	idDict epairs;
+	if( !ReadBinaryDict( file, strings, epairs ) )
+	{
+		return nullptr;
+	}
+	
+	const char* material = ReadBinaryString( file, strings );
+	if( material == nullptr )
+	{
+		return nullptr;
+	}
+	
+	int info[4] = { 0, 0, 0, 0 };
+	bool explicitlySubdivided = false;
+	file->ReadBigArray( info, 4 );
+	file->ReadBool( explicitlySubdivided );
+	
+	// xyz and st of every control point
+	const int remaining = file->Length() - file->Tell();
+	if( info[0] < 1 || info[1] < 1 || info[1] > remaining / ( 5 * 4 ) || info[0] > remaining / ( 5 * 4 * info[1] ) )
+	{
+		return nullptr;
+	}
+	
+	idMapPatch* patch = new( TAG_IDLIB ) idMapPatch( info[0], info[1] );
+	patch->SetSize( info[0], info[1] );
+	patch->SetMaterial( material );
+	patch->SetHorzSubdivisions( info[2] );
+	patch->SetVertSubdivisions( info[3] );
+	patch->SetExplicitlySubdivided( explicitlySubdivided );
+	patch->epairs.TransferKeyValues( epairs );
+	
+	const int numVerts = patch->GetWidth() * patch->GetHeight();
+	idTempArray<float> v( numVerts * 5 );
+	file->ReadBigArray( v.Ptr(), numVerts * 5 );
+	
+	for( int i = 0; i < numVerts; i++ )
+	{
+		const float* p = &v[i * 5];
+		idDrawVert& vert = patch->verts[i];
+		vert.xyz.Set( p[0], p[1], p[2] );
+		vert.SetTexCoord( p[3], p[4] );
+	}
+	
+	return patch;
+}
+
+/*
+===============
+idMapPatch::WriteBinary
+===============
+*/
+void idMapPatch::WriteBinary( idFile* file, idMapStringTable& strings ) const
+{
+	WriteBinaryDict( file, epairs, strings );
+	
+	file->WriteBig( strings.Intern( material ) );
+	file->WriteBig( GetWidth() );
+	file->WriteBig( GetHeight() );
+	file->WriteBig( horzSubdivisions );
+	file->WriteBig( vertSubdivisions );
+	file->WriteBool( explicitSubdivisions );
+	
+	const int numVerts = GetWidth() * GetHeight();
+	for( int i = 0; i < numVerts; i++ )
+	{
+		const idVec2 st = verts[i].GetTexCoord();
+		file->WriteBigArray( verts[i].xyz.ToFloatPtr(), 3 );
+		file->WriteBigArray( st.ToFloatPtr(), 2 );
+	}
+}
+
+/*
+===============
+MapPolygonMesh::ReadBinary
+===============
+*/
+MapPolygonMesh* MapPolygonMesh::ReadBinary( idDeclManager *apDeclManager, idFile* file, const idStrList& strings )
+{
+	MapPolygonMesh* mesh = new MapPolygonMesh( apDeclManager );
+	if( !ReadBinaryDict( file, strings, mesh->epairs ) )
+	{
+		delete mesh;
+		return nullptr;
+	}
+	
+	// xyz, st and normal of every vertex
+	int numVertices = 0;
+	if( !ReadBinaryCount( file, numVertices, 8 * 4 ) )
+	{
+		delete mesh;
+		return nullptr;
+	}
+	
+	idTempArray<float> v( numVertices * 8 );
+	file->ReadBigArray( v.Ptr(), numVertices * 8 );
+	
+	mesh->verts.SetNum( numVertices );
+	for( int i = 0; i < numVertices; i++ )
+	{
+		const float* p = &v[i * 8];
+		idDrawVert& vert = mesh->verts[i];
+		vert.Clear();
+		vert.xyz.Set( p[0], p[1], p[2] );
+		vert.SetTexCoord( p[3], p[4] );
+		vert.SetNormal( idVec3( p[5], p[6], p[7] ) );
+	}
+	
+	// material index and index count
+	int numPolygons = 0;
+	if( !ReadBinaryCount( file, numPolygons, 8 ) )
+	{
+		delete mesh;
+		return nullptr;
+	}
+	mesh->polygons.Resize( Max( numPolygons, 1 ) );
+	
+	for( int i = 0; i < numPolygons; i++ )
+	{
+		MapPolygon& polygon = mesh->polygons.Alloc();
+		
+		const char* material = ReadBinaryString( file, strings );
+		int numIndexes = 0;
+		if( material == nullptr || !ReadBinaryCount( file, numIndexes, 4 ) )
+		{
+			delete mesh;
+			return nullptr;
+		}
+		
+		polygon.SetMaterial( material );
+		polygon.indexes.SetNum( numIndexes );
+		file->ReadBigArray( polygon.indexes.Ptr(), numIndexes );
+		
+		for( int j = 0; j < numIndexes; j++ )
+		{
+			if( polygon.indexes[j] < 0 || polygon.indexes[j] >= numVertices )
+			{
+				delete mesh;
+				return nullptr;
+			}
+		}
+	}
+	
+	mesh->SetContents();
+	
+	return mesh;
+}
+
+/*
+===============
+MapPolygonMesh::WriteBinary
+===============
+*/
+void MapPolygonMesh::WriteBinary( idFile* file, idMapStringTable& strings ) const
+{
+	WriteBinaryDict( file, epairs, strings );
+	
+	file->WriteBig( verts.Num() );
+	for( int i = 0; i < verts.Num(); i++ )
+	{
+		const idVec2 st = verts[i].GetTexCoord();
+		const idVec3 normal = verts[i].GetNormal();
+		file->WriteBigArray( verts[i].xyz.ToFloatPtr(), 3 );
+		file->WriteBigArray( st.ToFloatPtr(), 2 );
+		file->WriteBigArray( normal.ToFloatPtr(), 3 );
+	}
+	
+	file->WriteBig( polygons.Num() );
+	for( int i = 0; i < polygons.Num(); i++ )
+	{
+		const MapPolygon& polygon = polygons[i];
+		file->WriteBig( strings.Intern( polygon.GetMaterial() ) );
+		file->WriteBig( polygon.indexes.Num() );
+		file->WriteBigArray( polygon.indexes.Ptr(), polygon.indexes.Num() );
+	}
+}
+
+/*
+===============
+idMapEntity::ReadBinary
+===============
+*/
+idMapEntity* idMapEntity::ReadBinary( idDeclManager *apDeclManager, idFile* file, const idStrList& strings )
+{
+	idMapEntity* mapEnt = new( TAG_IDLIB ) idMapEntity();
+	if( !ReadBinaryDict( file, strings, mapEnt->epairs ) )
+	{
+		delete mapEnt;
+		return nullptr;
+	}
+	
+	// type and at least an empty dict
+	int numPrimitives = 0;
+	if( !ReadBinaryCount( file, numPrimitives, 8 ) )
+	{
+		delete mapEnt;
+		return nullptr;
+	}
+	mapEnt->primitives.Resize( Max( numPrimitives, 1 ) );
+	
+	for( int i = 0; i < numPrimitives; i++ )
+	{
+		int type = idMapPrimitive::TYPE_INVALID;
+		file->ReadBig( type );
+		
+		idMapPrimitive* mapPrim = nullptr;
+		switch( type )
+		{
+			case idMapPrimitive::TYPE_BRUSH:
+				mapPrim = idMapBrush::ReadBinary( file, strings );
+				break;
+			case idMapPrimitive::TYPE_PATCH:
+				mapPrim = idMapPatch::ReadBinary( file, strings );
+				break;
+			case idMapPrimitive::TYPE_MESH:
+				mapPrim = MapPolygonMesh::ReadBinary( apDeclManager, file, strings );
+				break;
+		}
+		
+		if( mapPrim == nullptr )
+		{
+			delete mapEnt;
+			return nullptr;
+		}
+		mapEnt->AddPrimitive( mapPrim );
+	}
+	
+	return mapEnt;
+}
+
+/*
+===============
+idMapEntity::WriteBinary
+===============
+*/
+void idMapEntity::WriteBinary( idFile* file, idMapStringTable& strings ) const
+{
+	WriteBinaryDict( file, epairs, strings );
+	
+	file->WriteBig( primitives.Num() );
+	for( int i = 0; i < primitives.Num(); i++ )
+	{
+		const idMapPrimitive* mapPrim = primitives[i];
+		file->WriteBig( mapPrim->GetType() );
+		
+		switch( mapPrim->GetType() )
+		{
+			case idMapPrimitive::TYPE_BRUSH:
+				static_cast<const idMapBrush*>( mapPrim )->WriteBinary( file, strings );
+				break;
+			case idMapPrimitive::TYPE_PATCH:
+				static_cast<const idMapPatch*>( mapPrim )->WriteBinary( file, strings );
+				break;
+			case idMapPrimitive::TYPE_MESH:
+				static_cast<const MapPolygonMesh*>( mapPrim )->WriteBinary( file, strings );
+				break;
+		}
+	}
+}
+
+/*
+===============
+idMapFile::LoadBinary
+
+Fails if the binary file was written from another source file or the geometry
+read from it doesn't match the geometry CRC that was stored with it.
+===============
+*/
+bool idMapFile::LoadBinary( idDeclManager *apDeclManager, const char* fileName, const char* sourceName, ID_TIME_T sourceTime )
+{
+	idFile* file = idLib::fileSystem->OpenFileReadMemory( fileName );
+	if( file == nullptr )
+	{
+		return false;
+	}
+	
+	unsigned int magic = 0;
+	idStr source;
+	ID_TIME_T time = 0;
+	unsigned int crc = 0;
+	int stringTableOffset = 0;
+	int numEntities = 0;
+	
+	// the magic is written last, so a file with the wrong magic may be truncated
+	// or from another version and nothing else in it can be trusted
+	file->ReadBig( magic );
+	if( magic != BMAP_MAGIC )
+	{
+		idLib::fileSystem->CloseFile( file );
+		return false;
+	}
+	
+	int sourceLength = 0;
+	if( !ReadBinaryCount( file, sourceLength, 1 ) )
+	{
+		idLib::fileSystem->CloseFile( file );
+		return false;
+	}
+	source.Fill( ' ', sourceLength );
+	file->Read( &source[0], sourceLength );
+	file->ReadBig( time );
+	
+	if( source.Icmp( sourceName ) != 0 || time != sourceTime )
+	{
+		idLib::fileSystem->CloseFile( file );
+		return false;
+	}
+	
+	file->ReadBig( version );
+	file->ReadBig( crc );
+	file->ReadBig( stringTableOffset );
+	
+	// dict and primitive count of every entity
+	bool ok = ReadBinaryCount( file, numEntities, 8 );
+	
+	const int entitiesOffset = file->Tell();
+	
+	// the string table follows the entities
+	idStrList strings;
+	int numStrings = 0;
+	if( ok && stringTableOffset >= entitiesOffset && stringTableOffset < file->Length() )
+	{
+		file->Seek( stringTableOffset, FS_SEEK_SET );
+		
+		// length of every string
+		ok = ReadBinaryCount( file, numStrings, 4 );
+		strings.SetNum( numStrings );
+		for( int i = 0; i < strings.Num(); i++ )
+		{
+			int length = 0;
+			if( !ReadBinaryCount( file, length, 1 ) )
+			{
+				ok = false;
+				break;
+			}
+			strings[i].Fill( ' ', length );
+			file->Read( &strings[i][0], length );
+		}
+		file->Seek( entitiesOffset, FS_SEEK_SET );
+	}
+	else
+	{
+		ok = false;
+	}
+	
+	entities.DeleteContents( true );
+	entities.Resize( Max( numEntities, 1 ) );
+	
+	for( int i = 0; ok && i < numEntities; i++ )
+	{
+		idMapEntity* mapEnt = idMapEntity::ReadBinary( apDeclManager, file, strings );
+		if( mapEnt == nullptr )
+		{
+			ok = false;
+			break;
+		}
+		entities.Append( mapEnt );
+	}
+	
+	idLib::fileSystem->CloseFile( file );
+	
+	if( ok )
+	{
+		SetGeometryCRC();
+		ok = ( geometryCRC == crc );
+	}
+	
+	if( !ok )
+	{
+		idLib::sys->Warning( "%s is corrupt, parsing %s\n", fileName, sourceName );
+		entities.DeleteContents( true );
+		version = CURRENT_MAP_VERSION;
+		return false;
+	}
+	
+	fileTime = sourceTime;
+	return true;
+}
+
+/*
+===============
+idMapFile::WriteBinary
+===============
+*/
+bool idMapFile::WriteBinary( const char* fileName, const char* sourceName ) const
+{
+	// written to a temporary file that replaces the old one once it is complete, so a
+	// crash while writing never leaves a truncated file with a valid header behind
+	idStr tempFileName = fileName;
+	tempFileName.SetFileExtension( "tmp" );
+	
+	idFile* file = idLib::fileSystem->OpenFileWrite( tempFileName, "fs_basepath" );
+	if( file == nullptr )
+	{
+		idLib::sys->Warning( "Couldn't open %s\n", tempFileName.c_str() );
+		return false;
+	}
+	
+	// the magic is written last as well
+	file->WriteBig( 0u );
+	file->WriteString( sourceName );
+	file->WriteBig( fileTime );
+	file->WriteBig( version );
+	file->WriteBig( geometryCRC );
+	
+	// filled in once the strings are known
+	const int stringTableOffsetPos = file->Tell();
+	file->WriteBig( 0 );
+	
+	idMapStringTable strings;
+	file->WriteBig( entities.Num() );
+	for( int i = 0; i < entities.Num(); i++ )
+	{
+		entities[i]->WriteBinary( file, strings );
+	}
+	
+	const int stringTableOffset = file->Tell();
+	file->WriteBig( strings.GetStrings().Num() );
+	for( int i = 0; i < strings.GetStrings().Num(); i++ )
+	{
+		file->WriteString( strings.GetStrings()[i] );
+	}
+	
+	file->Seek( stringTableOffsetPos, FS_SEEK_SET );
+	file->WriteBig( stringTableOffset );
+	
+	file->Seek( 0, FS_SEEK_SET );
+	file->WriteBig( BMAP_MAGIC );
+	
+	idLib::fileSystem->CloseFile( file );
+	
+	if( !idLib::fileSystem->RenameFile( tempFileName, fileName, "fs_basepath" ) )
+	{
+		idLib::fileSystem->RemoveFile( tempFileName );
+		return false;
+	}
+	
+	return true;
+}
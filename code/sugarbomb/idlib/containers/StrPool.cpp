@@ -0,0 +1,348 @@
+/*
+*******************************************************************************
+
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+Copyright (C) 2019 SugarBombEngine Developers
+
+This file is part of SugarBombEngine
+
+SugarBombEngine is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+SugarBombEngine is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with SugarBombEngine. If not, see <http://www.gnu.org/licenses/>.
+
+In addition, SugarBombEngine is using id Tech 4 (BFG) pieces and thus
+subject to certain additional terms (all header and source files which 
+contains such pieces has this additional part appended to the license 
+header). You should have received a copy of these additional terms 
+stated in a separate file (LICENSE-idTech4) which accompanied the 
+SugarBombEngine source code. If not, please request a copy in 
+writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional
+terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc.,
+Suite 120, Rockville, Maryland 20850 USA.
+
+*******************************************************************************
+*/
+
+
+#pragma hdrstop
+#include "precompiled.h"
+
+/*
+================
+idStrPool::idStrPool
+================
+*/
+idStrPool::idStrPool( bool caseSensitive, bool permanent ) : permanent( permanent )
+{
+	this->caseSensitive = caseSensitive;
+	memset( buckets, 0, sizeof( buckets ) );
+	numPermanent = 0;
+}
+
+/*
+================
+idStrPool::Hash
+================
+*/
+ID_INLINE int idStrPool::Hash( const char* string ) const
+{
+	return caseSensitive ? idStr::Hash( string ) : idStr::IHash( string );
+}
+
+/*
+================
+idStrPool::Compare
+================
+*/
+ID_INLINE int idStrPool::Compare( const idPoolStr* poolStr, const char* string ) const
+{
+	return caseSensitive ? poolStr->Cmp( string ) : poolStr->Icmp( string );
+}
+
+/*
+================
+PoolSlot
+
+The high bits of the hash scrambled, the low bits are used by the hash index of each shard.
+================
+*/
+static int PoolSlot( int hash, int bits )
+{
+	return ( int )( ( ( unsigned int )hash * 0x9E3779B1u ) >> ( 32 - bits ) );
+}
+
+/*
+================
+idStrPool::FindPermanent
+
+Walks a bucket chain from first up to but not including last.
+================
+*/
+const idPoolStr* idStrPool::FindPermanent( const idPoolStr* first, const idPoolStr* last, int hash, const char* string ) const
+{
+	for( const idPoolStr* poolStr = first; poolStr != last; poolStr = poolStr->next )
+	{
+		if( poolStr->hash == hash && Compare( poolStr, string ) == 0 )
+		{
+			return poolStr;
+		}
+	}
+	return nullptr;
+}
+
+/*
+================
+idStrPool::AllocPermanentString
+
+Strings are only ever prepended to a bucket, with a compare exchange on the bucket head,
+so readers can walk a chain while other threads insert.
+================
+*/
+const idPoolStr* idStrPool::AllocPermanentString( const char* string )
+{
+	const int hash = Hash( string );
+	idPoolStr*& bucket = buckets[PoolSlot( hash, PERMANENT_HASH_BITS )];
+	
+	idPoolStr* head = bucket;
+	const idPoolStr* found = FindPermanent( head, nullptr, hash, string );
+	if( found != nullptr )
+	{
+		return found;
+	}
+	
+	idPoolStr* poolStr = new( TAG_IDLIB_STRING ) idPoolStr;
+	*static_cast<idStr*>( poolStr ) = string;
+	poolStr->pool = this;
+	poolStr->hash = hash;
+	
+	while( true )
+	{
+		poolStr->next = head;
+		idPoolStr* current = static_cast<idPoolStr*>( Sys_InterlockedCompareExchangePointer( reinterpret_cast<void*&>( bucket ), head, poolStr ) );
+		if( current == head )
+		{
+			Sys_InterlockedIncrement( numPermanent );
+			return poolStr;
+		}
+		
+		// another thread got in first, it may have added the same string
+		found = FindPermanent( current, head, hash, string );
+		if( found != nullptr )
+		{
+			delete poolStr;
+			return found;
+		}
+		head = current;
+	}
+}
+
+/*
+================
+idStrPool::AllocString
+================
+*/
+const idPoolStr* idStrPool::AllocString( const char* string )
+{
+	if( permanent )
+	{
+		return AllocPermanentString( string );
+	}
+	
+	const int hash = Hash( string );
+	poolShard_t& shard = shards[PoolSlot( hash, SHARD_BITS )];
+	
+	idScopedCriticalSection lock( shard.mutex );
+	
+	for( int i = shard.poolHash.First( hash ); i != -1; i = shard.poolHash.Next( i ) )
+	{
+		idPoolStr* poolStr = shard.pool[i];
+		if( poolStr->hash == hash && Compare( poolStr, string ) == 0 )
+		{
+			poolStr->numUsers++;
+			return poolStr;
+		}
+	}
+	
+	idPoolStr* poolStr = new( TAG_IDLIB_STRING ) idPoolStr;
+	*static_cast<idStr*>( poolStr ) = string;
+	poolStr->pool = this;
+	poolStr->numUsers = 1;
+	poolStr->hash = hash;
+	shard.poolHash.Add( hash, shard.pool.Append( poolStr ) );
+	return poolStr;
+}
+
+/*
+================
+idStrPool::FreeString
+================
+*/
+void idStrPool::FreeString( const idPoolStr* poolStr )
+{
+	// permanent strings stay until the pool is cleared
+	if( permanent )
+	{
+		return;
+	}
+	
+	poolShard_t& shard = shards[PoolSlot( poolStr->hash, SHARD_BITS )];
+	
+	idScopedCriticalSection lock( shard.mutex );
+	
+	/*
+	 * DG: numUsers can actually be 0 when shutting down the game, because then
+	 * first idCommonLocal::Quit() -> idCommonLocal::Shutdown() -> idLib::Shutdown()
+	 * -> idDict::Shutdown() -> idDict::globalKeys.Clear() and idDict::globalVars.Clear()
+	 * is called and then, from destructors,
+	 * ~idSessionLocal() => destroy idDict titleStorageVars -> ~idDict() -> idDict::Clear()
+	 * -> idDict::globalVars.FreeString() and idDict::globalKeys.FreeString() (this function)
+	 * is called, leading here.
+	 * So just return if poolStr->numUsers < 1, instead of segfaulting/asserting below
+	 * when i == -1 because nothing was found here. As there is no nice way to find out if
+	 * we're shutting down (at this point) just get rid of the following assertion:
+	 * assert( poolStr->numUsers >= 1 );
+	 */
+	if( poolStr->numUsers < 1 )
+		return;
+	// DG end
+	
+	assert( poolStr->pool == this );
+	
+	poolStr->numUsers--;
+	if( poolStr->numUsers <= 0 )
+	{
+		int i;
+		for( i = shard.poolHash.First( poolStr->hash ); i != -1; i = shard.poolHash.Next( i ) )
+		{
+			if( shard.pool[i] == poolStr )
+			{
+				break;
+			}
+		}
+		assert( i != -1 );
+		delete shard.pool[i];
+		shard.pool.RemoveIndex( i );
+		shard.poolHash.RemoveIndex( poolStr->hash, i );
+	}
+}
+
+/*
+================
+idStrPool::CopyString
+================
+*/
+const idPoolStr* idStrPool::CopyString( const idPoolStr* poolStr )
+{
+	assert( poolStr->pool->permanent || poolStr->numUsers >= 1 );
+	
+	if( poolStr->pool == this )
+	{
+		// the string is from this pool so just increase the user count
+		if( !permanent )
+		{
+			idScopedCriticalSection lock( shards[PoolSlot( poolStr->hash, SHARD_BITS )].mutex );
+			poolStr->numUsers++;
+		}
+		return poolStr;
+	}
+	else
+	{
+		// the string is from another pool so it needs to be re-allocated from this pool.
+		return AllocString( poolStr->c_str() );
+	}
+}
+
+/*
+================
+idStrPool::Clear
+================
+*/
+void idStrPool::Clear()
+{
+	for( int i = 0; i < NUM_SHARDS; i++ )
+	{
+		poolShard_t& shard = shards[i];
+		for( int j = 0; j < shard.pool.Num(); j++ )
+		{
+			shard.pool[j]->numUsers = 0;
+		}
+		shard.pool.DeleteContents( true );
+		shard.poolHash.Free();
+	}
+	
+	for( int i = 0; i < ( 1 << PERMANENT_HASH_BITS ); i++ )
+	{
+		idPoolStr* next;
+		for( idPoolStr* poolStr = buckets[i]; poolStr != nullptr; poolStr = next )
+		{
+			next = poolStr->next;
+			delete poolStr;
+		}
+		buckets[i] = nullptr;
+	}
+	numPermanent = 0;
+}
+
+/*
+================
+idStrPool::Num
+================
+*/
+int idStrPool::Num() const
+{
+	int num = numPermanent;
+	for( int i = 0; i < NUM_SHARDS; i++ )
+	{
+		num += shards[i].pool.Num();
+	}
+	return num;
+}
+
+/*
+================
+idStrPool::Allocated
+================
+*/
+size_t idStrPool::Allocated() const
+{
+	size_t size = 0;
+	for( int i = 0; i < NUM_SHARDS; i++ )
+	{
+		const poolShard_t& shard = shards[i];
+		size += shard.pool.Allocated() + shard.poolHash.Allocated();
+		for( int j = 0; j < shard.pool.Num(); j++ )
+		{
+			size += shard.pool[j]->Allocated();
+		}
+	}
+	
+	for( int i = 0; i < ( 1 << PERMANENT_HASH_BITS ); i++ )
+	{
+		for( const idPoolStr* poolStr = buckets[i]; poolStr != nullptr; poolStr = poolStr->next )
+		{
+			size += poolStr->Allocated();
+		}
+	}
+	return size;
+}
+
+/*
+================
+idStrPool::Size
+================
+*/
+size_t idStrPool::Size() const
+{
+	return sizeof( *this ) + Allocated() + Num() * sizeof( idPoolStr );
+}
@@ -956,6 +956,122 @@ void TestUntransformJoints()
 	PrintClocks( va( "   simd->UntransformJoints() %s", result ), COUNT, bestClocksSIMD, bestClocksGeneric );
 }
 
+/*
+============
+TestTransformVertsAndTangents
+============
+*/
+void TestTransformVertsAndTangents()
+{
+	int i, j;
+	TIME_TYPE start, end, bestClocksGeneric, bestClocksSIMD;
+	idTempArray< idJointMat > joints( COUNT );
+	idTempArray< idDrawVert > baseVerts( BIG_COUNT );
+	idTempArray< idDrawVert > verts1( BIG_COUNT );
+	idTempArray< idDrawVert > verts2( BIG_COUNT );
+	const char* result;
+	
+	idRandom srnd( RANDOM_SEED );
+	
+	for( i = 0; i < COUNT; i++ )
+	{
+		idAngles angles;
+		angles[0] = srnd.CRandomFloat() * 180.0f;
+		angles[1] = srnd.CRandomFloat() * 180.0f;
+		angles[2] = srnd.CRandomFloat() * 180.0f;
+		joints[i].SetRotation( angles.ToMat3() );
+		idVec3 v;
+		v[0] = srnd.CRandomFloat() * 2.0f;
+		v[1] = srnd.CRandomFloat() * 2.0f;
+		v[2] = srnd.CRandomFloat() * 2.0f;
+		joints[i].SetTranslation( v );
+	}
+	
+	for( i = 0; i < BIG_COUNT; i++ )
+	{
+		idVec3 n( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		idVec3 t( srnd.CRandomFloat(), srnd.CRandomFloat(), srnd.CRandomFloat() );
+		n.Normalize();
+		t.Normalize();
+		
+		baseVerts[i].Clear();
+		baseVerts[i].xyz[0] = srnd.CRandomFloat() * 10.0f;
+		baseVerts[i].xyz[1] = srnd.CRandomFloat() * 10.0f;
+		baseVerts[i].xyz[2] = srnd.CRandomFloat() * 10.0f;
+		baseVerts[i].SetNormal( n );
+		baseVerts[i].SetTangent( t );
+		
+		int weightsLeft = 255;
+		for( j = 0; j < 3; j++ )
+		{
+			baseVerts[i].color[j] = srnd.RandomInt( COUNT );
+			baseVerts[i].color2[j] = srnd.RandomInt( weightsLeft + 1 );
+			weightsLeft -= baseVerts[i].color2[j];
+		}
+		baseVerts[i].color[3] = srnd.RandomInt( COUNT );
+		baseVerts[i].color2[3] = weightsLeft;
+	}
+	
+	bestClocksGeneric = 0;
+	for( i = 0; i < NUMTESTS; i++ )
+	{
+		StartRecordTime( start );
+		p_generic->TransformVertsAndTangents( verts1.Ptr(), BIG_COUNT, baseVerts.Ptr(), joints.Ptr() );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksGeneric );
+	}
+	PrintClocks( "generic->TransformVertsAndTangents()", BIG_COUNT, bestClocksGeneric );
+	
+	bestClocksSIMD = 0;
+	for( i = 0; i < NUMTESTS; i++ )
+	{
+		StartRecordTime( start );
+		p_simd->TransformVertsAndTangents( verts2.Ptr(), BIG_COUNT, baseVerts.Ptr(), joints.Ptr() );
+		StopRecordTime( end );
+		GetBest( start, end, bestClocksSIMD );
+	}
+	
+	for( i = 0; i < BIG_COUNT; i++ )
+	{
+		if( !verts1[i].xyz.Compare( verts2[i].xyz, 1e-3f ) )
+		{
+			break;
+		}
+		// the SIMD path re-normalizes with a reciprocal square root estimate, allow one step of byte rounding
+		if( !verts1[i].GetNormalRaw().Compare( verts2[i].GetNormalRaw(), 2.5f / 255.0f ) )
+		{
+			break;
+		}
+		if( !verts1[i].GetTangentRaw().Compare( verts2[i].GetTangentRaw(), 2.5f / 255.0f ) )
+		{
+			break;
+		}
+	}
+	result = ( i >= BIG_COUNT ) ? "ok" : S_COLOR_RED"X";
+	PrintClocks( va( "   simd->TransformVertsAndTangents() %s", result ), BIG_COUNT, bestClocksSIMD, bestClocksGeneric );
+	
+	// the clock counters are not available on every platform, so also report the throughput
+	const int numPasses = 64;
+	
+	uint64 startMicroseconds = Sys_Microseconds();
+	for( i = 0; i < numPasses; i++ )
+	{
+		p_generic->TransformVertsAndTangents( verts1.Ptr(), BIG_COUNT, baseVerts.Ptr(), joints.Ptr() );
+	}
+	const uint64 genericMicroseconds = Max( Sys_Microseconds() - startMicroseconds, ( uint64 )1 );
+	
+	startMicroseconds = Sys_Microseconds();
+	for( i = 0; i < numPasses; i++ )
+	{
+		p_simd->TransformVertsAndTangents( verts2.Ptr(), BIG_COUNT, baseVerts.Ptr(), joints.Ptr() );
+	}
+	const uint64 simdMicroseconds = Max( Sys_Microseconds() - startMicroseconds, ( uint64 )1 );
+	
+	idLib::sys->Printf( "TransformVertsAndTangents: generic %.0f verts/ms, simd %.0f verts/ms\n",
+						( float )BIG_COUNT * numPasses * 1000.0f / genericMicroseconds,
+						( float )BIG_COUNT * numPasses * 1000.0f / simdMicroseconds );
+}
+
 /*
 ============
 TestMath
@@ -1426,6 +1542,7 @@ void idSIMD::Test_f( const idCmdArgs& args )
 	TestConvertJointMatsToJointQuats();
 	TestTransformJoints();
 	TestUntransformJoints();
+	TestTransformVertsAndTangents();
 	
 	idLib::sys->Printf( "====================================\n" );
 	
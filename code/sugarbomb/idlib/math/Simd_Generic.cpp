@@ -243,3 +243,37 @@ void VPCALL idSIMD_Generic::UntransformJoints( idJointMat* jointMats, const int*
 		jointMats[i] /= jointMats[parents[i]];
 	}
 }
+
+/*
+============
+idSIMD_Generic::TransformVertsAndTangents
+============
+*/
+void VPCALL idSIMD_Generic::TransformVertsAndTangents( idDrawVert* targetVerts, const int numVerts, const idDrawVert* baseVerts, const idJointMat* joints )
+{
+	for( int i = 0; i < numVerts; i++ )
+	{
+		const idDrawVert& base = baseVerts[i];
+		
+		const idJointMat& j0 = joints[base.color[0]];
+		const idJointMat& j1 = joints[base.color[1]];
+		const idJointMat& j2 = joints[base.color[2]];
+		const idJointMat& j3 = joints[base.color[3]];
+		
+		const float w0 = base.color2[0] * ( 1.0f / 255.0f );
+		const float w1 = base.color2[1] * ( 1.0f / 255.0f );
+		const float w2 = base.color2[2] * ( 1.0f / 255.0f );
+		const float w3 = base.color2[3] * ( 1.0f / 255.0f );
+		
+		idJointMat accum;
+		idJointMat::Mul( accum, j0, w0 );
+		idJointMat::Mad( accum, j1, w1 );
+		idJointMat::Mad( accum, j2, w2 );
+		idJointMat::Mad( accum, j3, w3 );
+		
+		targetVerts[i].xyz = accum * idVec4( base.xyz.x, base.xyz.y, base.xyz.z, 1.0f );
+		targetVerts[i].SetNormal( accum * base.GetNormal() );
+		targetVerts[i].SetTangent( accum * base.GetTangent() );
+		targetVerts[i].tangent[3] = base.tangent[3];
+	}
+}
@@ -974,5 +974,161 @@ void VPCALL idSIMD_SSE::UntransformJoints( idJointMat* jointMats, const int* par
 	}
 }
 
+/*
+============
+idSIMD_SSE::TransformVertsAndTangents
+
+Skins four vertices at a time. The blended joint matrices of the four vertices are
+transposed so every matrix element of all four vertices lives in a single register,
+which lets the position, normal and tangent transforms run without shuffles.
+============
+*/
+void VPCALL idSIMD_SSE::TransformVertsAndTangents( idDrawVert* targetVerts, const int numVerts, const idDrawVert* baseVerts, const idJointMat* joints )
+{
+	const __m128 vector_float_one			= { 1.0f, 1.0f, 1.0f, 1.0f };
+	const __m128 vector_float_half			= { 0.5f, 0.5f, 0.5f, 0.5f };
+	const __m128 vector_float_255_over_2	= { 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f };
+	const __m128 vector_float_2_over_255	= { 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f };
+	const __m128 vector_float_1_over_255	= { 1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f, 1.0f / 255.0f };
+	const __m128 vector_float_rsqrt_c0		= {  -3.0f,  -3.0f,  -3.0f,  -3.0f };
+	const __m128 vector_float_rsqrt_c1		= {  -0.5f,  -0.5f,  -0.5f,  -0.5f };
+	const __m128 vector_float_tiny			= {    1e-10f,    1e-10f,    1e-10f,    1e-10f };
+	
+	const float* __restrict jointsPtr = joints->ToFloatPtr();
+	
+	ALIGN16( byte normalBytes[16] );
+	ALIGN16( byte tangentBytes[16] );
+	
+	int i = 0;
+	for( ; i + 4 <= numVerts; i += 4 )
+	{
+		const idDrawVert* __restrict base = baseVerts + i;
+		
+		// blend the joint matrices of each vertex
+		__m128 ma[4];
+		__m128 mb[4];
+		__m128 mc[4];
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			const float* __restrict j0 = jointsPtr + base[k].color[0] * 12;
+			const float* __restrict j1 = jointsPtr + base[k].color[1] * 12;
+			const float* __restrict j2 = jointsPtr + base[k].color[2] * 12;
+			const float* __restrict j3 = jointsPtr + base[k].color[3] * 12;
+			
+			const __m128i wi = _mm_cvtsi32_si128( *( const int* )base[k].color2 );
+			const __m128 w = _mm_mul_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( _mm_unpacklo_epi8( wi, _mm_setzero_si128() ), _mm_setzero_si128() ) ), vector_float_1_over_255 );
+			
+			const __m128 w0 = _mm_splat_ps( w, 0 );
+			const __m128 w1 = _mm_splat_ps( w, 1 );
+			const __m128 w2 = _mm_splat_ps( w, 2 );
+			const __m128 w3 = _mm_splat_ps( w, 3 );
+			
+			ma[k] = _mm_mul_ps( _mm_load_ps( j0 + 0 ), w0 );
+			mb[k] = _mm_mul_ps( _mm_load_ps( j0 + 4 ), w0 );
+			mc[k] = _mm_mul_ps( _mm_load_ps( j0 + 8 ), w0 );
+			
+			ma[k] = _mm_madd_ps( _mm_load_ps( j1 + 0 ), w1, ma[k] );
+			mb[k] = _mm_madd_ps( _mm_load_ps( j1 + 4 ), w1, mb[k] );
+			mc[k] = _mm_madd_ps( _mm_load_ps( j1 + 8 ), w1, mc[k] );
+			
+			ma[k] = _mm_madd_ps( _mm_load_ps( j2 + 0 ), w2, ma[k] );
+			mb[k] = _mm_madd_ps( _mm_load_ps( j2 + 4 ), w2, mb[k] );
+			mc[k] = _mm_madd_ps( _mm_load_ps( j2 + 8 ), w2, mc[k] );
+			
+			ma[k] = _mm_madd_ps( _mm_load_ps( j3 + 0 ), w3, ma[k] );
+			mb[k] = _mm_madd_ps( _mm_load_ps( j3 + 4 ), w3, mb[k] );
+			mc[k] = _mm_madd_ps( _mm_load_ps( j3 + 8 ), w3, mc[k] );
+		}
+		
+		// after the transpose ma[n] holds matrix element [0][n] of all four vertices
+		_MM_TRANSPOSE4_PS( ma[0], ma[1], ma[2], ma[3] );
+		_MM_TRANSPOSE4_PS( mb[0], mb[1], mb[2], mb[3] );
+		_MM_TRANSPOSE4_PS( mc[0], mc[1], mc[2], mc[3] );
+		
+		// position
+		const __m128 px = _mm_setr_ps( base[0].xyz.x, base[1].xyz.x, base[2].xyz.x, base[3].xyz.x );
+		const __m128 py = _mm_setr_ps( base[0].xyz.y, base[1].xyz.y, base[2].xyz.y, base[3].xyz.y );
+		const __m128 pz = _mm_setr_ps( base[0].xyz.z, base[1].xyz.z, base[2].xyz.z, base[3].xyz.z );
+		
+		__m128 tx = _mm_madd_ps( ma[0], px, _mm_madd_ps( ma[1], py, _mm_madd_ps( ma[2], pz, ma[3] ) ) );
+		__m128 ty = _mm_madd_ps( mb[0], px, _mm_madd_ps( mb[1], py, _mm_madd_ps( mb[2], pz, mb[3] ) ) );
+		__m128 tz = _mm_madd_ps( mc[0], px, _mm_madd_ps( mc[1], py, _mm_madd_ps( mc[2], pz, mc[3] ) ) );
+		
+		ALIGN16( float positions[3][4] );
+		_mm_store_ps( positions[0], tx );
+		_mm_store_ps( positions[1], ty );
+		_mm_store_ps( positions[2], tz );
+		
+		// normal and tangent, decoded and re-normalized like idDrawVert::GetNormal() and idDrawVert::GetTangent()
+		for( int n = 0; n < 2; n++ )
+		{
+			const bool isNormal = ( n == 0 );
+			byte* outBytes = isNormal ? normalBytes : tangentBytes;
+			
+			const __m128i packed = _mm_setr_epi32(	*( const int* )( isNormal ? base[0].normal : base[0].tangent ),
+													*( const int* )( isNormal ? base[1].normal : base[1].tangent ),
+													*( const int* )( isNormal ? base[2].normal : base[2].tangent ),
+													*( const int* )( isNormal ? base[3].normal : base[3].tangent ) );
+			
+			const __m128i mask = _mm_set1_epi32( 0xFF );
+			__m128 vx = _mm_cvtepi32_ps( _mm_and_si128( packed, mask ) );
+			__m128 vy = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( packed, 8 ), mask ) );
+			__m128 vz = _mm_cvtepi32_ps( _mm_and_si128( _mm_srli_epi32( packed, 16 ), mask ) );
+			
+			vx = _mm_sub_ps( _mm_mul_ps( vx, vector_float_2_over_255 ), vector_float_one );
+			vy = _mm_sub_ps( _mm_mul_ps( vy, vector_float_2_over_255 ), vector_float_one );
+			vz = _mm_sub_ps( _mm_mul_ps( vz, vector_float_2_over_255 ), vector_float_one );
+			
+			__m128 ss = _mm_madd_ps( vx, vx, _mm_madd_ps( vy, vy, _mm_mul_ps( vz, vz ) ) );
+			ss = _mm_max_ps( ss, vector_float_tiny );
+			
+			__m128 rs = _mm_rsqrt_ps( ss );
+			__m128 sq = _mm_mul_ps( rs, rs );
+			__m128 sh = _mm_mul_ps( rs, vector_float_rsqrt_c1 );
+			__m128 sx = _mm_madd_ps( ss, sq, vector_float_rsqrt_c0 );
+			__m128 invLength = _mm_mul_ps( sh, sx );					// invLength = 1 / sqrt( ss )
+			
+			vx = _mm_mul_ps( vx, invLength );
+			vy = _mm_mul_ps( vy, invLength );
+			vz = _mm_mul_ps( vz, invLength );
+			
+			__m128 rx = _mm_madd_ps( ma[0], vx, _mm_madd_ps( ma[1], vy, _mm_mul_ps( ma[2], vz ) ) );
+			__m128 ry = _mm_madd_ps( mb[0], vx, _mm_madd_ps( mb[1], vy, _mm_mul_ps( mb[2], vz ) ) );
+			__m128 rz = _mm_madd_ps( mc[0], vx, _mm_madd_ps( mc[1], vy, _mm_mul_ps( mc[2], vz ) ) );
+			
+			// same rounding as VertexFloatToByte()
+			rx = _mm_madd_ps( _mm_add_ps( rx, vector_float_one ), vector_float_255_over_2, vector_float_half );
+			ry = _mm_madd_ps( _mm_add_ps( ry, vector_float_one ), vector_float_255_over_2, vector_float_half );
+			rz = _mm_madd_ps( _mm_add_ps( rz, vector_float_one ), vector_float_255_over_2, vector_float_half );
+			
+			const __m128i xy16 = _mm_packs_epi32( _mm_cvtps_epi32( rx ), _mm_cvtps_epi32( ry ) );
+			const __m128i zz16 = _mm_packs_epi32( _mm_cvtps_epi32( rz ), _mm_cvtps_epi32( rz ) );
+			_mm_store_si128( ( __m128i* )outBytes, _mm_packus_epi16( xy16, zz16 ) );	// x0..x3 y0..y3 z0..z3 z0..z3
+		}
+		
+		for( int k = 0; k < 4; k++ )
+		{
+			idDrawVert& target = targetVerts[i + k];
+			
+			target.xyz.x = positions[0][k];
+			target.xyz.y = positions[1][k];
+			target.xyz.z = positions[2][k];
+			
+			target.normal[0] = normalBytes[0 + k];
+			target.normal[1] = normalBytes[4 + k];
+			target.normal[2] = normalBytes[8 + k];
+			
+			target.tangent[0] = tangentBytes[0 + k];
+			target.tangent[1] = tangentBytes[4 + k];
+			target.tangent[2] = tangentBytes[8 + k];
+			target.tangent[3] = base[k].tangent[3];
+		}
+	}
+	
+	// remaining vertices
+	idSIMD_Generic::TransformVertsAndTangents( targetVerts + i, numVerts - i, baseVerts + i, joints );
+}
+
 #endif // #if defined(USE_INTRINSICS)
 
@@ -1,6 +1,9 @@
 #include "esmreader.hpp"
 
 #include <stdexcept>
+#include <chrono>
+
+#include <components/debug/debuglog.hpp>
 
 namespace ESM
 {
@@ -15,7 +18,7 @@ using namespace Misc;
 ESM_Context ESMReader::getContext()
 {
     // Update the file position before returning
-    mCtx.filePos = mEsm->tellg();
+    mCtx.filePos = getFileOffset();
     return mCtx;
 }
 
@@ -23,6 +26,11 @@ ESMReader::ESMReader()
     : mIdx(0)
     , mRecordFlags(0)
     , mBuffer(50*1024)
+    , mRecordBuffering(true)
+    , mRecordBuffered(false)
+    , mRecordPos(0)
+    , mRecordEnd(0)
+    , mRecordOffset(0)
     , mGlobalReaderList(nullptr)
     , mEncoder(nullptr)
     , mFileSize(0)
@@ -44,7 +52,9 @@ void ESMReader::restoreContext(const ESM_Context &rc)
     // Copy the data
     mCtx = rc;
 
-    // Make sure we seek to the right place
+    // Make sure we seek to the right place. The rest of the record is read from the stream,
+    // the context doesn't tell where the record ends.
+    mRecordBuffered = false;
     mEsm->seekg(mCtx.filePos);
 }
 
@@ -64,6 +74,7 @@ void ESMReader::clearCtx()
    mCtx.subCached = false;
    mCtx.recName.clear();
    mCtx.subName.clear();
+   mRecordBuffered = false;
 }
 
 void ESMReader::openRaw(Files::IStreamPtr _esm, const std::string& name)
@@ -275,6 +286,7 @@ NAME ESMReader::getRecName()
 {
     if (!hasMoreRecs())
         fail("No more records, getRecName() failed");
+    unbufferRecord();
     getName(mCtx.recName);
     mCtx.leftFile -= mCtx.recName.data_size();
 
@@ -312,6 +324,39 @@ void ESMReader::getRecHeader(uint32_t &flags)
 
     // Adjust number of bytes mCtx.left in file
     mCtx.leftFile -= mCtx.leftRec;
+
+    if (mRecordBuffering)
+        bufferRecord();
+}
+
+void ESMReader::bufferRecord()
+{
+    size_t size = mCtx.leftRec;
+
+    if (mRecordBuffer.size() < size)
+        mRecordBuffer.resize(size);
+
+    mRecordBuffered = false;
+    mRecordOffset = mFileSize - mCtx.leftFile - size;
+
+    if (size > 0)
+        getExactSlow(&mRecordBuffer[0], size);
+
+    mRecordPos = 0;
+    mRecordEnd = size;
+    mRecordBuffered = true;
+}
+
+void ESMReader::unbufferRecord()
+{
+    if (!mRecordBuffered)
+        return;
+
+    mRecordBuffered = false;
+
+    // only happens if a record was left without reading or skipping all of it
+    if (mRecordPos != mRecordEnd)
+        mEsm->seekg(mRecordOffset + mRecordPos);
 }
 
 /*************************************************************************
@@ -320,8 +365,11 @@ void ESMReader::getRecHeader(uint32_t &flags)
  *
  *************************************************************************/
 
-void ESMReader::getExact(void*x, int size)
+void ESMReader::getExactSlow(void*x, int size)
 {
+    if (mRecordBuffered)
+        fail("Read past the end of the record");
+
     try
     {
         mEsm->read((char*)x, size);
@@ -334,6 +382,20 @@ void ESMReader::getExact(void*x, int size)
 
 std::string ESMReader::getString(int size)
 {
+    // decode straight from the record buffer, without copying the string into mBuffer first
+    if (mRecordBuffered && size >= 0 && static_cast<size_t>(size) <= mRecordEnd - mRecordPos)
+    {
+        const char *ptr = &mRecordBuffer[mRecordPos];
+        mRecordPos += size;
+
+        size = strnlen(ptr, size);
+
+        if (mEncoder)
+            return mEncoder->getUtf8(ptr, size);
+
+        return std::string (ptr, size);
+    }
+
     size_t s = size;
     if (mBuffer.size() <= s)
         // Add some extra padding to reduce the chance of having to resize
@@ -367,7 +429,7 @@ void ESMReader::fail(const std::string &msg)
     ss << "\n  Record: " << mCtx.recName.toString();
     ss << "\n  Subrecord: " << mCtx.subName.toString();
     if (mEsm.get())
-        ss << "\n  Offset: 0x" << hex << mEsm->tellg();
+        ss << "\n  Offset: 0x" << hex << getFileOffset();
     throw std::runtime_error(ss.str());
 }
 
@@ -378,12 +440,72 @@ void ESMReader::setEncoder(ToUTF8::Utf8Encoder* encoder)
 
 size_t ESMReader::getFileOffset()
 {
+    if (mRecordBuffered)
+        return mRecordOffset + mRecordPos;
+
     return mEsm->tellg();
 }
 
 void ESMReader::skip(int bytes)
 {
+    if (mRecordBuffered)
+    {
+        if (bytes < 0 || static_cast<size_t>(bytes) > mRecordEnd - mRecordPos)
+            fail("Skipped past the end of the record");
+
+        mRecordPos += bytes;
+        return;
+    }
+
     mEsm->seekg(getFileOffset()+bytes);
 }
 
+void ESMReader::benchmark(const std::string &file, ToUTF8::Utf8Encoder* encoder)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double times[2];
+    size_t records = 0;
+    size_t subRecords = 0;
+
+    for (int buffered = 0; buffered < 2; ++buffered)
+    {
+        Clock::time_point start = Clock::now();
+
+        ESMReader reader;
+        reader.setEncoder(encoder);
+        reader.setRecordBuffering(buffered != 0);
+        reader.open(file);
+
+        records = 0;
+        subRecords = 0;
+
+        while (reader.hasMoreRecs())
+        {
+            reader.getRecName();
+            reader.getRecHeader();
+            ++records;
+
+            while (reader.hasMoreSubs())
+            {
+                reader.getSubName();
+                reader.getSubHeader();
+                ++subRecords;
+
+                // read 4 byte fields, like the record loaders do for most of the data
+                uint32_t size = reader.getSubSize();
+                uint32_t field;
+                for (; size >= sizeof(field); size -= sizeof(field))
+                    reader.getT(field);
+                reader.skip(size);
+            }
+        }
+
+        times[buffered] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    Log(Debug::Info) << "ESM parse benchmark, " << file << ": " << records << " records, " << subRecords
+                     << " sub-records, stream " << times[0] << " ms, record buffers " << times[1] << " ms";
+}
+
 }
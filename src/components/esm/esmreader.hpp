@@ -87,6 +87,15 @@ public:
   void setGlobalReaderList(std::vector<ESMReader> *list) {mGlobalReaderList = list;}
   std::vector<ESMReader> *getGlobalReaderList() {return mGlobalReaderList;}
 
+  /// Read every record into memory as a whole when its header is read and decode the
+  /// sub-records from there, instead of one stream read per field. On by default.
+  void setRecordBuffering(bool enable) { mRecordBuffering = enable; }
+  bool getRecordBuffering() const { return mRecordBuffering; }
+
+  /// Parse all sub-records of \a file field by field, once from the stream and once from
+  /// record buffers, and log the time taken by each.
+  static void benchmark(const std::string &file, ToUTF8::Utf8Encoder* encoder);
+
   /*************************************************************************
    *
    *  Medium-level reading shortcuts
@@ -247,7 +256,18 @@ public:
   template <typename X>
   void getT(X &x) { getExact(&x, sizeof(X)); }
 
-  void getExact(void*x, int size);
+  void getExact(void*x, int size)
+  {
+      // bounds-checked cursor into the buffered record
+      if (mRecordBuffered && size >= 0 && static_cast<size_t>(size) <= mRecordEnd - mRecordPos)
+      {
+          memcpy(x, &mRecordBuffer[mRecordPos], size);
+          mRecordPos += size;
+      }
+      else
+          getExactSlow(x, size);
+  }
+
   void getName(NAME &name) { getT(name); }
   void getUint(uint32_t &u) { getT(u); }
 
@@ -271,6 +291,14 @@ public:
 private:
   void clearCtx();
 
+  void getExactSlow(void*x, int size);
+
+  // Read the data of the record whose header was just read into mRecordBuffer
+  void bufferRecord();
+
+  // Stop reading from mRecordBuffer, the stream is moved to the current position
+  void unbufferRecord();
+
   Files::IStreamPtr mEsm;
 
   ESM_Context mCtx;
@@ -282,6 +310,15 @@ private:
   // Buffer for ESM strings
   std::vector<char> mBuffer;
 
+  bool mRecordBuffering;
+  bool mRecordBuffered;
+
+  // Data of the current record, if mRecordBuffered is set
+  std::vector<char> mRecordBuffer;
+  size_t mRecordPos;
+  size_t mRecordEnd;
+  size_t mRecordOffset; // file offset of mRecordBuffer[0]
+
   Header mHeader;
 
   std::vector<ESMReader> *mGlobalReaderList;
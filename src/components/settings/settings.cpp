@@ -1,6 +1,7 @@
 #include "settings.hpp"
 
 #include <sstream>
+#include <chrono>
 
 #include <components/debug/debuglog.hpp>
 #include <components/misc/stringops.hpp>
@@ -56,6 +57,7 @@ namespace Settings
 CategorySettingValueMap Manager::mDefaultSettings = CategorySettingValueMap();
 CategorySettingValueMap Manager::mUserSettings = CategorySettingValueMap();
 CategorySettingVector Manager::mChangedSettings = CategorySettingVector();
+Manager::CachedValueMap Manager::mCachedValues = Manager::CachedValueMap();
 
 typedef std::map< CategorySetting, bool > CategorySettingStatusMap;
 
@@ -356,18 +358,21 @@ void Manager::clear()
     mDefaultSettings.clear();
     mUserSettings.clear();
     mChangedSettings.clear();
+    updateCachedValues();
 }
 
 void Manager::loadDefault(const std::string &file)
 {
     SettingsFileParser parser;
     parser.loadSettingsFile(file, mDefaultSettings);
+    updateCachedValues();
 }
 
 void Manager::loadUser(const std::string &file)
 {
     SettingsFileParser parser;
     parser.loadSettingsFile(file, mUserSettings);
+    updateCachedValues();
 }
 
 void Manager::saveUser(const std::string &file)
@@ -406,6 +411,61 @@ bool Manager::getBool (const std::string& setting, const std::string& category)
     return parseBool( getString(setting, category) );
 }
 
+CachedValue* Manager::getCachedValue(const std::string &setting, const std::string &category)
+{
+    CategorySettingValueMap::key_type key = std::make_pair(category, setting);
+    CachedValueMap::iterator it = mCachedValues.find(key);
+    if (it != mCachedValues.end())
+        return it->second.get();
+
+    // getString throws for a non-existing setting before anything is cached
+    std::unique_ptr<CachedValue> cached (new CachedValue);
+    cached->mRevision = 0;
+    updateCachedValue(*cached, getString(setting, category), false);
+
+    CachedValue* value = cached.get();
+    mCachedValues[key] = std::move(cached);
+    return value;
+}
+
+void Manager::updateCachedValue(CachedValue &cached, const std::string &value, bool notify)
+{
+    if (cached.mRevision != 0 && cached.mString == value)
+        return;
+
+    cached.mString = value;
+    cached.mFloat = parseFloat(value);
+    cached.mInt = parseInt(value);
+    cached.mBool = parseBool(value);
+    ++cached.mRevision;
+
+    if (notify)
+    {
+        for (const std::function<void ()>& listener : cached.mListeners)
+            listener();
+    }
+}
+
+void Manager::updateCachedValues()
+{
+    for (CachedValueMap::value_type& cached : mCachedValues)
+    {
+        // a setting that no longer exists reads as empty, like a default constructed value
+        std::string value;
+        CategorySettingValueMap::iterator it = mUserSettings.find(cached.first);
+        if (it != mUserSettings.end())
+            value = it->second;
+        else
+        {
+            it = mDefaultSettings.find(cached.first);
+            if (it != mDefaultSettings.end())
+                value = it->second;
+        }
+
+        updateCachedValue(*cached.second, value, true);
+    }
+}
+
 void Manager::setString(const std::string &setting, const std::string &category, const std::string &value)
 {
     CategorySettingValueMap::key_type key = std::make_pair(category, setting);
@@ -420,6 +480,10 @@ void Manager::setString(const std::string &setting, const std::string &category,
     mUserSettings[key] = value;
 
     mChangedSettings.insert(key);
+
+    CachedValueMap::iterator cached = mCachedValues.find(key);
+    if (cached != mCachedValues.end())
+        updateCachedValue(*cached->second, value, true);
 }
 
 void Manager::setInt (const std::string& setting, const std::string& category, const int value)
@@ -444,4 +508,28 @@ const CategorySettingVector Manager::apply()
     return vec;
 }
 
+void Manager::benchmarkLookups(const std::string &setting, const std::string &category, int iterations)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    Handle<float> handle = getHandle<float>(setting, category);
+
+    // accumulate the values so the reads can't be optimized away
+    float sum = 0.f;
+
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+        sum += getFloat(setting, category);
+    Clock::time_point lookupEnd = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+        sum += handle.get();
+    Clock::time_point handleEnd = Clock::now();
+
+    double lookupNs = std::chrono::duration<double, std::nano>(lookupEnd - start).count() / iterations;
+    double handleNs = std::chrono::duration<double, std::nano>(handleEnd - lookupEnd).count() / iterations;
+
+    Log(Debug::Info) << "Settings lookup benchmark, " << iterations << " reads of \"" << setting << "\" in [" << category << "]: "
+                     << "getFloat " << lookupNs << " ns, handle " << handleNs << " ns per read (sum " << sum << ")";
+}
+
 }
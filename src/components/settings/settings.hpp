@@ -3,7 +3,10 @@
 
 #include <set>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include <functional>
 
 namespace Settings
 {
@@ -11,6 +14,58 @@ namespace Settings
     typedef std::set< std::pair<std::string, std::string> > CategorySettingVector;
     typedef std::map < CategorySetting, std::string > CategorySettingValueMap;
 
+    ///
+    /// \brief Value of a setting parsed into every supported type, owned by the Manager
+    ///
+    struct CachedValue
+    {
+        std::string mString;
+        float mFloat;
+        int mInt;
+        bool mBool;
+
+        unsigned int mRevision;
+        ///< incremented every time the value changes
+
+        std::vector<std::function<void ()> > mListeners;
+        ///< called after the value has changed
+    };
+
+    ///
+    /// \brief Handle to a setting, resolved once and then read without any lookup or parsing
+    ///
+    /// Handles stay valid for the lifetime of the program, also across Manager::clear()
+    /// and reloads, so they can be kept in static or member variables.
+    ///
+    template <typename T>
+    class Handle
+    {
+    public:
+        Handle() : mValue(nullptr) {}
+
+        const T& get() const;
+
+        operator const T& () const { return get(); }
+
+        unsigned int getRevision() const { return mValue->mRevision; }
+        ///< changes whenever the setting changes, to poll instead of listening
+
+        void addListener (const std::function<void ()>& listener) const { mValue->mListeners.push_back(listener); }
+        ///< \note listeners are never removed, they must outlive the setting or only capture global state
+
+    private:
+        friend class Manager;
+
+        explicit Handle (CachedValue* value) : mValue(value) {}
+
+        CachedValue* mValue;
+    };
+
+    template <> inline const std::string& Handle<std::string>::get() const { return mValue->mString; }
+    template <> inline const float& Handle<float>::get() const { return mValue->mFloat; }
+    template <> inline const int& Handle<int>::get() const { return mValue->mInt; }
+    template <> inline const bool& Handle<bool>::get() const { return mValue->mBool; }
+
     ///
     /// \brief Settings management (can change during runtime)
     ///
@@ -43,10 +98,32 @@ namespace Settings
         static std::string getString (const std::string& setting, const std::string& category);
         static bool getBool (const std::string& setting, const std::string& category);
 
+        template <typename T>
+        static Handle<T> getHandle (const std::string& setting, const std::string& category)
+        {
+            return Handle<T>(getCachedValue(setting, category));
+        }
+        ///< the setting has to exist, like for the get functions
+
         static void setInt (const std::string& setting, const std::string& category, const int value);
         static void setFloat (const std::string& setting, const std::string& category, const float value);
         static void setString (const std::string& setting, const std::string& category, const std::string& value);
         static void setBool (const std::string& setting, const std::string& category, const bool value);
+
+        static void benchmarkLookups (const std::string& setting, const std::string& category, int iterations);
+        ///< logs the cost of reading the setting through getFloat and through a handle
+
+    private:
+        typedef std::map < CategorySetting, std::unique_ptr<CachedValue> > CachedValueMap;
+
+        static CachedValueMap mCachedValues;
+
+        static CachedValue* getCachedValue (const std::string& setting, const std::string& category);
+
+        static void updateCachedValue (CachedValue& cached, const std::string& value, bool notify);
+
+        static void updateCachedValues();
+        ///< re-reads all cached values, after the settings were loaded or cleared
     };
 
 }
@@ -559,8 +559,10 @@ void Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
-    mEnvironment.setScriptManager (new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+    MWScript::ScriptManager* scriptManager = new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>());
+    scriptManager->loadCache ((mCfgMgr.getUserDataPath() / "scripts.cache").string(), mFileCollections, mContentFiles);
+    mEnvironment.setScriptManager (scriptManager);
 
     // Create game mechanics system
     MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
@@ -652,6 +654,10 @@ void Engine::go()
     std::string settingspath;
     settingspath = loadSettings (settings);
 
+    // OPENMW_SETTINGS_BENCHMARK=<iterations> compares string lookups of a setting with a cached handle
+    if (const char* env = getenv("OPENMW_SETTINGS_BENCHMARK"))
+        Settings::Manager::benchmarkLookups("framerate limit", "Video", std::max(1, atoi(env)));
+
     // Create encoder
     ToUTF8::Utf8Encoder encoder (mEncoding);
     mEncoder = &encoder;
@@ -445,7 +445,8 @@ namespace MWClass
 
         if(stats.isDead())
         {
-            bool canLoot = Settings::Manager::getBool ("can loot during death animation", "Game");
+            static const Settings::Handle<bool> canLootDuringDeath = Settings::Manager::getHandle<bool>("can loot during death animation", "Game");
+            bool canLoot = canLootDuringDeath;
 
             // by default user can loot friendly actors during death animation
             if (canLoot && !stats.getAiSequence().isInCombat())
@@ -1053,7 +1053,7 @@ void idGameLocal::LoadMap( const char* mapName, int randseed )
 	
 	common->UpdateLevelLoadPacifier();
 	
-	pvs.Init();
+	pvs.Init( ( mapFile != nullptr ) ? mapFileName.c_str() : nullptr, ( mapFile != nullptr ) ? mapFile->GetGeometryCRC() : 0 );
 	
 	common->UpdateLevelLoadPacifier();
 	
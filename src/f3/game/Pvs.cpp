@@ -67,6 +67,152 @@ typedef struct pvsStack_s
 	byte* 				mightSee;	// bit set for all portals that might be visible through this passage/portal stack
 } pvsStack_t;
 
+idCVar pvs_jobs( "pvs_jobs", "1", CVAR_GAME | CVAR_BOOL, "build the portal PVS in parallel jobs, one source portal per job" );
+idCVar pvs_cache( "pvs_cache", "1", CVAR_GAME | CVAR_BOOL, "load the area PVS from generated/pvs/ if it matches the map, and write it there after building it" );
+
+// portals flooded in one wave of jobs, the portals of earlier waves are used to cut down the flood
+#define PVS_JOB_WAVE		256
+
+#define PVS_CACHE_MAGIC		( ( 'B' << 24 ) | ( 'P' << 16 ) | ( 'V' << 8 ) | 'S' )
+#define PVS_CACHE_VERSION	1
+
+/*
+================
+PVS_OrBits
+
+dst = src1 | src2, the PVS bit strings are padded to whole ints
+================
+*/
+static ID_INLINE void PVS_OrBits( int* dst, const int* src1, const int* src2, const int numInts )
+{
+	int i = 0;
+#if defined(USE_INTRINSICS)
+	for( ; i + 4 <= numInts; i += 4 )
+	{
+		const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src1 + i ) );
+		const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src2 + i ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_or_si128( a, b ) );
+	}
+#endif
+	for( ; i < numInts; i++ )
+	{
+		dst[i] = src1[i] | src2[i];
+	}
+}
+
+/*
+================
+PVS_AndBits
+
+dst = src1 & src2 & src3, returns true if dst has a bit set that isn't set in vis
+================
+*/
+static ID_INLINE bool PVS_AndBits( int* dst, const int* src1, const int* src2, const int* src3, const int* vis, const int numInts )
+{
+	int i = 0;
+	int more = 0;
+#if defined(USE_INTRINSICS)
+	__m128i more4 = _mm_setzero_si128();
+	for( ; i + 4 <= numInts; i += 4 )
+	{
+		const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src1 + i ) );
+		const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src2 + i ) );
+		const __m128i c = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src3 + i ) );
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( vis + i ) );
+		const __m128i m = _mm_and_si128( _mm_and_si128( a, b ), c );
+		more4 = _mm_or_si128( more4, _mm_andnot_si128( v, m ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), m );
+	}
+	more = ( _mm_movemask_epi8( _mm_cmpeq_epi8( more4, _mm_setzero_si128() ) ) != 0xFFFF );
+#endif
+	for( ; i < numInts; i++ )
+	{
+		const int m = src1[i] & src2[i] & src3[i];
+		more |= ( m & ~vis[i] );
+		dst[i] = m;
+	}
+	return ( more != 0 );
+}
+
+/*
+================
+pvsBuildJob_t
+================
+*/
+typedef struct pvsBuildJob_s
+{
+	const idPVS* 		pvs;
+	int					portalNum;
+	bool				passages;		// create the passages of the portal instead of flooding its PVS
+	int					passageMemory;
+	
+	void				Run()
+	{
+		if( passages )
+		{
+			passageMemory = pvs->CreatePortalPassages( portalNum );
+		}
+		else
+		{
+			pvs->FloodPortalPVS( portalNum );
+		}
+	}
+} pvsBuildJob_t;
+
+static void PVS_BuildJob( pvsBuildJob_t* job )
+{
+	job->Run();
+}
+REGISTER_PARALLEL_JOB( PVS_BuildJob, "PVS_BuildJob" );
+
+static idParallelJobList* 	pvsJobList = nullptr;
+
+/*
+================
+PVS_RunBuildJobs
+
+runs one job per portal in waves of PVS_JOB_WAVE, the portals of a wave are marked done
+after the wave so the flood of later waves can use their PVS, returns the passage memory
+================
+*/
+static int PVS_RunBuildJobs( const idPVS* pvs, pvsPortal_t* portals, int numPortals, bool passages )
+{
+	pvsBuildJob_t jobs[PVS_JOB_WAVE];
+	int passageMemory = 0;
+	
+	if( pvsJobList == nullptr )
+	{
+		pvsJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, PVS_JOB_WAVE, 0, nullptr );
+	}
+	
+	for( int first = 0; first < numPortals; first += PVS_JOB_WAVE )
+	{
+		const int num = Min( PVS_JOB_WAVE, numPortals - first );
+		for( int i = 0; i < num; i++ )
+		{
+			jobs[i].pvs = pvs;
+			jobs[i].portalNum = first + i;
+			jobs[i].passages = passages;
+			jobs[i].passageMemory = 0;
+			pvsJobList->AddJob( ( jobRun_t ) PVS_BuildJob, &jobs[i] );
+		}
+		pvsJobList->Submit();
+		pvsJobList->Wait();
+		
+		for( int i = 0; i < num; i++ )
+		{
+			if( passages )
+			{
+				passageMemory += jobs[i].passageMemory;
+			}
+			else
+			{
+				portals[first + i].done = true;
+			}
+		}
+	}
+	return passageMemory;
+}
 
 /*
 ================
@@ -362,14 +508,15 @@ idPVS::FloodPassagePVS_r
 */
 pvsStack_t* idPVS::FloodPassagePVS_r( pvsPortal_t* source, const pvsPortal_t* portal, pvsStack_t* prevStack ) const
 {
-	int i, j, n, m;
+	int i, n;
 	pvsPortal_t* p;
 	pvsArea_t* area;
 	pvsStack_t* stack;
 	pvsPassage_t* passage;
 	// RB: 64 bit fixes, changed long to int
-	int* sourceVis, *passageVis, *portalVis, *mightSee, *prevMightSee, more;
+	int* sourceVis, *passageVis, *portalVis, *mightSee, *prevMightSee;
 	// RB end
+	bool more;
 	
 	area = &pvsAreas[portal->areaNum];
 	
@@ -416,36 +563,20 @@ pvsStack_t* idPVS::FloodPassagePVS_r( pvsPortal_t* source, const pvsPortal_t* po
 		mightSee = reinterpret_cast<int*>( stack->mightSee );
 		// RB end
 		
-		more = 0;
-		// use the portal PVS if it has been calculated
+		// get new PVS which is decreased by going through this passage and
+		// check if anything might be visible through this passage that wasn't yet visible
 		if( p->done )
 		{
+			// use the portal PVS if it has been calculated
 			// RB: 64 bit fixes, changed long to int
 			portalVis = reinterpret_cast<int*>( p->vis );
 			// RB end
-			
-			for( j = 0; j < portalVisLongs; j++ )
-			{
-				// get new PVS which is decreased by going through this passage
-				m = *prevMightSee++ & *passageVis++ & *portalVis++;
-				// check if anything might be visible through this passage that wasn't yet visible
-				more |= ( m & ~( *sourceVis++ ) );
-				// store new PVS
-				*mightSee++ = m;
-			}
+			more = PVS_AndBits( mightSee, prevMightSee, passageVis, portalVis, sourceVis, portalVisLongs );
 		}
 		else
 		{
 			// the p->mightSee is implicitely stored in the passageVis
-			for( j = 0; j < portalVisLongs; j++ )
-			{
-				// get new PVS which is decreased by going through this passage
-				m = *prevMightSee++ & *passageVis++;
-				// check if anything might be visible through this passage that wasn't yet visible
-				more |= ( m & ~( *sourceVis++ ) );
-				// store new PVS
-				*mightSee++ = m;
-			}
+			more = PVS_AndBits( mightSee, prevMightSee, passageVis, passageVis, sourceVis, portalVisLongs );
 		}
 		
 		// if nothing more can be seen
@@ -463,32 +594,26 @@ pvsStack_t* idPVS::FloodPassagePVS_r( pvsPortal_t* source, const pvsPortal_t* po
 
 /*
 ===============
-idPVS::PassagePVS
+idPVS::FloodPortalPVS
+
+calculates the PVS of a single portal, the passages have to be created
 ===============
 */
-void idPVS::PassagePVS() const
+void idPVS::FloodPortalPVS( int portalNum ) const
 {
-	int i;
 	pvsPortal_t* source;
 	pvsStack_t* stack, *s;
 	
-	// create the passages
-	CreatePassages();
-	
 	// allocate first stack entry
 	stack = reinterpret_cast<pvsStack_t*>( new byte[sizeof( pvsStack_t ) + portalVisBytes] );
 	stack->mightSee = ( reinterpret_cast<byte*>( stack ) ) + sizeof( pvsStack_t );
 	stack->next = nullptr;
 	
 	// calculate portal PVS by flooding through the passages
-	for( i = 0; i < numPortals; i++ )
-	{
-		source = &pvsPortals[i];
-		memset( source->vis, 0, portalVisBytes );
-		memcpy( stack->mightSee, source->mightSee, portalVisBytes );
-		FloodPassagePVS_r( source, source, stack );
-		source->done = true;
-	}
+	source = &pvsPortals[portalNum];
+	memset( source->vis, 0, portalVisBytes );
+	memcpy( stack->mightSee, source->mightSee, portalVisBytes );
+	FloodPassagePVS_r( source, source, stack );
 	
 	// free the allocated stack
 	for( s = stack; s; s = stack )
@@ -496,6 +621,34 @@ void idPVS::PassagePVS() const
 		stack = stack->next;
 		delete[] s;
 	}
+}
+
+/*
+===============
+idPVS::PassagePVS
+===============
+*/
+void idPVS::PassagePVS() const
+{
+	int i;
+	
+	// create the passages
+	CreatePassages();
+	
+	if( pvs_jobs.GetBool() && numPortals > 1 )
+	{
+		// portals of the same wave don't see each others PVS yet, only the ones of earlier waves,
+		// so the result doesn't depend on the number of job threads
+		PVS_RunBuildJobs( this, pvsPortals, numPortals, false );
+	}
+	else
+	{
+		for( i = 0; i < numPortals; i++ )
+		{
+			FloodPortalPVS( i );
+			pvsPortals[i].done = true;
+		}
+	}
 	
 	// destroy the passages
 	DestroyPassages();
@@ -643,14 +796,16 @@ void idPVS::AddPassageBoundaries( const idWinding& source, const idWinding& pass
 
 /*
 ================
-idPVS::CreatePassages
+idPVS::CreatePortalPassages
+
+creates the passages of a single portal, returns the memory used
 ================
 */
 #define MAX_PASSAGE_BOUNDS		128
 
-void idPVS::CreatePassages() const
+int idPVS::CreatePortalPassages( int portalNum ) const
 {
-	int i, j, l, n, numBounds, front, passageMemory, byteNum, bitNum;
+	int j, l, n, numBounds, front, passageMemory, byteNum, bitNum;
 	int sides[MAX_PASSAGE_BOUNDS];
 	idPlane passageBounds[MAX_PASSAGE_BOUNDS];
 	pvsPortal_t* source, *target, *p;
@@ -660,74 +815,100 @@ void idPVS::CreatePassages() const
 	byte canSee, mightSee, bit;
 	
 	passageMemory = 0;
-	for( i = 0; i < numPortals; i++ )
+	
+	source = &pvsPortals[portalNum];
+	area = &pvsAreas[source->areaNum];
+	
+	source->passages = new( TAG_PVS ) pvsPassage_t[area->numPortals];
+	
+	for( j = 0; j < area->numPortals; j++ )
 	{
-		source = &pvsPortals[i];
-		area = &pvsAreas[source->areaNum];
+		target = area->portals[j];
+		n = target - pvsPortals;
 		
-		source->passages = new( TAG_PVS ) pvsPassage_t[area->numPortals];
+		passage = &source->passages[j];
 		
-		for( j = 0; j < area->numPortals; j++ )
+		// if the source portal cannot see this portal
+		if( !( source->mightSee[ n >> 3 ] & ( 1 << ( n & 7 ) ) ) )
 		{
-			target = area->portals[j];
-			n = target - pvsPortals;
-			
-			passage = &source->passages[j];
-			
-			// if the source portal cannot see this portal
-			if( !( source->mightSee[ n >> 3 ] & ( 1 << ( n & 7 ) ) ) )
-			{
-				// not all portals in the area have to be visible because areas are not necesarily convex
-				// also no passage has to be created for the portal which is the opposite of the source
-				passage->canSee = nullptr;
-				continue;
-			}
-			
-			passage->canSee = new( TAG_PVS ) byte[portalVisBytes];
-			passageMemory += portalVisBytes;
-			
-			// boundary plane normals point inwards
-			numBounds = 0;
-			AddPassageBoundaries( *( source->w ), *( target->w ), false, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
-			AddPassageBoundaries( *( target->w ), *( source->w ), true, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
+			// not all portals in the area have to be visible because areas are not necesarily convex
+			// also no passage has to be created for the portal which is the opposite of the source
+			passage->canSee = nullptr;
+			continue;
+		}
+		
+		passage->canSee = new( TAG_PVS ) byte[portalVisBytes];
+		passageMemory += portalVisBytes;
+		
+		// boundary plane normals point inwards
+		numBounds = 0;
+		AddPassageBoundaries( *( source->w ), *( target->w ), false, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
+		AddPassageBoundaries( *( target->w ), *( source->w ), true, passageBounds, numBounds, MAX_PASSAGE_BOUNDS );
+		
+		// get all portals visible through this passage
+		for( byteNum = 0; byteNum < portalVisBytes; byteNum++ )
+		{
+		
+			canSee = 0;
+			mightSee = source->mightSee[byteNum] & target->mightSee[byteNum];
 			
-			// get all portals visible through this passage
-			for( byteNum = 0; byteNum < portalVisBytes; byteNum++ )
+			// go through eight portals at a time to speed things up
+			for( bitNum = 0; bitNum < 8; bitNum++ )
 			{
 			
-				canSee = 0;
-				mightSee = source->mightSee[byteNum] & target->mightSee[byteNum];
+				bit = 1 << bitNum;
 				
-				// go through eight portals at a time to speed things up
-				for( bitNum = 0; bitNum < 8; bitNum++ )
+				if( !( mightSee & bit ) )
 				{
+					continue;
+				}
 				
-					bit = 1 << bitNum;
-					
-					if( !( mightSee & bit ) )
+				p = &pvsPortals[( byteNum << 3 ) + bitNum];
+				
+				if( p->areaNum == source->areaNum )
+				{
+					continue;
+				}
+				
+				for( front = 0, l = 0; l < numBounds; l++ )
+				{
+					sides[l] = p->bounds.PlaneSide( passageBounds[l] );
+					// if completely at the back of the passage bounding plane
+					if( sides[l] == PLANESIDE_BACK )
 					{
-						continue;
+						break;
 					}
-					
-					p = &pvsPortals[( byteNum << 3 ) + bitNum];
-					
-					if( p->areaNum == source->areaNum )
+					// if completely at the front
+					if( sides[l] == PLANESIDE_FRONT )
 					{
-						continue;
+						front++;
 					}
+				}
+				// if completely outside the passage
+				if( l < numBounds )
+				{
+					continue;
+				}
+				
+				// if not at the front of all bounding planes and thus not completely inside the passage
+				if( front != numBounds )
+				{
+				
+					winding = *p->w;
 					
-					for( front = 0, l = 0; l < numBounds; l++ )
+					for( l = 0; l < numBounds; l++ )
 					{
-						sides[l] = p->bounds.PlaneSide( passageBounds[l] );
-						// if completely at the back of the passage bounding plane
-						if( sides[l] == PLANESIDE_BACK )
+						// only clip if the winding possibly crosses this plane
+						if( sides[l] != PLANESIDE_CROSS )
 						{
-							break;
+							continue;
 						}
-						// if completely at the front
-						if( sides[l] == PLANESIDE_FRONT )
+						// clip away the part at the back of the bounding plane
+						winding.ClipInPlace( passageBounds[l] );
+						// if completely clipped away
+						if( !winding.GetNumPoints() )
 						{
-							front++;
+							break;
 						}
 					}
 					// if completely outside the passage
@@ -735,46 +916,43 @@ void idPVS::CreatePassages() const
 					{
 						continue;
 					}
-					
-					// if not at the front of all bounding planes and thus not completely inside the passage
-					if( front != numBounds )
-					{
-					
-						winding = *p->w;
-						
-						for( l = 0; l < numBounds; l++ )
-						{
-							// only clip if the winding possibly crosses this plane
-							if( sides[l] != PLANESIDE_CROSS )
-							{
-								continue;
-							}
-							// clip away the part at the back of the bounding plane
-							winding.ClipInPlace( passageBounds[l] );
-							// if completely clipped away
-							if( !winding.GetNumPoints() )
-							{
-								break;
-							}
-						}
-						// if completely outside the passage
-						if( l < numBounds )
-						{
-							continue;
-						}
-					}
-					
-					canSee |= bit;
 				}
 				
-				// store results of all eight portals
-				passage->canSee[byteNum] = canSee;
+				canSee |= bit;
 			}
 			
-			// can always see the target portal
-			passage->canSee[n >> 3] |= ( 1 << ( n & 7 ) );
+			// store results of all eight portals
+			passage->canSee[byteNum] = canSee;
 		}
+		
+		// can always see the target portal
+		passage->canSee[n >> 3] |= ( 1 << ( n & 7 ) );
+	}
+	return passageMemory;
+}
+
+/*
+================
+idPVS::CreatePassages
+================
+*/
+void idPVS::CreatePassages() const
+{
+	int i, passageMemory;
+	
+	passageMemory = 0;
+	if( pvs_jobs.GetBool() && numPortals > 1 )
+	{
+		passageMemory = PVS_RunBuildJobs( this, pvsPortals, numPortals, true );
 	}
+	else
+	{
+		for( i = 0; i < numPortals; i++ )
+		{
+			passageMemory += CreatePortalPassages( i );
+		}
+	}
+	
 	if( passageMemory < 1024 )
 	{
 		gameLocal.Printf( "%5d bytes passage memory used to build PVS\n", passageMemory );
@@ -872,10 +1050,7 @@ int idPVS::AreaPVSFromPortalPVS() const
 			p2 = reinterpret_cast<int*>( area->portals[j]->vis );
 			// RB end
 			
-			for( k = 0; k < portalVisLongs; k++ )
-			{
-				*p1++ |= *p2++;
-			}
+			PVS_OrBits( p1, p1, p2, portalVisLongs );
 		}
 		
 		// the portals of this area are always visible
@@ -909,12 +1084,77 @@ int idPVS::AreaPVSFromPortalPVS() const
 	return totalVisibleAreas;
 }
 
+/*
+================
+idPVS::ReadCache
+================
+*/
+bool idPVS::ReadCache( const char* fileName, unsigned int mapGeometryCRC )
+{
+	idFileLocal file( fileSystem->OpenFileReadMemory( fileName ) );
+	if( file == nullptr )
+	{
+		return false;
+	}
+	
+	unsigned int magic = 0;
+	unsigned int crc = 0;
+	int version = 0;
+	int fileNumAreas = 0;
+	int fileNumPortals = 0;
+	int fileAreaVisBytes = 0;
+	
+	file->ReadBig( magic );
+	file->ReadBig( version );
+	file->ReadBig( crc );
+	file->ReadBig( fileNumAreas );
+	file->ReadBig( fileNumPortals );
+	file->ReadBig( fileAreaVisBytes );
+	
+	if( magic != PVS_CACHE_MAGIC || version != PVS_CACHE_VERSION || crc != mapGeometryCRC ||
+			fileNumAreas != numAreas || fileNumPortals != numPortals || fileAreaVisBytes != areaVisBytes )
+	{
+		return false;
+	}
+	
+	const int size = numAreas * areaVisBytes;
+	if( file->Read( areaPVS, size ) != size )
+	{
+		memset( areaPVS, 0xFF, size );
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idPVS::WriteCache
+================
+*/
+void idPVS::WriteCache( const char* fileName, unsigned int mapGeometryCRC ) const
+{
+	idFileLocal file( fileSystem->OpenFileWrite( fileName, "fs_basepath" ) );
+	if( file == nullptr )
+	{
+		gameLocal.Warning( "idPVS::WriteCache: couldn't write %s", fileName );
+		return;
+	}
+	
+	file->WriteBig( ( unsigned int )PVS_CACHE_MAGIC );
+	file->WriteBig( ( int )PVS_CACHE_VERSION );
+	file->WriteBig( mapGeometryCRC );
+	file->WriteBig( numAreas );
+	file->WriteBig( numPortals );
+	file->WriteBig( areaVisBytes );
+	file->Write( areaPVS, numAreas * areaVisBytes );
+}
+
 /*
 ================
 idPVS::Init
 ================
 */
-void idPVS::Init()
+void idPVS::Init( const char* mapName, unsigned int mapGeometryCRC )
 {
 	int totalVisibleAreas;
 	
@@ -952,9 +1192,27 @@ void idPVS::Init()
 		memset( currentPVS[i].pvs, 0, areaVisBytes );
 	}
 	
+	// the area PVS only depends on the map geometry, so it's cached per map
+	idStr cacheFileName;
+	if( pvs_cache.GetBool() && mapName != nullptr && mapName[0] != '\0' )
+	{
+		cacheFileName = "generated/pvs/";
+		cacheFileName.AppendPath( mapName );
+		cacheFileName.SetFileExtension( ".bpvs" );
+	}
+	
 	idTimer timer;
 	timer.Start();
 	
+	if( cacheFileName.Length() > 0 && ReadCache( cacheFileName, mapGeometryCRC ) )
+	{
+		timer.Stop();
+		gameLocal.Printf( "%5.0f msec to load PVS from %s\n", timer.Milliseconds(), cacheFileName.c_str() );
+		gameLocal.Printf( "%5d areas\n", numAreas );
+		gameLocal.Printf( "%5d portals\n", numPortals );
+		return;
+	}
+	
 	CreatePVSData();
 	
 	FrontPortalPVS();
@@ -969,7 +1227,12 @@ void idPVS::Init()
 	
 	timer.Stop();
 	
-	gameLocal.Printf( "%5.0f msec to calculate PVS\n", timer.Milliseconds() );
+	if( cacheFileName.Length() > 0 )
+	{
+		WriteCache( cacheFileName, mapGeometryCRC );
+	}
+	
+	gameLocal.Printf( "%5.0f msec to calculate PVS%s\n", timer.Milliseconds(), pvs_jobs.GetBool() ? " (jobs)" : "" );
 	gameLocal.Printf( "%5d areas\n", numAreas );
 	gameLocal.Printf( "%5d portals\n", numPortals );
 	gameLocal.Printf( "%5d areas visible on average\n", totalVisibleAreas / numAreas );
@@ -1162,7 +1425,7 @@ idPVS::SetupCurrentPVS
 */
 pvsHandle_t idPVS::SetupCurrentPVS( const int* sourceAreas, const int numSourceAreas, const pvsType_t type ) const
 {
-	int i, j;
+	int i;
 	unsigned int h;
 	// RB: 64 bit fixes, changed long to int
 	int* vis, *pvs;
@@ -1195,10 +1458,7 @@ pvsHandle_t idPVS::SetupCurrentPVS( const int* sourceAreas, const int numSourceA
 			vis = reinterpret_cast<int*>( areaPVS + sourceAreas[i] * areaVisBytes );
 			pvs = reinterpret_cast<int*>( currentPVS[handle.i].pvs );
 			// RB end
-			for( j = 0; j < areaVisLongs; j++ )
-			{
-				*pvs++ |= *vis++;
-			}
+			PVS_OrBits( pvs, pvs, vis, areaVisLongs );
 		}
 	}
 	else
@@ -1241,7 +1501,6 @@ idPVS::MergeCurrentPVS
 */
 pvsHandle_t idPVS::MergeCurrentPVS( pvsHandle_t pvs1, pvsHandle_t pvs2 ) const
 {
-	int i;
 	// RB: 64 bit fixes, changed long to int
 	int* pvs1Ptr, *pvs2Ptr, *ptr;
 	// RB end
@@ -1262,10 +1521,7 @@ pvsHandle_t idPVS::MergeCurrentPVS( pvsHandle_t pvs1, pvsHandle_t pvs2 ) const
 	pvs2Ptr = reinterpret_cast<int*>( currentPVS[pvs2.i].pvs );
 	// RB end
 	
-	for( i = 0; i < areaVisLongs; i++ )
-	{
-		*ptr++ = *pvs1Ptr++ | *pvs2Ptr++;
-	}
+	PVS_OrBits( ptr, pvs1Ptr, pvs2Ptr, areaVisLongs );
 	
 	return handle;
 }
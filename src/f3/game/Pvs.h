@@ -78,8 +78,8 @@ class idPVS
 public:
 	idPVS();
 	~idPVS();
-	// setup for the current map
-	void				Init();
+	// setup for the current map, the area PVS is cached per map name and geometry CRC
+	void				Init( const char* mapName = nullptr, unsigned int mapGeometryCRC = 0 );
 	void				Shutdown();
 	// get the area(s) the source is in
 	int					GetPVSArea( const idVec3& point ) const;		// returns the area number
@@ -128,13 +128,19 @@ private:
 	void				FloodFrontPortalPVS_r( struct pvsPortal_s* portal, int areaNum ) const;
 	void				FrontPortalPVS() const;
 	struct pvsStack_s* 	FloodPassagePVS_r( struct pvsPortal_s* source, const struct pvsPortal_s* portal, struct pvsStack_s* prevStack ) const;
+	void				FloodPortalPVS( int portalNum ) const;
 	void				PassagePVS() const;
 	void				AddPassageBoundaries( const idWinding& source, const idWinding& pass, bool flipClip, idPlane* bounds, int& numBounds, int maxBounds ) const;
+	int					CreatePortalPassages( int portalNum ) const;
 	void				CreatePassages() const;
 	void				DestroyPassages() const;
 	int					AreaPVSFromPortalPVS() const;
 	void				GetConnectedAreas( int srcArea, bool* connectedAreas ) const;
 	pvsHandle_t			AllocCurrentPVS( unsigned int h ) const;
+	bool				ReadCache( const char* fileName, unsigned int mapGeometryCRC );
+	void				WriteCache( const char* fileName, unsigned int mapGeometryCRC ) const;
+	
+	friend struct pvsBuildJob_s;
 };
 
 //} // namespace BFG
@@ -1586,7 +1586,8 @@ bool CharacterController::updateWeaponState(CharacterState& idle)
                     {
                         if (isWeapon)
                         {
-                            if (Settings::Manager::getBool("best attack", "Game"))
+                            static const Settings::Handle<bool> bestAttack = Settings::Manager::getHandle<bool>("best attack", "Game");
+                            if (bestAttack)
                             {
                                 MWWorld::ConstContainerStoreIterator weapon = mPtr.getClass().getInventoryStore(mPtr).getSlot(MWWorld::InventoryStore::Slot_CarriedRight);
                                 mAttackType = getBestAttack(weapon->get<ESM::Weapon>()->mBase);
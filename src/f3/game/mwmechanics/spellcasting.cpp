@@ -619,7 +619,8 @@ namespace MWMechanics
                                     ActiveSpells::ActiveEffect effect_ = effect;
                                     effect_.mMagnitude *= -1;
                                     absorbEffects.push_back(effect_);
-                                    if (reflected && Settings::Manager::getBool("classic reflected absorb spells behavior", "Game"))
+                                    static const Settings::Handle<bool> classicReflectedAbsorb = Settings::Manager::getHandle<bool>("classic reflected absorb spells behavior", "Game");
+                                    if (reflected && classicReflectedAbsorb)
                                         target.getClass().getCreatureStats(target).getActiveSpells().addSpell("", true,
                                             absorbEffects, mSourceName, caster.getClass().getCreatureStats(caster).getActorId());
                                     else
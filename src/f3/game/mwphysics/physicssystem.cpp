@@ -4,6 +4,12 @@
 #include <unordered_map>
 #include <fstream>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include <boost/optional.hpp>
 
@@ -95,14 +101,16 @@ namespace MWPhysics
     private:
         const btCollisionWorld *mColWorld;
         const btCollisionObject *mColObj;
+        TraceScratch *mScratch;
 
         ActorTracer mTracer, mUpStepper, mDownStepper;
         bool mHaveMoved;
 
     public:
-        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj)
+        Stepper(const btCollisionWorld *colWorld, const btCollisionObject *colObj, TraceScratch *scratch)
             : mColWorld(colWorld)
             , mColObj(colObj)
+            , mScratch(scratch)
             , mHaveMoved(true)
         {}
 
@@ -155,7 +163,7 @@ namespace MWPhysics
             if (mHaveMoved)
             {
                 mHaveMoved = false;
-                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld);
+                mUpStepper.doTrace(mColObj, position, position+osg::Vec3f(0.0f,0.0f,sStepSizeUp), mColWorld, mScratch);
                 if(mUpStepper.mFraction < std::numeric_limits<float>::epsilon())
                     return false; // didn't even move the smallest representable amount
                                   // (TODO: shouldn't this be larger? Why bother with such a small amount?)
@@ -175,7 +183,7 @@ namespace MWPhysics
              *    ==============================================
              */
             osg::Vec3f tracerPos = mUpStepper.mEndPos;
-            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld);
+            mTracer.doTrace(mColObj, tracerPos, tracerPos + toMove, mColWorld, mScratch);
             if(mTracer.mFraction < std::numeric_limits<float>::epsilon())
                 return false; // didn't even move the smallest representable amount
 
@@ -194,7 +202,7 @@ namespace MWPhysics
              *          +--+            +--+
              *    ==============================================
              */
-            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+            mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mScratch);
             if (!canStepDown(mDownStepper))
             {
                 // Try again with increased step length
@@ -203,11 +211,11 @@ namespace MWPhysics
 
                 osg::Vec3f direction = toMove;
                 direction.normalize();
-                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld);
+                mTracer.doTrace(mColObj, tracerPos, tracerPos + direction*sMinStep, mColWorld, mScratch);
                 if (mTracer.mFraction < 0.001f)
                     return false;
 
-                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld);
+                mDownStepper.doTrace(mColObj, mTracer.mEndPos, mTracer.mEndPos-osg::Vec3f(0.0f,0.0f,sStepSizeDown), mColWorld, mScratch);
                 if (!canStepDown(mDownStepper))
                     return false;
             }
@@ -285,9 +293,11 @@ namespace MWPhysics
             }
         }
 
+        /// @param standingOn set to the object the actor ends up standing on, if any
+        /// @param scratch when given, the collision world is only read and several actors can be moved at once
         static osg::Vec3f move(osg::Vec3f position, const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
                                   bool isFlying, float waterlevel, float slowFall, const btCollisionWorld* collisionWorld,
-                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+                               MWWorld::Ptr& standingOn, TraceScratch* scratch = nullptr)
         {
             const ESM::Position& refpos = ptr.getRefData().getPosition();
             // Early-out for totally static creatures
@@ -355,7 +365,7 @@ namespace MWPhysics
                 velocity *= 1.f-(fStromWalkMult * (angleDegrees/180.f));
             }
 
-            Stepper stepper(collisionWorld, colobj);
+            Stepper stepper(collisionWorld, colobj, scratch);
             osg::Vec3f origVelocity = velocity;
             osg::Vec3f newPosition = position;
             /*
@@ -382,7 +392,7 @@ namespace MWPhysics
                 if((newPosition - nextpos).length2() > 0.0001)
                 {
                     // trace to where character would go if there were no obstructions
-                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld);
+                    tracer.doTrace(colobj, newPosition, nextpos, collisionWorld, scratch);
 
                     // check for obstructions
                     if(tracer.mFraction >= 1.0f)
@@ -454,16 +464,16 @@ namespace MWPhysics
                 osg::Vec3f from = newPosition;
                 osg::Vec3f to = newPosition - (physicActor->getOnGround() ?
                              osg::Vec3f(0,0,sStepSizeDown + 2*sGroundOffset) : osg::Vec3f(0,0,2*sGroundOffset));
-                tracer.doTrace(colobj, from, to, collisionWorld);
+                tracer.doTrace(colobj, from, to, collisionWorld, scratch);
                 if(tracer.mFraction < 1.0f
                         && tracer.mHitObject->getBroadphaseHandle()->m_collisionFilterGroup != CollisionType_Actor)
                 {
-                    const btCollisionObject* standingOn = tracer.mHitObject;
-                    PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOn->getUserPointer());
+                    const btCollisionObject* standingOnObject = tracer.mHitObject;
+                    PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOnObject->getUserPointer());
                     if (ptrHolder)
-                        standingCollisionTracker[ptr] = ptrHolder->getPtr();
+                        standingOn = ptrHolder->getPtr();
 
-                    if (standingOn->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
+                    if (standingOnObject->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
                         physicActor->setWalkingOnWater(true);
                     if (!isFlying)
                         newPosition.z() = tracer.mEndPos.z() + sGroundOffset;
@@ -515,6 +525,124 @@ namespace MWPhysics
         }
     };
 
+    /// Fork-join pool for MovementSolver::move. The calling thread takes part in the work,
+    /// every thread has its own TraceScratch.
+    class MovementSolverPool
+    {
+    public:
+        typedef std::function<void (int index, TraceScratch& scratch)> Function;
+
+        MovementSolverPool(int numThreads)
+            : mScratch(std::max(1, numThreads))
+            , mFunction(nullptr)
+            , mCount(0)
+            , mNext(0)
+            , mBusyThreads(0)
+            , mGeneration(0)
+            , mQuit(false)
+        {
+            for (int i = 1; i < numThreads; ++i)
+                mThreads.emplace_back(&MovementSolverPool::worker, this, i);
+        }
+
+        ~MovementSolverPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQuit = true;
+            }
+            mWorkCondition.notify_all();
+            for (std::thread& thread : mThreads)
+                thread.join();
+        }
+
+        int getNumThreads() const { return static_cast<int>(mScratch.size()); }
+
+        /// Calls \a function for every index in [0, count) and returns once all calls are done.
+        void run(int count, const Function& function)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mFunction = &function;
+                mCount = count;
+                mNext = 0;
+                mBusyThreads = static_cast<int>(mThreads.size());
+                mException = nullptr;
+                ++mGeneration;
+            }
+            mWorkCondition.notify_all();
+
+            work(0);
+
+            std::unique_lock<std::mutex> lock(mMutex);
+            mDoneCondition.wait(lock, [this] { return mBusyThreads == 0; });
+            mFunction = nullptr;
+            if (mException)
+                std::rethrow_exception(mException);
+        }
+
+        /// Same as run(), but on the calling thread only.
+        void runSerial(int count, const Function& function)
+        {
+            for (int index = 0; index < count; ++index)
+                function(index, mScratch[0]);
+        }
+
+    private:
+        void worker(int threadIndex)
+        {
+            unsigned int generation = 0;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mWorkCondition.wait(lock, [&] { return mQuit || mGeneration != generation; });
+                    if (mQuit)
+                        return;
+                    generation = mGeneration;
+                }
+
+                work(threadIndex);
+
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (--mBusyThreads == 0)
+                    mDoneCondition.notify_one();
+            }
+        }
+
+        void work(int threadIndex)
+        {
+            try
+            {
+                for (int index = mNext++; index < mCount; index = mNext++)
+                    (*mFunction)(index, mScratch[threadIndex]);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (!mException)
+                    mException = std::current_exception();
+                mNext = mCount;
+            }
+        }
+
+        std::vector<std::thread> mThreads;
+        std::vector<TraceScratch> mScratch;
+
+        std::mutex mMutex;
+        std::condition_variable mWorkCondition;
+        std::condition_variable mDoneCondition;
+
+        const Function* mFunction;
+        int mCount;
+        std::atomic<int> mNext;
+        int mBusyThreads;
+        unsigned int mGeneration;
+        bool mQuit;
+        std::exception_ptr mException;
+    };
+
+
 
     // ---------------------------------------------------------------
 
@@ -528,6 +656,9 @@ namespace MWPhysics
         , mWaterEnabled(false)
         , mParentNode(parentNode)
         , mPhysicsDt(1.f / 60.f)
+        , mVerifyMovement(false)
+        , mBenchmarkThreads(0)
+        , mBenchmarkFrame(0)
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
@@ -552,6 +683,24 @@ namespace MWPhysics
                 Log(Debug::Warning) << "Warning: using custom physics framerate (" << physFramerate << " FPS).";
             }
         }
+
+        // Threads used to move actors, 1 moves them all on the calling thread
+        int numThreads = std::min(8, std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+        env = getenv("OPENMW_PHYSICS_THREADS");
+        if (env)
+            numThreads = std::max(1, std::atoi(env));
+        mSolverPool.reset(new MovementSolverPool(numThreads));
+
+        mVerifyMovement = getenv("OPENMW_PHYSICS_VERIFY") != nullptr;
+        if (mVerifyMovement)
+            Log(Debug::Warning) << "Warning: checking parallel actor movement against the serial solver, this is slow.";
+
+        env = getenv("OPENMW_PHYSICS_BENCHMARK");
+        if (env)
+        {
+            mBenchmarkThreads = std::max(1, std::atoi(env));
+            Log(Debug::Warning) << "Warning: benchmarking actor movement with up to " << mBenchmarkThreads << " threads every 600 frames.";
+        }
     }
 
     PhysicsSystem::~PhysicsSystem()
@@ -1282,7 +1431,52 @@ namespace MWPhysics
             mStandingCollisions.clear();
         }
 
+        prepareQueuedMovement();
+
+        // Below a handful of actors waking up the pool costs more than it saves, the results are the same either way
+        const size_t minParallelActors = 4;
+        const bool parallel = mSolverPool->getNumThreads() > 1 && mActorMovements.size() >= minParallelActors;
+
+        if (mVerifyMovement && parallel)
+            verifyQueuedMovement(numSteps);
+
+        if (mBenchmarkThreads > 0 && ++mBenchmarkFrame % 600 == 0)
+            benchmarkQueuedMovement(mBenchmarkThreads);
+
+        solveQueuedMovement(numSteps, parallel);
+
         const MWWorld::Ptr player = MWMechanics::getPlayer();
+        const MWBase::World *world = MWBase::Environment::get().getWorld();
+        for (const ActorMovement& movement : mActorMovements)
+        {
+            Actor* physicActor = movement.mActor;
+            const osg::Vec3f& position = movement.mPosition;
+
+            float interpolationFactor = mTimeAccum / mPhysicsDt;
+            osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+
+            float heightDiff = position.z() - movement.mOldHeight;
+
+            MWMechanics::CreatureStats& stats = movement.mPtr.getClass().getCreatureStats(movement.mPtr);
+            if ((movement.mWasOnGround && physicActor->getOnGround()) || movement.mFlying || world->isSwimming(movement.mPtr) || movement.mSlowFall < 1)
+                stats.land(movement.mPtr == player);
+            else if (heightDiff < 0)
+                stats.addToFallHeight(-heightDiff);
+
+            mMovementResults.push_back(std::make_pair(movement.mPtr, interpolated));
+        }
+
+        mActorMovements.clear();
+        mMovementQueue.clear();
+
+        return mMovementResults;
+    }
+
+    void PhysicsSystem::prepareQueuedMovement()
+    {
+        mActorMovements.clear();
+        mActorMovements.reserve(mMovementQueue.size());
+
         const MWBase::World *world = MWBase::Environment::get().getWorld();
         PtrVelocityList::iterator iter = mMovementQueue.begin();
         for(;iter != mMovementQueue.end();++iter)
@@ -1313,43 +1507,173 @@ namespace MWPhysics
             }
             physicActor->setCanWaterWalk(waterCollision);
 
+            ActorMovement movement;
+            movement.mPtr = iter->first;
+            movement.mActor = physicActor;
+            movement.mMovement = iter->second;
+            movement.mWaterlevel = waterlevel;
             // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-            float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            movement.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            movement.mFlying = world->isFlying(iter->first);
+            movement.mWasOnGround = physicActor->getOnGround();
+            movement.mPosition = physicActor->getPosition();
+            movement.mOldHeight = movement.mPosition.z();
+            movement.mPositionChanged = false;
+            mActorMovements.push_back(movement);
+        }
+    }
 
-            bool flying = world->isFlying(iter->first);
+    void PhysicsSystem::solveQueuedMovement(int numSteps, bool parallel)
+    {
+        solveQueuedMovement(numSteps, *mSolverPool, parallel);
+    }
 
-            bool wasOnGround = physicActor->getOnGround();
-            osg::Vec3f position = physicActor->getPosition();
-            float oldHeight = position.z();
-            bool positionChanged = false;
-            for (int i=0; i<numSteps; ++i)
+    void PhysicsSystem::solveQueuedMovement(int numSteps, MovementSolverPool& pool, bool parallel)
+    {
+        const MovementSolverPool::Function solve = [this] (int index, TraceScratch& scratch)
+        {
+            ActorMovement& movement = mActorMovements[index];
+            movement.mStandingOn = MWWorld::Ptr();
+            movement.mNewPosition = MovementSolver::move(movement.mPosition, movement.mActor->getPtr(), movement.mActor, movement.mMovement,
+                                                         mPhysicsDt, movement.mFlying, movement.mWaterlevel, movement.mSlowFall,
+                                                         mCollisionWorld, movement.mStandingOn, &scratch);
+        };
+
+        for (int i=0; i<numSteps; ++i)
+        {
+            // Nothing may change the collision world while the solver runs
+            if (parallel)
+                pool.run(static_cast<int>(mActorMovements.size()), solve);
+            else
+                pool.runSerial(static_cast<int>(mActorMovements.size()), solve);
+
+            for (ActorMovement& movement : mActorMovements)
             {
-                position = MovementSolver::move(position, physicActor->getPtr(), physicActor, iter->second, mPhysicsDt,
-                                                flying, waterlevel, slowFall, mCollisionWorld, mStandingCollisions);
-                if (position != physicActor->getPosition())
-                    positionChanged = true;
-                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
+                Actor* physicActor = movement.mActor;
+                if (!movement.mStandingOn.isEmpty())
+                    mStandingCollisions[physicActor->getPtr()] = movement.mStandingOn;
+
+                const bool moved = movement.mNewPosition != physicActor->getPosition();
+                movement.mPosition = movement.mNewPosition;
+                physicActor->setPosition(movement.mPosition); // always set even if unchanged to make sure interpolation is correct
+                if (moved)
+                {
+                    movement.mPositionChanged = true;
+                    mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+                }
             }
-            if (positionChanged)
-                mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+        }
+    }
 
-            float interpolationFactor = mTimeAccum / mPhysicsDt;
-            osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
+    bool PhysicsSystem::ActorState::sameResult(const ActorState& other) const
+    {
+        return mPosition == other.mPosition && mInertialForce == other.mInertialForce && mOnGround == other.mOnGround
+            && mOnSlope == other.mOnSlope && mWalkingOnWater == other.mWalkingOnWater;
+    }
+
+    void PhysicsSystem::getQueuedActorStates(std::vector<ActorState>& states) const
+    {
+        for (const ActorMovement& movement : mActorMovements)
+        {
+            const Actor* actor = movement.mActor;
+            ActorState state = { actor->getPosition(), actor->getPreviousPosition(), actor->getInertialForce(),
+                                 actor->getOnGround(), actor->getOnSlope(), actor->isWalkingOnWater() };
+            states.push_back(state);
+        }
+    }
 
-            float heightDiff = position.z() - oldHeight;
+    void PhysicsSystem::restoreQueuedActorStates(const std::vector<ActorState>& states, const std::vector<ActorMovement>& movements,
+                                                 const CollisionMap& standingCollisions)
+    {
+        for (size_t i = 0; i < states.size(); ++i)
+        {
+            Actor* actor = movements[i].mActor;
+            actor->setPosition(states[i].mPreviousPosition);
+            actor->setPosition(states[i].mPosition);
+            actor->setInertialForce(states[i].mInertialForce);
+            actor->setOnGround(states[i].mOnGround);
+            actor->setOnSlope(states[i].mOnSlope);
+            actor->setWalkingOnWater(states[i].mWalkingOnWater);
+            mCollisionWorld->updateSingleAabb(actor->getCollisionObject());
+        }
+        mActorMovements = movements;
+        mStandingCollisions = standingCollisions;
+    }
 
-            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-            if ((wasOnGround && physicActor->getOnGround()) || flying || world->isSwimming(iter->first) || slowFall < 1)
-                stats.land(iter->first == player);
-            else if (heightDiff < 0)
-                stats.addToFallHeight(-heightDiff);
+    void PhysicsSystem::verifyQueuedMovement(int numSteps)
+    {
+        std::vector<ActorState> states;
+        getQueuedActorStates(states);
+
+        const std::vector<ActorMovement> movements = mActorMovements;
+        const CollisionMap standingCollisions = mStandingCollisions;
+
+        std::vector<ActorState> serial;
+        solveQueuedMovement(numSteps, false);
+        getQueuedActorStates(serial);
+        const CollisionMap serialCollisions = mStandingCollisions;
+        restoreQueuedActorStates(states, movements, standingCollisions);
 
-            mMovementResults.push_back(std::make_pair(iter->first, interpolated));
+        std::vector<ActorState> parallel;
+        solveQueuedMovement(numSteps, true);
+        getQueuedActorStates(parallel);
+        const bool sameCollisions = mStandingCollisions == serialCollisions;
+        restoreQueuedActorStates(states, movements, standingCollisions);
+
+        for (size_t i = 0; i < serial.size(); ++i)
+        {
+            if (!serial[i].sameResult(parallel[i]))
+                Log(Debug::Error) << "Error: parallel movement of " << movements[i].mPtr.getCellRef().getRefId() << " differs from the serial solver";
         }
+        if (!sameCollisions)
+            Log(Debug::Error) << "Error: parallel movement found different standing collisions than the serial solver";
+    }
 
-        mMovementQueue.clear();
+    void PhysicsSystem::benchmarkQueuedMovement(int maxThreads)
+    {
+        if (mActorMovements.empty())
+            return;
 
-        return mMovementResults;
+        std::vector<ActorState> states;
+        getQueuedActorStates(states);
+
+        const std::vector<ActorMovement> movements = mActorMovements;
+        const CollisionMap standingCollisions = mStandingCollisions;
+
+        // A second worth of steps, so the cost of waking the threads doesn't dominate
+        const int numSteps = std::max(1, static_cast<int>(1.f / mPhysicsDt));
+
+        const auto serialStart = std::chrono::steady_clock::now();
+        solveQueuedMovement(numSteps, false);
+        const std::chrono::duration<double, std::milli> serialTime = std::chrono::steady_clock::now() - serialStart;
+
+        std::vector<ActorState> serial;
+        getQueuedActorStates(serial);
+        restoreQueuedActorStates(states, movements, standingCollisions);
+
+        Log(Debug::Info) << "Physics benchmark: " << movements.size() << " actors, " << numSteps << " steps, serial: " << serialTime.count() << " ms";
+
+        for (int numThreads = 1; numThreads <= maxThreads; ++numThreads)
+        {
+            // the threads are started before the clock, only solving is timed
+            MovementSolverPool pool(numThreads);
+
+            const auto start = std::chrono::steady_clock::now();
+            solveQueuedMovement(numSteps, pool, true);
+            const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+            std::vector<ActorState> result;
+            getQueuedActorStates(result);
+            restoreQueuedActorStates(states, movements, standingCollisions);
+
+            // every actor is solved against the world as it was at the start of the step, so any difference is a bug
+            bool deterministic = true;
+            for (size_t i = 0; i < serial.size() && deterministic; ++i)
+                deterministic = serial[i].sameResult(result[i]);
+
+            Log(deterministic ? Debug::Info : Debug::Error) << "Physics benchmark: " << numThreads << " threads: " << time.count() << " ms, "
+                << serialTime.count() / time.count() << "x serial" << (deterministic ? "" : ", results differ from the serial run");
+        }
     }
 
     void PhysicsSystem::stepSimulation(float dt)
@@ -4,6 +4,7 @@
 #include <memory>
 #include <map>
 #include <set>
+#include <vector>
 #include <algorithm>
 
 #include <osg/Quat>
@@ -49,6 +50,7 @@ namespace MWPhysics
     class HeightField;
     class Object;
     class Actor;
+    class MovementSolverPool;
 
     static const float sMaxSlope = 49.0f;
     static const float sStepSizeUp = 34.0f;
@@ -222,6 +224,71 @@ namespace MWPhysics
             PtrVelocityList mMovementQueue;
             PtrVelocityList mMovementResults;
 
+            struct ActorMovement
+            {
+                MWWorld::Ptr mPtr;
+                Actor* mActor;
+                osg::Vec3f mMovement;
+                float mWaterlevel;
+                float mSlowFall;
+                bool mFlying;
+                bool mWasOnGround;
+                float mOldHeight;
+
+                osg::Vec3f mPosition;
+                bool mPositionChanged;
+
+                // written by the parallel solver, committed after each step
+                osg::Vec3f mNewPosition;
+                MWWorld::Ptr mStandingOn;
+            };
+            std::vector<ActorMovement> mActorMovements;
+
+            void prepareQueuedMovement();
+
+            /// Moves all actors of a step against the collision world as it was at the start of the step,
+            /// then commits the results in queue order. The results are the same with and without \a parallel.
+            void solveQueuedMovement(int numSteps, bool parallel);
+
+            /// Same as above, with the threads of \a pool.
+            void solveQueuedMovement(int numSteps, MovementSolverPool& pool, bool parallel);
+
+            /// State the solver changes on the actors, saved so a solve can be undone
+            struct ActorState
+            {
+                osg::Vec3f mPosition;
+                osg::Vec3f mPreviousPosition;
+                osg::Vec3f mInertialForce;
+                bool mOnGround;
+                bool mOnSlope;
+                bool mWalkingOnWater;
+
+                bool sameResult(const ActorState& other) const;
+            };
+
+            void getQueuedActorStates(std::vector<ActorState>& states) const;
+
+            /// Puts the actors of \a movements back into \a states and restores the queue.
+            void restoreQueuedActorStates(const std::vector<ActorState>& states, const std::vector<ActorMovement>& movements,
+                                          const CollisionMap& standingCollisions);
+
+            /// Moves the queued actors with and without the pool and logs an error for every actor whose
+            /// results differ. The actors are put back where they were afterwards.
+            /// Set OPENMW_PHYSICS_VERIFY to run it on every frame that uses the pool.
+            void verifyQueuedMovement(int numSteps);
+
+            /// Moves the queued actors for a second of simulation, serially and then with 1 to \a maxThreads
+            /// threads, and logs how long each run took and whether its results match the serial run.
+            /// The actors are put back where they were afterwards.
+            /// Set OPENMW_PHYSICS_BENCHMARK=<maxThreads> to run it every 600 frames.
+            void benchmarkQueuedMovement(int maxThreads);
+
+            std::unique_ptr<MovementSolverPool> mSolverPool;
+
+            bool mVerifyMovement;
+            int mBenchmarkThreads;
+            int mBenchmarkFrame;
+
             float mTimeAccum;
 
             float mWaterHeight;
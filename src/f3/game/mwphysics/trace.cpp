@@ -4,6 +4,7 @@
 
 #include <BulletCollision/CollisionDispatch/btCollisionWorld.h>
 #include <BulletCollision/CollisionShapes/btConvexShape.h>
+#include <BulletCollision/BroadphaseCollision/btBroadphaseInterface.h>
 
 #include "collisiontype.hpp"
 #include "actor.hpp"
@@ -48,8 +49,57 @@ protected:
     const btScalar mMinSlopeDot;
 };
 
+class CandidateCollector : public btBroadphaseAabbCallback
+{
+public:
+    CandidateCollector(std::vector<const btCollisionObject*>& candidates)
+      : mCandidates(candidates)
+    {
+    }
+
+    virtual bool process(const btBroadphaseProxy* proxy)
+    {
+        mCandidates.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+        return true;
+    }
+
+private:
+    std::vector<const btCollisionObject*>& mCandidates;
+};
+
+// Same as btCollisionWorld::convexSweepTest, but safe to call from several threads at once when
+// given a scratch. btDbvtBroadphase::aabbTest keeps its traversal stack local, rayTest does not.
+static void convexSweepTest(const btCollisionWorld* world, const btConvexShape* shape, const btTransform& from, const btTransform& to,
+                            btCollisionWorld::ConvexResultCallback& callback, TraceScratch* scratch)
+{
+    if (!scratch)
+    {
+        world->convexSweepTest(shape, from, to, callback);
+        return;
+    }
+
+    btVector3 fromMin, fromMax, toMin, toMax;
+    shape->getAabb(from, fromMin, fromMax);
+    shape->getAabb(to, toMin, toMax);
+    fromMin.setMin(toMin);
+    fromMax.setMax(toMax);
+
+    scratch->mCandidates.clear();
+    CandidateCollector collector(scratch->mCandidates);
+    const_cast<btCollisionWorld*>(world)->getBroadphase()->aabbTest(fromMin, fromMax, collector);
+
+    const btScalar allowedPenetration = world->getDispatchInfo().m_allowedCcdPenetration;
+    for (const btCollisionObject* object : scratch->mCandidates)
+    {
+        if (!callback.needsCollision(object->getBroadphaseHandle()))
+            continue;
+        btCollisionWorld::objectQuerySingle(shape, from, to, object, object->getCollisionShape(), object->getWorldTransform(),
+                                            callback, allowedPenetration);
+    }
+}
 
-void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
+void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                          TraceScratch* scratch)
 {
     const btVector3 btstart = toBullet(start);
     const btVector3 btend = toBullet(end);
@@ -67,8 +117,7 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
 
     const btCollisionShape *shape = actor->getCollisionShape();
     assert(shape->isConvex());
-    world->convexSweepTest(static_cast<const btConvexShape*>(shape),
-                                               from, to, newTraceCallback);
+    convexSweepTest(world, static_cast<const btConvexShape*>(shape), from, to, newTraceCallback, scratch);
 
     // Copy the hit data over to our trace results struct:
     if(newTraceCallback.hasHit())
@@ -90,7 +139,8 @@ void ActorTracer::doTrace(const btCollisionObject *actor, const osg::Vec3f& star
     }
 }
 
-void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world)
+void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                             TraceScratch* scratch)
 {
     const btVector3 btstart(start.x(), start.y(), start.z());
     const btVector3 btend(end.x(), end.y(), end.z());
@@ -105,7 +155,7 @@ void ActorTracer::findGround(const Actor* actor, const osg::Vec3f& start, const
     newTraceCallback.m_collisionFilterMask = actor->getCollisionObject()->getBroadphaseHandle()->m_collisionFilterMask;
     newTraceCallback.m_collisionFilterMask &= ~CollisionType_Actor;
 
-    world->convexSweepTest(actor->getConvexShape(), from, to, newTraceCallback);
+    convexSweepTest(world, actor->getConvexShape(), from, to, newTraceCallback, scratch);
     if(newTraceCallback.hasHit())
     {
         const btVector3& tracehitnormal = newTraceCallback.m_hitNormalWorld;
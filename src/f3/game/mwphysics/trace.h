@@ -1,6 +1,8 @@
 #ifndef OENGINE_BULLET_TRACE_H
 #define OENGINE_BULLET_TRACE_H
 
+#include <vector>
+
 #include <osg/Vec3f>
 
 class btCollisionObject;
@@ -11,6 +13,15 @@ namespace MWPhysics
 {
     class Actor;
 
+    /// Per-thread state for traces that run concurrently against the same collision world.
+    /// btCollisionWorld::convexSweepTest goes through the broadphase's shared ray test stack,
+    /// traces with a scratch gather their candidates with an AABB query instead.
+    /// @note The collision world must not be modified while traces are running.
+    struct TraceScratch
+    {
+        std::vector<const btCollisionObject*> mCandidates;
+    };
+
     struct ActorTracer
     {
         osg::Vec3f mEndPos;
@@ -20,8 +31,10 @@ namespace MWPhysics
 
         float mFraction;
 
-        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
-        void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world);
+        void doTrace(const btCollisionObject *actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                     TraceScratch* scratch = nullptr);
+        void findGround(const Actor* actor, const osg::Vec3f& start, const osg::Vec3f& end, const btCollisionWorld* world,
+                        TraceScratch* scratch = nullptr);
     };
 }
 
@@ -2,8 +2,15 @@
 
 #include <cassert>
 #include <sstream>
+#include <fstream>
 #include <exception>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include <boost/filesystem.hpp>
 
 #include <components/debug/debuglog.hpp>
 
@@ -11,6 +18,8 @@
 
 #include <components/misc/stringops.hpp>
 
+#include <components/files/collections.hpp>
+
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/context.hpp>
 #include <components/compiler/exception.hpp>
@@ -19,6 +28,60 @@
 #include "../mwworld/esmstore.hpp"
 
 #include "extensions.hpp"
+#include "compilercontext.hpp"
+
+namespace
+{
+    // Bump when the bytecode or the opcodes change
+    const unsigned int sScriptCacheVersion = 2;
+    const char sScriptCacheMagic[8] = { 'O', 'M', 'W', 'S', 'C', 'R', 'P', 'T' };
+
+    unsigned long long hashString (const std::string& string, unsigned long long hash = 14695981039346656037ULL)
+    {
+        // FNV-1a, stable between runs unlike std::hash
+        for (std::string::const_iterator iter (string.begin()); iter!=string.end(); ++iter)
+        {
+            hash ^= static_cast<unsigned char> (*iter);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    template<typename T>
+    void writeValue (std::ostream& stream, const T& value)
+    {
+        stream.write (reinterpret_cast<const char *> (&value), sizeof (T));
+    }
+
+    template<typename T>
+    T readValue (std::istream& stream)
+    {
+        T value = T();
+        stream.read (reinterpret_cast<char *> (&value), sizeof (T));
+        if (!stream)
+            throw std::runtime_error ("unexpected end of file");
+        return value;
+    }
+
+    void writeString (std::ostream& stream, const std::string& string)
+    {
+        writeValue (stream, static_cast<unsigned int> (string.size()));
+        stream.write (string.data(), string.size());
+    }
+
+    std::string readString (std::istream& stream)
+    {
+        unsigned int size = readValue<unsigned int> (stream);
+        if (size>0xffff)
+            throw std::runtime_error ("invalid string length");
+        std::string string (size, '\0');
+        stream.read (&string[0], size);
+        if (!stream)
+            throw std::runtime_error ("unexpected end of file");
+        return string;
+    }
+}
 
 namespace MWScript
 {
@@ -27,7 +90,8 @@ namespace MWScript
         const std::vector<std::string>& scriptBlacklist)
     : mErrorHandler (std::cerr), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mWarningsMode (warningsMode), mGlobalScripts (store),
+      mContentHash (0), mCacheChanged (false)
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -38,52 +102,80 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
-    bool ScriptManager::compile (const std::string& name)
+    ScriptManager::~ScriptManager()
     {
-        mParser.reset();
-        mErrorHandler.reset();
-
-        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
+        try
         {
-            mErrorHandler.setContext(name);
+            saveCache();
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Error: failed to write script cache " << mCachePath << ": " << e.what();
+        }
+    }
 
-            bool Success = true;
-            try
-            {
-                std::istringstream input (script->mScriptText);
+    bool ScriptManager::compileSource (const ESM::Script& script, Compiler::FileParser& parser,
+        Compiler::StreamErrorHandler& errorHandler, const Compiler::Context& context,
+        CompiledScript& compiled)
+    {
+        parser.reset();
+        errorHandler.reset();
+        errorHandler.setContext(script.mId);
+
+        bool Success = true;
+        try
+        {
+            std::istringstream input (script.mScriptText);
 
-                Compiler::Scanner scanner (mErrorHandler, input, mCompilerContext.getExtensions());
+            Compiler::Scanner scanner (errorHandler, input, context.getExtensions());
 
-                scanner.scan (mParser);
+            scanner.scan (parser);
 
-                if (!mErrorHandler.isGood())
-                    Success = false;
-            }
-            catch (const Compiler::SourceException&)
-            {
-                // error has already been reported via error handler
+            if (!errorHandler.isGood())
                 Success = false;
-            }
-            catch (const std::exception& error)
-            {
-                Log(Debug::Error) << "Error: An exception has been thrown: " << error.what();
-                Success = false;
-            }
+        }
+        catch (const Compiler::SourceException&)
+        {
+            // error has already been reported via error handler
+            Success = false;
+        }
+        catch (const std::exception& error)
+        {
+            Log(Debug::Error) << "Error: An exception has been thrown: " << error.what();
+            Success = false;
+        }
+
+        if (Success)
+        {
+            compiled.first.clear();
+            parser.getCode (compiled.first);
+            compiled.second = parser.getLocals();
+        }
+
+        return Success;
+    }
 
-            if (!Success)
+    bool ScriptManager::compile (const std::string& name)
+    {
+        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
+        {
+            if (const CompiledScript *cached = findCached (*script))
             {
-                Log(Debug::Warning)
-                    << "Warning: compiling failed: " << name;
+                mScripts.insert (std::make_pair (name, *cached));
+                return true;
             }
 
-            if (Success)
+            CompiledScript compiled;
+            if (compileSource (*script, mParser, mErrorHandler, mCompilerContext, compiled))
             {
-                std::vector<Interpreter::Type_Code> code;
-                mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+                mScripts.insert (std::make_pair (name, compiled));
+                addToCache (*script, compiled);
 
                 return true;
             }
+
+            Log(Debug::Warning)
+                << "Warning: compiling failed: " << name;
         }
 
         return false;
@@ -131,11 +223,15 @@ namespace MWScript
 
     std::pair<int, int> ScriptManager::compileAll()
     {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
         int count = 0;
         int success = 0;
 
         const MWWorld::Store<ESM::Script>& scripts = mStore.get<ESM::Script>();
 
+        std::vector<const ESM::Script *> sources;
+
         for (MWWorld::Store<ESM::Script>::iterator iter = scripts.begin();
             iter != scripts.end(); ++iter)
             if (!std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(),
@@ -143,15 +239,227 @@ namespace MWScript
             {
                 ++count;
 
-                if (compile (iter->mId))
+                if (const CompiledScript *cached = findCached (*iter))
+                {
+                    mScripts.insert (std::make_pair (iter->mId, *cached));
                     ++success;
+                }
+                else
+                    sources.push_back (&*iter);
             }
 
+        // Compile the rest on worker threads, each with its own parser, error handler and context.
+        // Nothing is added to mScripts until all threads are done, member lookups in other scripts
+        // go through getLocals, which is locked.
+        struct Result
+        {
+            bool mSuccess;
+            CompiledScript mScript;
+            std::string mMessages;
+        };
+
+        std::vector<Result> results (sources.size());
+        std::atomic<size_t> next (0);
+
+        const auto compileSources = [&] ()
+        {
+            std::ostringstream messages;
+            Compiler::StreamErrorHandler errorHandler (messages);
+            errorHandler.setWarningsMode (mWarningsMode);
+
+            CompilerContext context (CompilerContext::Type_Full);
+            context.setExtensions (mCompilerContext.getExtensions());
+
+            Compiler::FileParser parser (errorHandler, context);
+
+            for (size_t i = next++; i<sources.size(); i = next++)
+            {
+                messages.str ("");
+                results[i].mSuccess = compileSource (*sources[i], parser, errorHandler, context, results[i].mScript);
+                results[i].mMessages = messages.str();
+            }
+        };
+
+        const size_t numThreads = std::min (sources.size() / 16 + 1,
+            static_cast<size_t> (std::max (1u, std::thread::hardware_concurrency())));
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i<numThreads; ++i)
+            threads.push_back (std::thread (compileSources));
+        compileSources();
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // report and store in script order, like the single threaded compiler did
+        for (size_t i = 0; i<sources.size(); ++i)
+        {
+            std::cerr << results[i].mMessages;
+
+            if (results[i].mSuccess)
+            {
+                mScripts.insert (std::make_pair (sources[i]->mId, results[i].mScript));
+                addToCache (*sources[i], results[i].mScript);
+                ++success;
+            }
+            else
+                Log(Debug::Warning)
+                    << "Warning: compiling failed: " << sources[i]->mId;
+        }
+
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        Log(Debug::Info)
+            << "Scripts: " << count - sources.size() << " loaded from the cache, "
+            << sources.size() << " compiled on " << numThreads << " threads in " << duration.count() << " ms";
+
+        saveCache();
+
         return std::make_pair (count, success);
     }
 
+    const ScriptManager::CompiledScript *ScriptManager::findCached (const ESM::Script& script) const
+    {
+        // the text of every script is part of mContentHash, an entry is only there if it is up to date
+        std::map<std::string, CompiledScript>::const_iterator iter =
+            mCache.find (Misc::StringUtils::lowerCase (script.mId));
+
+        if (iter==mCache.end())
+            return nullptr;
+
+        return &iter->second;
+    }
+
+    void ScriptManager::addToCache (const ESM::Script& script, const CompiledScript& compiled)
+    {
+        if (mCachePath.empty())
+            return;
+
+        mCache[Misc::StringUtils::lowerCase (script.mId)] = compiled;
+        mCacheChanged = true;
+    }
+
+    void ScriptManager::loadCache (const std::string& path, const Files::Collections& fileCollections,
+        const std::vector<std::string>& contentFiles)
+    {
+        mCachePath = path;
+        mCache.clear();
+        mCacheChanged = false;
+
+        // The bytecode refers to globals and records of the loaded content files and to the locals
+        // of other scripts, so a change to any script invalidates the whole cache. A content file
+        // edited in place keeps its name, so its size and modification time are part of the key too.
+        mContentHash = hashString (std::string());
+        for (std::vector<std::string>::const_iterator iter (contentFiles.begin()); iter!=contentFiles.end(); ++iter)
+        {
+            mContentHash = hashString (Misc::StringUtils::lowerCase (*iter) + '\n', mContentHash);
+
+            const Files::MultiDirCollection& collection = fileCollections.getCollection (boost::filesystem::path (*iter).extension().string());
+            if (!collection.doesExist (*iter))
+                continue;
+
+            boost::system::error_code error;
+            const boost::filesystem::path file = collection.getPath (*iter);
+            const boost::uintmax_t size = boost::filesystem::file_size (file, error);
+            const std::time_t time = boost::filesystem::last_write_time (file, error);
+
+            std::ostringstream stamp;
+            stamp << file.string() << '\n' << size << '\n' << time << '\n';
+            mContentHash = hashString (stamp.str(), mContentHash);
+        }
+
+        const MWWorld::Store<ESM::Script>& scripts = mStore.get<ESM::Script>();
+        for (MWWorld::Store<ESM::Script>::iterator iter = scripts.begin(); iter != scripts.end(); ++iter)
+            mContentHash = hashString (iter->mScriptText, hashString (iter->mId, mContentHash));
+
+        std::ifstream stream (path.c_str(), std::ios::binary);
+        if (!stream.is_open())
+            return;
+
+        try
+        {
+            char magic[sizeof (sScriptCacheMagic)];
+            stream.read (magic, sizeof (magic));
+            if (!stream || !std::equal (magic, magic + sizeof (magic), sScriptCacheMagic)
+                || readValue<unsigned int> (stream)!=sScriptCacheVersion
+                || readValue<unsigned long long> (stream)!=mContentHash)
+            {
+                Log(Debug::Info) << "Script cache " << path << " is out of date";
+                mCacheChanged = true;
+                return;
+            }
+
+            unsigned int numScripts = readValue<unsigned int> (stream);
+            for (unsigned int i = 0; i<numScripts; ++i)
+            {
+                std::string name = readString (stream);
+                CompiledScript& cached = mCache[name];
+
+                unsigned int codeSize = readValue<unsigned int> (stream);
+                cached.first.resize (codeSize);
+                if (codeSize)
+                    stream.read (reinterpret_cast<char *> (&cached.first[0]), codeSize * sizeof (Interpreter::Type_Code));
+
+                static const char types[] = { 's', 'l', 'f' };
+                for (int type = 0; type<3; ++type)
+                {
+                    unsigned int numLocals = readValue<unsigned int> (stream);
+                    for (unsigned int local = 0; local<numLocals; ++local)
+                        cached.second.declare (types[type], readString (stream));
+                }
+            }
+
+            Log(Debug::Info) << "Loaded " << mCache.size() << " compiled scripts from " << path;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Warning: ignoring script cache " << path << ": " << e.what();
+            mCache.clear();
+            mCacheChanged = true;
+        }
+    }
+
+    void ScriptManager::saveCache()
+    {
+        if (mCachePath.empty() || !mCacheChanged)
+            return;
+
+        std::ofstream stream (mCachePath.c_str(), std::ios::binary);
+        if (!stream.is_open())
+            throw std::runtime_error ("can't open file for writing");
+
+        stream.write (sScriptCacheMagic, sizeof (sScriptCacheMagic));
+        writeValue (stream, sScriptCacheVersion);
+        writeValue (stream, mContentHash);
+        writeValue (stream, static_cast<unsigned int> (mCache.size()));
+
+        for (std::map<std::string, CompiledScript>::const_iterator iter (mCache.begin()); iter!=mCache.end(); ++iter)
+        {
+            writeString (stream, iter->first);
+
+            const std::vector<Interpreter::Type_Code>& code = iter->second.first;
+            writeValue (stream, static_cast<unsigned int> (code.size()));
+            if (!code.empty())
+                stream.write (reinterpret_cast<const char *> (&code[0]), code.size() * sizeof (Interpreter::Type_Code));
+
+            static const char types[] = { 's', 'l', 'f' };
+            for (int type = 0; type<3; ++type)
+            {
+                const std::vector<std::string>& locals = iter->second.second.get (types[type]);
+                writeValue (stream, static_cast<unsigned int> (locals.size()));
+                for (std::vector<std::string>::const_iterator local (locals.begin()); local!=locals.end(); ++local)
+                    writeString (stream, *local);
+            }
+        }
+
+        if (!stream)
+            throw std::runtime_error ("write failed");
+
+        mCacheChanged = false;
+    }
+
     const Compiler::Locals& ScriptManager::getLocals (const std::string& name)
     {
+        std::lock_guard<std::recursive_mutex> lock (mLocalsMutex);
+
         std::string name2 = Misc::StringUtils::lowerCase (name);
 
         {
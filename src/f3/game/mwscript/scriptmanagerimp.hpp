@@ -2,6 +2,7 @@
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
 #include <map>
+#include <mutex>
 #include <string>
 
 #include <components/compiler/streamerrorhandler.hpp>
@@ -14,6 +15,11 @@
 
 #include "globalscripts.hpp"
 
+namespace ESM
+{
+    struct Script;
+}
+
 namespace MWWorld
 {
     class ESMStore;
@@ -30,6 +36,11 @@ namespace Interpreter
     class Interpreter;
 }
 
+namespace Files
+{
+    class Collections;
+}
+
 namespace MWScript
 {
     class ScriptManager : public MWBase::ScriptManager
@@ -40,6 +51,7 @@ namespace MWScript
             Compiler::FileParser mParser;
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
+            int mWarningsMode;
 
             typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
             typedef std::map<std::string, CompiledScript> ScriptCollection;
@@ -49,12 +61,39 @@ namespace MWScript
             std::map<std::string, Compiler::Locals> mOtherLocals;
             std::vector<std::string> mScriptBlacklist;
 
+            // getLocals is called by the compiler contexts of compileAll's worker threads
+            std::recursive_mutex mLocalsMutex;
+
+            std::string mCachePath;
+            unsigned long long mContentHash; // covers the text of every script, see loadCache
+            std::map<std::string, CompiledScript> mCache; // lower case script name
+            bool mCacheChanged;
+
+            static bool compileSource (const ESM::Script& script, Compiler::FileParser& parser,
+                Compiler::StreamErrorHandler& errorHandler, const Compiler::Context& context,
+                CompiledScript& compiled);
+            ///< Thread safe as long as every thread uses its own parser, error handler and context
+
+            const CompiledScript *findCached (const ESM::Script& script) const;
+
+            void addToCache (const ESM::Script& script, const CompiledScript& compiled);
+
         public:
 
             ScriptManager (const MWWorld::ESMStore& store,
                 Compiler::Context& compilerContext, int warningsMode,
                 const std::vector<std::string>& scriptBlacklist);
 
+            virtual ~ScriptManager();
+            ///< Writes the bytecode cache, if scripts were compiled since it was loaded
+
+            void loadCache (const std::string& path, const Files::Collections& fileCollections,
+                const std::vector<std::string>& contentFiles);
+            ///< Use the compiled scripts stored in \a path, unless they were compiled for a different
+            /// list of content files or one of them changed on disk. Scripts whose text changed are compiled again.
+
+            void saveCache();
+
             virtual void run (const std::string& name, Interpreter::Context& interpreterContext);
             ///< Run the script with the given name (compile first, if not compiled yet)
 
@@ -63,7 +102,7 @@ namespace MWScript
             /// \return Success?
 
             virtual std::pair<int, int> compileAll();
-            ///< Compile all scripts
+            ///< Compile all scripts, the ones that are not cached on several threads
             /// \return count, success
 
             virtual const Compiler::Locals& getLocals (const std::string& name);
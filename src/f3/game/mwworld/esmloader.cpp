@@ -1,6 +1,8 @@
 #include "esmloader.hpp"
 #include "esmstore.hpp"
 
+#include <cstdlib>
+
 #include <components/esm/esmreader.hpp>
 
 namespace MWWorld
@@ -19,6 +21,10 @@ void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
 {
   ContentLoader::load(filepath.filename(), index);
 
+  // OPENMW_ESM_BENCHMARK compares parsing the file from the stream and from record buffers
+  if (getenv("OPENMW_ESM_BENCHMARK"))
+    ESM::ESMReader::benchmark(filepath.string(), mEncoder);
+
   ESM::ESMReader lEsm;
   lEsm.setEncoder(mEncoder);
   lEsm.setIndex(index);
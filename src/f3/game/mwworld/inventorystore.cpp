@@ -215,7 +215,8 @@ MWWorld::ConstContainerStoreIterator MWWorld::InventoryStore::getSlot (int slot)
 
 bool MWWorld::InventoryStore::canActorAutoEquip(const MWWorld::Ptr& actor, const MWWorld::Ptr& item)
 {
-    if (!Settings::Manager::getBool("prevent merchant equipping", "Game"))
+    static const Settings::Handle<bool> preventMerchantEquipping = Settings::Manager::getHandle<bool>("prevent merchant equipping", "Game");
+    if (!preventMerchantEquipping)
         return true;
 
     // Only autoEquip if we are the original owner of the item.
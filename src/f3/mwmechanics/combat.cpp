@@ -159,8 +159,9 @@ namespace MWMechanics
         if (!(weapon.get<ESM::Weapon>()->mBase->mData.mFlags & ESM::Weapon::Silver
               || weapon.get<ESM::Weapon>()->mBase->mData.mFlags & ESM::Weapon::Magical))
         {
+            static const Settings::Handle<bool> enchantedWeaponsMagical = Settings::Manager::getHandle<bool>("enchanted weapons are magical", "Game");
             if (weapon.getClass().getEnchantment(weapon).empty()
-              || !Settings::Manager::getBool("enchanted weapons are magical", "Game"))
+              || !enchantedWeaponsMagical)
                 damage *= multiplier;
         }
 
@@ -401,7 +402,8 @@ namespace MWMechanics
         // 0 = Do not factor strength into hand-to-hand combat.
         // 1 = Factor into werewolf hand-to-hand combat.
         // 2 = Ignore werewolves.
-        int factorStrength = Settings::Manager::getInt("strength influences hand to hand", "Game");
+        static const Settings::Handle<int> strengthInfluencesHandToHand = Settings::Manager::getHandle<int>("strength influences hand to hand", "Game");
+        int factorStrength = strengthInfluencesHandToHand;
         if (factorStrength == 1 || (factorStrength == 2 && !isWerewolf)) {
             damage *= attacker.getClass().getCreatureStats(attacker).getAttribute(ESM::Attribute::Strength).getModified() / 40.0f;
         }
@@ -186,6 +186,10 @@ idCommonLocal::idCommonLocal() :
 	mapSpawned = false;
 	aviCaptureMode = false;
 	timeDemo = TD_NO;
+	benchmarkDemo = false;
+	benchmarkSkipBackEnd = false;
+	benchmarkLastFrameTime = 0;
+	benchmarkLastAllocs = 0;
 	
 	nextSnapshotSendTime = 0;
 	nextUsercmdSendTime = 0;
@@ -194,6 +198,12 @@ idCommonLocal::idCommonLocal() :
 	
 	saveFile = nullptr;
 	stringsFile = nullptr;
+	pipelineFile = nullptr;
+	
+	saveSnapshotThread = nullptr;
+	saveSnapshotPending = false;
+	saveSnapshotHandle = 0;
+	saveSnapshotStallTime = 0;
 	
 	ClearWipe();
 }
@@ -1212,15 +1222,15 @@ void idCommonLocal::Init( int argc, const char* const* argv, const char* cmdline
 		
 		fileSystem->BeginLevelLoad( "_startup", saveFile.GetDataPtr(), saveFile.GetAllocated() );
 		
+		// init the parallel job manager, the declaration manager scans decl files on the job threads
+		parallelJobManager->Init();
+		
 		// initialize the declaration manager
 		declManager->Init();
 		
 		// init journalling, etc
 		eventLoop->Init();
 		
-		// init the parallel job manager
-		parallelJobManager->Init();
-		
 		// exec the startup scripts
 		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "exec default.cfg\n" );
 		
@@ -1439,6 +1449,8 @@ void idCommonLocal::Shutdown()
 	
 	
 	// Kill any pending saves...
+	printf( "ShutdownBackgroundSave();\n" );
+	ShutdownBackgroundSave();
 	printf( "session->GetSaveGameManager().CancelToTerminate();\n" );
 	session->GetSaveGameManager().CancelToTerminate();
 	
@@ -171,6 +171,7 @@ void idCommonLocal::StopPlayingRenderDemo()
 	soundSystem->SetPlayingSoundWorld( menuSoundWorld );
 	
 	common->Printf( "stopped playing %s.\n", readDemo->GetName() );
+	idStr demoName = readDemo->GetName();
 	delete readDemo;
 	readDemo = nullptr;
 	
@@ -182,6 +183,14 @@ void idCommonLocal::StopPlayingRenderDemo()
 		idStr	message = va( "%i frames rendered in %3.1f seconds = %3.1f fps\n", numDemoFrames, demoSeconds, demoFPS );
 		
 		common->Printf( message );
+		
+		if( benchmarkDemo )
+		{
+			WriteBenchmarkReport( demoName, demoSeconds );
+			cvarSystem->SetCVarBool( "r_skipBackEnd", benchmarkSkipBackEnd );
+			benchmarkDemo = false;
+		}
+		
 		if( timeDemo == TD_YES_THEN_QUIT )
 		{
 			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
@@ -282,6 +291,10 @@ void idCommonLocal::StartPlayingRenderDemo( idStr demoName )
 	numDemoFrames = 1;
 	
 	timeDemoStartTime = Sys_Milliseconds();
+	
+	benchmarkFrames.Clear();
+	benchmarkLastFrameTime = Sys_Microseconds();
+	benchmarkLastAllocs = Mem_GetNumAllocs();
 }
 
 /*
@@ -324,6 +337,180 @@ void idCommonLocal::TimeRenderDemo( const char* demoName, bool twice, bool quit
 	}
 }
 
+/*
+================
+idCommonLocal::BenchmarkRenderDemo
+
+A timeDemo that skips the render back end, so only CPU work is measured.
+Skipping the back end still needs a window and an OpenGL context, start with
++set r_nullRenderer 1 to run without a GPU. Per frame timings are written as
+json to outputName.
+================
+*/
+void idCommonLocal::BenchmarkRenderDemo( const char* demoName, const char* outputName, bool quit )
+{
+	benchmarkOutputName = outputName;
+	benchmarkSkipBackEnd = cvarSystem->GetCVarBool( "r_skipBackEnd" );
+	cvarSystem->SetCVarBool( "r_skipBackEnd", true );
+	benchmarkDemo = true;
+	
+	if( !cvarSystem->GetCVarBool( "r_nullRenderer" ) )
+	{
+		common->Printf( "benchmarkDemo: start with +set r_nullRenderer 1 to run without a GPU\n" );
+	}
+	
+	// play it twice so the timed run doesn't include loading media
+	TimeRenderDemo( demoName, true, quit );
+	
+	if( !readDemo )
+	{
+		cvarSystem->SetCVarBool( "r_skipBackEnd", benchmarkSkipBackEnd );
+		benchmarkDemo = false;
+		if( quit )
+		{
+			// a script waiting on the results shouldn't hang
+			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
+		}
+	}
+}
+
+/*
+================
+idCommonLocal::RecordBenchmarkFrame
+
+Called at the end of each frame while a benchmarkDemo is playing
+================
+*/
+void idCommonLocal::RecordBenchmarkFrame()
+{
+	const uint64 now = Sys_Microseconds();
+	const int allocs = Mem_GetNumAllocs();
+	
+	demoBenchmarkFrame_t& frame = benchmarkFrames.Alloc();
+	frame.frame = now - benchmarkLastFrameTime;
+	frame.game = frameTiming.finishGameTime - frameTiming.startGameTime;
+	frame.draw = frameTiming.finishDrawTime - frameTiming.finishGameTime;
+	frame.frontend = time_frontend;
+	frame.backend = time_backend;
+	frame.sound = frameTiming.soundTime;
+	frame.network = frameTiming.networkTime;
+	frame.allocs = allocs - benchmarkLastAllocs;
+	
+	benchmarkLastFrameTime = now;
+	benchmarkLastAllocs = allocs;
+}
+
+/*
+================
+WriteBenchmarkStat
+
+Writes "name": { avg, percentiles, max } in milliseconds
+================
+*/
+static void WriteBenchmarkStat( idFile* f, const char* name, idList<uint64>& values, bool last )
+{
+	float average = 0.0f;
+	float p50 = 0.0f;
+	float p90 = 0.0f;
+	float p99 = 0.0f;
+	float max = 0.0f;
+	
+	if( values.Num() > 0 )
+	{
+		uint64 total = 0;
+		for( int i = 0; i < values.Num(); i++ )
+		{
+			total += values[i];
+		}
+		values.SortWithTemplate( idSort_QuickDefault<uint64>() );
+		
+		const int n = values.Num() - 1;
+		average = total * 0.001f / values.Num();
+		p50 = values[n * 50 / 100] * 0.001f;
+		p90 = values[n * 90 / 100] * 0.001f;
+		p99 = values[n * 99 / 100] * 0.001f;
+		max = values[n] * 0.001f;
+	}
+	
+	f->Printf( "\t\t\"%s\": { \"avg\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f }%s\n",
+			   name, average, p50, p90, p99, max, last ? "" : "," );
+}
+
+/*
+================
+idCommonLocal::WriteBenchmarkReport
+================
+*/
+void idCommonLocal::WriteBenchmarkReport( const char* demoName, float demoSeconds )
+{
+	const int numFrames = benchmarkFrames.Num();
+	
+	idFileLocal f( fileSystem->OpenFileWrite( benchmarkOutputName ) );
+	if( f == nullptr )
+	{
+		common->Warning( "couldn't write %s", benchmarkOutputName.c_str() );
+		return;
+	}
+	
+	int totalAllocs = 0;
+	int maxAllocs = 0;
+	for( int i = 0; i < numFrames; i++ )
+	{
+		totalAllocs += benchmarkFrames[i].allocs;
+		maxAllocs = Max( maxAllocs, benchmarkFrames[i].allocs );
+	}
+	
+	f->Printf( "{\n" );
+	f->Printf( "\t\"demo\": \"%s\",\n", demoName );
+	f->Printf( "\t\"renderBackEnd\": false,\n" );
+	f->Printf( "\t\"nullRenderer\": %s,\n", cvarSystem->GetCVarBool( "r_nullRenderer" ) ? "true" : "false" );
+	f->Printf( "\t\"frames\": %i,\n", numFrames );
+	f->Printf( "\t\"seconds\": %.3f,\n", demoSeconds );
+	f->Printf( "\t\"fps\": %.2f,\n", demoSeconds > 0.0f ? numDemoFrames / demoSeconds : 0.0f );
+	f->Printf( "\t\"allocations\": { \"total\": %i, \"perFrame\": %.1f, \"max\": %i },\n",
+			   totalAllocs, numFrames > 0 ? ( float )totalAllocs / numFrames : 0.0f, maxAllocs );
+	
+	// summary per timing in milliseconds
+	static const char* timingNames[] = { "frame", "game", "draw", "frontend", "backend", "sound", "network" };
+	static uint64 demoBenchmarkFrame_t::* const timingMembers[] =
+	{
+		&demoBenchmarkFrame_t::frame, &demoBenchmarkFrame_t::game, &demoBenchmarkFrame_t::draw, &demoBenchmarkFrame_t::frontend,
+		&demoBenchmarkFrame_t::backend, &demoBenchmarkFrame_t::sound, &demoBenchmarkFrame_t::network
+	};
+	const int numTimings = sizeof( timingNames ) / sizeof( timingNames[0] );
+	
+	f->Printf( "\t\"timings\": {\n" );
+	idList<uint64> values;
+	values.SetNum( numFrames );
+	for( int t = 0; t < numTimings; t++ )
+	{
+		for( int i = 0; i < numFrames; i++ )
+		{
+			values[i] = benchmarkFrames[i].*timingMembers[t];
+		}
+		WriteBenchmarkStat( f, timingNames[t], values, t == numTimings - 1 );
+	}
+	f->Printf( "\t},\n" );
+	
+	// raw per frame values in microseconds
+	f->Printf( "\t\"columns\": [ \"frame\", \"game\", \"draw\", \"frontend\", \"backend\", \"sound\", \"network\", \"allocs\" ],\n" );
+	f->Printf( "\t\"perFrame\": [\n" );
+	for( int i = 0; i < numFrames; i++ )
+	{
+		const demoBenchmarkFrame_t& frame = benchmarkFrames[i];
+		f->Printf( "\t\t[ %llu, %llu, %llu, %llu, %llu, %llu, %llu, %i ]%s\n",
+				   ( unsigned long long )frame.frame, ( unsigned long long )frame.game, ( unsigned long long )frame.draw,
+				   ( unsigned long long )frame.frontend, ( unsigned long long )frame.backend, ( unsigned long long )frame.sound,
+				   ( unsigned long long )frame.network, frame.allocs, i == numFrames - 1 ? "" : "," );
+	}
+	f->Printf( "\t]\n" );
+	f->Printf( "}\n" );
+	
+	common->Printf( "wrote benchmark results for %i frames to %s\n", numFrames, benchmarkOutputName.c_str() );
+	
+	benchmarkFrames.Clear();
+}
+
 
 /*
 ================
@@ -626,6 +813,44 @@ CONSOLE_COMMAND( timeDemoQuit, "times a demo and quits", idCmdSystem::ArgComplet
 	commonLocal.TimeRenderDemo( va( "demos/%s", args.Argv( 1 ) ), true );
 }
 
+/*
+================
+Common_BenchmarkDemo_f
+================
+*/
+static void BenchmarkDemo( const idCmdArgs& args, bool quit )
+{
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "use: %s <demo> [output.json]\n", args.Argv( 0 ) );
+		return;
+	}
+	
+	idStr outputName;
+	if( args.Argc() > 2 )
+	{
+		outputName = args.Argv( 2 );
+	}
+	else
+	{
+		outputName = va( "benchmarks/%s", args.Argv( 1 ) );
+		outputName.StripFileExtension();
+	}
+	outputName.DefaultFileExtension( ".json" );
+	
+	commonLocal.BenchmarkRenderDemo( va( "demos/%s", args.Argv( 1 ) ), outputName, quit );
+}
+
+CONSOLE_COMMAND( benchmarkDemo, "times a demo without the render back end and writes per frame timings as json", idCmdSystem::ArgCompletion_DemoName )
+{
+	BenchmarkDemo( args, false );
+}
+
+CONSOLE_COMMAND( benchmarkDemoQuit, "runs benchmarkDemo and quits", idCmdSystem::ArgCompletion_DemoName )
+{
+	BenchmarkDemo( args, true );
+}
+
 /*
 ================
 Common_AVIDemo_f
@@ -41,6 +41,8 @@ If you have questions concerning this license or the applicable additional terms
 idCVar com_wipeSeconds( "com_wipeSeconds", "1", CVAR_SYSTEM, "" );
 idCVar com_disableAutoSaves( "com_disableAutoSaves", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
 idCVar com_disableAllSaves( "com_disableAllSaves", "0", CVAR_SYSTEM | CVAR_BOOL, "" );
+idCVar com_backgroundSaves( "com_backgroundSaves", "1", CVAR_SYSTEM | CVAR_BOOL, "serialize saves to memory and compress/write them on a background thread instead of stalling the game" );
+idCVar com_showSaveTimes( "com_showSaveTimes", "0", CVAR_SYSTEM | CVAR_BOOL, "print how long each save stalled the game thread" );
 
 
 extern idCVar sys_lang;
@@ -395,6 +397,9 @@ Exits with mapSpawned = true
 */
 void idCommonLocal::ExecuteMapChange()
 {
+	// the level load borrows saveFile as its scratch buffer
+	FinishBackgroundSave();
+	
 	if( session->GetState() != idSession::LOADING )
 	{
 		idLib::Warning( "Session state is not LOADING in ExecuteMapChange" );
@@ -801,6 +806,7 @@ void idCommonLocal::LoadPacifierBinarizeFilename( const char* filename, const ch
 	loadPacifierBinarizeStartTime = Sys_Milliseconds();
 	loadPacifierBinarizeMiplevel = 0;
 	loadPacifierBinarizeMiplevelTotal = 0;
+	loadPacifierBinarizeThread = Sys_GetCurrentThreadID();
 }
 
 void idCommonLocal::LoadPacifierBinarizeInfo( const char* info )
@@ -847,7 +853,7 @@ void idCommonLocal::LoadPacifierBinarizeEnd()
 	loadPacifierBinarizeTimeLeft = 0.0f;
 	loadPacifierBinarizeFilename = "";
 	loadPacifierBinarizeProgressTotal = 0;
-	loadPacifierBinarizeProgressCurrent = 0;
+	loadPacifierBinarizeProgressCurrent.SetValue( 0 );
 	loadPacifierBinarizeMiplevel = 0;
 	loadPacifierBinarizeMiplevelTotal = 0;
 }
@@ -856,14 +862,19 @@ void idCommonLocal::LoadPacifierBinarizeEnd()
 void idCommonLocal::LoadPacifierBinarizeProgressTotal( int total )
 {
 	loadPacifierBinarizeProgressTotal = total;
-	loadPacifierBinarizeProgressCurrent = 0;
+	loadPacifierBinarizeProgressCurrent.SetValue( 0 );
 }
 
 // foresthale 2014-05-30: loading progress pacifier for binarize operations only
 void idCommonLocal::LoadPacifierBinarizeProgressIncrement( int step )
 {
-	loadPacifierBinarizeProgressCurrent += step;
-	LoadPacifierBinarizeProgress( ( float )loadPacifierBinarizeProgressCurrent / loadPacifierBinarizeProgressTotal );
+	const int current = loadPacifierBinarizeProgressCurrent.Add( step );
+	
+	// the DXT encoders also report from job threads, but only the binarizing thread may draw
+	if( Sys_GetCurrentThreadID() == loadPacifierBinarizeThread )
+	{
+		LoadPacifierBinarizeProgress( ( float )current / loadPacifierBinarizeProgressTotal );
+	}
 }
 
 /*
@@ -908,6 +919,50 @@ void idCommonLocal::ScrubSaveGameFileName( idStr& saveFileName ) const
 	}
 }
 
+/*
+================================================
+idSaveSnapshotThread
+
+Pushes a savegame that was already serialized into memory through the
+compressing pipeline, so the game thread only pays for the serialization.
+================================================
+*/
+class idSaveSnapshotThread : public idSysThread
+{
+public:
+	idSaveSnapshotThread() : pipeline( nullptr ), snapshot( nullptr ), dest( nullptr ), compressTime( 0 ) {}
+	
+	void			Setup( idFile_SaveGamePipelined* pipeline_, const idFile_SaveGame* snapshot_, idFile_SaveGame* dest_ )
+	{
+		pipeline = pipeline_;
+		snapshot = snapshot_;
+		dest = dest_;
+	}
+	
+	int				GetCompressTime() const
+	{
+		return compressTime;
+	}
+	
+	virtual int		Run()
+	{
+		const int start = Sys_Milliseconds();
+		
+		pipeline->OpenForWriting( dest );
+		pipeline->Write( snapshot->GetDataPtr(), snapshot->Length() );
+		pipeline->Finish();
+		
+		compressTime = Sys_Milliseconds() - start;
+		return 0;
+	}
+	
+private:
+	idFile_SaveGamePipelined* 	pipeline;
+	const idFile_SaveGame* 		snapshot;
+	idFile_SaveGame* 			dest;
+	int							compressTime;
+};
+
 /*
 ===============
 idCommonLocal::SaveGame
@@ -944,24 +999,35 @@ bool idCommonLocal::SaveGame( const char* saveName )
 		return false;
 	}
 	
-	soundWorld->Pause();
-	soundSystem->SetPlayingSoundWorld( menuSoundWorld );
-	soundSystem->Render();
+	const int saveStartTime = Sys_Milliseconds();
+	
+	// saves during a map change are hidden behind the loading screen anyway,
+	// so only in-game saves go through the background snapshot path
+	const bool background = com_backgroundSaves.GetBool() && !insideExecuteMapChange;
 	
 	Dialog().ShowSaveIndicator( true );
-	if( insideExecuteMapChange )
-	{
-		UpdateLevelLoadPacifier();
-	}
-	else
+	
+	// in the background case the game keeps running while the snapshot is compressed and written
+	if( !background )
 	{
-		// Heremake sure we pump the gui enough times to show the 'saving' dialog
-		const bool captureToImage = false;
-		for( int i = 0; i < NumScreenUpdatesToShowDialog; ++i )
+		soundWorld->Pause();
+		soundSystem->SetPlayingSoundWorld( menuSoundWorld );
+		soundSystem->Render();
+		
+		if( insideExecuteMapChange )
 		{
-			UpdateScreen( captureToImage );
+			UpdateLevelLoadPacifier();
+		}
+		else
+		{
+			// Heremake sure we pump the gui enough times to show the 'saving' dialog
+			const bool captureToImage = false;
+			for( int i = 0; i < NumScreenUpdatesToShowDialog; ++i )
+			{
+				UpdateScreen( captureToImage );
+			}
+			renderSystem->BeginAutomaticBackgroundSwaps( AUTORENDER_DIALOGICON );
 		}
-		renderSystem->BeginAutomaticBackgroundSwaps( AUTORENDER_DIALOGICON );
 	}
 	
 	// Make sure the file is writable and the contents are cleared out (Set to write from the start of file)
@@ -970,9 +1036,12 @@ bool idCommonLocal::SaveGame( const char* saveName )
 	stringsFile.MakeWritable();
 	stringsFile.Clear( false );
 	
-	// Setup the save pipeline
+	// Setup the save pipeline, in the background case it is opened by the snapshot thread
 	pipelineFile = new( TAG_SAVEGAMES ) idFile_SaveGamePipelined();
-	pipelineFile->OpenForWriting( &saveFile );
+	if( !background )
+	{
+		pipelineFile->OpenForWriting( &saveFile );
+	}
 	
 	// Write SaveGame Header:
 	// Game Name / Version / Map Name / Persistant Player Info
@@ -989,9 +1058,19 @@ bool idCommonLocal::SaveGame( const char* saveName )
 	game->GetServerInfo().WriteToFileHandle( &saveFile );
 	
 	// let the game save its state
-	game->SaveGame( pipelineFile, &stringsFile );
-	
-	pipelineFile->Finish();
+	if( background )
+	{
+		// plain memory writes only, the serialized stream is the snapshot that gets compressed later
+		saveSnapshot.MakeWritable();
+		saveSnapshot.Clear( false );
+		game->SaveGame( &saveSnapshot, &stringsFile );
+	}
+	else
+	{
+		game->SaveGame( pipelineFile, &stringsFile );
+		
+		pipelineFile->Finish();
+	}
 	
 	idSaveGameDetails gameDetails;
 	game->GetSaveGameDetails( gameDetails );
@@ -1002,6 +1081,24 @@ bool idCommonLocal::SaveGame( const char* saveName )
 	gameDetails.slotName = saveName;
 	ScrubSaveGameFileName( gameDetails.slotName );
 	
+	if( background )
+	{
+		if( saveSnapshotThread == nullptr )
+		{
+			saveSnapshotThread = new( TAG_SAVEGAMES ) idSaveSnapshotThread();
+			saveSnapshotThread->StartWorkerThread( "SaveSnapshot", CORE_ANY, THREAD_NORMAL );
+		}
+		
+		saveSnapshotDetails = gameDetails;
+		saveSnapshotThread->Setup( pipelineFile, &saveSnapshot, &saveFile );
+		saveSnapshotThread->SignalWork();
+		saveSnapshotPending = true;
+		
+		// handed off to the session in UpdateBackgroundSave once the snapshot is compressed
+		saveSnapshotStallTime = Sys_Milliseconds() - saveStartTime;
+		return true;
+	}
+	
 	saveFileEntryList_t files;
 	files.Append( &stringsFile );
 	files.Append( &saveFile );
@@ -1015,9 +1112,97 @@ bool idCommonLocal::SaveGame( const char* saveName )
 	
 	syncNextGameFrame = true;
 	
+	if( com_showSaveTimes.GetBool() )
+	{
+		Printf( "Save '%s': %i ms game thread stall (synchronous)\n", gameDetails.slotName.c_str(), Sys_Milliseconds() - saveStartTime );
+	}
+	
 	return true;
 }
 
+/*
+===============
+idCommonLocal::UpdateBackgroundSave
+
+Hands a background save to the session once its snapshot has been compressed.
+===============
+*/
+void idCommonLocal::UpdateBackgroundSave()
+{
+	if( !saveSnapshotPending || !saveSnapshotThread->IsWorkDone() )
+	{
+		return;
+	}
+	saveSnapshotPending = false;
+	
+	saveFileEntryList_t files;
+	files.Append( &stringsFile );
+	files.Append( &saveFile );
+	
+	saveSnapshotHandle = session->SaveGameAsync( saveSnapshotDetails.slotName, files, saveSnapshotDetails );
+	
+	if( com_showSaveTimes.GetBool() )
+	{
+		Printf( "Save '%s': %i ms game thread stall, %i ms background compression (%i kB -> %i kB)\n",
+				saveSnapshotDetails.slotName.c_str(), saveSnapshotStallTime, saveSnapshotThread->GetCompressTime(),
+				saveSnapshot.Length() / 1024, saveFile.Length() / 1024 );
+	}
+}
+
+/*
+===============
+idCommonLocal::FinishBackgroundSave
+
+Blocks until no background save uses saveFile and stringsFile anymore. A snapshot that is
+still compressing is waited for and written out synchronously, a save that was already
+handed to the session is pumped until it completes.
+===============
+*/
+void idCommonLocal::FinishBackgroundSave()
+{
+	if( saveSnapshotPending )
+	{
+		saveSnapshotThread->WaitForThread();
+		saveSnapshotPending = false;
+		
+		saveFileEntryList_t files;
+		files.Append( &stringsFile );
+		files.Append( &saveFile );
+		
+		session->SaveGameSync( saveSnapshotDetails.slotName, files, saveSnapshotDetails );
+	}
+	
+	if( saveSnapshotHandle != 0 )
+	{
+		while( !session->IsSaveGameCompletedFromHandle( saveSnapshotHandle ) )
+		{
+			session->GetSaveGameManager().Pump();
+			Sys_Sleep( 10 );
+		}
+		saveSnapshotHandle = 0;
+	}
+}
+
+/*
+===============
+idCommonLocal::ShutdownBackgroundSave
+===============
+*/
+void idCommonLocal::ShutdownBackgroundSave()
+{
+	if( saveSnapshotThread == nullptr )
+	{
+		return;
+	}
+	
+	// a save that is still compressing is finished and written out synchronously so it isn't lost on quit
+	FinishBackgroundSave();
+	
+	saveSnapshotThread->StopThread();
+	delete saveSnapshotThread;
+	saveSnapshotThread = nullptr;
+}
+
 /*
 ===============
 idCommonLocal::LoadGame
@@ -1025,6 +1210,9 @@ idCommonLocal::LoadGame
 */
 bool idCommonLocal::LoadGame( const char* saveName )
 {
+	// the save is loaded into the same buffers a background save may still be writing
+	FinishBackgroundSave();
+	
 	if( IsMultiplayer() )
 	{
 		common->Printf( "Can't load during net play.\n" );
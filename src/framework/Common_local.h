@@ -39,6 +39,8 @@ static const int initialBaseTicksPerSec = initialHz * initialBaseTicks;
 static const int LOAD_TIP_CHANGE_INTERVAL = 12000;
 static const int LOAD_TIP_COUNT = 26;
 
+class idSaveSnapshotThread;
+
 class idGameThread : public idSysThread
 {
 public:
@@ -129,6 +131,21 @@ struct frameTiming_t
 	uint64	finishDrawTime;
 	uint64	startRenderTime;
 	uint64	finishRenderTime;
+	uint64	soundTime;			// time spent in the sound system this frame
+	uint64	networkTime;		// time spent in session and snapshot processing this frame
+};
+
+// per frame results of benchmarkDemo, in microseconds
+struct demoBenchmarkFrame_t
+{
+	uint64	frame;
+	uint64	game;
+	uint64	draw;
+	uint64	frontend;
+	uint64	backend;
+	uint64	sound;
+	uint64	network;
+	int		allocs;
 };
 
 #define	MAX_PRINT_MSG_SIZE	4096
@@ -343,6 +360,7 @@ public:	// These are public because they are called directly by static functions
 	void	StopPlayingRenderDemo();
 	void	CompressDemoFile( const char* scheme, const char* name );
 	void	TimeRenderDemo( const char* name, bool twice = false, bool quit = false );
+	void	BenchmarkRenderDemo( const char* name, const char* outputName, bool quit );
 	void	AVIRenderDemo( const char* name );
 	void	AVIGame( const char* name );
 	
@@ -384,6 +402,15 @@ private:
 	idFile_SaveGame 			stringsFile;
 	idFile_SaveGamePipelined*	 pipelineFile;
 	
+	// background saves serialize into saveSnapshot on the game thread and
+	// compress it into saveFile on saveSnapshotThread
+	idFile_SaveGame				saveSnapshot;
+	idSaveSnapshotThread*		saveSnapshotThread;
+	idSaveGameDetails			saveSnapshotDetails;
+	bool						saveSnapshotPending;
+	saveGameHandle_t			saveSnapshotHandle;			// async session save that still reads saveFile and stringsFile
+	int							saveSnapshotStallTime;
+	
 	// The main render world and sound world
 	idRenderWorld* 		renderWorld;
 	idSoundWorld* 		soundWorld;
@@ -491,6 +518,13 @@ private:
 	int					demoTimeOffset;
 	renderView_t		currentDemoRenderView;
 	
+	bool				benchmarkDemo;			// timeDemo with the render back end skipped and per frame timings
+	bool				benchmarkSkipBackEnd;	// r_skipBackEnd value to restore
+	idStr				benchmarkOutputName;
+	uint64				benchmarkLastFrameTime;
+	int					benchmarkLastAllocs;
+	idList<demoBenchmarkFrame_t>	benchmarkFrames;
+	
 	idStrList			mpGameModes;
 	idStrList			mpDisplayGameModes;
 	idList<mpMap_t>		mpGameMaps;
@@ -538,7 +572,8 @@ private:
 	int					loadPacifierBinarizeMiplevel;
 	int					loadPacifierBinarizeMiplevelTotal;
 	int					loadPacifierBinarizeProgressTotal;
-	int					loadPacifierBinarizeProgressCurrent;
+	idSysInterlockedInteger	loadPacifierBinarizeProgressCurrent;	// also advanced by DXT compression jobs
+	uintptr_t			loadPacifierBinarizeThread;				// only this thread updates the screen
 	
 	bool				showShellRequested;
 private:
@@ -568,6 +603,8 @@ private:
 	void	EndAVICapture();
 	
 	void	AdvanceRenderDemo( bool singleFrameOnly );
+	void	RecordBenchmarkFrame();
+	void	WriteBenchmarkReport( const char* demoName, float demoSeconds );
 	
 	void	ProcessGameReturn( const gameReturn_t& ret );
 	
@@ -609,6 +646,9 @@ private:
 	void	PlayIntroGui();
 	
 	void	ScrubSaveGameFileName( idStr& saveFileName ) const;
+	void	UpdateBackgroundSave();
+	void	FinishBackgroundSave();
+	void	ShutdownBackgroundSave();
 };
 
 extern idCommonLocal commonLocal;
@@ -668,3 +668,284 @@ CONSOLE_COMMAND( convertMapToJSON, "Convert .map file to new map format with pol
 	
 	common->SetRefreshOnPrint( false );
 }
+
+
+CONSOLE_COMMAND( benchmarkMapFiles, "Compare parsing .map files as text and loading them from generated/maps/*.bmap ", idCmdSystem::ArgCompletion_MapName )
+{
+	common->SetRefreshOnPrint( true );
+	
+	struct mapSource_t
+	{
+		idStr		name;
+		int			length;
+	};
+	idList<mapSource_t> sources;
+	
+	if( args.Argc() == 2 )
+	{
+		mapSource_t& source = sources.Alloc();
+		source.name = args.Argv( 1 );
+		source.name.StripFileExtension();
+		source.name = va( "maps/%s.map", source.name.c_str() );
+		source.length = fileSystem->ReadFile( source.name, nullptr );
+	}
+	else
+	{
+		idFileList* fileList = fileSystem->ListFilesTree( "maps", ".map", true );
+		for( int i = 0; i < fileList->GetNumFiles(); i++ )
+		{
+			mapSource_t& source = sources.Alloc();
+			source.name = fileList->GetFile( i );
+			source.length = fileSystem->ReadFile( source.name, nullptr );
+		}
+		fileSystem->FreeFileList( fileList );
+	}
+	
+	// largest maps first
+	class idSort_MapSourceLength : public idSort_Quick< mapSource_t, idSort_MapSourceLength >
+	{
+	public:
+		int Compare( const mapSource_t& a, const mapSource_t& b ) const
+		{
+			return b.length - a.length;
+		}
+	};
+	sources.SortWithTemplate( idSort_MapSourceLength() );
+	
+	const bool useBinary = cvarSystem->GetCVarBool( "map_useBinary" );
+	
+	uint64 totalText = 0;
+	uint64 totalBinary = 0;
+	
+	common->Printf( "%-40s %8s %8s %10s %10s\n", "map", "KB", "entities", "text ms", "binary ms" );
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		const mapSource_t& source = sources[i];
+		if( source.length <= 0 )
+		{
+			common->Printf( "%s not found\n", source.name.c_str() );
+			continue;
+		}
+		
+		cvarSystem->SetCVarBool( "map_useBinary", false );
+		
+		idMapFile textMap;
+		uint64 startTime = Sys_Microseconds();
+		if( !textMap.Parse( declManager, source.name ) )
+		{
+			common->Printf( "%s failed to parse\n", source.name.c_str() );
+			continue;
+		}
+		uint64 textTime = Sys_Microseconds() - startTime;
+		
+		cvarSystem->SetCVarBool( "map_useBinary", true );
+		
+		// writes the .bmap if it is missing or out of date
+		{
+			idMapFile map;
+			map.Parse( declManager, source.name );
+		}
+		
+		idMapFile binaryMap;
+		startTime = Sys_Microseconds();
+		binaryMap.Parse( declManager, source.name );
+		uint64 binaryTime = Sys_Microseconds() - startTime;
+		
+		common->Printf( "%-40s %8i %8i %10.2f %10.2f\n", source.name.c_str(), source.length >> 10, textMap.GetNumEntities(), textTime * 0.001f, binaryTime * 0.001f );
+		
+		if( !binaryMap.LoadedFromBinary() )
+		{
+			common->Warning( "%s wasn't loaded from the binary file", source.name.c_str() );
+		}
+		else if( binaryMap.GetGeometryCRC() != textMap.GetGeometryCRC() || binaryMap.GetNumEntities() != textMap.GetNumEntities() )
+		{
+			common->Warning( "%s differs between the text and the binary file", source.name.c_str() );
+		}
+		
+		totalText += textTime;
+		totalBinary += binaryTime;
+	}
+	
+	cvarSystem->SetCVarBool( "map_useBinary", useBinary );
+	
+	common->Printf( "%i maps, text %.1f ms, binary %.1f ms\n", sources.Num(), totalText * 0.001f, totalBinary * 0.001f );
+	
+	common->SetRefreshOnPrint( false );
+}
+
+/*
+================
+SpawnArgsJob
+
+Builds the spawn args of a range of map entities the way the game does when it spawns them,
+and looks up the keys most entities read in Spawn, either by name or by interned key handle.
+================
+*/
+struct spawnArgsEntity_t
+{
+	const idDict*			epairs;
+	const idDict*			defaults;
+};
+
+struct spawnArgsJob_t
+{
+	const spawnArgsEntity_t*	entities;
+	int						numEntities;
+	bool					useHandles;
+	int						found;
+};
+
+static const char* spawnArgsKeys[] =
+{
+	"classname", "name", "origin", "angle", "rotation", "model", "skin", "hide", "solid", "health",
+	"target", "bind", "spawnclass", "scriptobject", "noclipmodel", "neverDormant", "cinematic", "gravity"
+};
+static const int NUM_SPAWN_ARGS_KEYS = sizeof( spawnArgsKeys ) / sizeof( spawnArgsKeys[0] );
+
+static idDictKey spawnArgsHandles[NUM_SPAWN_ARGS_KEYS];
+static idDictKey spawnArgsOrigin;
+
+static void SpawnArgsJob( spawnArgsJob_t* job )
+{
+	int found = 0;
+	
+	for( int i = 0; i < job->numEntities; i++ )
+	{
+		const spawnArgsEntity_t& entity = job->entities[i];
+		
+		idDict spawnArgs;
+		spawnArgs = *entity.epairs;
+		if( entity.defaults != nullptr )
+		{
+			spawnArgs.SetDefaults( entity.defaults );
+		}
+		
+		for( int k = 0; k < NUM_SPAWN_ARGS_KEYS; k++ )
+		{
+			const idKeyValue* kv = job->useHandles ? spawnArgs.FindKey( spawnArgsHandles[k] ) : spawnArgs.FindKey( spawnArgsKeys[k] );
+			if( kv != nullptr )
+			{
+				found++;
+			}
+		}
+		
+		const idVec3 origin = job->useHandles ? spawnArgs.GetVector( spawnArgsOrigin ) : spawnArgs.GetVector( "origin" );
+		if( origin.x != 0.0f )
+		{
+			found++;
+		}
+	}
+	
+	job->found = found;
+}
+
+REGISTER_PARALLEL_JOB( SpawnArgsJob, "SpawnArgsJob" );
+
+CONSOLE_COMMAND( benchmarkSpawnArgs, "Compare building the spawn args of all entities of a map by key name and by key handle, serial and in jobs ", idCmdSystem::ArgCompletion_MapName )
+{
+	common->SetRefreshOnPrint( true );
+	
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "Usage: benchmarkSpawnArgs <map> [iterations]\n" );
+		common->SetRefreshOnPrint( false );
+		return;
+	}
+	
+	idStr mapName = args.Argv( 1 );
+	mapName.StripFileExtension();
+	mapName = va( "maps/%s.map", mapName.c_str() );
+	
+	const int iterations = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 10;
+	
+	idMapFile map;
+	if( !map.Parse( declManager, mapName ) )
+	{
+		common->Printf( "%s failed to parse\n", mapName.c_str() );
+		common->SetRefreshOnPrint( false );
+		return;
+	}
+	
+	// the decl manager is only used from the main thread, so the entity defs are resolved up front
+	idList<spawnArgsEntity_t> entities;
+	entities.SetNum( map.GetNumEntities() );
+	for( int i = 0; i < map.GetNumEntities(); i++ )
+	{
+		const idMapEntity* mapEnt = map.GetEntity( i );
+		const idDeclEntityDef* def = static_cast<const idDeclEntityDef*>( declManager->FindType( DECL_ENTITYDEF, mapEnt->epairs.GetString( "classname" ), false ) );
+		
+		entities[i].epairs = &mapEnt->epairs;
+		entities[i].defaults = ( def != nullptr ) ? &def->dict : nullptr;
+	}
+	
+	for( int k = 0; k < NUM_SPAWN_ARGS_KEYS; k++ )
+	{
+		spawnArgsHandles[k] = idDict::InternKey( spawnArgsKeys[k] );
+	}
+	spawnArgsOrigin = idDict::InternKey( "origin" );
+	
+	const int ENTITIES_PER_JOB = 64;
+	const int numJobs = ( entities.Num() + ENTITIES_PER_JOB - 1 ) / ENTITIES_PER_JOB;
+	
+	idList<spawnArgsJob_t> jobs;
+	jobs.SetNum( numJobs );
+	
+	common->Printf( "%i entities, %i iterations\n", entities.Num(), iterations );
+	common->Printf( "%-20s %10s %10s\n", "", "keys ms", "handles ms" );
+	
+	int found[2][2] = { { 0, 0 }, { 0, 0 } };
+	
+	for( int parallel = 0; parallel < 2; parallel++ )
+	{
+		uint64 times[2];
+		
+		for( int useHandles = 0; useHandles < 2; useHandles++ )
+		{
+			for( int j = 0; j < numJobs; j++ )
+			{
+				jobs[j].entities = entities.Ptr() + j * ENTITIES_PER_JOB;
+				jobs[j].numEntities = Min( ENTITIES_PER_JOB, entities.Num() - j * ENTITIES_PER_JOB );
+				jobs[j].useHandles = ( useHandles != 0 );
+				jobs[j].found = 0;
+			}
+			
+			const uint64 startTime = Sys_Microseconds();
+			for( int n = 0; n < iterations; n++ )
+			{
+				if( parallel )
+				{
+					idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, nullptr );
+					for( int j = 0; j < numJobs; j++ )
+					{
+						jobList->AddJob( ( jobRun_t )SpawnArgsJob, &jobs[j] );
+					}
+					jobList->Submit();
+					jobList->Wait();
+					parallelJobManager->FreeJobList( jobList );
+				}
+				else
+				{
+					for( int j = 0; j < numJobs; j++ )
+					{
+						SpawnArgsJob( &jobs[j] );
+					}
+				}
+			}
+			times[useHandles] = Sys_Microseconds() - startTime;
+			
+			for( int j = 0; j < numJobs; j++ )
+			{
+				found[parallel][useHandles] += jobs[j].found;
+			}
+		}
+		
+		common->Printf( "%-20s %10.2f %10.2f\n", parallel ? "parallel" : "serial", times[0] * 0.001f / iterations, times[1] * 0.001f / iterations );
+	}
+	
+	if( found[0][0] != found[0][1] || found[0][0] != found[1][0] || found[0][0] != found[1][1] )
+	{
+		common->Warning( "spawn args lookups by key name and by handle found different keys" );
+	}
+	
+	common->SetRefreshOnPrint( false );
+}
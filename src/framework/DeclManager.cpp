@@ -157,6 +157,17 @@ private:
 	idDeclLocal* 				nextInFile;				// next decl in the decl file
 };
 
+// a single declaration found while scanning a decl file, the result
+// of a scan is what gets stored in the binary decl index
+struct declScanEntry_t
+{
+	declType_t					type;
+	idStr						name;
+	int							textOffset;				// offset in source file to decl text
+	int							textLength;				// length of decl text in source file
+	int							sourceLine;				// this is where the actual declaration token starts
+};
+
 class idDeclFile
 {
 public:
@@ -166,6 +177,20 @@ public:
 	void						Reload( bool force );
 	int							LoadAndParse();
 	
+	// LoadAndParse split in stages so several files can be scanned in parallel,
+	// only Scan() is allowed to run outside the main thread
+	bool						LoadText();
+	void						Scan( bool quiet );
+	void						ApplyScan();
+	void						FreeText();
+	
+	// binary index of the declarations in the file, skips Scan() for unchanged files
+	bool						LoadIndex();
+	void						WriteIndex() const;
+	
+private:
+	void						ScanWarning( int line, VERIFY_FORMAT_STRING const char* fmt, ... ) ID_INSTANCE_ATTRIBUTE_PRINTF( 2, 3 );
+	
 public:
 	idStr						fileName;
 	declType_t					defaultType;
@@ -176,6 +201,12 @@ public:
 	int							numLines;
 	
 	idDeclLocal* 				decls;
+	
+	// only valid while loading
+	char* 						buffer;
+	idList<declScanEntry_t, TAG_IDLIB_LIST_DECL>	scanEntries;
+	idStrList					scanWarnings;	// scan and lexer warnings, printed by ApplyScan, jobs can't print
+	bool						scanHadError;
 };
 
 class idDeclManagerLocal : public idDeclManager
@@ -258,6 +289,8 @@ private:
 	
 private:
 	static void					ListDecls_f( const idCmdArgs& args );
+	static void					BenchmarkDeclScan_f( const idCmdArgs& args );
+	static void					BenchmarkLexer_f( const idCmdArgs& args );
 	static void					ReloadDecls_f( const idCmdArgs& args );
 	static void					TouchDecl_f( const idCmdArgs& args );
 	// RB begin
@@ -266,6 +299,8 @@ private:
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
+idCVar decl_parallelScan( "decl_parallelScan", "1", CVAR_SYSTEM | CVAR_BOOL, "scan the decl files of a folder in parallel on the job threads" );
+idCVar decl_binaryIndex( "decl_binaryIndex", "1", CVAR_SYSTEM | CVAR_BOOL, "load/write a binary index of the decls in each decl file so unchanged files are not rescanned" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager* 		declManager = &declManagerLocal;
@@ -615,6 +650,8 @@ idDeclFile::idDeclFile( const char* fileName, declType_t defaultType )
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = nullptr;
+	this->buffer = nullptr;
+	this->scanHadError = false;
 }
 
 /*
@@ -631,6 +668,8 @@ idDeclFile::idDeclFile()
 	this->fileSize = 0;
 	this->numLines = 0;
 	this->decls = nullptr;
+	this->buffer = nullptr;
+	this->scanHadError = false;
 }
 
 /*
@@ -669,16 +708,31 @@ int c_savedMemory = 0;
 
 int idDeclFile::LoadAndParse()
 {
-	int			i, numTypes;
-	idLexer		src;
-	idToken		token;
-	int			startMarker;
-	char* 		buffer;
-	int			length, size;
-	int			sourceLine;
-	idStr		name;
-	idDeclLocal* newDecl;
-	bool		reparse;
+	if( !LoadText() )
+	{
+		return 0;
+	}
+	
+	if( !LoadIndex() )
+	{
+		Scan( false );
+		WriteIndex();
+	}
+	
+	ApplyScan();
+	FreeText();
+	
+	return checksum;
+}
+
+/*
+================
+idDeclFile::LoadText
+================
+*/
+bool idDeclFile::LoadText()
+{
+	int			length;
 	
 	// load the text
 	common->DPrintf( "...loading '%s'\n", fileName.c_str() );
@@ -686,27 +740,83 @@ int idDeclFile::LoadAndParse()
 	if( length == -1 )
 	{
 		common->FatalError( "couldn't load %s", fileName.c_str() );
-		return 0;
+		return false;
 	}
 	
-	if( !src.LoadMemory( buffer, length, fileName ) )
+	checksum = MD5_BlockChecksum( buffer, length );
+	
+	fileSize = length;
+	
+	return true;
+}
+
+/*
+================
+idDeclFile::FreeText
+================
+*/
+void idDeclFile::FreeText()
+{
+	if( buffer != nullptr )
 	{
-		common->Error( "Couldn't parse %s", fileName.c_str() );
 		Mem_Free( buffer );
-		return 0;
+		buffer = nullptr;
 	}
+	scanEntries.Clear();
+	scanWarnings.Clear();
+}
+
+/*
+================
+idDeclFile::ScanWarning
+================
+*/
+void idDeclFile::ScanWarning( int line, const char* fmt, ... )
+{
+	char		text[MAX_STRING_CHARS];
+	char		message[MAX_STRING_CHARS];
+	va_list		argptr;
 	
-	// mark all the defs that were from the last reload of this file
-	for( idDeclLocal* decl = decls; decl; decl = decl->nextInFile )
-	{
-		decl->redefinedInReload = false;
-	}
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
 	
-	src.SetFlags( DECL_LEXER_FLAGS );
+	// same format as idLexer::Warning
+	idStr::snPrintf( message, sizeof( message ), "file %s, line %d: %s", fileName.c_str(), line, text );
+	scanWarnings.Append( message );
+}
+
+/*
+================
+idDeclFile::Scan
+
+Identifies each individual declaration in the text loaded by LoadText().
+This only reads the text and the registered decl types, so it can run on a
+job thread. Printing isn't thread safe, so lexer warnings are collected in
+scanWarnings for ApplyScan to print. A quiet scan suppresses the lexer errors
+and only flags scanHadError, the caller can rescan to show them.
+================
+*/
+void idDeclFile::Scan( bool quiet )
+{
+	int			i, numTypes;
+	idLexer		src;
+	idToken		token;
+	int			startMarker;
+	int			sourceLine;
 	
-	checksum = MD5_BlockChecksum( buffer, length );
+	scanEntries.Clear();
+	scanWarnings.Clear();
+	scanHadError = false;
 	
-	fileSize = length;
+	if( !src.LoadMemory( buffer, fileSize, fileName ) )
+	{
+		ScanWarning( 0, "Couldn't parse %s", fileName.c_str() );
+		return;
+	}
+	
+	src.SetFlags( quiet ? ( DECL_LEXER_FLAGS | LEXFL_NOERRORS ) : DECL_LEXER_FLAGS );
+	src.SetWarningList( &scanWarnings );
 	
 	// scan through, identifying each individual declaration
 	while( 1 )
@@ -742,7 +852,7 @@ int idDeclFile::LoadAndParse()
 			{
 			
 				// if we ever see an open brace, we somehow missed the [type] <name> prefix
-				src.Warning( "Missing decl name" );
+				ScanWarning( src.GetLineNum(), "Missing decl name" );
 				src.SkipBracedSection( false );
 				continue;
 				
@@ -752,7 +862,7 @@ int idDeclFile::LoadAndParse()
 			
 				if( defaultType == DECL_MAX_TYPES )
 				{
-					src.Warning( "No type" );
+					ScanWarning( src.GetLineNum(), "No type" );
 					continue;
 				}
 				src.UnreadToken( &token );
@@ -764,14 +874,14 @@ int idDeclFile::LoadAndParse()
 		// now parse the name
 		if( !src.ReadToken( &token ) )
 		{
-			src.Warning( "Type without definition at end of file" );
+			ScanWarning( src.GetLineNum(), "Type without definition at end of file" );
 			break;
 		}
 		
 		if( !token.Icmp( "{" ) )
 		{
 			// if we ever see an open brace, we somehow missed the [type] <name> prefix
-			src.Warning( "Missing decl name" );
+			ScanWarning( src.GetLineNum(), "Missing decl name" );
 			src.SkipBracedSection( false );
 			continue;
 		}
@@ -783,35 +893,74 @@ int idDeclFile::LoadAndParse()
 			continue;
 		}
 		
-		name = token;
+		declScanEntry_t& entry = scanEntries.Alloc();
+		entry.type = identifiedType;
+		entry.name = token;
 		
 		// make sure there's a '{'
 		if( !src.ReadToken( &token ) )
 		{
-			src.Warning( "Type without definition at end of file" );
+			ScanWarning( src.GetLineNum(), "Type without definition at end of file" );
+			scanEntries.RemoveIndex( scanEntries.Num() - 1 );
 			break;
 		}
 		if( token != "{" )
 		{
-			src.Warning( "Expecting '{' but found '%s'", token.c_str() );
+			ScanWarning( src.GetLineNum(), "Expecting '{' but found '%s'", token.c_str() );
+			scanEntries.RemoveIndex( scanEntries.Num() - 1 );
 			continue;
 		}
 		src.UnreadToken( &token );
 		
 		// now take everything until a matched closing brace
 		src.SkipBracedSection();
-		size = src.GetFileOffset() - startMarker;
+		
+		entry.textOffset = startMarker;
+		entry.textLength = src.GetFileOffset() - startMarker;
+		entry.sourceLine = sourceLine;
+	}
+	
+	numLines = src.GetLineNum();
+	scanHadError = src.HadError();
+}
+
+/*
+================
+idDeclFile::ApplyScan
+
+Registers the declarations found by Scan() or LoadIndex(), must run on the main thread
+================
+*/
+void idDeclFile::ApplyScan()
+{
+	idDeclLocal* newDecl;
+	bool		reparse;
+	
+	for( int i = 0; i < scanWarnings.Num(); i++ )
+	{
+		common->Warning( "%s", scanWarnings[i].c_str() );
+	}
+	
+	// mark all the defs that were from the last reload of this file
+	for( idDeclLocal* decl = decls; decl; decl = decl->nextInFile )
+	{
+		decl->redefinedInReload = false;
+	}
+	
+	for( int i = 0; i < scanEntries.Num(); i++ )
+	{
+		const declScanEntry_t& entry = scanEntries[i];
 		
 		// look it up, possibly getting a newly created default decl
 		reparse = false;
-		newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, false );
+		newDecl = declManagerLocal.FindTypeWithoutParsing( entry.type, entry.name, false );
 		if( newDecl )
 		{
 			// update the existing copy
 			if( newDecl->sourceFile != this || newDecl->redefinedInReload )
 			{
-				src.Warning( "%s '%s' previously defined at %s:%i", declManagerLocal.GetDeclNameFromType( identifiedType ),
-							 name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
+				common->Warning( "file %s, line %d: %s '%s' previously defined at %s:%i", fileName.c_str(), entry.sourceLine,
+								 declManagerLocal.GetDeclNameFromType( entry.type ), entry.name.c_str(), newDecl->sourceFile->fileName.c_str(), newDecl->sourceLine );
 				continue;
 			}
 			if( newDecl->declState != DS_UNPARSED )
@@ -822,7 +971,7 @@ int idDeclFile::LoadAndParse()
 		else
 		{
 			// allow it to be created as a default, then add it to the per-file list
-			newDecl = declManagerLocal.FindTypeWithoutParsing( identifiedType, name, true );
+			newDecl = declManagerLocal.FindTypeWithoutParsing( entry.type, entry.name, true );
 			newDecl->nextInFile = this->decls;
 			this->decls = newDecl;
 		}
@@ -835,11 +984,11 @@ int idDeclFile::LoadAndParse()
 			newDecl->textSource = nullptr;
 		}
 		
-		newDecl->SetTextLocal( buffer + startMarker, size );
+		newDecl->SetTextLocal( buffer + entry.textOffset, entry.textLength );
 		newDecl->sourceFile = this;
-		newDecl->sourceTextOffset = startMarker;
-		newDecl->sourceTextLength = size;
-		newDecl->sourceLine = sourceLine;
+		newDecl->sourceTextOffset = entry.textOffset;
+		newDecl->sourceTextLength = entry.textLength;
+		newDecl->sourceLine = entry.sourceLine;
 		newDecl->declState = DS_UNPARSED;
 		
 		// if it is currently in use, reparse it immedaitely
@@ -849,10 +998,6 @@ int idDeclFile::LoadAndParse()
 		}
 	}
 	
-	numLines = src.GetLineNum();
-	
-	Mem_Free( buffer );
-	
 	// any defs that weren't redefinedInReload should now be defaulted
 	for( idDeclLocal* decl = decls ; decl ; decl = decl->nextInFile )
 	{
@@ -864,8 +1009,228 @@ int idDeclFile::LoadAndParse()
 			decl->sourceLine = decl->sourceFile->numLines;
 		}
 	}
+}
+
+/*
+================
+DeclTypesChecksum
+
+The scan depends on the registered type names, so the index is only valid
+for the same set of decl types
+================
+*/
+static unsigned int DeclTypesChecksum()
+{
+	idStr types;
+	for( int i = 0; i < declManagerLocal.GetNumDeclTypes(); i++ )
+	{
+		idDeclType* typeInfo = declManagerLocal.GetDeclType( i );
+		if( typeInfo != nullptr )
+		{
+			types += typeInfo->typeName;
+			types += " ";
+		}
+		else
+		{
+			types += "- ";
+		}
+	}
+	return MD5_BlockChecksum( types.c_str(), types.Length() );
+}
+
+/*
+================
+DeclIndexFileName
+================
+*/
+static void DeclIndexFileName( const char* fileName, idStrStatic< MAX_OSPATH >& indexFileName )
+{
+	indexFileName = "generated/decls/";
+	indexFileName.AppendPath( fileName );
+	indexFileName.Append( ".bdix" );
+}
+
+static const byte BDIX_VERSION = 101;
+static const unsigned int BDIX_MAGIC = ( 'B' << 24 ) | ( 'D' << 16 ) | ( 'I' << 8 ) | BDIX_VERSION;
+
+/*
+================
+idDeclFile::LoadIndex
+
+Fills in the scan results from the binary index if it was written
+for the exact same text, must be called after LoadText()
+================
+*/
+bool idDeclFile::LoadIndex()
+{
+	if( !decl_binaryIndex.GetBool() )
+	{
+		return false;
+	}
 	
-	return checksum;
+	idStrStatic< MAX_OSPATH > indexFileName;
+	DeclIndexFileName( fileName, indexFileName );
+	
+	idFileLocal file( fileSystem->OpenFileReadMemory( indexFileName ) );
+	if( file == nullptr )
+	{
+		return false;
+	}
+	
+	unsigned int magic = 0;
+	file->ReadBig( magic );
+	if( magic != BDIX_MAGIC )
+	{
+		return false;
+	}
+	
+	unsigned int loadedTypesChecksum = 0;
+	int loadedChecksum = 0;
+	int loadedFileSize = 0;
+	file->ReadBig( loadedTypesChecksum );
+	file->ReadBig( loadedChecksum );
+	file->ReadBig( loadedFileSize );
+	if( loadedTypesChecksum != DeclTypesChecksum() || loadedChecksum != checksum || loadedFileSize != fileSize )
+	{
+		return false;
+	}
+	
+	int numEntries = 0;
+	int numWarnings = 0;
+	file->ReadBig( numLines );
+	file->ReadBig( numEntries );
+	file->ReadBig( numWarnings );
+	
+	scanEntries.SetNum( numEntries );
+	for( int i = 0; i < numEntries; i++ )
+	{
+		declScanEntry_t& entry = scanEntries[i];
+		int type = 0;
+		file->ReadBig( type );
+		file->ReadString( entry.name );
+		file->ReadBig( entry.textOffset );
+		file->ReadBig( entry.textLength );
+		file->ReadBig( entry.sourceLine );
+		entry.type = ( declType_t ) type;
+		
+		if( type < 0 || type >= declManagerLocal.GetNumDeclTypes() || entry.textOffset < 0 || entry.textLength < 0 || entry.textOffset + entry.textLength > fileSize )
+		{
+			scanEntries.Clear();
+			return false;
+		}
+	}
+	
+	scanWarnings.SetNum( numWarnings );
+	for( int i = 0; i < numWarnings; i++ )
+	{
+		file->ReadString( scanWarnings[i] );
+	}
+	
+	return true;
+}
+
+/*
+================
+idDeclFile::WriteIndex
+================
+*/
+void idDeclFile::WriteIndex() const
+{
+	if( !decl_binaryIndex.GetBool() || fileSystem->UsingResourceFiles() )
+	{
+		return;
+	}
+	
+	// a quiet scan that hit errors will be redone, don't store it
+	if( scanHadError )
+	{
+		return;
+	}
+	
+	idStrStatic< MAX_OSPATH > indexFileName;
+	DeclIndexFileName( fileName, indexFileName );
+	
+	idFileLocal file( fileSystem->OpenFileWrite( indexFileName, "fs_basepath" ) );
+	if( file == nullptr )
+	{
+		return;
+	}
+	
+	file->WriteBig( BDIX_MAGIC );
+	file->WriteBig( DeclTypesChecksum() );
+	file->WriteBig( checksum );
+	file->WriteBig( fileSize );
+	file->WriteBig( numLines );
+	file->WriteBig( scanEntries.Num() );
+	file->WriteBig( scanWarnings.Num() );
+	
+	for( int i = 0; i < scanEntries.Num(); i++ )
+	{
+		const declScanEntry_t& entry = scanEntries[i];
+		file->WriteBig( ( int ) entry.type );
+		file->WriteString( entry.name );
+		file->WriteBig( entry.textOffset );
+		file->WriteBig( entry.textLength );
+		file->WriteBig( entry.sourceLine );
+	}
+	
+	for( int i = 0; i < scanWarnings.Num(); i++ )
+	{
+		file->WriteString( scanWarnings[i] );
+	}
+}
+
+/*
+================
+DeclFileScanJob
+================
+*/
+static void DeclFileScanJob( idDeclFile* declFile )
+{
+	declFile->Scan( true );
+}
+
+REGISTER_PARALLEL_JOB( DeclFileScanJob, "DeclFileScanJob" );
+
+/*
+================
+ScanDeclFiles
+
+Scans the text of each file, spread over the job threads if parallel is set
+================
+*/
+static void ScanDeclFiles( idList<idDeclFile*>& files, bool parallel )
+{
+	if( !parallel || files.Num() <= 1 )
+	{
+		for( int i = 0; i < files.Num(); i++ )
+		{
+			files[i]->Scan( false );
+		}
+		return;
+	}
+	
+	// the default punctuation table is shared by all lexers and lazily built,
+	// make sure that happens on this thread before the jobs start
+	idLexer lexer;
+	
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, files.Num(), 0, nullptr );
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		jobList->AddJob( ( jobRun_t )DeclFileScanJob, files[i] );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+	
+	// rescan the files that had errors so the lexer can print them
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		if( files[i]->scanHadError )
+		{
+			files[i]->Scan( false );
+		}
+	}
 }
 
 /*
@@ -920,6 +1285,8 @@ void idDeclManagerLocal::Init()
 	cmdSystem->AddCommand( "listDecls", ListDecls_f, CMD_FL_SYSTEM, "lists all decls" );
 	
 	cmdSystem->AddCommand( "reloadDecls", ReloadDecls_f, CMD_FL_SYSTEM, "reloads decls" );
+	cmdSystem->AddCommand( "benchmarkDeclScan", BenchmarkDeclScan_f, CMD_FL_SYSTEM, "compares scanning all decl files against loading their binary index" );
+	cmdSystem->AddCommand( "benchmarkLexer", BenchmarkLexer_f, CMD_FL_SYSTEM, "measures the lexer throughput over all decl files and maps" );
 	cmdSystem->AddCommand( "touch", TouchDecl_f, CMD_FL_SYSTEM, "touches a decl" );
 	
 	cmdSystem->AddCommand( "listTables", idListDecls_f<DECL_TABLE>, CMD_FL_SYSTEM, "lists tables", idCmdSystem::ArgCompletion_String<listDeclStrings> );
@@ -1100,6 +1467,8 @@ void idDeclManagerLocal::RegisterDeclFolder( const char* folder, const char* ext
 	idDeclFolder* declFolder;
 	idFileList* fileList;
 	idDeclFile* df;
+	idList<idDeclFile*> folderFiles;
+	idList<idDeclFile*> scanFiles;
 	
 	// check whether this folder / extension combination already exists
 	for( i = 0; i < declFolders.Num(); i++ )
@@ -1147,10 +1516,47 @@ void idDeclManagerLocal::RegisterDeclFolder( const char* folder, const char* ext
 			df = new( TAG_DECL ) idDeclFile( fileName, defaultType );
 			loadedFiles.Append( df );
 		}
-		df->LoadAndParse();
+		folderFiles.Append( df );
 	}
 	
 	fileSystem->FreeFileList( fileList );
+	
+	// the file system isn't thread safe, so all text is read here and only
+	// the files without an up to date binary index are scanned on the job threads
+	uint64 startTime = Sys_Microseconds();
+	
+	for( i = 0; i < folderFiles.Num(); i++ )
+	{
+		if( folderFiles[i]->LoadText() && !folderFiles[i]->LoadIndex() )
+		{
+			scanFiles.Append( folderFiles[i] );
+		}
+	}
+	
+	uint64 readTime = Sys_Microseconds();
+	
+	ScanDeclFiles( scanFiles, decl_parallelScan.GetBool() );
+	for( i = 0; i < scanFiles.Num(); i++ )
+	{
+		scanFiles[i]->WriteIndex();
+	}
+	
+	uint64 scanTime = Sys_Microseconds();
+	
+	// register the decls in file order so redefinitions resolve like a serial load
+	int numDecls = 0;
+	for( i = 0; i < folderFiles.Num(); i++ )
+	{
+		numDecls += folderFiles[i]->scanEntries.Num();
+		folderFiles[i]->ApplyScan();
+		folderFiles[i]->FreeText();
+	}
+	
+	uint64 endTime = Sys_Microseconds();
+	
+	common->Printf( "%5i decls from %4i %s files (%i scanned, %i indexed): read %.1f ms, scan %.1f ms, register %.1f ms\n",
+					numDecls, folderFiles.Num(), declFolder->extension.c_str(), scanFiles.Num(), folderFiles.Num() - scanFiles.Num(),
+					( readTime - startTime ) * 0.001f, ( scanTime - readTime ) * 0.001f, ( endTime - scanTime ) * 0.001f );
 }
 
 /*
@@ -1908,6 +2314,175 @@ void idDeclManagerLocal::ReloadDecls_f( const idCmdArgs& args )
 	declManagerLocal.Reload( force );
 }
 
+/*
+===================
+idDeclManagerLocal::BenchmarkDeclScan_f
+
+Compares the cold startup path, scanning every decl file serially and on the
+job threads, against the warm path of loading the binary decl index
+===================
+*/
+void idDeclManagerLocal::BenchmarkDeclScan_f( const idCmdArgs& args )
+{
+	idList<idDeclFile*>& files = declManagerLocal.loadedFiles;
+	idList<idDeclFile*> loaded;
+	
+	// LoadText updates the file state that Reload relies on, restore it afterwards
+	idList<ID_TIME_T> timestamps;
+	idList<int> checksums;
+	idList<int> fileSizes;
+	idList<int> numLines;
+	
+	uint64 startTime = Sys_Microseconds();
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		timestamps.Append( files[i]->timestamp );
+		checksums.Append( files[i]->checksum );
+		fileSizes.Append( files[i]->fileSize );
+		numLines.Append( files[i]->numLines );
+		if( files[i]->LoadText() )
+		{
+			loaded.Append( files[i] );
+		}
+	}
+	uint64 readTime = Sys_Microseconds() - startTime;
+	
+	startTime = Sys_Microseconds();
+	ScanDeclFiles( loaded, false );
+	uint64 serialTime = Sys_Microseconds() - startTime;
+	
+	int numDecls = 0;
+	for( int i = 0; i < loaded.Num(); i++ )
+	{
+		numDecls += loaded[i]->scanEntries.Num();
+	}
+	
+	startTime = Sys_Microseconds();
+	ScanDeclFiles( loaded, true );
+	uint64 parallelTime = Sys_Microseconds() - startTime;
+	
+	int numIndexed = 0;
+	startTime = Sys_Microseconds();
+	for( int i = 0; i < loaded.Num(); i++ )
+	{
+		if( loaded[i]->LoadIndex() )
+		{
+			numIndexed++;
+		}
+	}
+	uint64 indexTime = Sys_Microseconds() - startTime;
+	
+	for( int i = 0; i < files.Num(); i++ )
+	{
+		files[i]->FreeText();
+		files[i]->timestamp = timestamps[i];
+		files[i]->checksum = checksums[i];
+		files[i]->fileSize = fileSizes[i];
+		files[i]->numLines = numLines[i];
+	}
+	
+	common->Printf( "%i decls in %i files, read %.1f ms\n", numDecls, loaded.Num(), readTime * 0.001f );
+	common->Printf( "cold, serial scan:   %8.1f ms\n", serialTime * 0.001f );
+	common->Printf( "cold, parallel scan: %8.1f ms (%i job threads)\n", parallelTime * 0.001f, parallelJobManager->GetNumProcessingUnits() );
+	common->Printf( "warm, binary index:  %8.1f ms (%i of %i files indexed)\n", indexTime * 0.001f, numIndexed, loaded.Num() );
+}
+
+/*
+===================
+idDeclManagerLocal::BenchmarkLexer_f
+
+Tokenizes all decl files and maps byte by byte, with the vectorised scanners, and
+with the scanners without copying the tokens.
+===================
+*/
+void idDeclManagerLocal::BenchmarkLexer_f( const idCmdArgs& args )
+{
+	struct lexerSource_t
+	{
+		char*	buffer;
+		int		length;
+		int		flags;
+	};
+	idList<lexerSource_t> sources;
+	int totalLength = 0;
+	
+	const int mapFlags = LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES;	// as idMapFile::Parse
+	
+	for( int i = 0; i <= declManagerLocal.declFolders.Num(); i++ )
+	{
+		idFileList* fileList;
+		idStr folder;
+		int flags;
+		if( i < declManagerLocal.declFolders.Num() )
+		{
+			folder = declManagerLocal.declFolders[i]->folder;
+			fileList = fileSystem->ListFiles( folder, declManagerLocal.declFolders[i]->extension, true );
+			flags = DECL_LEXER_FLAGS;
+		}
+		else
+		{
+			folder = "maps";
+			fileList = fileSystem->ListFilesTree( folder, ".map", true );
+			flags = mapFlags;
+		}
+		
+		for( int j = 0; j < fileList->GetNumFiles(); j++ )
+		{
+			// ListFilesTree returns full relative paths
+			idStr fileName = ( i < declManagerLocal.declFolders.Num() ) ? folder + "/" + fileList->GetFile( j ) : idStr( fileList->GetFile( j ) );
+			lexerSource_t source;
+			source.length = fileSystem->ReadFile( fileName, ( void** )&source.buffer );
+			source.flags = flags | LEXFL_NOERRORS | LEXFL_NOWARNINGS | LEXFL_NOFATALERRORS;
+			if( source.length > 0 )
+			{
+				sources.Append( source );
+				totalLength += source.length;
+			}
+		}
+		fileSystem->FreeFileList( fileList );
+	}
+	
+	common->Printf( "%i files, %.1f MB\n", sources.Num(), totalLength * 0.000001f );
+	
+	const char* modes[] = { "byte by byte", "vectorised", "vectorised, views" };
+	for( int mode = 0; mode < 3; mode++ )
+	{
+		idLexer::SetVectorScan( mode != 0 );
+		
+		int numTokens = 0;
+		uint64 startTime = Sys_Microseconds();
+		for( int i = 0; i < sources.Num(); i++ )
+		{
+			idLexer src( sources[i].buffer, sources[i].length, "benchmarkLexer", sources[i].flags );
+			if( mode < 2 )
+			{
+				idToken token;
+				while( src.ReadToken( &token ) )
+				{
+					numTokens++;
+				}
+			}
+			else
+			{
+				tokenView_t token;
+				while( src.ReadTokenView( &token ) )
+				{
+					numTokens++;
+				}
+			}
+		}
+		uint64 time = Max( Sys_Microseconds() - startTime, ( uint64 )1 );
+		
+		common->Printf( "%-18s %8.1f ms %8.1f MB/s %9i tokens\n", modes[mode], time * 0.001f, totalLength / ( float )time, numTokens );
+	}
+	idLexer::SetVectorScan( true );
+	
+	for( int i = 0; i < sources.Num(); i++ )
+	{
+		fileSystem->FreeFile( sources[i].buffer );
+	}
+}
+
 /*
 ===================
 idDeclManagerLocal::TouchDecl_f
@@ -433,6 +433,9 @@ void idCommonLocal::Frame()
 		
 		eventLoop->RunEventLoop();
 		
+		// hand a finished background save over to the session
+		UpdateBackgroundSave();
+		
 		// Activate the shell if it's been requested
 		if( showShellRequested && game )
 		{
@@ -491,6 +494,8 @@ void idCommonLocal::Frame()
 		// this should exit right after vsync, with the GPU idle and ready to draw
 		// This may block if the GPU isn't finished renderng the previous frame.
 		frameTiming.startSyncTime = Sys_Microseconds();
+		frameTiming.soundTime = 0;
+		frameTiming.networkTime = 0;
 		const emptyCommand_t* renderCommands = nullptr;
 		if( com_smp.GetInteger() > 0 )
 		{
@@ -628,9 +633,11 @@ void idCommonLocal::Frame()
 		//--------------------------------------------
 		
 		// Update session and syncronize to the new session state after sleeping
+		uint64 networkStartTime = Sys_Microseconds();
 		session->UpdateSignInManager();
 		session->Pump();
 		session->ProcessSnapAckQueue();
+		frameTiming.networkTime += Sys_Microseconds() - networkStartTime;
 		
 		if( session->GetState() == idSession::LOADING )
 		{
@@ -648,6 +655,7 @@ void idCommonLocal::Frame()
 			return;
 		}
 		
+		networkStartTime = Sys_Microseconds();
 		if( mapSpawned && !pauseGame )
 		{
 			if( IsClient() )
@@ -657,6 +665,7 @@ void idCommonLocal::Frame()
 		}
 		
 		ExecuteReliableMessages();
+		frameTiming.networkTime += Sys_Microseconds() - networkStartTime;
 		
 		// send frame and mouse events to active guis
 		GuiFrameEvents();
@@ -742,13 +751,16 @@ void idCommonLocal::Frame()
 		
 		// Send local usermds to the server.
 		// This happens after the game frame has run so that prediction data is up to date.
+		networkStartTime = Sys_Microseconds();
 		SendUsercmds( Game()->GetLocalClientNum() );
 		
 		// Now that we have an updated game frame, we can send out new snapshots to our clients
 		session->Pump(); // Pump to get updated usercmds to relay
 		SendSnapshots();
+		frameTiming.networkTime += Sys_Microseconds() - networkStartTime;
 		
 		// Render the sound system using the latest commands from the game thread
+		uint64 soundStartTime = Sys_Microseconds();
 		if( pauseGame )
 		{
 			soundWorld->Pause();
@@ -760,6 +772,7 @@ void idCommonLocal::Frame()
 			soundSystem->SetPlayingSoundWorld( soundWorld );
 		}
 		soundSystem->Render();
+		frameTiming.soundTime = Sys_Microseconds() - soundStartTime;
 		
 		// process the game return for map changes, etc
 		ProcessGameReturn( ret );
@@ -799,6 +812,11 @@ void idCommonLocal::Frame()
 		
 		mainFrameTiming = frameTiming;
 		
+		if( benchmarkDemo && readDemo && timeDemo )
+		{
+			RecordBenchmarkFrame();
+		}
+		
 		session->GetSaveGameManager().Pump();
 	}
 	catch( idException& )
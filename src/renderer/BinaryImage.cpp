@@ -64,14 +64,179 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "Use high quality (slow) compression" );
 idCVar r_useHighQualitySky( "r_useHighQualitySky", "0", CVAR_BOOL | CVAR_ARCHIVE, "Use high quality skyboxes" );
+idCVar image_parallelCompression( "image_parallelCompression", "1", CVAR_BOOL, "Compress the DXT mip levels of an image with jobs" );
+
+/*
+========================
+dxtCompressJobParms_t
+
+DXT blocks are written in rows of 4x4 texels, so a strip of rows that is a multiple
+of 4 high compresses independently into a contiguous range of the output.
+========================
+*/
+struct dxtCompressJobParms_t
+{
+	const byte*			inBuf;
+	byte*				outBuf;
+	int					width;
+	int					height;
+	textureFormat_t		textureFormat;
+	textureColor_t		colorFormat;
+	bool				highQuality;
+};
+
+static const int DXT_TEXELS_PER_JOB = 32 * 1024;
+
+idBinaryImage::binarizeStats_t idBinaryImage::binarizeStats;
+
+/*
+========================
+CompressDXTJob
+========================
+*/
+static void CompressDXTJob( const dxtCompressJobParms_t* parms )
+{
+	idDxtEncoder dxt;
+	if( parms->textureFormat == FMT_DXT1 )
+	{
+		if( parms->highQuality )
+		{
+			dxt.CompressImageDXT1HQ( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+		else
+		{
+			dxt.CompressImageDXT1Fast( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+	}
+	else if( parms->colorFormat == CFM_NORMAL_DXT5 )
+	{
+		if( parms->highQuality )
+		{
+			dxt.CompressNormalMapDXT5HQ( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+		else
+		{
+			dxt.CompressNormalMapDXT5Fast( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+	}
+	else if( parms->colorFormat == CFM_YCOCG_DXT5 )
+	{
+		if( parms->highQuality )
+		{
+			dxt.CompressYCoCgDXT5HQ( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+		else
+		{
+			dxt.CompressYCoCgDXT5Fast( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+	}
+	else
+	{
+		if( parms->highQuality )
+		{
+			dxt.CompressImageDXT5HQ( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+		else
+		{
+			dxt.CompressImageDXT5Fast( parms->inBuf, parms->outBuf, parms->width, parms->height );
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( CompressDXTJob, "CompressDXTJob" );
+
+/*
+========================
+DXTCompressorName
+========================
+*/
+static const char* DXTCompressorName( textureFormat_t textureFormat, textureColor_t colorFormat, bool highQuality )
+{
+	if( textureFormat == FMT_DXT1 )
+	{
+		return highQuality ? "DXT1HQ" : "DXT1Fast";
+	}
+	if( colorFormat == CFM_NORMAL_DXT5 )
+	{
+		return highQuality ? "NormalMapDXT5HQ" : "NormalMapDXT5Fast";
+	}
+	if( colorFormat == CFM_YCOCG_DXT5 )
+	{
+		return highQuality ? "YCoCgDXT5HQ" : "YCoCgDXT5Fast";
+	}
+	return highQuality ? "DXT5HQ" : "DXT5Fast";
+}
+
+/*
+========================
+AddDXTCompressJobs
+
+Splits a padded level into strips of whole block rows.
+========================
+*/
+static void AddDXTCompressJobs( idList< dxtCompressJobParms_t >& jobs, const byte* pic, byte* outBuf, int width, int height, textureFormat_t textureFormat, textureColor_t colorFormat, bool highQuality )
+{
+	const int blockSize = ( textureFormat == FMT_DXT1 ) ? 8 : 16;
+	const int rowsPerJob = Max( 4, ( DXT_TEXELS_PER_JOB / width ) & ~3 );
+	
+	for( int y = 0; y < height; y += rowsPerJob )
+	{
+		dxtCompressJobParms_t& job = jobs.Alloc();
+		job.inBuf = pic + y * width * 4;
+		job.outBuf = outBuf + ( y / 4 ) * ( width / 4 ) * blockSize;
+		job.width = width;
+		job.height = Min( rowsPerJob, height - y );
+		job.textureFormat = textureFormat;
+		job.colorFormat = colorFormat;
+		job.highQuality = highQuality;
+	}
+}
+
+/*
+========================
+RunDXTCompressJobs
+========================
+*/
+static void RunDXTCompressJobs( idList< dxtCompressJobParms_t >& jobs )
+{
+	if( !image_parallelCompression.GetBool() || jobs.Num() == 1 )
+	{
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			CompressDXTJob( &jobs[i] );
+		}
+		return;
+	}
+	
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobs.Num(), 0, nullptr );
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		jobList->AddJob( ( jobRun_t )CompressDXTJob, &jobs[i] );
+	}
+	jobList->Submit( nullptr, JOBLIST_PARALLELISM_MAX_CORES );
+	
+	// the jobs advance the progress counter, keep the pacifier drawing from this thread
+	while( !jobList->TryWait() )
+	{
+		commonLocal.LoadPacifierBinarizeProgressIncrement( 0 );
+		Sys_Sleep( 1 );
+	}
+	
+	parallelJobManager->FreeJobList( jobList );
+}
 
 /*
 ========================
 idBinaryImage::Load2DFromMemory
+
+All mip levels are generated first and the DXT compression of every level is then
+split into jobs, so the small levels do not leave the job threads idle.
 ========================
 */
 void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips )
 {
+	const uint64 startTime = Sys_Microseconds();
+	
 	fileData.textureType = TT_2D;
 	fileData.format = textureFormat;
 	fileData.colorFormat = colorFormat;
@@ -113,6 +278,21 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		}
 	}
 	
+	const bool isDXT = ( textureFormat == FMT_DXT5 || textureFormat == FMT_DXT1 );
+	const bool highQuality = image_highQualityCompression.GetBool();
+	if( textureFormat == FMT_DXT5 && colorFormat != CFM_NORMAL_DXT5 && colorFormat != CFM_YCOCG_DXT5 )
+	{
+		fileData.colorFormat = colorFormat = CFM_DEFAULT;
+	}
+	if( isDXT )
+	{
+		commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - %s", width, height, DXTCompressorName( textureFormat, colorFormat, highQuality ) ) );
+	}
+	
+	// the source of every DXT level has to stay around until the jobs are done
+	idList< dxtCompressJobParms_t > dxtJobs;
+	idList< byte* > dxtPics;
+	
 	int	scaledWidth = width;
 	int scaledHeight = height;
 	images.SetNum( numLevels );
@@ -122,104 +302,39 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		
 		commonLocal.LoadPacifierBinarizeMiplevel( level + 1, numLevels );
 		
-		// Images that are going to be DXT compressed and aren't multiples of 4 need to be
-		// padded out before compressing.
-		byte* dxtPic = pic;
-		int	dxtWidth = 0;
-		int	dxtHeight = 0;
-		if( textureFormat == FMT_DXT5 || textureFormat == FMT_DXT1 )
-		{
-			if( ( scaledWidth & 3 ) || ( scaledHeight & 3 ) )
-			{
-				dxtWidth = ( scaledWidth + 3 ) & ~3;
-				dxtHeight = ( scaledHeight + 3 ) & ~3;
-				dxtPic = ( byte* )Mem_ClearedAlloc( dxtWidth * 4 * dxtHeight, TAG_IMAGE );
-				for( int i = 0; i < scaledHeight; i++ )
-				{
-					memcpy( dxtPic + i * dxtWidth * 4, pic + i * scaledWidth * 4, scaledWidth * 4 );
-				}
-			}
-			else
-			{
-				dxtPic = pic;
-				dxtWidth = scaledWidth;
-				dxtHeight = scaledHeight;
-			}
-		}
-		
 		img.level = level;
 		img.destZ = 0;
 		img.width = scaledWidth;
 		img.height = scaledHeight;
 		
+		bool keepPic = false;
+		
 		// compress data or convert floats as necessary
-		if( textureFormat == FMT_DXT1 )
+		if( isDXT )
 		{
-			idDxtEncoder dxt;
-			img.Alloc( dxtWidth * dxtHeight / 2 );
-			if( image_highQualityCompression.GetBool() )
-			{
-				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1HQ", width, height ) );
-				
-				dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-			}
-			else
-			{
-				commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT1Fast", width, height ) );
-				
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-			}
-		}
-		else if( textureFormat == FMT_DXT5 )
-		{
-			idDxtEncoder dxt;
-			img.Alloc( dxtWidth * dxtHeight );
-			if( colorFormat == CFM_NORMAL_DXT5 )
-			{
-				if( image_highQualityCompression.GetBool() )
-				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5HQ", width, height ) );
-					
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
-				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - NormalMapDXT5Fast", width, height ) );
-					
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-			}
-			else if( colorFormat == CFM_YCOCG_DXT5 )
+			// Images that are going to be DXT compressed and aren't multiples of 4 need to be
+			// padded out before compressing.
+			byte* dxtPic = pic;
+			int	dxtWidth = scaledWidth;
+			int	dxtHeight = scaledHeight;
+			if( ( scaledWidth & 3 ) || ( scaledHeight & 3 ) )
 			{
-				if( image_highQualityCompression.GetBool() )
-				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5HQ", width, height ) );
-					
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
+				dxtWidth = ( scaledWidth + 3 ) & ~3;
+				dxtHeight = ( scaledHeight + 3 ) & ~3;
+				dxtPic = ( byte* )Mem_ClearedAlloc( dxtWidth * 4 * dxtHeight, TAG_IMAGE );
+				for( int i = 0; i < scaledHeight; i++ )
 				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - YCoCgDXT5Fast", width, height ) );
-					
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
+					memcpy( dxtPic + i * dxtWidth * 4, pic + i * scaledWidth * 4, scaledWidth * 4 );
 				}
 			}
 			else
 			{
-				fileData.colorFormat = colorFormat = CFM_DEFAULT;
-				if( image_highQualityCompression.GetBool() )
-				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5HQ", width, height ) );
-					
-					dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
-				{
-					commonLocal.LoadPacifierBinarizeInfo( va( "(%d x %d) - DXT5Fast", width, height ) );
-					
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
+				keepPic = true;
 			}
+			dxtPics.Append( dxtPic );
+			
+			img.Alloc( ( textureFormat == FMT_DXT1 ) ? ( dxtWidth * dxtHeight / 2 ) : ( dxtWidth * dxtHeight ) );
+			AddDXTCompressJobs( dxtJobs, dxtPic, img.data, dxtWidth, dxtHeight, textureFormat, colorFormat, highQuality );
 		}
 		else if( textureFormat == FMT_LUM8 || textureFormat == FMT_INT8 )
 		{
@@ -269,13 +384,6 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 			}
 		}
 		
-		// if we had to pad to quads, free the padded version
-		if( pic != dxtPic )
-		{
-			Mem_Free( dxtPic );
-			dxtPic = nullptr;
-		}
-		
 		// downsample for the next level
 		byte* shrunk = nullptr;
 		if( gammaMips )
@@ -286,7 +394,10 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		{
 			shrunk = R_MipMap( pic, scaledWidth, scaledHeight );
 		}
-		Mem_Free( pic );
+		if( !keepPic )
+		{
+			Mem_Free( pic );
+		}
 		pic = shrunk;
 		
 		scaledWidth = Max( 1, scaledWidth >> 1 );
@@ -294,6 +405,19 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 	}
 	
 	Mem_Free( pic );
+	
+	if( dxtJobs.Num() > 0 )
+	{
+		RunDXTCompressJobs( dxtJobs );
+	}
+	for( int i = 0; i < dxtPics.Num(); i++ )
+	{
+		Mem_Free( dxtPics[i] );
+	}
+	
+	binarizeStats.numImages++;
+	binarizeStats.numTexels += ( int64 )width * height;
+	binarizeStats.microseconds += Sys_Microseconds() - startTime;
 }
 
 /*
@@ -1,14 +1,37 @@
 #include <iostream>
 #include <iomanip>
 #include <vector>
+#include <memory>
+#include <map>
+#include <set>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 
 #include <components/bsa/bsa_file.hpp>
+#include <components/bsa/compressedbsafile.hpp>
+
+#include <extern/BSAOpt/hash.hpp>
 
-#define BSATOOL_VERSION 1.1
+#define BSATOOL_VERSION 1.2
 
 // Create local aliases for brevity
 namespace bpo = boost::program_options;
@@ -20,9 +43,13 @@ struct Arguments
     std::string filename;
     std::string extractfile;
     std::string outdir;
+    std::string sourcedir;
+    std::string tracefile;
 
     bool longformat;
     bool fullpath;
+    bool compress;
+    unsigned int threads;
 };
 
 void replaceAll(std::string& str, const std::string& needle, const std::string& substitute)
@@ -45,6 +72,10 @@ bool parseOptions (int argc, char** argv, Arguments &info)
             "      Extract a file from the input archive.\n\n"
             "  bsatool extractall archivefile [output_directory]\n"
             "      Extract all files from the input archive.\n\n"
+            "  bsatool pack [-c] [-t tracefile] [-j threads] source_directory archivefile\n"
+            "      Create a TES4 archive from all files below the source directory.\n"
+            "      Files listed in the trace (one path per line, in load order) are\n"
+            "      stored first and in that order, the others by hash.\n\n"
             "Allowed options");
 
     desc.add_options()
@@ -53,6 +84,10 @@ bool parseOptions (int argc, char** argv, Arguments &info)
         ("long,l", "Include extra information in archive listing.")
         ("full-path,f", "Create directory hierarchy on file extraction "
          "(always true for extractall).")
+        ("compress,c", "Compress the files of a packed archive.")
+        ("trace,t", bpo::value<std::string>(), "File access trace to order the packed data by.")
+        ("threads,j", bpo::value<unsigned int>()->default_value(0), "Number of packing threads "
+         "(0 uses all cores).")
         ;
 
     // input-file is hidden and used as a positional argument
@@ -104,7 +139,7 @@ bool parseOptions (int argc, char** argv, Arguments &info)
     }
 
     info.mode = variables["mode"].as<std::string>();
-    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall"))
+    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall" || info.mode == "pack"))
     {
         std::cout << std::endl << "ERROR: invalid mode \"" << info.mode << "\"\n\n"
             << desc << std::endl;
@@ -122,7 +157,18 @@ bool parseOptions (int argc, char** argv, Arguments &info)
     // Default output to the working directory
     info.outdir = ".";
 
-    if (info.mode == "extract")
+    if (info.mode == "pack")
+    {
+        if (variables["input-file"].as< std::vector<std::string> >().size() < 2)
+        {
+            std::cout << "\nERROR: output archive unspecified\n\n"
+                << desc << std::endl;
+            return false;
+        }
+        info.sourcedir = info.filename;
+        info.filename = variables["input-file"].as< std::vector<std::string> >()[1];
+    }
+    else if (info.mode == "extract")
     {
         if (variables["input-file"].as< std::vector<std::string> >().size() < 2)
         {
@@ -140,6 +186,11 @@ bool parseOptions (int argc, char** argv, Arguments &info)
 
     info.longformat = variables.count("long") != 0;
     info.fullpath = variables.count("full-path") != 0;
+    info.compress = variables.count("compress") != 0;
+    info.threads = variables["threads"].as<unsigned int>();
+
+    if (variables.count("trace"))
+        info.tracefile = variables["trace"].as<std::string>();
 
     return true;
 }
@@ -147,6 +198,7 @@ bool parseOptions (int argc, char** argv, Arguments &info)
 int list(Bsa::BSAFile& bsa, Arguments& info);
 int extract(Bsa::BSAFile& bsa, Arguments& info);
 int extractAll(Bsa::BSAFile& bsa, Arguments& info);
+int pack(Arguments& info);
 
 int main(int argc, char** argv)
 {
@@ -156,16 +208,23 @@ int main(int argc, char** argv)
         if(!parseOptions (argc, argv, info))
             return 1;
 
+        if (info.mode == "pack")
+            return pack(info);
+
         // Open file
-        Bsa::BSAFile bsa;
-        bsa.open(info.filename);
+        std::unique_ptr<Bsa::BSAFile> bsa;
+        if (Bsa::CompressedBSAFile::detectVersion(info.filename) == Bsa::BSAVER_COMPRESSED)
+            bsa.reset(new Bsa::CompressedBSAFile());
+        else
+            bsa.reset(new Bsa::BSAFile());
+        bsa->open(info.filename);
 
         if (info.mode == "list")
-            return list(bsa, info);
+            return list(*bsa, info);
         else if (info.mode == "extract")
-            return extract(bsa, info);
+            return extract(*bsa, info);
         else if (info.mode == "extractall")
-            return extractAll(bsa, info);
+            return extractAll(*bsa, info);
         else
         {
             std::cout << "Unsupported mode. That is not supposed to happen." << std::endl;
@@ -289,3 +348,451 @@ int extractAll(Bsa::BSAFile& bsa, Arguments& info)
 
     return 0;
 }
+
+namespace
+{
+    const std::uint32_t sCompressedFlag = 0x40000000;
+
+    struct PackedFile
+    {
+        bfs::path source;
+        std::string folder;     // lower case, backslash separated
+        std::string name;       // lower case file name
+        std::uint64_t hash;
+
+        std::uint32_t rawSize;
+        std::uint32_t storedSize;
+        std::uint32_t offset;
+        std::uint32_t hashOrderOffset;
+        bool compressed;
+        bool ready;
+
+        std::vector<char> data; // released once written
+    };
+
+    struct PackedFolder
+    {
+        std::string name;
+        std::vector<PackedFile*> files; // sorted by hash
+    };
+
+    // Files are handed to the threads and written in data order; the threads may only
+    // run a few files ahead of the writer since pending files are kept in memory
+    struct PackQueue
+    {
+        std::vector<PackedFile*> order;
+        std::size_t next;
+        std::size_t written;
+        std::size_t window;
+        bool compress;
+        std::string error;
+
+        std::mutex mutex;
+        std::condition_variable fileReady;
+        std::condition_variable fileWritten;
+    };
+
+    struct ReadPattern
+    {
+        std::size_t reads;
+        std::size_t seeks;
+        std::uint64_t span;
+    };
+
+    void writeUInt32(std::ostream& out, std::uint32_t value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void writeUInt64(std::ostream& out, std::uint64_t value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::uint64_t getFileHash(const std::string& name)
+    {
+        bfs::path p(name);
+        return GenOBHashPair(p.stem().string(), p.extension().string());
+    }
+
+    void packFile(PackedFile& file, bool compress)
+    {
+        bfs::ifstream in(file.source, std::ios::binary);
+        if (!in)
+            throw std::runtime_error("can not open " + file.source.string());
+
+        std::vector<char> raw(static_cast<std::size_t>(bfs::file_size(file.source)));
+        if (!raw.empty() && !in.read(&raw[0], raw.size()))
+            throw std::runtime_error("can not read " + file.source.string());
+
+        file.rawSize = static_cast<std::uint32_t>(raw.size());
+        file.compressed = false;
+
+        if (compress && !raw.empty())
+        {
+            // the original size followed by the zlib stream, as CompressedBSAFile reads it
+            std::vector<char> packed(sizeof(std::uint32_t));
+            std::memcpy(&packed[0], &file.rawSize, sizeof(file.rawSize));
+
+            boost::iostreams::filtering_streambuf<boost::iostreams::output> outputStreamBuf;
+            outputStreamBuf.push(boost::iostreams::zlib_compressor());
+            outputStreamBuf.push(boost::iostreams::back_inserter(packed));
+            boost::iostreams::copy(boost::iostreams::array_source(&raw[0], raw.size()), outputStreamBuf);
+
+            // files that do not shrink are stored as they are
+            if (packed.size() < raw.size())
+            {
+                file.data.swap(packed);
+                file.compressed = true;
+            }
+        }
+
+        if (!file.compressed)
+            file.data.swap(raw);
+
+        file.storedSize = static_cast<std::uint32_t>(file.data.size());
+    }
+
+    void packWorker(PackQueue* queue)
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        while (queue->next < queue->order.size() && queue->error.empty())
+        {
+            if (queue->next >= queue->written + queue->window)
+            {
+                queue->fileWritten.wait(lock);
+                continue;
+            }
+
+            PackedFile& file = *queue->order[queue->next++];
+            lock.unlock();
+
+            std::string error;
+            try
+            {
+                packFile(file, queue->compress);
+            }
+            catch (std::exception& e)
+            {
+                error = e.what();
+            }
+
+            lock.lock();
+            if (!error.empty() && queue->error.empty())
+                queue->error = error;
+            file.ready = true;
+            queue->fileReady.notify_all();
+        }
+    }
+
+    // How a cold load that requests the traced files in order reads the archive
+    ReadPattern getReadPattern(const std::vector<PackedFile*>& trace, bool hashOrder)
+    {
+        ReadPattern pattern = { 0, 0, 0 };
+        std::uint64_t end = 0;
+        std::uint64_t first = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t last = 0;
+
+        for (std::vector<PackedFile*>::const_iterator it = trace.begin(); it != trace.end(); ++it)
+        {
+            const std::uint64_t offset = hashOrder ? (*it)->hashOrderOffset : (*it)->offset;
+
+            if (pattern.reads == 0 || offset != end)
+                ++pattern.seeks;
+            ++pattern.reads;
+
+            end = offset + (*it)->storedSize;
+            first = std::min(first, offset);
+            last = std::max(last, end);
+        }
+
+        if (pattern.reads != 0)
+            pattern.span = last - first;
+
+        return pattern;
+    }
+
+    void printReadPattern(const char* layout, const ReadPattern& pattern)
+    {
+        std::cout << "  " << std::setw(12) << std::left << layout << pattern.reads << " reads, "
+            << pattern.seeks << " seeks, " << pattern.span / 1024 << " KiB span" << std::endl;
+    }
+}
+
+int pack(Arguments& info)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    bfs::path source(info.sourcedir);
+    if (!bfs::is_directory(source))
+    {
+        std::cout << "ERROR: " << source << " is not a directory." << std::endl;
+        return 3;
+    }
+
+    Clock::time_point start = Clock::now();
+
+    // Collect the files, grouped by folder and sorted by hash like the records
+    std::vector<std::unique_ptr<PackedFile> > files;
+    std::map<std::uint64_t, PackedFolder> folders;
+    std::map<std::string, PackedFile*> byPath;
+
+    const std::string sourcePath = source.generic_string();
+    for (bfs::recursive_directory_iterator it(source), end; it != end; ++it)
+    {
+        if (!bfs::is_regular_file(it->status()))
+            continue;
+
+        std::string path = it->path().generic_string().substr(sourcePath.size());
+        boost::algorithm::trim_left_if(path, boost::algorithm::is_any_of("/"));
+        boost::algorithm::to_lower(path);
+
+        const std::size_t separator = path.rfind('/');
+        if (separator == std::string::npos)
+        {
+            std::cout << "WARNING: skipping " << path << ", TES4 archives can not store files outside a folder" << std::endl;
+            continue;
+        }
+
+        std::unique_ptr<PackedFile> file(new PackedFile());
+        file->source = it->path();
+        file->folder = path.substr(0, separator);
+        file->name = path.substr(separator + 1);
+        std::replace(file->folder.begin(), file->folder.end(), '/', '\\');
+        file->hash = getFileHash(file->name);
+        file->ready = false;
+
+        if (file->folder.size() > 254)
+        {
+            std::cout << "ERROR: folder name " << file->folder << " is too long" << std::endl;
+            return 3;
+        }
+
+        std::string emptyString;
+        PackedFolder& folder = folders[GenOBHash(file->folder, emptyString)];
+        if (folder.files.empty())
+            folder.name = file->folder;
+        else if (folder.name != file->folder)
+        {
+            std::cout << "ERROR: folders " << folder.name << " and " << file->folder << " have the same hash" << std::endl;
+            return 3;
+        }
+
+        folder.files.push_back(file.get());
+        byPath[file->folder + "\\" + file->name] = file.get();
+        files.push_back(std::move(file));
+    }
+
+    if (files.empty())
+    {
+        std::cout << "ERROR: no files found in " << source << std::endl;
+        return 3;
+    }
+
+    std::vector<PackedFile*> hashOrder;
+    std::uint32_t totalFolderNameLength = 0;
+    std::uint32_t totalFileNameLength = 0;
+    std::uint64_t headerSize = 36 + 16 * folders.size();
+
+    for (std::map<std::uint64_t, PackedFolder>::iterator it = folders.begin(); it != folders.end(); ++it)
+    {
+        std::vector<PackedFile*>& folderFiles = it->second.files;
+        std::sort(folderFiles.begin(), folderFiles.end(),
+            [](const PackedFile* a, const PackedFile* b) { return a->hash < b->hash; });
+
+        for (std::size_t i = 0; i < folderFiles.size(); ++i)
+        {
+            if (i > 0 && folderFiles[i - 1]->hash == folderFiles[i]->hash)
+            {
+                std::cout << "ERROR: files " << folderFiles[i - 1]->name << " and " << folderFiles[i]->name
+                    << " in " << it->second.name << " have the same hash" << std::endl;
+                return 3;
+            }
+
+            totalFileNameLength += static_cast<std::uint32_t>(folderFiles[i]->name.size() + 1);
+            hashOrder.push_back(folderFiles[i]);
+        }
+
+        totalFolderNameLength += static_cast<std::uint32_t>(it->second.name.size() + 1);
+        headerSize += 1 + it->second.name.size() + 1 + 16 * folderFiles.size();
+    }
+    headerSize += totalFileNameLength;
+
+    // Traced files go first, in the order they were loaded
+    std::vector<PackedFile*> trace;
+    std::size_t unknownTraceEntries = 0;
+    if (!info.tracefile.empty())
+    {
+        bfs::ifstream traceStream(info.tracefile);
+        if (!traceStream)
+        {
+            std::cout << "ERROR: can not open trace " << info.tracefile << std::endl;
+            return 3;
+        }
+
+        std::set<const PackedFile*> seen;
+        std::string line;
+        while (std::getline(traceStream, line))
+        {
+            boost::algorithm::trim(line);
+            boost::algorithm::to_lower(line);
+            std::replace(line.begin(), line.end(), '/', '\\');
+            boost::algorithm::trim_left_if(line, boost::algorithm::is_any_of("\\"));
+            if (line.empty())
+                continue;
+
+            std::map<std::string, PackedFile*>::const_iterator found = byPath.find(line);
+            if (found == byPath.end())
+                ++unknownTraceEntries;
+            else if (seen.insert(found->second).second)
+                trace.push_back(found->second);
+        }
+    }
+
+    PackQueue queue;
+    queue.order = trace;
+    {
+        std::set<const PackedFile*> traced(trace.begin(), trace.end());
+        for (std::vector<PackedFile*>::const_iterator it = hashOrder.begin(); it != hashOrder.end(); ++it)
+            if (!traced.count(*it))
+                queue.order.push_back(*it);
+    }
+
+    unsigned int numThreads = info.threads != 0 ? info.threads : std::max(1u, std::thread::hardware_concurrency());
+    queue.next = 0;
+    queue.written = 0;
+    queue.window = 4 * numThreads;
+    queue.compress = info.compress;
+
+    bfs::ofstream out(bfs::path(info.filename), std::ios::binary);
+    if (!out)
+    {
+        std::cout << "ERROR: can not create " << info.filename << std::endl;
+        return 3;
+    }
+
+    // The records only depend on the names, so the data is streamed out behind them
+    // and the records are filled in once all offsets are known
+    const std::vector<char> placeholder(static_cast<std::size_t>(headerSize));
+    out.write(&placeholder[0], placeholder.size());
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < numThreads; ++i)
+        threads.push_back(std::thread(packWorker, &queue));
+
+    std::uint64_t position = headerSize;
+    std::uint64_t rawBytes = 0;
+    {
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        for (std::size_t i = 0; i < queue.order.size() && queue.error.empty(); ++i)
+        {
+            PackedFile& file = *queue.order[i];
+            queue.fileReady.wait(lock, [&]() { return file.ready || !queue.error.empty(); });
+            if (!queue.error.empty())
+                break;
+            lock.unlock();
+
+            if (position + file.storedSize > std::numeric_limits<std::uint32_t>::max())
+            {
+                lock.lock();
+                queue.error = "archive exceeds 4 GiB";
+                break;
+            }
+
+            file.offset = static_cast<std::uint32_t>(position);
+            if (!file.data.empty())
+                out.write(&file.data[0], file.data.size());
+            position += file.storedSize;
+            rawBytes += file.rawSize;
+            std::vector<char>().swap(file.data);
+
+            lock.lock();
+            ++queue.written;
+            queue.fileWritten.notify_all();
+        }
+        queue.fileWritten.notify_all();
+    }
+
+    for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        it->join();
+
+    if (!queue.error.empty())
+    {
+        std::cout << "ERROR: " << queue.error << std::endl;
+        return 3;
+    }
+
+    // Header, folder records, file record blocks and file names
+    std::uint32_t archiveFlags = 0x1 | 0x2;
+    if (info.compress)
+        archiveFlags |= 0x4;
+
+    out.seekp(0);
+    writeUInt32(out, 0x00415342); // "BSA\0"
+    writeUInt32(out, 0x67);
+    writeUInt32(out, 36);
+    writeUInt32(out, archiveFlags);
+    writeUInt32(out, static_cast<std::uint32_t>(folders.size()));
+    writeUInt32(out, static_cast<std::uint32_t>(files.size()));
+    writeUInt32(out, totalFolderNameLength);
+    writeUInt32(out, totalFileNameLength);
+    writeUInt32(out, 0);
+
+    std::uint64_t blockOffset = 36 + 16 * folders.size();
+    for (std::map<std::uint64_t, PackedFolder>::const_iterator it = folders.begin(); it != folders.end(); ++it)
+    {
+        writeUInt64(out, it->first);
+        writeUInt32(out, static_cast<std::uint32_t>(it->second.files.size()));
+        writeUInt32(out, static_cast<std::uint32_t>(blockOffset + totalFileNameLength));
+        blockOffset += 1 + it->second.name.size() + 1 + 16 * it->second.files.size();
+    }
+
+    for (std::map<std::uint64_t, PackedFolder>::const_iterator it = folders.begin(); it != folders.end(); ++it)
+    {
+        out.put(static_cast<char>(it->second.name.size() + 1));
+        out.write(it->second.name.c_str(), it->second.name.size() + 1);
+
+        for (std::vector<PackedFile*>::const_iterator file = it->second.files.begin(); file != it->second.files.end(); ++file)
+        {
+            std::uint32_t size = (*file)->storedSize;
+            if ((*file)->compressed != info.compress)
+                size |= sCompressedFlag;
+
+            writeUInt64(out, (*file)->hash);
+            writeUInt32(out, size);
+            writeUInt32(out, (*file)->offset);
+        }
+    }
+
+    for (std::vector<PackedFile*>::const_iterator it = hashOrder.begin(); it != hashOrder.end(); ++it)
+        out.write((*it)->name.c_str(), (*it)->name.size() + 1);
+
+    out.close();
+    if (!out)
+    {
+        std::cout << "ERROR: writing " << info.filename << " failed" << std::endl;
+        return 3;
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "Packed " << files.size() << " files in " << folders.size() << " folders into " << info.filename << std::endl;
+    std::cout << "  " << rawBytes / 1024 << " KiB -> " << position / 1024 << " KiB in " << seconds << " s, "
+        << (seconds > 0 ? rawBytes / (1024 * 1024) / seconds : 0) << " MiB/s on " << numThreads << " threads" << std::endl;
+
+    if (!info.tracefile.empty())
+    {
+        std::uint64_t hashOrderPosition = headerSize;
+        for (std::vector<PackedFile*>::const_iterator it = hashOrder.begin(); it != hashOrder.end(); ++it)
+        {
+            (*it)->hashOrderOffset = static_cast<std::uint32_t>(hashOrderPosition);
+            hashOrderPosition += (*it)->storedSize;
+        }
+
+        std::cout << "Cold load of the traced files (" << unknownTraceEntries << " trace entries not in the archive):" << std::endl;
+        printReadPattern("hash order", getReadPattern(trace, true));
+        printReadPattern("packed", getReadPattern(trace, false));
+    }
+
+    return 0;
+}
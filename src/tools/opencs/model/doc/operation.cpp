@@ -2,14 +2,58 @@
 
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #include <QTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <components/debug/debuglog.hpp>
 
 #include "../world/universalid.hpp"
 
+#include "../prefs/state.hpp"
+
 #include "state.hpp"
 #include "stage.hpp"
 
+namespace
+{
+    // Steps handed to each thread per timer event, small enough to keep the progress bar and
+    // abort responsive
+    const int sParallelStepsPerThread = 64;
+
+    class StepRange : public QRunnable
+    {
+            CSMDoc::Stage& mStage;
+            int mBegin;
+            int mEnd;
+            CSMDoc::Messages& mMessages;
+            std::string& mError;
+
+        public:
+
+            StepRange (CSMDoc::Stage& stage, int begin, int end, CSMDoc::Messages& messages,
+                std::string& error)
+            : mStage (stage), mBegin (begin), mEnd (end), mMessages (messages), mError (error)
+            {}
+
+            virtual void run()
+            {
+                try
+                {
+                    for (int step = mBegin; step<mEnd; ++step)
+                        mStage.perform (step, mMessages);
+                }
+                catch (const std::exception& e)
+                {
+                    mError = e.what();
+                }
+            }
+    };
+}
+
 void CSMDoc::Operation::prepareStages()
 {
     mCurrentStage = mStages.begin();
@@ -23,6 +67,47 @@ void CSMDoc::Operation::prepareStages()
         iter->second = iter->first->setup();
         mTotalSteps += iter->second;
     }
+
+    int threads = CSMPrefs::get()["Reports"]["operation-threads"].toInt();
+    mThreadPool->setMaxThreadCount (threads>0 ? threads : QThread::idealThreadCount());
+
+    mElapsed.start();
+}
+
+void CSMDoc::Operation::performParallel (Messages& messages)
+{
+    Stage& stage = *mCurrentStage->first;
+
+    int threads = std::max (1, mThreadPool->maxThreadCount());
+    int begin = mCurrentStep;
+    int end = std::min (mCurrentStage->second, begin + threads * sParallelStepsPerThread);
+    int stepsPerThread = (end - begin + threads - 1) / threads;
+
+    std::vector<Messages> results (threads, Messages (mDefaultSeverity));
+    std::vector<std::string> errors (threads);
+
+    for (int i = 0; i<threads && begin + i * stepsPerThread<end; ++i)
+        mThreadPool->start (new StepRange (stage, begin + i * stepsPerThread,
+            std::min (end, begin + (i+1) * stepsPerThread), results[i], errors[i]));
+
+    mThreadPool->waitForDone();
+
+    mCurrentStep = end;
+    mCurrentStepTotal += end - begin;
+
+    // merge in step order, so the report looks the same as with a single thread
+    for (int i = 0; i<threads; ++i)
+    {
+        for (Messages::Iterator iter (results[i].begin()); iter!=results[i].end(); ++iter)
+            messages.add (iter->mId, iter->mMessage, iter->mHint, iter->mSeverity);
+
+        if (!errors[i].empty())
+        {
+            emit reportMessage (Message (CSMWorld::UniversalId(), errors[i], "", Message::Severity_SeriousError), mType);
+            abort();
+            break;
+        }
+    }
 }
 
 CSMDoc::Operation::Operation (int type, bool ordered, bool finalAlways)
@@ -32,6 +117,7 @@ CSMDoc::Operation::Operation (int type, bool ordered, bool finalAlways)
   mDefaultSeverity (Message::Severity_Error)
 {
     mTimer = new QTimer (this);
+    mThreadPool = new QThreadPool (this);
 }
 
 CSMDoc::Operation::~Operation()
@@ -106,6 +192,11 @@ void CSMDoc::Operation::executeStage()
             mCurrentStep = 0;
             ++mCurrentStage;
         }
+        else if (mCurrentStage->first->isParallel() && mThreadPool->maxThreadCount()>1)
+        {
+            performParallel (messages);
+            break;
+        }
         else
         {
             try
@@ -134,6 +225,9 @@ void CSMDoc::Operation::executeStage()
 
 void CSMDoc::Operation::operationDone()
 {
+    Log(Debug::Info) << "Operation " << mType << " finished after " << mElapsed.elapsed() << " ms using "
+        << mThreadPool->maxThreadCount() << " threads" << (mError ? " (aborted)" : "");
+
     mTimer->stop();
     emit done (mType, mError);
 }
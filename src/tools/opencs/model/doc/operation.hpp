@@ -7,6 +7,9 @@
 #include <QObject>
 #include <QTimer>
 #include <QStringList>
+#include <QElapsedTimer>
+
+class QThreadPool;
 
 #include "messages.hpp"
 
@@ -34,11 +37,16 @@ namespace CSMDoc
             bool mError;
             bool mConnected;
             QTimer *mTimer;
+            QThreadPool *mThreadPool;
+            QElapsedTimer mElapsed;
             bool mPrepared;
             Message::Severity mDefaultSeverity;
 
             void prepareStages();
 
+            void performParallel (Messages& messages);
+            ///< Perform the next batch of steps of the current stage on the thread pool.
+
         public:
 
             Operation (int type, bool ordered, bool finalAlways = false);
@@ -23,6 +23,12 @@ namespace CSMDoc
 
             virtual void perform (int stage, Messages& messages) = 0;
             ///< Messages resulting from this stage will be appended to \a messages.
+
+            virtual bool isParallel() const;
+            ///< Can perform be called for different steps from several threads at the same time?
+            /// Messages are still reported in step order.
+            ///
+            /// \note Default: false
     };
 }
 
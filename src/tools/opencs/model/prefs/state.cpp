@@ -124,6 +124,9 @@ void CSMPrefs::State::declare()
     declareEnum ("double-c", "Control Double Click", actionEditAndRemove).addValues (reportValues);
     declareEnum ("double-sc", "Shift Control Double Click", actionNone).addValues (reportValues);
     declareBool("ignore-base-records", "Ignore base records in verifier", false);
+    declareInt ("operation-threads", "Verifier and search threads", 0).
+        setTooltip ("Number of threads used by the verifier and the search, 0 uses one per CPU core").
+        setRange (0, 64);
 
     declareCategory ("Search & Replace");
     declareInt ("char-before", "Characters before search string", 10).
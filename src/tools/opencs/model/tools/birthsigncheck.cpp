@@ -50,3 +50,8 @@ void CSMTools::BirthsignCheckStage::perform (int stage, CSMDoc::Messages& messag
 
     /// \todo check data members that can't be edited in the table view
 }
+
+bool CSMTools::BirthsignCheckStage::isParallel() const
+{
+    return true;
+}
@@ -54,3 +54,8 @@ void CSMTools::BodyPartCheckStage::perform (int stage, CSMDoc::Messages &message
     else if ( mRaces.searchId( bodyPart.mRace ) == -1 )
         messages.add(id, "Race '" + bodyPart.mRace + " does not exist", "", CSMDoc::Message::Severity_Error);
 }
+
+bool CSMTools::BodyPartCheckStage::isParallel() const
+{
+    return true;
+}
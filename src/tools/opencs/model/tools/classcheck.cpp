@@ -67,3 +67,8 @@ void CSMTools::ClassCheckStage::perform (int stage, CSMDoc::Messages& messages)
             messages.add(id, "Skill " + ESM::Skill::indexToId (skill.first) + " is listed more than once", "", CSMDoc::Message::Severity_Error);
         }
 }
+
+bool CSMTools::ClassCheckStage::isParallel() const
+{
+    return true;
+}
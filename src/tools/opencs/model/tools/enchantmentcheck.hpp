@@ -25,6 +25,8 @@ namespace CSMTools
             virtual void perform (int stage, CSMDoc::Messages& messages);
             ///< Messages resulting from this tage will be appended to \a messages.
 
+            virtual bool isParallel() const;
+
     };
 }
 
@@ -58,3 +58,8 @@ void CSMTools::FactionCheckStage::perform (int stage, CSMDoc::Messages& messages
 
     /// \todo check data members that can't be edited in the table view
 }
+
+bool CSMTools::FactionCheckStage::isParallel() const
+{
+    return true;
+}
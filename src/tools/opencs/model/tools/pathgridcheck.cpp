@@ -136,3 +136,8 @@ void CSMTools::PathgridCheckStage::perform (int stage, CSMDoc::Messages& message
 
     // TODO: check whether there are disconnected graphs
 }
+
+bool CSMTools::PathgridCheckStage::isParallel() const
+{
+    return true;
+}
@@ -35,6 +35,8 @@ namespace CSMTools
         virtual int setup();
 
         virtual void perform (int stage, CSMDoc::Messages& messages);
+
+        virtual bool isParallel() const;
     };
 }
 
@@ -15,6 +15,8 @@ namespace CSMTools
                 const CSMWorld::IdCollection<ESM::Faction>& factions);
 
             virtual void perform(int stage, CSMDoc::Messages& messages);
+
+            virtual bool isParallel() const;
             virtual int setup();
 
         private:
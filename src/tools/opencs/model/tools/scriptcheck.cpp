@@ -1,5 +1,8 @@
 #include "scriptcheck.hpp"
 
+#include <sstream>
+
+#include <components/compiler/errorhandler.hpp>
 #include <components/compiler/tokenloc.hpp>
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/fileparser.hpp>
@@ -12,51 +15,78 @@
 
 #include "../prefs/state.hpp"
 
-CSMDoc::Message::Severity CSMTools::ScriptCheckStage::getSeverity (Type type)
+namespace
 {
-    switch (type)
+    /// \brief Reports compiler errors of a single script to the verifier messages
+    class ScriptErrorHandler : public Compiler::ErrorHandler
     {
-        case WarningMessage: return CSMDoc::Message::Severity_Warning;
-        case ErrorMessage: return CSMDoc::Message::Severity_Error;
-    }
-
-    return CSMDoc::Message::Severity_SeriousError;
+            CSMWorld::UniversalId mId;
+            CSMDoc::Messages& mMessages;
+
+            CSMDoc::Message::Severity getSeverity (Type type)
+            {
+                switch (type)
+                {
+                    case WarningMessage: return CSMDoc::Message::Severity_Warning;
+                    case ErrorMessage: return CSMDoc::Message::Severity_Error;
+                }
+
+                return CSMDoc::Message::Severity_SeriousError;
+            }
+
+            virtual void report (const std::string& message, const Compiler::TokenLoc& loc, Type type)
+            {
+                std::ostringstream stream;
+
+                stream << "line " << loc.mLine << ", column " << loc.mColumn << ": " << message << " (" << loc.mLiteral << ")";
+
+                std::ostringstream hintStream;
+
+                hintStream << "l:" << loc.mLine << " " << loc.mColumn;
+
+                mMessages.add (mId, stream.str(), hintStream.str(), getSeverity (type));
+            }
+
+            virtual void report (const std::string& message, Type type)
+            {
+                mMessages.add (mId, message, "", getSeverity (type));
+            }
+
+        public:
+
+            ScriptErrorHandler (const std::string& id, CSMDoc::Messages& messages,
+                CSMTools::ScriptCheckStage::WarningMode warningMode)
+            : mId (CSMWorld::UniversalId::Type_Script, id), mMessages (messages)
+            {
+                switch (warningMode)
+                {
+                    case CSMTools::ScriptCheckStage::Mode_Ignore: setWarningsMode (0); break;
+                    case CSMTools::ScriptCheckStage::Mode_Normal: setWarningsMode (1); break;
+                    case CSMTools::ScriptCheckStage::Mode_Strict: setWarningsMode (2); break;
+                }
+            }
+    };
 }
 
-void CSMTools::ScriptCheckStage::report (const std::string& message, const Compiler::TokenLoc& loc,
-    Type type)
+CSMWorld::ScriptContext& CSMTools::ScriptCheckStage::getContext()
 {
-    std::ostringstream stream;
-
-    CSMWorld::UniversalId id (CSMWorld::UniversalId::Type_Script, mId);
-
-    stream << "line " << loc.mLine << ", column " << loc.mColumn << ": " << message << " (" << loc.mLiteral << ")";
+    std::lock_guard<std::mutex> lock (mContextsMutex);
 
-    std::ostringstream hintStream;
-
-    hintStream << "l:" << loc.mLine << " " << loc.mColumn;
-
-    mMessages->add (id, stream.str(), hintStream.str(), getSeverity (type));
-}
-
-void CSMTools::ScriptCheckStage::report (const std::string& message, Type type)
-{
-    CSMWorld::UniversalId id (CSMWorld::UniversalId::Type_Script, mId);
+    std::unique_ptr<CSMWorld::ScriptContext>& context = mContexts[std::this_thread::get_id()];
 
-    std::ostringstream stream;
-    stream << message;
+    if (!context)
+    {
+        context.reset (new CSMWorld::ScriptContext (mDocument.getData()));
+        context->setExtensions (&mExtensions);
+    }
 
-    mMessages->add (id, stream.str(), "", getSeverity (type));
+    return *context;
 }
 
 CSMTools::ScriptCheckStage::ScriptCheckStage (const CSMDoc::Document& document)
-: mDocument (document), mContext (document.getData()), mMessages (0), mWarningMode (Mode_Ignore)
+: mDocument (document), mWarningMode (Mode_Ignore)
 {
-    /// \todo add an option to configure warning mode
-    setWarningsMode (0);
-
     Compiler::registerExtensions (mExtensions);
-    mContext.setExtensions (&mExtensions);
 
     mIgnoreBaseRecords = false;
 }
@@ -72,10 +102,8 @@ int CSMTools::ScriptCheckStage::setup()
     else if (warnings=="Strict")
         mWarningMode = Mode_Strict;
 
-    mContext.clear();
-    mMessages = 0;
-    mId.clear();
-    Compiler::ErrorHandler::reset();
+    // contexts cache the script ids, drop them so changes since the last run are picked up
+    mContexts.clear();
 
     mIgnoreBaseRecords = CSMPrefs::get()["Reports"]["ignore-base-records"].isTrue();
 
@@ -86,33 +114,27 @@ void CSMTools::ScriptCheckStage::perform (int stage, CSMDoc::Messages& messages)
 {
     const CSMWorld::Record<ESM::Script> &record = mDocument.getData().getScripts().getRecord(stage);
 
-    mId = mDocument.getData().getScripts().getId (stage);
+    std::string id = mDocument.getData().getScripts().getId (stage);
 
     if (mDocument.isBlacklisted (
-        CSMWorld::UniversalId (CSMWorld::UniversalId::Type_Script, mId)))
+        CSMWorld::UniversalId (CSMWorld::UniversalId::Type_Script, id)))
         return;
 
     // Skip "Base" records (setting!) and "Deleted" records
     if ((mIgnoreBaseRecords && record.mState == CSMWorld::RecordBase::State_BaseOnly) || record.isDeleted())
         return;
 
-    mMessages = &messages;
-
-    switch (mWarningMode)
-    {
-        case Mode_Ignore: setWarningsMode (0); break;
-        case Mode_Normal: setWarningsMode (1); break;
-        case Mode_Strict: setWarningsMode (2); break;
-    }
+    ScriptErrorHandler errorHandler (id, messages, mWarningMode);
 
     try
     {
-        mFile = record.get().mId;
+        CSMWorld::ScriptContext& context = getContext();
+
         std::istringstream input (record.get().mScriptText);
 
-        Compiler::Scanner scanner (*this, input, mContext.getExtensions());
+        Compiler::Scanner scanner (errorHandler, input, context.getExtensions());
 
-        Compiler::FileParser parser (*this, mContext);
+        Compiler::FileParser parser (errorHandler, context);
 
         scanner.scan (parser);
     }
@@ -122,13 +144,16 @@ void CSMTools::ScriptCheckStage::perform (int stage, CSMDoc::Messages& messages)
     }
     catch (const std::exception& error)
     {
-        CSMWorld::UniversalId id (CSMWorld::UniversalId::Type_Script, mId);
+        CSMWorld::UniversalId universalId (CSMWorld::UniversalId::Type_Script, id);
 
         std::ostringstream stream;
         stream << error.what();
 
-        messages.add (id, stream.str(), "", CSMDoc::Message::Severity_SeriousError);
+        messages.add (universalId, stream.str(), "", CSMDoc::Message::Severity_SeriousError);
     }
+}
 
-    mMessages = 0;
+bool CSMTools::ScriptCheckStage::isParallel() const
+{
+    return true;
 }
@@ -1,7 +1,11 @@
 #ifndef CSM_TOOLS_SCRIPTCHECK_H
 #define CSM_TOOLS_SCRIPTCHECK_H
 
-#include <components/compiler/errorhandler.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
 #include <components/compiler/extensions.hpp>
 
 #include "../doc/stage.hpp"
@@ -16,8 +20,13 @@ namespace CSMDoc
 namespace CSMTools
 {
     /// \brief VerifyStage: make sure that scripts compile
-    class ScriptCheckStage : public CSMDoc::Stage, private Compiler::ErrorHandler
+    ///
+    /// Each script is compiled with its own error handler and each thread with its own context,
+    /// so steps can run in parallel.
+    class ScriptCheckStage : public CSMDoc::Stage
     {
+        public:
+
             enum WarningMode
             {
                 Mode_Ignore,
@@ -25,22 +34,17 @@ namespace CSMTools
                 Mode_Strict
             };
 
+        private:
+
             const CSMDoc::Document& mDocument;
             Compiler::Extensions mExtensions;
-            CSMWorld::ScriptContext mContext;
-            std::string mId;
-            std::string mFile;
-            CSMDoc::Messages *mMessages;
+            std::map<std::thread::id, std::unique_ptr<CSMWorld::ScriptContext> > mContexts;
+            std::mutex mContextsMutex;
             WarningMode mWarningMode;
             bool mIgnoreBaseRecords;
 
-            CSMDoc::Message::Severity getSeverity (Type type);
-
-            virtual void report (const std::string& message, const Compiler::TokenLoc& loc, Type type);
-            ///< Report error to the user.
-
-            virtual void report (const std::string& message, Type type);
-            ///< Report a file related error
+            CSMWorld::ScriptContext& getContext();
+            ///< Context of the calling thread, created on first use
 
         public:
 
@@ -51,6 +55,8 @@ namespace CSMTools
 
             virtual void perform (int stage, CSMDoc::Messages& messages);
             ///< Messages resulting from this tage will be appended to \a messages.
+
+            virtual bool isParallel() const;
     };
 }
 
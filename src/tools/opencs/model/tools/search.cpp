@@ -45,11 +45,14 @@ void CSMTools::Search::searchRegExCell (const CSMWorld::IdTableBase *model,
 {
     QString text = model->data (index).toString();
 
+    // QRegExp keeps the match state, use a copy so rows can be searched from several threads
+    QRegExp regExp (mRegExp);
+
     int pos = 0;
 
-    while ((pos = mRegExp.indexIn (text, pos))!=-1)
+    while ((pos = regExp.indexIn (text, pos))!=-1)
     {
-        int length = mRegExp.matchedLength();
+        int length = regExp.matchedLength();
         
         std::ostringstream hint;
         hint
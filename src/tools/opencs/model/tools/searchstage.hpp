@@ -30,6 +30,8 @@ namespace CSMTools
             virtual void perform (int stage, CSMDoc::Messages& messages);
             ///< Messages resulting from this stage will be appended to \a messages.
 
+            virtual bool isParallel() const;
+
             void setOperation (const SearchOperation *operation);
     };
 }
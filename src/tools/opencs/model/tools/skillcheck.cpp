@@ -38,3 +38,8 @@ void CSMTools::SkillCheckStage::perform (int stage, CSMDoc::Messages& messages)
             messages.add(id, "Use value #" + std::to_string(i) + " is negative", "", CSMDoc::Message::Severity_Error);
         }
 }
+
+bool CSMTools::SkillCheckStage::isParallel() const
+{
+    return true;
+}
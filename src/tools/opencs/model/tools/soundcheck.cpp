@@ -45,3 +45,8 @@ void CSMTools::SoundCheckStage::perform (int stage, CSMDoc::Messages& messages)
         messages.add(id, "Sound file '" + sound.mSound + "' does not exist", "", CSMDoc::Message::Severity_Error);
     }
 }
+
+bool CSMTools::SoundCheckStage::isParallel() const
+{
+    return true;
+}
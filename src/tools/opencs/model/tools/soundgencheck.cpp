@@ -55,3 +55,8 @@ void CSMTools::SoundGenCheckStage::perform(int stage, CSMDoc::Messages &messages
         messages.add(id, "Sound '" + soundGen.mSound + "' doesn't exist", "", CSMDoc::Message::Severity_Error);
     }
 }
+
+bool CSMTools::SoundGenCheckStage::isParallel() const
+{
+    return true;
+}
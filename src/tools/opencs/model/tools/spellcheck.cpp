@@ -44,3 +44,8 @@ void CSMTools::SpellCheckStage::perform (int stage, CSMDoc::Messages& messages)
 
     /// \todo check data members that can't be edited in the table view
 }
+
+bool CSMTools::SpellCheckStage::isParallel() const
+{
+    return true;
+}
@@ -34,3 +34,8 @@ int CSMTools::StartScriptCheckStage::setup()
 
     return mStartScripts.getSize();
 }
+
+bool CSMTools::StartScriptCheckStage::isParallel() const
+{
+    return true;
+}
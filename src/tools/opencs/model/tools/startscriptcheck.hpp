@@ -22,6 +22,8 @@ namespace CSMTools
                 const CSMWorld::IdCollection<ESM::Script>& scripts);
 
             virtual void perform(int stage, CSMDoc::Messages& messages);
+
+            virtual bool isParallel() const;
             virtual int setup();
     };
 }
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <cctype>
 #include <stdexcept>
@@ -74,7 +75,41 @@ namespace CSMWorld
         return LandTexture::createUniqueRecordId(record.mPluginIndex, record.mIndex);
     }
 
+    /// \brief Case-insensitive hash of a record ID
+    ///
+    /// Folds the case while hashing, so IDs can be looked up without making a lower case copy.
+    /// Uses the same folding as IdEqual, so IDs that compare equal always hash equally.
+    struct IdHash
+    {
+        std::size_t operator() (const std::string& id) const
+        {
+            // FNV-1a
+            std::size_t hash = 2166136261u;
+
+            for (std::string::const_iterator iter (id.begin()); iter!=id.end(); ++iter)
+            {
+                hash ^= static_cast<unsigned char> (Misc::StringUtils::toLower (*iter));
+                hash *= 16777619u;
+            }
+
+            return hash;
+        }
+    };
+
+    /// \brief Case-insensitive comparison of record IDs
+    struct IdEqual
+    {
+        bool operator() (const std::string& left, const std::string& right) const
+        {
+            return Misc::StringUtils::ciEqual (left, right);
+        }
+    };
+
     /// \brief Single-type record collection
+    ///
+    /// Every record gets a handle that stays the same while rows are inserted, removed or
+    /// reordered. The ID indices map to handles, so changing the rows only has to update the
+    /// handle to row table of the rows that actually moved, instead of walking the indices.
     template<typename ESXRecordT, typename IdAccessorT = IdAccessor<ESXRecordT> >
     class Collection : public CollectionBase
     {
@@ -85,16 +120,34 @@ namespace CSMWorld
         private:
 
             std::vector<Record<ESXRecordT> > mRecords;
-            std::map<std::string, int> mIndex;
+            std::vector<int> mRowHandles;
+            ///< handle of the record in each row
+            std::vector<int> mHandleRows;
+            ///< row of the record with each handle, -1 for unused handles
+            std::vector<int> mFreeHandles;
+            std::unordered_map<std::string, int, IdHash, IdEqual> mIndex;
+            ///< ID -> handle (the hash of each ID is computed once and kept in its node)
+            std::map<std::string, int> mSortedIndex;
+            ///< lower case ID -> handle, for sorted ID lists and prefix searches
             std::vector<Column<ESXRecordT> *> mColumns;
 
             // not implemented
             Collection (const Collection&);
             Collection& operator= (const Collection&);
 
+            int allocateHandle();
+
+            void updateHandleRows (int begin);
+            ///< Update the row of the handles in rows [begin, size)
+
         protected:
 
             const std::map<std::string, int>& getIdMap() const;
+            ///< Lower case IDs mapped to record handles, sorted
+            ///
+            /// \note Use getHandleRow() to turn a handle into a row.
+
+            int getHandleRow (int handle) const;
 
             const std::vector<Record<ESXRecordT> >& getRecords() const;
 
@@ -204,10 +257,37 @@ namespace CSMWorld
             NestableColumn *getNestableColumn (int column) const;
     };
 
+    template<typename ESXRecordT, typename IdAccessorT>
+    int Collection<ESXRecordT, IdAccessorT>::allocateHandle()
+    {
+        if (!mFreeHandles.empty())
+        {
+            int handle = mFreeHandles.back();
+            mFreeHandles.pop_back();
+            return handle;
+        }
+
+        mHandleRows.push_back (-1);
+        return static_cast<int> (mHandleRows.size())-1;
+    }
+
+    template<typename ESXRecordT, typename IdAccessorT>
+    void Collection<ESXRecordT, IdAccessorT>::updateHandleRows (int begin)
+    {
+        for (int i = begin; i<static_cast<int> (mRowHandles.size()); ++i)
+            mHandleRows[mRowHandles[i]] = i;
+    }
+
     template<typename ESXRecordT, typename IdAccessorT>
     const std::map<std::string, int>& Collection<ESXRecordT, IdAccessorT>::getIdMap() const
     {
-        return mIndex;
+        return mSortedIndex;
+    }
+
+    template<typename ESXRecordT, typename IdAccessorT>
+    int Collection<ESXRecordT, IdAccessorT>::getHandleRow (int handle) const
+    {
+        return mHandleRows.at (handle);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -232,20 +312,23 @@ namespace CSMWorld
 
             // reorder records
             std::vector<Record<ESXRecordT> > buffer (size);
+            std::vector<int> handles (size);
 
             for (int i=0; i<size; ++i)
             {
                 buffer[newOrder[i]] = mRecords [baseIndex+i];
                 buffer[newOrder[i]].setModified (buffer[newOrder[i]].get());
+                handles[newOrder[i]] = mRowHandles[baseIndex+i];
             }
 
             std::copy (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
 
             // adjust index
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
-                 ++iter)
-                if (iter->second>=baseIndex && iter->second<baseIndex+size)
-                    iter->second = newOrder.at (iter->second-baseIndex)+baseIndex;
+            for (int i=0; i<size; ++i)
+            {
+                mRowHandles[baseIndex+i] = handles[i];
+                mHandleRows[handles[i]] = baseIndex+i;
+            }
         }
 
         return true;
@@ -338,9 +421,10 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::add (const ESXRecordT& record)
     {
-        std::string id = Misc::StringUtils::lowerCase (IdAccessorT().getId (record));
+        std::string id = IdAccessorT().getId (record);
 
-        std::map<std::string, int>::iterator iter = mIndex.find (id);
+        typename std::unordered_map<std::string, int, IdHash, IdEqual>::const_iterator iter =
+            mIndex.find (id);
 
         if (iter==mIndex.end())
         {
@@ -348,11 +432,11 @@ namespace CSMWorld
             record2.mState = Record<ESXRecordT>::State_ModifiedOnly;
             record2.mModified = record;
 
-            insertRecord (record2, getAppendIndex (id));
+            insertRecord (record2, getAppendIndex (Misc::StringUtils::lowerCase (id)));
         }
         else
         {
-            mRecords[iter->second].setModified (record);
+            mRecords[mHandleRows[iter->second]].setModified (record);
         }
     }
 
@@ -444,27 +528,34 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::removeRows (int index, int count)
     {
-        mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
+        for (int i = index; i<index+count; ++i)
+        {
+            int handle = mRowHandles.at (i);
 
-        typename std::map<std::string, int>::iterator iter = mIndex.begin();
+            // purge() removes erased records, which get() refuses to hand out. Only deleted
+            // records are erased by merge(), and those keep their ID in the base record.
+            const Record<ESXRecordT>& record = mRecords.at (i);
+            std::string id = IdAccessorT().getId (
+                record.isErased() ? record.mBase : record.get());
 
-        while (iter!=mIndex.end())
-        {
-            if (iter->second>=index)
+            // a record with a duplicate ID was never indexed, keep the entry of the original
+            typename std::unordered_map<std::string, int, IdHash, IdEqual>::iterator iter =
+                mIndex.find (id);
+
+            if (iter!=mIndex.end() && iter->second==handle)
             {
-                if (iter->second>=index+count)
-                {
-                    iter->second -= count;
-                    ++iter;
-                }
-                else
-                {
-                    mIndex.erase (iter++);
-                }
+                mIndex.erase (iter);
+                mSortedIndex.erase (Misc::StringUtils::lowerCase (id));
             }
-            else
-                ++iter;
+
+            mHandleRows[handle] = -1;
+            mFreeHandles.push_back (handle);
         }
+
+        mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
+        mRowHandles.erase (mRowHandles.begin()+index, mRowHandles.begin()+index+count);
+
+        updateHandleRows (index);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -485,14 +576,13 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     int Collection<ESXRecordT, IdAccessorT>::searchId (const std::string& id) const
     {
-        std::string id2 = Misc::StringUtils::lowerCase(id);
-
-        std::map<std::string, int>::const_iterator iter = mIndex.find (id2);
+        typename std::unordered_map<std::string, int, IdHash, IdEqual>::const_iterator iter =
+            mIndex.find (id);
 
         if (iter==mIndex.end())
             return -1;
 
-        return iter->second;
+        return mHandleRows[iter->second];
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -522,11 +612,13 @@ namespace CSMWorld
     {
         std::vector<std::string> ids;
 
-        for (typename std::map<std::string, int>::const_iterator iter = mIndex.begin();
-            iter!=mIndex.end(); ++iter)
+        for (typename std::map<std::string, int>::const_iterator iter = mSortedIndex.begin();
+            iter!=mSortedIndex.end(); ++iter)
         {
-            if (listDeleted || !mRecords[iter->second].isDeleted())
-                ids.push_back (IdAccessorT().getId (mRecords[iter->second].get()));
+            const Record<ESXRecordT>& record = mRecords[mHandleRows[iter->second]];
+
+            if (listDeleted || !record.isDeleted())
+                ids.push_back (IdAccessorT().getId (record.get()));
         }
 
         return ids;
@@ -556,16 +648,14 @@ namespace CSMWorld
 
         mRecords.insert (mRecords.begin()+index, record2);
 
-        if (index<static_cast<int> (mRecords.size())-1)
-        {
-            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
-                ++iter)
-                 if (iter->second>=index)
-                     ++(iter->second);
-        }
+        int handle = allocateHandle();
+        mRowHandles.insert (mRowHandles.begin()+index, handle);
+        updateHandleRows (index);
+
+        std::string id = IdAccessorT().getId (record2.get());
 
-        mIndex.insert (std::make_pair (Misc::StringUtils::lowerCase (IdAccessorT().getId (
-            record2.get())), index));
+        if (mIndex.insert (std::make_pair (id, handle)).second)
+            mSortedIndex.insert (std::make_pair (Misc::StringUtils::lowerCase (id), handle));
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -2,6 +2,8 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
 
 #include <QAbstractItemModel>
 
@@ -13,6 +15,7 @@
 #include <components/resource/scenemanager.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/vfs/registerarchives.hpp>
+#include <components/debug/debuglog.hpp>
 
 #include "idtable.hpp"
 #include "idtree.hpp"
@@ -63,6 +66,52 @@ int CSMWorld::Data::count (RecordBase::State state, const CollectionBase& collec
     return number;
 }
 
+void CSMWorld::Data::benchmarkSearchId (const std::string& name, const CollectionBase& collection)
+{
+    const int iterations = 20;
+
+    // look up the IDs in upper case, so the case folding can't be skipped
+    std::vector<std::string> ids;
+    ids.reserve (collection.getSize());
+
+    for (int i=0; i<collection.getSize(); ++i)
+    {
+        std::string id = collection.getId (i);
+        std::transform (id.begin(), id.end(), id.begin(), ::toupper);
+        ids.push_back (id);
+    }
+
+    // the index as it was before, lower case copy and sorted map, for comparison
+    std::map<std::string, int> sortedIndex;
+
+    for (int i=0; i<collection.getSize(); ++i)
+        sortedIndex.insert (std::make_pair (Misc::StringUtils::lowerCase (collection.getId (i)), i));
+
+    int found = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int i=0; i<iterations; ++i)
+        for (std::vector<std::string>::const_iterator iter (ids.begin()); iter!=ids.end(); ++iter)
+            if (collection.searchId (*iter)!=-1)
+                ++found;
+
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+    for (int i=0; i<iterations; ++i)
+        for (std::vector<std::string>::const_iterator iter (ids.begin()); iter!=ids.end(); ++iter)
+            if (sortedIndex.find (Misc::StringUtils::lowerCase (*iter))!=sortedIndex.end())
+                ++found;
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    Log(Debug::Info) << "searchId benchmark " << name << ": " << ids.size() << " IDs, "
+        << std::chrono::duration_cast<std::chrono::microseconds> (middle-start).count()/iterations
+        << " us per pass (lower case + sorted map: "
+        << std::chrono::duration_cast<std::chrono::microseconds> (end-middle).count()/iterations
+        << " us, " << found << " hits)";
+}
+
 CSMWorld::Data::Data (ToUTF8::FromType encoding, bool fsStrict, const Files::PathContainer& dataPaths,
     const std::vector<std::string>& archives, const Fallback::Map* fallback, const boost::filesystem::path& resDir)
 : mEncoder (encoding), mPathgrids (mCells), mRefs (mCells),
@@ -1036,6 +1085,15 @@ bool CSMWorld::Data::continueLoading (CSMDoc::Messages& messages)
 
         loadFallbackEntries();
 
+        if (std::getenv ("OPENMW_CS_SEARCHID_BENCHMARK"))
+        {
+            benchmarkSearchId ("referenceables", mReferenceables);
+            benchmarkSearchId ("references", mRefs);
+            benchmarkSearchId ("cells", mCells);
+            benchmarkSearchId ("topic infos", mTopicInfos);
+            benchmarkSearchId ("scripts", mScripts);
+        }
+
         return true;
     }
 
@@ -146,6 +146,9 @@ namespace CSMWorld
 
             static int count (RecordBase::State state, const CollectionBase& collection);
 
+            static void benchmarkSearchId (const std::string& name, const CollectionBase& collection);
+            ///< Log the time it takes to look up every ID of \a collection, as a table filter would.
+
             void loadFallbackEntries();
 
         public:
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../../../opencs/model/world/collection.hpp"
+
+namespace
+{
+    struct TestRecord
+    {
+        std::string mId;
+        int mValue;
+
+        void blank()
+        {
+            mValue = 0;
+        }
+    };
+
+    TestRecord makeRecord (const std::string& id, int value)
+    {
+        TestRecord record;
+        record.mId = id;
+        record.mValue = value;
+        return record;
+    }
+
+    typedef CSMWorld::Collection<TestRecord> TestCollection;
+
+    void addBase (TestCollection& collection, const std::string& id, int value)
+    {
+        TestRecord record = makeRecord (id, value);
+        collection.appendRecord (CSMWorld::Record<TestRecord> (CSMWorld::RecordBase::State_BaseOnly, &record));
+    }
+
+    void deleteRecord (TestCollection& collection, const std::string& id)
+    {
+        int index = collection.searchId (id);
+        ASSERT_NE (index, -1);
+
+        CSMWorld::Record<TestRecord> record = collection.getRecord (index);
+        record.mState = CSMWorld::RecordBase::State_Deleted;
+        collection.setRecord (index, record);
+    }
+
+    TEST(CollectionTest, purgeRemovesErasedRecord)
+    {
+        TestCollection collection;
+        addBase (collection, "Alpha", 1);
+        addBase (collection, "Beta", 2);
+        addBase (collection, "Gamma", 3);
+
+        deleteRecord (collection, "beta");
+
+        // merge() erases the deleted record and purges it
+        ASSERT_NO_THROW (collection.merge());
+
+        EXPECT_EQ (collection.getSize(), 2);
+        EXPECT_EQ (collection.searchId ("BETA"), -1);
+        EXPECT_EQ (collection.searchId ("alpha"), 0);
+        EXPECT_EQ (collection.searchId ("gamma"), 1);
+        EXPECT_EQ (collection.getRecord ("Gamma").get().mValue, 3);
+    }
+
+    TEST(CollectionTest, purgedIdCanBeAddedAgain)
+    {
+        TestCollection collection;
+        addBase (collection, "Alpha", 1);
+        addBase (collection, "Beta", 2);
+
+        deleteRecord (collection, "Alpha");
+        collection.merge();
+
+        collection.add (makeRecord ("ALPHA", 4));
+
+        EXPECT_EQ (collection.getSize(), 2);
+        EXPECT_EQ (collection.searchId ("Beta"), 0);
+        EXPECT_EQ (collection.searchId ("alpha"), 1);
+        EXPECT_EQ (collection.getRecord ("Alpha").get().mValue, 4);
+    }
+
+    TEST(CollectionTest, equalIdsHashEqually)
+    {
+        CSMWorld::IdHash hash;
+        CSMWorld::IdEqual equal;
+
+        const char *ids[][2] = { { "Alpha", "aLPHA" }, { "fargoth_ring", "Fargoth_Ring" }, { "", "" } };
+
+        for (std::size_t i = 0; i<sizeof (ids) / sizeof (ids[0]); ++i)
+        {
+            ASSERT_TRUE (equal (ids[i][0], ids[i][1]));
+            EXPECT_EQ (hash (ids[i][0]), hash (ids[i][1]));
+        }
+    }
+}